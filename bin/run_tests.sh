@@ -17,5 +17,11 @@ echo ~~~ Running Sanity Tests ~~~
 echo ~~~ Running Expression Tests ~~~
 ./expression_tests.exe
 
+echo ~~~ Running Tokenizer Tests ~~~
+./tokenizer_tests.exe
+
+echo ~~~ Running Parser Tests ~~~
+./parser_tests.exe
+
 ###### Restore Path ###########################################################
 cd $og_path
@@ -77,16 +77,17 @@ md_arena_push(MD_Arena* arena, MD_SSIZE size, MD_SSIZE align)
 			        new_block = md_arena_alloc(.backing = md_varena_allocator(new_vm), .block_size = md_arena_block_size);
 		}
 		else {
-			MD_SPTR const md_arena_block_size = arena->block_size + header_size;
+			MD_SPTR const md_arena_block_size = md_max(arena->block_size, aligned_size) + header_size;
 			new_block = md_arena_alloc(.backing = arena->backing, .block_size = md_arena_block_size);
 		}
 		new_block->base_pos = current->base_pos + current->block_size;
 
 		md_sll_stack_push_n(arena->current, new_block, prev);
 		
-		current = new_block;
-		pos_pre = current->pos;
-		pos_pst = pos_pre + aligned_size;
+		current   = new_block;
+		curr_sptr = md_scast(MD_SPTR, current);
+		pos_pre   = current->pos;
+		pos_pst   = pos_pre + aligned_size;
 	}
 
 	// rjf: push onto current block
@@ -128,6 +128,18 @@
 #	endif
 #endif
 
+// Allows a function to use AVX2 intrinsics without compiling the whole unit with -mavx2
+// (MSVC doesn't gate intrinsics on the target, so its a no-op there)
+#ifndef        md_target_avx2
+#	if MD_COMPILER_MSVC
+#		define md_target_avx2
+#	elif MD_COMPILER_GCC || MD_COMPILER_CLANG
+#		define md_target_avx2 __attribute__( ( __target__("avx2") ) )
+#	else
+#		define md_target_avx2
+#	endif
+#endif
+
 ////////////////////////////////
 //~ rjf: For-Loop Construct Macros
 
@@ -353,7 +353,16 @@ void* md_mem_set( void* destination, MD_U8 fill_byte, MD_SSIZE byte_count )
 #		endif
 #	elif MD_OS_LINUX
 #		if MD_ARCH_X64
-#			define md_ins_atomic_u64_inc_eval(x) __sync_fetch_and_add((volatile MD_U64 *)(x), 1)
+#			define md_ins_atomic_u64_eval(x)                 __sync_add_and_fetch((volatile MD_U64 *)(x), 0)
+#			define md_ins_atomic_u64_inc_eval(x)             __sync_add_and_fetch((volatile MD_U64 *)(x), 1)
+#			define md_ins_atomic_u64_dec_eval(x)             __sync_sub_and_fetch((volatile MD_U64 *)(x), 1)
+#			define md_ins_atomic_u64_eval_assign(x,c)        __atomic_exchange_n ((volatile MD_U64 *)(x), (c), __ATOMIC_SEQ_CST)
+#			define md_ins_atomic_u64_add_eval(x,c)           __sync_add_and_fetch((volatile MD_U64 *)(x), (c))
+#			define md_ins_atomic_u64_eval_cond_assign(x,k,c) __sync_val_compare_and_swap((volatile MD_U64 *)(x), (c), (k))
+#			define md_ins_atomic_u32_eval(x,c)               __sync_add_and_fetch((volatile MD_U32 *)(x), 0)
+#			define md_ins_atomic_u32_eval_assign(x,c)        __atomic_exchange_n ((volatile MD_U32 *)(x), (c), __ATOMIC_SEQ_CST)
+#			define md_ins_atomic_u32_eval_cond_assign(x,k,c) __sync_val_compare_and_swap((volatile MD_U32 *)(x), (c), (k))
+#			define md_ins_atomic_ptr_eval_assign(x,c)        (void*) md_ins_atomic_u64_eval_assign((volatile MD_U64 *)(x), (MD_U64)(c))
 #		else
 #			error Atomic intrinsics not defined for this operating system / architecture combination.
 #		endif
@@ -415,7 +424,7 @@ md_dll__insert_npz(
 			}
 			else
 			{
-				if ( ! md_check_nil(nil, p) && md_check_nil(nil, *p_next)) {
+				if ( ! md_check_nil(nil, *p_next)) {
 					*p_next_prev = n;
 				}
 				*n_next = *p_next;
@@ -494,7 +503,7 @@ md_dll__remove_npz(
 	if (n == *l) {
 		*l = l_prev;
 	}
-	if (md_check_nil(nil, n_prev)) {
+	if (! md_check_nil(nil, n_prev)) {
 		*n_prev_next = n_next;
 	}
 	if (! md_check_nil(nil, n_next)) {
@@ -980,14 +989,14 @@ md_bswap_u64(MD_U64 x)
 	inline MD_U64 md_clz32(MD_U32 mask) { unsigned long idx; _BitScanReverse  (&idx, mask); return 31 - idx; }
 	inline MD_U64 md_clz64(MD_U64 mask) { unsigned long idx; _BitScanReverse64(&idx, mask); return 63 - idx; }
 #elif MD_COMPILER_CLANG || MD_COMPILER_GCC
-	inline MD_U64 md_count_bits_set16(MD_U16 val) { NotImplemented; return 0; }
-	inline MD_U64 md_count_bits_set32(MD_U32 val) { NotImplemented; return 0; }
-	inline MD_U64 md_count_bits_set64(MD_U64 val) { NotImplemented; return 0; }
-
-	inline MD_U64 md_ctz32(MD_U32 val) { NotImplemented; return 0; }
-	inline MD_U64 md_ctz64(MD_U32 val) { NotImplemented; return 0; }
-	inline MD_U64 md_clz32(MD_U32 val) { NotImplemented; return 0; }
-	inline MD_U64 md_clz64(MD_U64 val) { NotImplemented; return 0; }
+	inline MD_U64 md_count_bits_set16(MD_U16 val) { return __builtin_popcount  (val); }
+	inline MD_U64 md_count_bits_set32(MD_U32 val) { return __builtin_popcount  (val); }
+	inline MD_U64 md_count_bits_set64(MD_U64 val) { return __builtin_popcountll(val); }
+
+	inline MD_U64 md_ctz32(MD_U32 mask) { return __builtin_ctz  (mask); }
+	inline MD_U64 md_ctz64(MD_U64 mask) { return __builtin_ctzll(mask); }
+	inline MD_U64 md_clz32(MD_U32 mask) { return __builtin_clz  (mask); }
+	inline MD_U64 md_clz64(MD_U64 mask) { return __builtin_clzll(mask); }
 #else
 #	error "Bit intrinsic functions not defined for this compiler."
 #endif
@@ -6,10 +6,12 @@
 #include <stdarg.h>
 #include <stddef.h>
 
-#if defined( MD_OS_WINDOWS )
+#if MD_OS_WINDOWS
 #	include <intrin.h>
 #	include <tmmintrin.h>
 #	include <wmmintrin.h>
+#elif MD_ARCH_X64
+#	include <immintrin.h>
 #endif
 
 #if MD_LANG_C
@@ -95,6 +95,65 @@ md_str8_find_needle_reverse(MD_String8 string, MD_U64 start_pos, MD_String8 need
 	return result;
 }
 
+////////////////////////////////
+//~ Ed: String Hashing
+
+#define MD_HASH_PRIME_1 0x9E3779B185EBCA87ull
+#define MD_HASH_PRIME_2 0xC2B2AE3D27D4EB4Full
+#define MD_HASH_PRIME_3 0x165667B19E3779F9ull
+#define MD_HASH_PRIME_4 0x85EBCA77C2B2AE63ull
+#define MD_HASH_PRIME_5 0x27D4EB2F165667C5ull
+
+md_internal MD_U64 md_hash__rotl  (MD_U64 x, MD_U64 bits)  { return (x << bits) | (x >> (64 - bits)); }
+md_internal MD_U64 md_hash__read64(MD_U8* ptr)              { MD_U64 v; md_memory_copy(&v, ptr, sizeof(v)); return v; }
+md_internal MD_U32 md_hash__read32(MD_U8* ptr)              { MD_U32 v; md_memory_copy(&v, ptr, sizeof(v)); return v; }
+md_internal MD_U64 md_hash__round (MD_U64 acc, MD_U64 word) { return md_hash__rotl(acc + word * MD_HASH_PRIME_2, 31) * MD_HASH_PRIME_1; }
+md_internal MD_U64 md_hash__merge (MD_U64 acc, MD_U64 lane) { return (acc ^ md_hash__round(0, lane)) * MD_HASH_PRIME_1 + MD_HASH_PRIME_4; }
+
+MD_U64
+md_hash_u64_from_str8(MD_U64 seed, MD_String8 string)
+{
+	MD_U8* ptr = string.str;
+	MD_U8* opl = string.str + string.size;
+	MD_U64 hash;
+	if (string.size >= 32)
+	{
+		MD_U64 lanes[4] = { seed + MD_HASH_PRIME_1 + MD_HASH_PRIME_2, seed + MD_HASH_PRIME_2, seed, seed - MD_HASH_PRIME_1 };
+		for (;ptr + 32 <= opl; ptr += 32) {
+			lanes[0] = md_hash__round(lanes[0], md_hash__read64(ptr +  0));
+			lanes[1] = md_hash__round(lanes[1], md_hash__read64(ptr +  8));
+			lanes[2] = md_hash__round(lanes[2], md_hash__read64(ptr + 16));
+			lanes[3] = md_hash__round(lanes[3], md_hash__read64(ptr + 24));
+		}
+		hash = md_hash__rotl(lanes[0], 1) + md_hash__rotl(lanes[1], 7) + md_hash__rotl(lanes[2], 12) + md_hash__rotl(lanes[3], 18);
+		for (MD_U64 lane = 0; lane < 4; lane += 1) {
+			hash = md_hash__merge(hash, lanes[lane]);
+		}
+	}
+	else {
+		hash = seed + MD_HASH_PRIME_5;
+	}
+	hash += string.size;
+
+	//- Ed: tail, then avalanche
+	for (;ptr + 8 <= opl; ptr += 8) {
+		hash = md_hash__rotl(hash ^ md_hash__round(0, md_hash__read64(ptr)), 27) * MD_HASH_PRIME_1 + MD_HASH_PRIME_4;
+	}
+	if (ptr + 4 <= opl) {
+		hash = md_hash__rotl(hash ^ (md_hash__read32(ptr) * MD_HASH_PRIME_1), 23) * MD_HASH_PRIME_2 + MD_HASH_PRIME_3;
+		ptr += 4;
+	}
+	for (;ptr < opl; ptr += 1) {
+		hash = md_hash__rotl(hash ^ (*ptr * MD_HASH_PRIME_5), 11) * MD_HASH_PRIME_1;
+	}
+	hash ^= hash >> 33;
+	hash *= MD_HASH_PRIME_2;
+	hash ^= hash >> 29;
+	hash *= MD_HASH_PRIME_3;
+	hash ^= hash >> 32;
+	return hash;
+}
+
 ////////////////////////////////
 //~ rjf: String Slicing
 
@@ -432,6 +432,12 @@ md_str8_ends_with(MD_String8 string, MD_String8 end, MD_StringMatchFlags flags)
 	return  is_match;
 }
 
+////////////////////////////////
+//~ Ed: String Hashing
+
+// Fast, non-cryptographic (xxHash64's construction), reads 32 bytes per step. The same bytes & seed hash the same on any machine of the same byte order.
+MD_API MD_U64 md_hash_u64_from_str8(MD_U64 seed, MD_String8 string);
+
 ////////////////////////////////
 //~ rjf: String <=> Integer Conversions
 
@@ -213,9 +213,25 @@ md_string_list_from_token_flags__ainfo(MD_AllocatorInfo ainfo, MD_TokenFlags fla
 	if (flags & MD_TokenFlag_Comment             ){ md_str8_list_push(ainfo, &strs, md_str8_lit("Comment"            )); }
 	if (flags & MD_TokenFlag_Whitespace          ){ md_str8_list_push(ainfo, &strs, md_str8_lit("Whitespace"         )); }
 	if (flags & MD_TokenFlag_Newline             ){ md_str8_list_push(ainfo, &strs, md_str8_lit("Newline"            )); }
+	if (flags & MD_TokenFlag_StringSingleQuote   ){ md_str8_list_push(ainfo, &strs, md_str8_lit("StringSingleQuote"  )); }
+	if (flags & MD_TokenFlag_StringDoubleQuote   ){ md_str8_list_push(ainfo, &strs, md_str8_lit("StringDoubleQuote"  )); }
+	if (flags & MD_TokenFlag_StringTick          ){ md_str8_list_push(ainfo, &strs, md_str8_lit("StringTick"         )); }
+	if (flags & MD_TokenFlag_StringTriplet       ){ md_str8_list_push(ainfo, &strs, md_str8_lit("StringTriplet"      )); }
 	if (flags & MD_TokenFlag_BrokenComment       ){ md_str8_list_push(ainfo, &strs, md_str8_lit("BrokenComment"      )); }
 	if (flags & MD_TokenFlag_BrokenStringLiteral ){ md_str8_list_push(ainfo, &strs, md_str8_lit("BrokenStringLiteral")); }
 	if (flags & MD_TokenFlag_BadCharacter        ){ md_str8_list_push(ainfo, &strs, md_str8_lit("BadCharacter"       )); }
+	if (flags & MD_TokenFlag_BraceLeft           ){ md_str8_list_push(ainfo, &strs, md_str8_lit("BraceLeft"          )); }
+	if (flags & MD_TokenFlag_BraceRight          ){ md_str8_list_push(ainfo, &strs, md_str8_lit("BraceRight"         )); }
+	if (flags & MD_TokenFlag_BracketLeft         ){ md_str8_list_push(ainfo, &strs, md_str8_lit("BracketLeft"        )); }
+	if (flags & MD_TokenFlag_BracketRight        ){ md_str8_list_push(ainfo, &strs, md_str8_lit("BracketRight"       )); }
+	if (flags & MD_TokenFlag_ParenLeft           ){ md_str8_list_push(ainfo, &strs, md_str8_lit("ParenLeft"          )); }
+	if (flags & MD_TokenFlag_ParenRight          ){ md_str8_list_push(ainfo, &strs, md_str8_lit("ParenRight"         )); }
+	if (flags & MD_TokenFlag_Colon               ){ md_str8_list_push(ainfo, &strs, md_str8_lit("Colon"              )); }
+	if (flags & MD_TokenFlag_Semicolon           ){ md_str8_list_push(ainfo, &strs, md_str8_lit("Semicolon"          )); }
+	if (flags & MD_TokenFlag_Comma               ){ md_str8_list_push(ainfo, &strs, md_str8_lit("Comma"              )); }
+	if (flags & MD_TokenFlag_At                  ){ md_str8_list_push(ainfo, &strs, md_str8_lit("At"                 )); }
+	if (flags & MD_TokenFlag_Hash                ){ md_str8_list_push(ainfo, &strs, md_str8_lit("Hash"               )); }
+	if (flags & MD_TokenFlag_Backslash           ){ md_str8_list_push(ainfo, &strs, md_str8_lit("Backslash"          )); }
 	return strs;
 }
 
@@ -250,6 +266,93 @@ md_token_array_from_chunk_list__ainfo(MD_AllocatorInfo ainfo, MD_TokenChunkList*
 	return result;
 }
 
+////////////////////////////////
+//~ Ed: Compact MD_Token Type Functions
+
+md_internal void
+md_compact_token_array__alloc(MD_AllocatorInfo ainfo, MD_CompactTokenArray* array, MD_U64 count, MD_B32 wide)
+{
+	array->flags = md_alloc_array_no_zero(ainfo, MD_U32, count);
+	if (wide) {
+		array->offsets_wide = md_alloc_array_no_zero(ainfo, MD_U64, count);
+		array->sizes_wide   = md_alloc_array_no_zero(ainfo, MD_U64, count);
+	}
+	else {
+		array->offsets = md_alloc_array_no_zero(ainfo, MD_U32, count);
+		array->sizes   = md_alloc_array_no_zero(ainfo, MD_U32, count);
+	}
+}
+
+md_internal void
+md_compact_token_array__set(MD_CompactTokenArray* array, MD_U64 idx, MD_Token token)
+{
+	array->flags[idx] = token.flags;
+	if (array->offsets_wide != 0) {
+		array->offsets_wide[idx] = token.range.md_min;
+		array->sizes_wide  [idx] = token.range.md_max - token.range.md_min;
+	}
+	else {
+		array->offsets[idx] = (MD_U32)token.range.md_min;
+		array->sizes  [idx] = (MD_U32)(token.range.md_max - token.range.md_min);
+	}
+}
+
+// Set list->wide before the first push when the text is over 4 GB
+void
+md_compact_token_chunk_list_push__ainfo(MD_AllocatorInfo ainfo, MD_CompactTokenChunkList* list, MD_U64 cap, MD_Token token)
+{
+	MD_CompactTokenChunkNode* node = list->last;
+	if (node == 0 || node->v.count >= node->cap) {
+		node      = md_alloc_array(ainfo, MD_CompactTokenChunkNode, 1);
+		node->cap = cap;
+		md_compact_token_array__alloc(ainfo, &node->v, cap, list->wide);
+		md_sll_queue_push(list->first, list->last, node);
+		list->chunk_count += 1;
+	}
+	md_compact_token_array__set(&node->v, node->v.count, token);
+	node->v.count           += 1;
+	list->total_token_count += 1;
+}
+
+MD_CompactTokenArray
+md_compact_token_array_from_chunk_list__ainfo(MD_AllocatorInfo ainfo, MD_CompactTokenChunkList* chunks)
+{
+	MD_CompactTokenArray result = {0};
+	result.count = chunks->total_token_count;
+	md_compact_token_array__alloc(ainfo, &result, result.count, chunks->wide);
+	MD_U64 write_idx = 0;
+	for (MD_CompactTokenChunkNode* n = chunks->first; n != 0; n = n->next)
+	{
+		md_memory_copy(result.flags + write_idx, n->v.flags, size_of(MD_U32) * n->v.count);
+		if (chunks->wide) {
+			md_memory_copy(result.offsets_wide + write_idx, n->v.offsets_wide, size_of(MD_U64) * n->v.count);
+			md_memory_copy(result.sizes_wide   + write_idx, n->v.sizes_wide,   size_of(MD_U64) * n->v.count);
+		}
+		else {
+			md_memory_copy(result.offsets + write_idx, n->v.offsets, size_of(MD_U32) * n->v.count);
+			md_memory_copy(result.sizes   + write_idx, n->v.sizes,   size_of(MD_U32) * n->v.count);
+		}
+		write_idx += n->v.count;
+	}
+	return result;
+}
+
+MD_CompactTokenArray
+md_compact_token_array_from_token_array__ainfo(MD_AllocatorInfo ainfo, MD_TokenArray tokens)
+{
+	MD_B32 wide = 0;
+	for (MD_U64 idx = 0; idx < tokens.count; idx += 1) {
+		wide |= tokens.v[idx].range.md_max > MD_MAX_U32;
+	}
+	MD_CompactTokenArray result = {0};
+	result.count = tokens.count;
+	md_compact_token_array__alloc(ainfo, &result, result.count, wide);
+	for (MD_U64 idx = 0; idx < tokens.count; idx += 1) {
+		md_compact_token_array__set(&result, idx, tokens.v[idx]);
+	}
+	return result;
+}
+
 ////////////////////////////////
 //~ rjf: MD_Node Type Functions
 
@@ -261,6 +364,9 @@ md_node_rec_depth_first(MD_Node* node, MD_Node* subtree_root, MD_U64 child_off,
 	MD_NodeRec 
 	rec      = {0};
 	rec.next = md_nil_node();
+	if (node->lazy != 0 && ! node->has_child_index) {
+		md_node_materialize(node);
+	}
 	if ( ! md_node_is_nil(*md_member_from_offset(MD_Node**, node, child_off))) {
 		rec.next       = *md_member_from_offset(MD_Node**, node, child_off);
 		rec.md_push_count = 1;
@@ -277,17 +383,148 @@ md_node_rec_depth_first(MD_Node* node, MD_Node* subtree_root, MD_U64 child_off,
 
 //- rjf: tree building
 
+md_global volatile MD_U64 md_tree__generation = 0;
+
+MD_U64 md_tree_generation     (void) { return md_tree__generation; }
+void   md_tree_generation_bump(void) { md_ins_atomic_u64_inc_eval(&md_tree__generation); }
+
 void
 md_unhook(MD_Node* node) {
 	MD_Node* parent = node->parent;
 	if ( ! md_node_is_nil(parent))
 	{
+		md_tree_generation_bump();
 		if (node->kind == MD_NodeKind_Tag) md_dll_remove_npz(md_nil_node(), parent->first_tag, parent->last_tag, node, next, prev);
-		else                            md_dll_remove_npz(md_nil_node(), parent->first,     parent->last,     node, next, prev);
+		else
+		{
+			if (parent->has_child_index) md_child_index_release(parent);
+			md_dll_remove_npz(md_nil_node(), parent->first, parent->last, node, next, prev);
+		}
 		node->parent = md_nil_node();
 	}
 }
 
+//- Ed: child indices
+
+md_internal MD_U64
+md_child_index__hash_node(MD_Node* node)
+{
+	MD_U64 hash = (MD_U64)(MD_UPTR)node * 0x9E3779B97F4A7C15ull;
+	return hash ^ (hash >> 32);
+}
+
+MD_Node*
+md_child_index_find(MD_ChildIndex* index, MD_String8 string)
+{
+	MD_U64 hash = md_hash_u64_from_str8(0, string);
+	for (MD_U64 slot_idx = hash & index->slot_mask;; slot_idx = (slot_idx + 1) & index->slot_mask)
+	{
+		MD_U32 slot = index->slots[slot_idx];
+		if (slot == 0) {
+			break;
+		}
+		MD_Node* child = index->children[slot - 1];
+		if (md_str8_match(child->string, string, 0)) {
+			return child;
+		}
+	}
+	return md_nil_node();
+}
+
+MD_U64
+md_child_index_position(MD_ChildIndex* index, MD_Node* child)
+{
+	for (MD_U64 slot_idx = md_child_index__hash_node(child) & index->slot_mask;; slot_idx = (slot_idx + 1) & index->slot_mask)
+	{
+		MD_U32 slot = index->position_slots[slot_idx];
+		if (slot == 0) {
+			break;
+		}
+		if (index->children[slot - 1] == child) {
+			return slot - 1;
+		}
+	}
+	return MD_MAX_U64;
+}
+
+MD_ChildIndex*
+md_child_index_from_node__ainfo(MD_AllocatorInfo ainfo, MD_Node* node)
+{
+	if (md_node_is_nil(node)) {
+		return 0;
+	}
+	// Ed: a lazy set indexes itself when it's parsed
+	MD_Node*       first = md_node_first(node);
+	MD_ChildIndex* index = md_child_index_lookup(node);
+	if (index != 0) {
+		return index;
+	}
+
+	//- Ed: children & both slot tables share the index's allocation
+	MD_U64 count = 0;
+	for (MD_Node* child = first; !md_node_is_nil(child); child = child->next) {
+		count += 1;
+	}
+	if (count >= MD_MAX_U32) {
+		return 0;
+	}
+	MD_U64 slot_count = 16;
+	while (slot_count < count * 2) {
+		slot_count *= 2;
+	}
+	MD_U8* block          = (MD_U8*)md_alloc_array(ainfo, MD_U8, sizeof(MD_ChildIndex) + count * sizeof(MD_Node*) + 2 * slot_count * sizeof(MD_U32));
+	index                 = (MD_ChildIndex*)block;
+	index->node           = node;
+	index->children       = (MD_Node**)(block + sizeof(MD_ChildIndex));
+	index->count          = count;
+	index->slots          = (MD_U32*)(block + sizeof(MD_ChildIndex) + count * sizeof(MD_Node*));
+	index->position_slots = index->slots + slot_count;
+	index->slot_mask      = slot_count - 1;
+	MD_U64 position = 0;
+	for (MD_Node* child = node->first; !md_node_is_nil(child); child = child->next, position += 1)
+	{
+		index->children[position] = child;
+		for (MD_U64 slot_idx = md_child_index__hash_node(child) & index->slot_mask;; slot_idx = (slot_idx + 1) & index->slot_mask)
+		{
+			if (index->position_slots[slot_idx] == 0) {
+				index->position_slots[slot_idx] = (MD_U32)(position + 1);
+				break;
+			}
+		}
+		MD_U64 hash = md_hash_u64_from_str8(0, child->string);
+		for (MD_U64 slot_idx = hash & index->slot_mask;; slot_idx = (slot_idx + 1) & index->slot_mask)
+		{
+			MD_U32 slot = index->slots[slot_idx];
+			if (slot == 0) {
+				index->slots[slot_idx] = (MD_U32)(position + 1);
+				break;
+			}
+			// Ed: lookups resolve to the first child with a label
+			if (md_str8_match(index->children[slot - 1]->string, child->string, 0)) {
+				break;
+			}
+		}
+	}
+
+	// Ed: the flag goes first, a node with the pointer set & no flag would read as a lazy set (see md_child_index_release)
+	node->has_child_index = 1;
+	node->child_index     = index;
+	return index;
+}
+
+// Ed: for the tree builders, an index for a node with at least MD_CHILD_INDEX_THRESHOLD children
+md_internal void
+md_child_index__build_if_wide(MD_AllocatorInfo ainfo, MD_Node* node)
+{
+	MD_U64 count = 0;
+	for (MD_Node* child = node->first; !md_node_is_nil(child) && count < MD_CHILD_INDEX_THRESHOLD; child = child->next) {
+		count += 1;
+	}
+	if (count == MD_CHILD_INDEX_THRESHOLD) {
+		md_child_index_from_node(ainfo, node);
+	}
+}
+
 //- rjf: tree introspection
 
 MD_String8
@@ -297,7 +534,7 @@ md_string_from_children__ainfo(MD_AllocatorInfo ainfo, MD_Node*  root)
 	MD_TempArena scratch = md_scratch_begin(ainfo);
 	{
 		MD_String8List strs = {0};
-		for md_each_node(child, root->first)
+		for md_each_child(child, root)
 		{
 			if (child->flags == child->prev->flags) {
 				md_str8_list_push(scratch.arena, &strs, md_str8_lit(" "));
@@ -329,7 +566,7 @@ md_node_match(MD_Node* a, MD_Node* b, MD_StringMatchFlags flags)
 			{
 				if (md_node_match(a_tag, b_tag, flags))
 				{
-					for (MD_Node* a_tag_arg = a_tag->first, *b_tag_arg = b_tag->first; !md_node_is_nil(a_tag_arg) || !md_node_is_nil(b_tag_arg); a_tag_arg = a_tag_arg->next, b_tag_arg = b_tag_arg->next)
+					for (MD_Node* a_tag_arg = md_node_first(a_tag), *b_tag_arg = md_node_first(b_tag); !md_node_is_nil(a_tag_arg) || !md_node_is_nil(b_tag_arg); a_tag_arg = a_tag_arg->next, b_tag_arg = b_tag_arg->next)
 					{
 						if (!tree_match(a_tag_arg, b_tag_arg, flags)) {
 							result = 0;
@@ -355,7 +592,7 @@ tree_match(MD_Node* a, MD_Node* b, MD_StringMatchFlags flags)
 	MD_B32 result = md_node_match(a, b, flags);
 	if (result)
 	{
-		for(MD_Node *a_child = a->first, *b_child = b->first; !md_node_is_nil(a_child) || !md_node_is_nil(b_child); a_child = a_child->next, b_child = b_child->next)
+		for(MD_Node *a_child = md_node_first(a), *b_child = md_node_first(b); !md_node_is_nil(a_child) || !md_node_is_nil(b_child); a_child = a_child->next, b_child = b_child->next)
 		{
 			if ( ! tree_match(a_child, b_child, flags)) {
 				result = 0;
@@ -372,6 +609,9 @@ tree_match(MD_Node* a, MD_Node* b, MD_StringMatchFlags flags)
 MD_Node*
 md_tree_copy__ainfo(MD_AllocatorInfo ainfo, MD_Node* src_root)
 {
+	// Ed: a new tree may sit where a released one was, lookup paths & tree hashes can't tell them apart by address
+	md_tree_generation_bump();
+
 	MD_Node* dst_root   = md_nil_node();
 	MD_Node* dst_parent = dst_root;
 	{
@@ -386,6 +626,7 @@ md_tree_copy__ainfo(MD_AllocatorInfo ainfo, MD_Node* src_root)
 			dst->string     = md_str8_copy(ainfo, src->string);
 			dst->raw_string = md_str8_copy(ainfo, src->raw_string);
 			dst->src_offset = src->src_offset;
+			dst->atom       = src->atom;
 			dst->parent     = dst_parent;
 			if (dst_parent != md_nil_node()) {
 				md_dll_push_back_npz(md_nil_node(), dst_parent->first, dst_parent->last, dst, next, prev);
@@ -403,714 +644,4283 @@ md_tree_copy__ainfo(MD_AllocatorInfo ainfo, MD_Node* src_root)
 			}
 		}
 	}
+	for (MD_Node* dst = dst_root; !md_node_is_nil(dst); dst = md_node_rec_depth_first_pre(dst, dst_root).next) {
+		md_child_index__build_if_wide(ainfo, dst);
+	}
 	return dst_root;
 }
 
 ////////////////////////////////
-//~ rjf: Text -> Tokens Functions
+//~ Ed: Atom Table Functions
 
-MD_TokenizeResult
-md_tokenize_from_text__ainfo(MD_AllocatorInfo ainfo, MD_String8 text)
+md_internal MD_AtomBuckets*
+md_atom__buckets_alloc(MD_AllocatorInfo ainfo, MD_AtomBuckets* prev, MD_U64 bucket_count)
 {
-	MD_TempArena scratch = md_scratch_begin(ainfo);
-
-	MD_TokenChunkList tokens = {0};
-	MD_MsgList        msgs = {0};
+	MD_AtomBuckets*
+	buckets               = md_alloc_array(ainfo, MD_AtomBuckets, 1);
+	buckets->prev         = prev;
+	buckets->bucket_count = bucket_count;
+	buckets->buckets      = (MD_AtomEntry* volatile*)md_alloc_array(ainfo, MD_AtomEntry*, bucket_count);
+	return buckets;
+}
 
-	MD_U8* byte_first = text.str;
-	MD_U8* byte_opl   = byte_first + text.size; // one-past-last
-	MD_U8* byte       = byte_first;
+MD_AtomTable*
+md_atom_table_alloc__ainfo(MD_AllocatorInfo ainfo, MD_U64 bucket_count)
+{
+	MD_U64 count = 64;
+	while (count < bucket_count) {
+		count *= 2;
+	}
+	MD_AtomTable*
+	table          = md_alloc_array(ainfo, MD_AtomTable, 1);
+	table->ainfo   = ainfo;
+	table->mutex   = md_os_mutex_alloc();
+	table->buckets = md_atom__buckets_alloc(ainfo, 0, count);
+	return table;
+}
 
-	//- rjf: scan string & produce tokens
-	for (;byte < byte_opl;)
+void
+md_atom_table_release(MD_AtomTable* table)
+{
+	// Ed: every entry was copied into the newest buckets, so their strings are freed from there & only once
+	MD_AtomBuckets* newest = table->buckets;
+	for (MD_U64 idx = 0; idx < newest->bucket_count; idx += 1) {
+		for (MD_AtomEntry* entry = newest->buckets[idx]; entry != 0; entry = entry->next) {
+			md_alloc_free(table->ainfo, entry->string.str);
+		}
+	}
+	for (MD_AtomBuckets* buckets = newest, *prev = 0; buckets != 0; buckets = prev)
 	{
-		MD_TokenFlags md_token_flags = 0;
-		MD_U8*        md_token_start = 0;
-		MD_U8*        md_token_opl   = 0;
-
-		#define is_whitespace(byte) (*byte == ' ' || *byte == '\t' || *byte == '\v' || *byte == '\r')
-		
-		//- rjf: whitespace
-		if (md_token_flags == 0 && is_whitespace(byte))
-		{
-			md_token_flags = MD_TokenFlag_Whitespace;
-			md_token_start = byte;
-			md_token_opl   = byte;
-
-			byte += 1;
-			for (;byte <= byte_opl; byte += 1)
-			{
-				md_token_opl += 1;
-				if (byte == byte_opl || !is_whitespace(byte)) {
-					break;
-				}
+		prev = buckets->prev;
+		for (MD_U64 idx = 0; idx < buckets->bucket_count; idx += 1) {
+			for (MD_AtomEntry* entry = buckets->buckets[idx], *next = 0; entry != 0; entry = next) {
+				next = entry->next;
+				md_alloc_free(table->ainfo, entry);
 			}
 		}
-		#undef is_whitspace
-		
-		//- rjf: newlines
-		if (md_token_flags == 0 && *byte == '\n')
-		{
-			md_token_flags = MD_TokenFlag_Newline;
-			md_token_start = byte;
-			md_token_opl   = byte+1;
+		md_alloc_free(table->ainfo, (void*)buckets->buckets);
+		md_alloc_free(table->ainfo, buckets);
+	}
+	md_os_mutex_release(table->mutex);
+	md_alloc_free(table->ainfo, table);
+}
 
-			byte += 1;
+md_internal MD_AtomEntry*
+md_atom__find(MD_AtomBuckets* buckets, MD_U64 hash, MD_String8 string)
+{
+	for (MD_AtomEntry* entry = buckets->buckets[hash & (buckets->bucket_count - 1)]; entry != 0; entry = entry->next) {
+		if (entry->hash == hash && md_str8_match(entry->string, string, 0)) {
+			return entry;
 		}
-		
-		//- rjf: single-line comments
-		if (md_token_flags == 0 && (byte + 1 < byte_opl && *byte == '/' && byte[1] == '/'))
+	}
+	return 0;
+}
+
+// Ed: copies rather than relinks the entries, lookups may still be walking the old chains (call under the mutex)
+md_internal MD_AtomBuckets*
+md_atom__grow(MD_AtomTable* table)
+{
+	MD_AtomBuckets* old     = table->buckets;
+	MD_AtomBuckets* buckets = md_atom__buckets_alloc(table->ainfo, old, old->bucket_count * 2);
+	for (MD_U64 idx = 0; idx < old->bucket_count; idx += 1)
+	{
+		for (MD_AtomEntry* entry = old->buckets[idx]; entry != 0; entry = entry->next)
 		{
-			md_token_flags = MD_TokenFlag_Comment;
-			md_token_start = byte;
-			md_token_opl   = byte+2;
+			MD_AtomEntry* volatile* bucket = &buckets->buckets[entry->hash & (buckets->bucket_count - 1)];
+			MD_AtomEntry*
+			copy       = md_alloc_array_no_zero(table->ainfo, MD_AtomEntry, 1);
+			*copy      = *entry;
+			copy->next = *bucket;
+			*bucket    = copy;
+		}
+	}
+	md_ins_atomic_ptr_eval_assign(&table->buckets, buckets);
+	return buckets;
+}
 
-			byte += 2;
+MD_Atom
+md_atom_lookup(MD_AtomTable* table, MD_String8 string)
+{
+	if (string.size == 0) {
+		return 0;
+	}
+	MD_U64        hash  = md_hash_u64_from_str8(0, string);
+	MD_AtomEntry* entry = md_atom__find(table->buckets, hash, string);
+	return entry ? entry->atom : 0;
+}
 
-			MD_B32 escaped = 0;
-			for (;byte <= byte_opl; byte += 1)
-			{
-				md_token_opl += 1;
-				if (byte == byte_opl) {
-					break;
-				}
-				if (escaped) {
-					escaped = 0;
-				}
-				else
-				{
-					if (*byte == '\n') {
-						break;
-					}
-					else if (*byte == '\\') {
-						escaped = 1;
-					}
-				}
-			}
-		}
-		
-		//- rjf: multi-line comments
-		if (md_token_flags == 0 && (byte + 1 < byte_opl && *byte == '/' && byte[1] == '*'))
+MD_Atom
+md_atom_from_str8(MD_AtomTable* table, MD_String8 string)
+{
+	if (string.size == 0) {
+		return 0;
+	}
+	MD_U64        hash  = md_hash_u64_from_str8(0, string);
+	MD_AtomEntry* entry = md_atom__find(table->buckets, hash, string);
+	if (entry == 0) md_os_mutex_scope(table->mutex)
+	{
+		// another thread may have interned it (or grown the table) since
+		MD_AtomBuckets* buckets = table->buckets;
+		entry = md_atom__find(buckets, hash, string);
+		if (entry == 0)
 		{
-			md_token_flags = MD_TokenFlag_Comment;
-			md_token_start = byte;
-			md_token_opl   = byte + 2;
-
-			byte += 2;
-			for (;byte <= byte_opl; byte += 1)
-			{
-				md_token_opl += 1;
-				if (byte == byte_opl) {
-					md_token_flags |= MD_TokenFlag_BrokenComment;
-					break;
-				}
-				if (byte + 1 < byte_opl && byte[0] == '*' && byte[1] == '/') {
-					md_token_opl += 2;
-					break;
-				}
+			if (table->count >= buckets->bucket_count) {
+				buckets = md_atom__grow(table);
 			}
+			MD_AtomEntry* volatile* bucket = &buckets->buckets[hash & (buckets->bucket_count - 1)];
+			entry         = md_alloc_array(table->ainfo, MD_AtomEntry, 1);
+			entry->next   = *bucket;
+			entry->hash   = hash;
+			entry->string = md_str8_copy(table->ainfo, string);
+			entry->atom   = (MD_Atom)md_ins_atomic_u64_inc_eval(&table->count);
+			md_ins_atomic_ptr_eval_assign(bucket, entry);
 		}
+	}
+	return entry->atom;
+}
 
-		#define is_identifier(byte) (         \
-			('A' <= *byte && *byte <= 'Z') || \
-			('a' <= *byte && *byte <= 'z') || \
-			*byte == '_'                   || \
-			md_utf8_class(*byte >> 3) >= 2       \
-		)
-		#if 0
-		(
-			!('A' <= *byte && *byte <= 'Z') && 
-			!('a' <= *byte && *byte <= 'z') && 
-			!('0' <= *byte && *byte <= '9') && 
-			*byte != '_' && 
-			md_utf8_class(*byte>>3) < 2
-		)
-		#endif
-		
-		//- rjf: identifiers
-		if (md_token_flags == 0 && is_identifier(byte))
-		{
-			md_token_flags = MD_TokenFlag_Identifier;
-			md_token_start = byte;
-			md_token_opl   = byte;
+////////////////////////////////
+//~ Ed: Text Scanning Kernels
 
-			byte += 1;
-			for(;byte <= byte_opl; byte += 1)
-			{
-				md_token_opl += 1;
-				if (byte == byte_opl || !is_identifier(byte)) {
-					break;
-				}
-			}
-		}
-		#undef is_identifier
-
-		#define is_numeric(byte) (                                                       \
-			('0'  <= *byte && *byte <= '9')                                           || \
-			(*byte == '.' && byte + 1 < byte_opl && '0' <= byte[1] && byte[1] <= '9') || \
-			(*byte == '-' && byte + 1 < byte_opl && '0' <= byte[1] && byte[1] <= '9') || \
-		     *byte == '_'                                                                \
-		)
-		#define is_not_numeric(byte) (         \
-			!('A' <= *byte && *byte <= 'Z') && \
-			!('a' <= *byte && *byte <= 'z') && \
-			!('0' <= *byte && *byte <= '9') && \
-			*byte != '_' && *byte != '.'       \
-		)
-		
-		//- rjf: numerics
-		if (md_token_flags == 0 && is_numeric(byte)) 
-		{
-			md_token_flags = MD_TokenFlag_Numeric;
-			md_token_start = byte;
-			md_token_opl   = byte;
+//- Ed: byte classes (must agree with the tokenizer's start-of-token checks, identifiers can't start with a digit but go on through them)
 
-			byte += 1;
-			for (;byte <= byte_opl; byte += 1)
-			{
-				md_token_opl += 1;
-				if (byte == byte_opl || is_not_numeric(byte)) {
-					break;
-				}
-			}
-		}
-		#undef is_numeric
-		#undef is_not_numeric
+md_force_inline MD_B32 md_text_scan__is_whitespace(MD_U8 c) { return c == ' ' || c == '\t' || c == '\v' || c == '\r'; }
+md_force_inline MD_B32 md_text_scan__is_identifier(MD_U8 c) { return ('A' <= c && c <= 'Z') || ('a' <= c && c <= 'z') || ('0' <= c && c <= '9') || c == '_' || md_utf8_class(c >> 3) >= 2; }
+md_force_inline MD_B32 md_text_scan__is_numeric   (MD_U8 c) { return ('A' <= c && c <= 'Z') || ('a' <= c && c <= 'z') || ('0' <= c && c <= '9') || c == '_' || c == '.'; }
 
-		#define is_triple_string_literal(byte) (                     \
-			(byte[0] == '"' && byte[1] == '"' && byte[2] == '"' ) || \
-			(byte[0] == '\''&& byte[1] == '\''&& byte[2] == '\'') || \
-			(byte[0] == '`' && byte[1] == '`' && byte[2] == '`' )    \
-		)
-		
-		//- rjf: triplet string literals
-		if (md_token_flags == 0 && byte + 2 < byte_opl && is_triple_string_literal(byte))
-		{
-			MD_U8 literal_style = byte[0];
-			md_token_flags  = MD_TokenFlag_StringLiteral | MD_TokenFlag_StringTriplet;
-			md_token_flags |= (literal_style == '\'') * MD_TokenFlag_StringSingleQuote;
-			md_token_flags |= (literal_style ==  '"') * MD_TokenFlag_StringDoubleQuote;
-			md_token_flags |= (literal_style ==  '`') * MD_TokenFlag_StringTick;
-			md_token_start  = byte;
-			md_token_opl    = byte + 3;
-
-			byte += 3;
-			for (;byte <= byte_opl; byte += 1)
-			{
-				if (byte == byte_opl) {
-					md_token_flags |= MD_TokenFlag_BrokenStringLiteral;
-					md_token_opl    = byte;
-					break;
-				}
-				if (byte + 2 < byte_opl && (byte[0] == literal_style && byte[1] == literal_style && byte[2] == literal_style)) { 
-					byte      += 3;
-					md_token_opl  = byte;
-					break;
-				}
-			}
-		}
-		#undef is_triple_string_literal
-		
-		//- rjf: singlet string literals
-		if (md_token_flags == 0 && (byte[0] == '"' || byte[0] == '\'' || byte[0] == '`'))
-		{
-			MD_U8 literal_style = byte[0];
-			md_token_flags  = MD_TokenFlag_StringLiteral;
-			md_token_flags |= (literal_style == '\'') * MD_TokenFlag_StringSingleQuote;
-			md_token_flags |= (literal_style ==  '"') * MD_TokenFlag_StringDoubleQuote;
-			md_token_flags |= (literal_style ==  '`') * MD_TokenFlag_StringTick;
-			md_token_start  = byte;
-			md_token_opl    = byte + 1;
+//- Ed: scalar
 
-			byte += 1;
-			MD_B32 escaped = 0;
-			for (;byte <= byte_opl; byte += 1)
-			{
-				if (byte == byte_opl || *byte == '\n') {
-					md_token_opl = byte;
-					md_token_flags |= MD_TokenFlag_BrokenStringLiteral;
-					break;
-				}
-				if (!escaped && byte[0] == '\\') {
-					escaped = 1;
-				}
-				else if (!escaped && byte[0] == literal_style) {
-					md_token_opl = byte+1;
-					byte += 1;
-					break;
-				}
-				else if (escaped) {
-					escaped = 0;
-				}
-			}
+md_internal MD_U8*
+md_text_scan_find_any__scalar(MD_U8* byte, MD_U8* byte_opl, MD_U8 a, MD_U8 b, MD_U8 c) {
+	for (; byte < byte_opl && *byte != a && *byte != b && *byte != c; byte += 1);
+	return byte;
+}
+
+md_internal MD_U8*
+md_text_scan_find_pair__scalar(MD_U8* byte, MD_U8* byte_opl, MD_U8 first, MD_U8 second) {
+	for (; byte + 1 < byte_opl; byte += 1) {
+		if (byte[0] == first && byte[1] == second) {
+			return byte;
 		}
+	}
+	return byte_opl;
+}
 
-		#define is_non_reserved_symbol(byte) (                                              \
-			*byte == '~' || *byte == '!' || *byte == '$' || *byte == '%' || *byte == '^' || \
-			*byte == '&' || *byte == '*' || *byte == '-' || *byte == '=' || *byte == '+' || \
-			*byte == '<' || *byte == '.' || *byte == '>' || *byte == '/' || *byte == '?' || \
-			*byte == '|'                                                                    \
-		)
-		#if 0
-		(
-			*byte != '~' && *byte != '!' && *byte != '$' && *byte != '%' && *byte != '^' &&
-			*byte != '&' && *byte != '*' && *byte != '-' && *byte != '=' && *byte != '+' &&
-			*byte != '<' && *byte != '.' && *byte != '>' && *byte != '/' && *byte != '?' &&
-			*byte != '|'
-		)
-		#endif
-		
-		//- rjf: non-reserved symbols
-		if (md_token_flags == 0 && is_non_reserved_symbol(byte))
-		{
-			md_token_flags = MD_TokenFlag_Symbol;
-			md_token_start = byte;
-			md_token_opl   = byte;
+md_internal MD_U8* md_text_scan_skip_whitespace__scalar(MD_U8* byte, MD_U8* byte_opl) { for (; byte < byte_opl && md_text_scan__is_whitespace(*byte); byte += 1); return byte; }
+md_internal MD_U8* md_text_scan_skip_identifier__scalar(MD_U8* byte, MD_U8* byte_opl) { for (; byte < byte_opl && md_text_scan__is_identifier(*byte); byte += 1); return byte; }
+md_internal MD_U8* md_text_scan_skip_numeric__scalar   (MD_U8* byte, MD_U8* byte_opl) { for (; byte < byte_opl && md_text_scan__is_numeric   (*byte); byte += 1); return byte; }
+md_internal MD_U8* md_text_scan_find_escape__scalar    (MD_U8* byte, MD_U8* byte_opl) { for (; byte < byte_opl && *byte != '"' && *byte != '\\' && *byte >= 0x20; byte += 1); return byte; }
 
-			byte += 1;
-			for (;byte <= byte_opl; byte += 1)
-			{
-				md_token_opl += 1;
-				if (byte == byte_opl || !is_non_reserved_symbol(byte)) {
-					break;
-				}
-			}
-		}
-		#undef is_non_reserved_symbol
+#if MD_ARCH_X64
 
-		#define is_reserved_symbol(byte) (  \
-			*byte == '{' || *byte == '}' || \
-			*byte == '(' || *byte == ')' || \
-			*byte == '[' || *byte == ']' || \
-			*byte == '#' ||                 \
-			*byte == ',' ||                 \
-			*byte == '\\'||                 \
-			*byte == ':' || *byte == ';' || \
-			*byte == '@'                    \
-		)
-		
-		//- rjf: reserved symbols
-		if (md_token_flags == 0 && is_reserved_symbol(byte)) {
-			md_token_flags = MD_TokenFlag_Reserved;
-			md_token_start = byte;
-			md_token_opl   = byte+1;
+//- Ed: sse2
+// Unsigned range checks are done by biasing into signed space: (x - lo) ^ 0x80 < (hi - lo) ^ 0x80
 
-			byte += 1;
-		}
-		#undef is_reserved_symbol
-		
-		//- rjf: bad characters in all other cases
-		if (md_token_flags == 0) {
-			md_token_flags = MD_TokenFlag_BadCharacter;
-			md_token_start = byte;
-			md_token_opl   = byte+1;
+md_force_inline __m128i
+md_text_scan__in_range_sse2(__m128i v, MD_U8 lo, MD_U8 count) {
+	__m128i biased = _mm_xor_si128(_mm_sub_epi8(v, _mm_set1_epi8((char)lo)), _mm_set1_epi8((char)0x80));
+	return _mm_cmplt_epi8(biased, _mm_set1_epi8((char)(0x80 + count)));
+}
 
-			byte += 1;
-		}
-		
-		//- rjf; push token if formed
-		if (md_token_flags != 0 && md_token_start != 0 && md_token_opl > md_token_start) {
-			MD_Token token = {{(MD_U64)(md_token_start - byte_first), (MD_U64)(md_token_opl - byte_first)}, md_token_flags};
-			md_token_chunk_list_push(scratch.arena, &tokens, 4096, token);
-		}
-		
-		//- rjf: push errors on unterminated comments
-		if (md_token_flags & MD_TokenFlag_BrokenComment)
-		{
-			MD_Node*   error        = md_push_node(ainfo, MD_NodeKind_ErrorMarker, 0, md_str8_lit(""), md_str8_lit(""), md_token_start - byte_first);
-			MD_String8 error_string = md_str8_lit("Unterminated comment.");
-			md_msg_list_push(ainfo, &msgs, error, MD_MsgKind_Error, error_string);
+md_internal MD_U8*
+md_text_scan_find_any__sse2(MD_U8* byte, MD_U8* byte_opl, MD_U8 a, MD_U8 b, MD_U8 c)
+{
+	__m128i va = _mm_set1_epi8((char)a);
+	__m128i vb = _mm_set1_epi8((char)b);
+	__m128i vc = _mm_set1_epi8((char)c);
+	for (; byte + 16 <= byte_opl; byte += 16)
+	{
+		__m128i v   = _mm_loadu_si128((__m128i*)byte);
+		__m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb)), _mm_cmpeq_epi8(v, vc));
+		MD_U32  mask = (MD_U32)_mm_movemask_epi8(hit);
+		if (mask != 0) {
+			return byte + md_ctz32(mask);
 		}
-		
-		//- rjf: push errors on unterminated strings
-		if (md_token_flags & MD_TokenFlag_BrokenStringLiteral) {
-			MD_Node*   error        = md_push_node(ainfo, MD_NodeKind_ErrorMarker, 0, md_str8_lit(""), md_str8_lit(""), md_token_start - byte_first);
-			MD_String8 error_string = md_str8_lit("Unterminated string literal.");
-			md_msg_list_push(ainfo, &msgs, error, MD_MsgKind_Error, error_string);
+	}
+	return md_text_scan_find_any__scalar(byte, byte_opl, a, b, c);
+}
+
+md_internal MD_U8*
+md_text_scan_find_pair__sse2(MD_U8* byte, MD_U8* byte_opl, MD_U8 first, MD_U8 second)
+{
+	__m128i vf = _mm_set1_epi8((char)first);
+	__m128i vs = _mm_set1_epi8((char)second);
+	for (; byte + 17 <= byte_opl; byte += 16)
+	{
+		MD_U32 mask_f = (MD_U32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((__m128i*)(byte + 0)), vf));
+		MD_U32 mask_s = (MD_U32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((__m128i*)(byte + 1)), vs));
+		MD_U32 mask   = mask_f & mask_s;
+		if (mask != 0) {
+			return byte + md_ctz32(mask);
 		}
 	}
-	
-	//- rjf: bake, fill & return
-	MD_TokenizeResult result = {0}; {
-		result.tokens = md_token_array_from_chunk_list(ainfo, &tokens);
-		result.msgs   = msgs;
+	return md_text_scan_find_pair__scalar(byte, byte_opl, first, second);
+}
+
+md_internal MD_U8*
+md_text_scan_skip_whitespace__sse2(MD_U8* byte, MD_U8* byte_opl)
+{
+	for (; byte + 16 <= byte_opl; byte += 16)
+	{
+		__m128i v  = _mm_loadu_si128((__m128i*)byte);
+		__m128i ws = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),  _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+			_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\v')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\r')))
+		);
+		MD_U32 mask = ~(MD_U32)_mm_movemask_epi8(ws) & 0xFFFF;
+		if (mask != 0) {
+			return byte + md_ctz32(mask);
+		}
 	}
-	scratch_end(scratch);
-	return result;
+	return md_text_scan_skip_whitespace__scalar(byte, byte_opl);
 }
 
-////////////////////////////////
-//~ rjf: Tokens -> Tree Functions
+md_internal MD_U8*
+md_text_scan_skip_identifier__sse2(MD_U8* byte, MD_U8* byte_opl)
+{
+	for (; byte + 16 <= byte_opl; byte += 16)
+	{
+		__m128i v     = _mm_loadu_si128((__m128i*)byte);
+		__m128i alpha = md_text_scan__in_range_sse2(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 26);
+		__m128i digit = md_text_scan__in_range_sse2(v, '0', 10);
+		__m128i under = _mm_cmpeq_epi8(v, _mm_set1_epi8('_'));
+		__m128i lead  = _mm_cmpgt_epi8(_mm_xor_si128(v, _mm_set1_epi8((char)0x80)), _mm_set1_epi8(0x3F)); // >= 0xC0
+		MD_U32  mask  = ~(MD_U32)_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(alpha, digit), _mm_or_si128(under, lead))) & 0xFFFF;
+		if (mask != 0) {
+			return byte + md_ctz32(mask);
+		}
+	}
+	return md_text_scan_skip_identifier__scalar(byte, byte_opl);
+}
 
-typedef enum MD_ParseWorkKind MD_ParseWorkKind;
-enum MD_ParseWorkKind
+md_internal MD_U8*
+md_text_scan_skip_numeric__sse2(MD_U8* byte, MD_U8* byte_opl)
+{
+	for (; byte + 16 <= byte_opl; byte += 16)
+	{
+		__m128i v     = _mm_loadu_si128((__m128i*)byte);
+		__m128i alpha = md_text_scan__in_range_sse2(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 26);
+		__m128i digit = md_text_scan__in_range_sse2(v, '0', 10);
+		__m128i punct = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('_')), _mm_cmpeq_epi8(v, _mm_set1_epi8('.')));
+		MD_U32  mask  = ~(MD_U32)_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(alpha, digit), punct)) & 0xFFFF;
+		if (mask != 0) {
+			return byte + md_ctz32(mask);
+		}
+	}
+	return md_text_scan_skip_numeric__scalar(byte, byte_opl);
+}
+
+md_internal MD_U8*
+md_text_scan_find_escape__sse2(MD_U8* byte, MD_U8* byte_opl)
+{
+	for (; byte + 16 <= byte_opl; byte += 16)
+	{
+		__m128i v     = _mm_loadu_si128((__m128i*)byte);
+		__m128i quote = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\\')));
+		MD_U32  mask  = (MD_U32)_mm_movemask_epi8(_mm_or_si128(quote, md_text_scan__in_range_sse2(v, 0, 0x20)));
+		if (mask != 0) {
+			return byte + md_ctz32(mask);
+		}
+	}
+	return md_text_scan_find_escape__scalar(byte, byte_opl);
+}
+
+//- Ed: avx2
+
+md_target_avx2 md_force_inline __m256i
+md_text_scan__in_range_avx2(__m256i v, MD_U8 lo, MD_U8 count) {
+	__m256i biased = _mm256_xor_si256(_mm256_sub_epi8(v, _mm256_set1_epi8((char)lo)), _mm256_set1_epi8((char)0x80));
+	return _mm256_cmpgt_epi8(_mm256_set1_epi8((char)(0x80 + count)), biased);
+}
+
+md_target_avx2 md_internal MD_U8*
+md_text_scan_find_any__avx2(MD_U8* byte, MD_U8* byte_opl, MD_U8 a, MD_U8 b, MD_U8 c)
+{
+	__m256i va = _mm256_set1_epi8((char)a);
+	__m256i vb = _mm256_set1_epi8((char)b);
+	__m256i vc = _mm256_set1_epi8((char)c);
+	for (; byte + 32 <= byte_opl; byte += 32)
+	{
+		__m256i v    = _mm256_loadu_si256((__m256i*)byte);
+		__m256i hit  = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, va), _mm256_cmpeq_epi8(v, vb)), _mm256_cmpeq_epi8(v, vc));
+		MD_U32  mask = (MD_U32)_mm256_movemask_epi8(hit);
+		if (mask != 0) {
+			return byte + md_ctz32(mask);
+		}
+	}
+	return md_text_scan_find_any__sse2(byte, byte_opl, a, b, c);
+}
+
+md_target_avx2 md_internal MD_U8*
+md_text_scan_find_pair__avx2(MD_U8* byte, MD_U8* byte_opl, MD_U8 first, MD_U8 second)
+{
+	__m256i vf = _mm256_set1_epi8((char)first);
+	__m256i vs = _mm256_set1_epi8((char)second);
+	for (; byte + 33 <= byte_opl; byte += 32)
+	{
+		MD_U32 mask_f = (MD_U32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((__m256i*)(byte + 0)), vf));
+		MD_U32 mask_s = (MD_U32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((__m256i*)(byte + 1)), vs));
+		MD_U32 mask   = mask_f & mask_s;
+		if (mask != 0) {
+			return byte + md_ctz32(mask);
+		}
+	}
+	return md_text_scan_find_pair__sse2(byte, byte_opl, first, second);
+}
+
+md_target_avx2 md_internal MD_U8*
+md_text_scan_skip_whitespace__avx2(MD_U8* byte, MD_U8* byte_opl)
+{
+	for (; byte + 32 <= byte_opl; byte += 32)
+	{
+		__m256i v  = _mm256_loadu_si256((__m256i*)byte);
+		__m256i ws = _mm256_or_si256(
+			_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),  _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+			_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\v')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')))
+		);
+		MD_U32 mask = ~(MD_U32)_mm256_movemask_epi8(ws);
+		if (mask != 0) {
+			return byte + md_ctz32(mask);
+		}
+	}
+	return md_text_scan_skip_whitespace__sse2(byte, byte_opl);
+}
+
+md_target_avx2 md_internal MD_U8*
+md_text_scan_skip_identifier__avx2(MD_U8* byte, MD_U8* byte_opl)
+{
+	for (; byte + 32 <= byte_opl; byte += 32)
+	{
+		__m256i v     = _mm256_loadu_si256((__m256i*)byte);
+		__m256i alpha = md_text_scan__in_range_avx2(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), 'a', 26);
+		__m256i digit = md_text_scan__in_range_avx2(v, '0', 10);
+		__m256i under = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_'));
+		__m256i lead  = _mm256_cmpgt_epi8(_mm256_xor_si256(v, _mm256_set1_epi8((char)0x80)), _mm256_set1_epi8(0x3F)); // >= 0xC0
+		MD_U32  mask  = ~(MD_U32)_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(alpha, digit), _mm256_or_si256(under, lead)));
+		if (mask != 0) {
+			return byte + md_ctz32(mask);
+		}
+	}
+	return md_text_scan_skip_identifier__sse2(byte, byte_opl);
+}
+
+md_target_avx2 md_internal MD_U8*
+md_text_scan_skip_numeric__avx2(MD_U8* byte, MD_U8* byte_opl)
+{
+	for (; byte + 32 <= byte_opl; byte += 32)
+	{
+		__m256i v     = _mm256_loadu_si256((__m256i*)byte);
+		__m256i alpha = md_text_scan__in_range_avx2(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), 'a', 26);
+		__m256i digit = md_text_scan__in_range_avx2(v, '0', 10);
+		__m256i punct = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('_')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('.')));
+		MD_U32  mask  = ~(MD_U32)_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(alpha, digit), punct));
+		if (mask != 0) {
+			return byte + md_ctz32(mask);
+		}
+	}
+	return md_text_scan_skip_numeric__sse2(byte, byte_opl);
+}
+
+md_target_avx2 md_internal MD_U8*
+md_text_scan_find_escape__avx2(MD_U8* byte, MD_U8* byte_opl)
+{
+	for (; byte + 32 <= byte_opl; byte += 32)
+	{
+		__m256i v     = _mm256_loadu_si256((__m256i*)byte);
+		__m256i quote = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\')));
+		MD_U32  mask  = (MD_U32)_mm256_movemask_epi8(_mm256_or_si256(quote, md_text_scan__in_range_avx2(v, 0, 0x20)));
+		if (mask != 0) {
+			return byte + md_ctz32(mask);
+		}
+	}
+	// NOTE(Ed): Labels are mostly shorter than a vector, so the tail is done here (vex encoded) instead of in the sse2 kernel,
+	// going from the avx2 state to legacy sse code on every call costs more than the scan.
+	if (byte + 16 <= byte_opl)
+	{
+		__m128i v     = _mm_loadu_si128((__m128i*)byte);
+		__m128i quote = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\\')));
+		MD_U32  mask  = (MD_U32)_mm_movemask_epi8(_mm_or_si128(quote, md_text_scan__in_range_sse2(v, 0, 0x20)));
+		if (mask != 0) {
+			return byte + md_ctz32(mask);
+		}
+		byte += 16;
+	}
+	return md_text_scan_find_escape__scalar(byte, byte_opl);
+}
+
+md_internal MD_B32
+md_text_scan__cpu_has_avx2(void)
+{
+	MD_B32 result = 0;
+#if MD_COMPILER_MSVC
+	int regs[4];
+	__cpuid(regs, 0);
+	if (regs[0] >= 7)
+	{
+		__cpuid(regs, 1);
+		MD_B32 has_osxsave = (regs[2] & (1 << 27)) != 0;
+		MD_B32 has_avx     = (regs[2] & (1 << 28)) != 0;
+		// the os also has to be saving the ymm registers
+		if (has_osxsave && has_avx && (_xgetbv(0) & 0x6) == 0x6) {
+			__cpuidex(regs, 7, 0);
+			result = (regs[1] & (1 << 5)) != 0;
+		}
+	}
+#else
+	__builtin_cpu_init();
+	result = __builtin_cpu_supports("avx2") != 0;
+#endif
+	return result;
+}
+
+#endif // MD_ARCH_X64
+
+//- Ed: dispatch
+
+#if MD_ARCH_X64
+#	define md_text_scan__kernels(level, suffix) { level, md_text_scan_find_any__##suffix, md_text_scan_find_pair__##suffix, md_text_scan_skip_whitespace__##suffix, md_text_scan_skip_identifier__##suffix, md_text_scan_skip_numeric__##suffix, md_text_scan_find_escape__##suffix }
+#else
+#	define md_text_scan__kernels(level, suffix) { level, md_text_scan_find_any__scalar,    md_text_scan_find_pair__scalar,    md_text_scan_skip_whitespace__scalar,    md_text_scan_skip_identifier__scalar,    md_text_scan_skip_numeric__scalar,    md_text_scan_find_escape__scalar    }
+#endif
+
+md_global MD_TextScanKernels md_text_scan_kernel_table[MD_TextScanLevel_COUNT] = {
+	{ MD_TextScanLevel_Scalar, md_text_scan_find_any__scalar, md_text_scan_find_pair__scalar, md_text_scan_skip_whitespace__scalar, md_text_scan_skip_identifier__scalar, md_text_scan_skip_numeric__scalar, md_text_scan_find_escape__scalar },
+	md_text_scan__kernels(MD_TextScanLevel_SSE2, sse2),
+	md_text_scan__kernels(MD_TextScanLevel_AVX2, avx2),
+};
+md_global MD_TextScanKernels* md_text_scan_kernels_selected = 0;
+
+#undef md_text_scan__kernels
+
+MD_TextScanLevel
+md_text_scan_level_supported(void)
+{
+	MD_TextScanLevel result = MD_TextScanLevel_Scalar;
+#if MD_ARCH_X64
+	// NOTE(Ed): sse2 is part of the x64 baseline
+	result = md_text_scan__cpu_has_avx2() ? MD_TextScanLevel_AVX2 : MD_TextScanLevel_SSE2;
+#endif
+	return result;
+}
+
+void
+md_text_scan_set_level(MD_TextScanLevel level)
+{
+	MD_TextScanLevel supported = md_text_scan_level_supported();
+	MD_TextScanLevel selected  = md_min(level, supported);
+	md_text_scan_kernels_selected = &md_text_scan_kernel_table[selected];
+}
+
+MD_TextScanKernels*
+md_text_scan_kernels(void)
+{
+	// NOTE(Ed): Racing threads will all resolve to the same entry, so no synchronization is needed.
+	if (md_text_scan_kernels_selected == 0) {
+		md_text_scan_set_level(MD_TextScanLevel_COUNT);
+	}
+	return md_text_scan_kernels_selected;
+}
+
+////////////////////////////////
+//~ rjf: Text -> Tokens Functions
+
+// NOTE(Ed): Token start states past the byte classes, only reachable through a byte of lookahead
+enum
+{
+	MD_TokenizeState_LineComment = MD_TokenByteClass_COUNT,
+	MD_TokenizeState_BlockComment,
+	MD_TokenizeState_TripletString,
+
+	// Ed: only used by streams, for a pending token whose kind is settled
+	MD_TokenizeState_SingletString,
+	MD_TokenizeState_None,
+};
+
+md_internal void
+md_tokenize__push_token_msgs(MD_AllocatorInfo ainfo, MD_MsgList* msgs, MD_Token token)
+{
+	//- rjf: push errors on unterminated comments
+	if (token.flags & MD_TokenFlag_BrokenComment)
+	{
+		MD_Node*   error        = md_push_node(ainfo, MD_NodeKind_ErrorMarker, 0, md_str8_lit(""), md_str8_lit(""), token.range.md_min);
+		MD_String8 error_string = md_str8_lit("Unterminated comment.");
+		md_msg_list_push(ainfo, msgs, error, MD_MsgKind_Error, error_string);
+	}
+
+	//- rjf: push errors on unterminated strings
+	if (token.flags & MD_TokenFlag_BrokenStringLiteral) {
+		MD_Node*   error        = md_push_node(ainfo, MD_NodeKind_ErrorMarker, 0, md_str8_lit(""), md_str8_lit(""), token.range.md_min);
+		MD_String8 error_string = md_str8_lit("Unterminated string literal.");
+		md_msg_list_push(ainfo, msgs, error, MD_MsgKind_Error, error_string);
+	}
+}
+
+// msgs may be null, for workers that leave the errors to the thread that owns ainfo
+md_internal void
+md_tokenize__push_token(MD_AllocatorInfo ainfo, MD_Arena* token_arena, MD_TokenChunkList* tokens, MD_MsgList* msgs, MD_Token token)
+{
+	md_token_chunk_list_push(token_arena, tokens, 4096, token);
+	if (msgs != 0 && (token.flags & (MD_TokenFlag_BrokenComment | MD_TokenFlag_BrokenStringLiteral))) {
+		md_tokenize__push_token_msgs(ainfo, msgs, token);
+	}
+}
+
+// Tokenizes the tokens that start in [byte_first, byte_stop) of the text ending at byte_opl, byte_first begins at byte_offset in the whole text.
+// When the text isn't final, the last token is held back if it reaches byte_opl (more input could extend it),
+// returns where tokenizing stopped.
+md_internal MD_U8*
+md_tokenize__text(MD_AllocatorInfo ainfo, MD_Arena* token_arena, MD_TokenChunkList* tokens, MD_MsgList* msgs, MD_U8* byte_first, MD_U8* byte_stop, MD_U8* byte_opl, MD_U64 byte_offset, MD_B32 is_final)
+{
+	MD_TextScanKernels* scan = md_text_scan_kernels();
+	MD_U8*              byte = byte_first;
+
+	//- rjf: scan string & produce tokens
+	for (;byte < byte_stop;)
+	{
+		MD_TokenFlags md_token_flags = 0;
+		MD_U8*        md_token_start = byte;
+		MD_U8*        md_token_opl   = 0;
+
+		//- Ed: classify the token's first byte, resolving the classes that need a byte of lookahead
+		MD_U32 state = md_token_byte_class(*byte);
+		MD_U8  next  = byte + 1 < byte_opl ? byte[1] : 0;
+		switch (state)
+		{
+			case MD_TokenByteClass_Slash:       state = next == '/' ? MD_TokenizeState_LineComment : next == '*' ? MD_TokenizeState_BlockComment : MD_TokenByteClass_Symbol; break;
+			case MD_TokenByteClass_NumericSign: state = md_token_byte_class(next) == MD_TokenByteClass_Digit ? MD_TokenByteClass_Digit : MD_TokenByteClass_Symbol;    break;
+			case MD_TokenByteClass_Quote:       state = byte + 2 < byte_opl && next == byte[0] && byte[2] == byte[0] ? MD_TokenizeState_TripletString : state;      break;
+		}
+
+		//- Ed: dispatch once per token
+		switch (state)
+		{
+			//- rjf: whitespace
+			case MD_TokenByteClass_Whitespace:
+			{
+				md_token_flags = MD_TokenFlag_Whitespace;
+				byte           = scan->skip_whitespace(byte + 1, byte_opl);
+				md_token_opl   = byte;
+			}
+			break;
+
+			//- rjf: newlines
+			case MD_TokenByteClass_Newline:
+			{
+				md_token_flags = MD_TokenFlag_Newline;
+				byte          += 1;
+				md_token_opl   = byte;
+			}
+			break;
+
+			//- rjf: single-line comments
+			case MD_TokenizeState_LineComment:
+			{
+				md_token_flags = MD_TokenFlag_Comment;
+
+				// NOTE(Ed): The terminating newline is left for its own token
+				byte += 2;
+				for (;;)
+				{
+					byte = scan->find_any(byte, byte_opl, '\n', '\\', '\n');
+					if (byte < byte_opl && *byte == '\\') {
+						byte = md_min(byte + 2, byte_opl);
+						continue;
+					}
+					break;
+				}
+				md_token_opl = byte;
+			}
+			break;
+
+			//- rjf: multi-line comments
+			case MD_TokenizeState_BlockComment:
+			{
+				md_token_flags = MD_TokenFlag_Comment;
+
+				byte = scan->find_pair(byte + 2, byte_opl, '*', '/');
+				if (byte == byte_opl) {
+					md_token_flags |= MD_TokenFlag_BrokenComment;
+				}
+				else {
+					byte += 2;
+				}
+				md_token_opl = byte;
+			}
+			break;
+
+			//- rjf: identifiers
+			case MD_TokenByteClass_Identifier:
+			{
+				md_token_flags = MD_TokenFlag_Identifier;
+				byte           = scan->skip_identifier(byte + 1, byte_opl);
+				md_token_opl   = byte;
+			}
+			break;
+
+			//- rjf: numerics
+			case MD_TokenByteClass_Digit:
+			{
+				md_token_flags = MD_TokenFlag_Numeric;
+				byte           = scan->skip_numeric(byte + 1, byte_opl);
+				md_token_opl   = byte;
+			}
+			break;
+
+			//- rjf: triplet string literals
+			case MD_TokenizeState_TripletString:
+			{
+				MD_U8 literal_style = byte[0];
+				md_token_flags  = MD_TokenFlag_StringLiteral | MD_TokenFlag_StringTriplet;
+				md_token_flags |= (literal_style == '\'') * MD_TokenFlag_StringSingleQuote;
+				md_token_flags |= (literal_style ==  '"') * MD_TokenFlag_StringDoubleQuote;
+				md_token_flags |= (literal_style ==  '`') * MD_TokenFlag_StringTick;
+
+				byte += 3;
+				for (;;)
+				{
+					byte = scan->find_any(byte, byte_opl, literal_style, literal_style, literal_style);
+					if (byte + 2 >= byte_opl) {
+						byte            = byte_opl;
+						md_token_flags |= MD_TokenFlag_BrokenStringLiteral;
+						md_token_opl    = byte;
+						break;
+					}
+					if (byte[1] == literal_style && byte[2] == literal_style) {
+						byte         += 3;
+						md_token_opl  = byte;
+						break;
+					}
+					byte += 1;
+				}
+			}
+			break;
+
+			//- rjf: singlet string literals
+			case MD_TokenByteClass_Quote:
+			{
+				MD_U8 literal_style = byte[0];
+				md_token_flags  = MD_TokenFlag_StringLiteral;
+				md_token_flags |= (literal_style == '\'') * MD_TokenFlag_StringSingleQuote;
+				md_token_flags |= (literal_style ==  '"') * MD_TokenFlag_StringDoubleQuote;
+				md_token_flags |= (literal_style ==  '`') * MD_TokenFlag_StringTick;
+
+				byte += 1;
+				for (;;)
+				{
+					byte = scan->find_any(byte, byte_opl, literal_style, '\\', '\n');
+					if (byte == byte_opl || *byte == '\n') {
+						md_token_opl    = byte;
+						md_token_flags |= MD_TokenFlag_BrokenStringLiteral;
+						break;
+					}
+					if (*byte == '\\') {
+						// an escaped newline still breaks the literal
+						byte += 1;
+						if (byte < byte_opl && *byte != '\n') {
+							byte += 1;
+						}
+						continue;
+					}
+					md_token_opl = byte + 1;
+					byte        += 1;
+					break;
+				}
+			}
+			break;
+
+			//- rjf: non-reserved symbols
+			case MD_TokenByteClass_Symbol:
+			{
+				md_token_flags = MD_TokenFlag_Symbol;
+				for (byte += 1; byte < byte_opl && md_token_byte_class(*byte) >= MD_TokenByteClass_Symbol; byte += 1);
+				md_token_opl = byte;
+			}
+			break;
+
+			//- rjf: reserved symbols
+			case MD_TokenByteClass_Reserved:
+			{
+				md_token_flags = MD_TokenFlag_Reserved | md_token_reserved_flag(*byte);
+				byte          += 1;
+				md_token_opl   = byte;
+			}
+			break;
+
+			//- rjf: bad characters in all other cases
+			default:
+			{
+				md_token_flags = MD_TokenFlag_BadCharacter;
+				byte          += 1;
+				md_token_opl   = byte;
+			}
+			break;
+		}
+
+		//- Ed: hold back a token that more input could extend
+		if (!is_final && md_token_opl >= byte_opl) {
+			byte = md_token_start;
+			break;
+		}
+
+		//- rjf; push token
+		MD_Token token = { .range = md_r1u64(byte_offset + (MD_U64)(md_token_start - byte_first), byte_offset + (MD_U64)(md_token_opl - byte_first)), .flags = md_token_flags };
+		md_tokenize__push_token(ainfo, token_arena, tokens, msgs, token);
+	}
+	return byte;
+}
+
+MD_TokenizeResult
+md_tokenize_from_text__ainfo(MD_AllocatorInfo ainfo, MD_String8 text)
+{
+	MD_TempArena scratch = md_scratch_begin(ainfo);
+
+	MD_TokenChunkList tokens = {0};
+	MD_MsgList        msgs   = {0};
+	md_tokenize__text(ainfo, scratch.arena, &tokens, &msgs, text.str, text.str + text.size, text.str + text.size, 0, 1);
+
+	//- rjf: bake, fill & return
+	MD_TokenizeResult result = {0}; {
+		result.tokens = md_token_array_from_chunk_list(ainfo, &tokens);
+		result.msgs   = msgs;
+	}
+	scratch_end(scratch);
+	return result;
+}
+
+////////////////////////////////
+//~ Ed: Text -> Compact Tokens Functions
+
+MD_TokenizeCompactResult
+md_tokenize_compact_from_text__ainfo(MD_AllocatorInfo ainfo, MD_String8 text)
+{
+	MD_TempArena scratch = md_scratch_begin(ainfo);
+
+	MD_CompactTokenChunkList tokens = {0};
+	MD_MsgList               msgs   = {0};
+	tokens.wide = text.size > MD_MAX_U32;
+
+	//- Ed: tokenize a window at a time into one reused wide chunk, a window can't start more tokens than it has bytes
+	MD_U64            window_size = MD_KB(16);
+	MD_TokenChunkNode window_node = { 0, md_push_array__no_zero(scratch.arena, MD_Token, window_size), 0, window_size };
+	MD_U8*            text_opl    = text.str + text.size;
+	for (MD_U8* byte = text.str; byte < text_opl;)
+	{
+		MD_TokenChunkList window = { &window_node, &window_node, 1, 0 };
+		window_node.count = 0;
+
+		MD_U8* window_opl = byte + md_min(window_size, (MD_U64)(text_opl - byte));
+		MD_U64 offset     = (MD_U64)(byte - text.str);
+		byte = md_tokenize__text(ainfo, scratch.arena, &window, &msgs, byte, window_opl, text_opl, offset, 1);
+		for (MD_U64 idx = 0; idx < window_node.count; idx += 1) {
+			md_compact_token_chunk_list_push(scratch.arena, &tokens, MD_KB(64), window_node.v[idx]);
+		}
+	}
+
+	MD_TokenizeCompactResult result = {0}; {
+		result.tokens = md_compact_token_array_from_chunk_list(ainfo, &tokens);
+		result.msgs   = msgs;
+	}
+	scratch_end(scratch);
+	return result;
+}
+
+////////////////////////////////
+//~ Ed: Text -> Significant Tokens Functions
+
+MD_U64
+md_significant_tokens_from_tokens(MD_Token* tokens, MD_U64 count, MD_SignificantToken* out, MD_Rng1U64* comments, MD_SignificantTokenFold* fold)
+{
+	MD_U64 out_count = 0;
+	for (MD_U64 idx = 0; idx < count; idx += 1)
+	{
+		MD_Token token = tokens[idx];
+		if (token.flags & MD_TokenFlagGroup_Irregular)
+		{
+			fold->trivia |= 1;
+			if ((token.flags & MD_TokenFlag_Newline) && (fold->trivia >> 1) < MD_TOKEN_TRIVIA_NEWLINE_MAX) {
+				fold->trivia += 2;
+			}
+			if (token.flags & MD_TokenFlagGroup_Comment) {
+				fold->comment.md_min = (fold->comment.md_max == 0) ? token.range.md_min : fold->comment.md_min;
+				fold->comment.md_max = token.range.md_max;
+			}
+			continue;
+		}
+		MD_SignificantToken significant = { token.range, token.flags, fold->trivia };
+		out[out_count] = significant;
+		if (comments != 0) {
+			comments[out_count] = fold->comment;
+		}
+		out_count += 1;
+		md_memory_zero_struct(fold);
+	}
+	return out_count;
+}
+
+MD_TokenizeSignificantResult
+md_tokenize_significant_from_text__ainfo(MD_AllocatorInfo ainfo, MD_String8 text, MD_B32 keep_comments)
+{
+	MD_TempArena scratch = md_scratch_begin(ainfo);
+
+	MD_SignificantTokenChunkList tokens = {0};
+	MD_SignificantTokenFold      fold   = {0};
+	MD_MsgList                   msgs   = {0};
+
+	//- Ed: tokenize a window at a time into one reused chunk, folding each window straight into the significant chunks
+	MD_U64            window_size = MD_KB(16);
+	MD_U64            chunk_size  = MD_KB(64);
+	MD_TokenChunkNode window_node = { 0, md_push_array__no_zero(scratch.arena, MD_Token, window_size), 0, window_size };
+	MD_U8*            text_opl    = text.str + text.size;
+	for (MD_U8* byte = text.str; byte < text_opl;)
+	{
+		MD_TokenChunkList window = { &window_node, &window_node, 1, 0 };
+		window_node.count = 0;
+
+		MD_U8* window_opl = byte + md_min(window_size, (MD_U64)(text_opl - byte));
+		MD_U64 offset     = (MD_U64)(byte - text.str);
+		byte = md_tokenize__text(ainfo, scratch.arena, &window, &msgs, byte, window_opl, text_opl, offset, 1);
+
+		MD_SignificantTokenChunkNode* node = tokens.last;
+		if (node == 0 || node->cap - node->count < window_node.count)
+		{
+			node           = md_push_array(scratch.arena, MD_SignificantTokenChunkNode, 1);
+			node->v        = md_push_array__no_zero(scratch.arena, MD_SignificantToken, chunk_size);
+			node->comments = keep_comments ? md_push_array__no_zero(scratch.arena, MD_Rng1U64, chunk_size) : 0;
+			node->cap      = chunk_size;
+			md_sll_queue_push(tokens.first, tokens.last, node);
+			tokens.chunk_count += 1;
+		}
+		MD_U64 folded = md_significant_tokens_from_tokens(window_node.v, window_node.count, node->v + node->count, node->comments ? node->comments + node->count : 0, &fold);
+		node->count             += folded;
+		tokens.total_token_count += folded;
+	}
+
+	MD_TokenizeSignificantResult result = {0}; {
+		result.tokens.count    = tokens.total_token_count;
+		result.tokens.v        = md_alloc_array_no_zero(ainfo, MD_SignificantToken, result.tokens.count);
+		result.tokens.comments = keep_comments ? md_alloc_array_no_zero(ainfo, MD_Rng1U64, result.tokens.count) : 0;
+		MD_U64 write_idx = 0;
+		for (MD_SignificantTokenChunkNode* n = tokens.first; n != 0; n = n->next)
+		{
+			md_memory_copy(result.tokens.v + write_idx, n->v, size_of(MD_SignificantToken) * n->count);
+			if (keep_comments) {
+				md_memory_copy(result.tokens.comments + write_idx, n->comments, size_of(MD_Rng1U64) * n->count);
+			}
+			write_idx += n->count;
+		}
+		result.msgs = msgs;
+	}
+	scratch_end(scratch);
+	return result;
+}
+
+////////////////////////////////
+//~ Ed: Incremental Text -> Tokens Functions
+
+// NOTE(Ed): Lexing a token reads its own bytes & at most the byte after it (where it stopped, or the 3rd byte of a quote pair),
+// so a token ending this far before the edit can't change. Lexing only ever looks forward, so past the edit a token that starts
+// where an old one did lines the streams back up for good.
+#define MD_TOKENIZE_EDIT_LOOKAHEAD 3
+
+// Re-lexes new_text from shortly before the edit until a token past it starts where one of old_tokens did.
+// Old tokens [restart_idx, old_idx) are replaced by relexed, the ones from old_idx on are kept with their offsets shifted.
+md_internal void
+md_tokenize__edit_relex(MD_Arena* arena, MD_TokenArray old_tokens, MD_String8 old_text, MD_String8 new_text, MD_Rng1U64 edit, MD_U64* restart_idx_out, MD_U64* old_idx_out, MD_TokenChunkList* relexed)
+{
+	md_assert(edit.md_min <= edit.md_max && edit.md_max <= old_text.size && old_text.size - (edit.md_max - edit.md_min) <= new_text.size);
+
+	//- Ed: restart at the first old token that reaches into the edit
+	MD_U64 restart_idx = 0;
+	for (MD_U64 hi = old_tokens.count; restart_idx < hi;)
+	{
+		MD_U64 mid = restart_idx + (hi - restart_idx) / 2;
+		if (old_tokens.v[mid].range.md_max + MD_TOKENIZE_EDIT_LOOKAHEAD <= edit.md_min) {
+			restart_idx = mid + 1;
+		}
+		else {
+			hi = mid;
+		}
+	}
+	MD_U64 restart = 0;
+	if (restart_idx < old_tokens.count) {
+		restart = old_tokens.v[restart_idx].range.md_min;
+	}
+	else if (restart_idx > 0) {
+		restart = old_tokens.v[restart_idx - 1].range.md_max;
+	}
+
+	//- Ed: re-lex a window at a time until a token past the edit starts where an old one did
+	MD_U64            edit_opl    = edit.md_max + new_text.size - old_text.size;
+	MD_U64            old_idx     = restart_idx;
+	MD_B32            aligned     = 0;
+	MD_AllocatorInfo  no_msgs     = {0};
+	MD_U64            window_size = MD_KB(4);
+	MD_TokenChunkNode window_node = { 0, md_push_array__no_zero(arena, MD_Token, window_size), 0, window_size };
+	MD_U8*            text_opl    = new_text.str + new_text.size;
+	for (MD_U8* byte = new_text.str + restart; byte < text_opl && ! aligned;)
+	{
+		MD_TokenChunkList window = { &window_node, &window_node, 1, 0 };
+		window_node.count = 0;
+
+		MD_U8* window_opl = byte + md_min(window_size, (MD_U64)(text_opl - byte));
+		MD_U64 offset     = (MD_U64)(byte - new_text.str);
+		byte = md_tokenize__text(no_msgs, 0, &window, 0, byte, window_opl, text_opl, offset, 1);
+		for (MD_U64 idx = 0; idx < window_node.count; idx += 1)
+		{
+			MD_Token token = window_node.v[idx];
+			if (token.range.md_min >= edit_opl)
+			{
+				MD_U64 old_min = token.range.md_min + old_text.size - new_text.size;
+				for (;old_idx < old_tokens.count && old_tokens.v[old_idx].range.md_min < old_min; old_idx += 1);
+				if (old_idx < old_tokens.count && old_tokens.v[old_idx].range.md_min == old_min) {
+					aligned = 1;
+					break;
+				}
+			}
+			md_token_chunk_list_push(arena, relexed, 4096, token);
+		}
+	}
+	*restart_idx_out = restart_idx;
+	*old_idx_out     = aligned ? old_idx : old_tokens.count;
+}
+
+MD_TokenizeEditResult
+md_tokenize_from_text_edit__ainfo(MD_AllocatorInfo ainfo, MD_TokenArray old_tokens, MD_String8 old_text, MD_String8 new_text, MD_Rng1U64 edit)
+{
+	MD_TempArena      scratch     = md_scratch_begin(ainfo);
+	MD_TokenChunkList relexed     = {0};
+	MD_U64            restart_idx = 0;
+	MD_U64            old_idx     = 0;
+	md_tokenize__edit_relex(scratch.arena, old_tokens, old_text, new_text, edit, &restart_idx, &old_idx, &relexed);
+
+	//- Ed: old tokens before the restart, the re-lexed ones, then the old tokens past the edit shifted over
+	MD_TokenizeEditResult result = {0};
+	{
+		MD_U64 suffix_count = old_tokens.count - old_idx;
+		result.tokens.count = restart_idx + relexed.total_token_count + suffix_count;
+		result.tokens.v     = md_alloc_array_no_zero(ainfo, MD_Token, result.tokens.count);
+		result.relexed      = md_r1u64(restart_idx, restart_idx + relexed.total_token_count);
+
+		md_memory_copy(result.tokens.v, old_tokens.v, size_of(MD_Token) * restart_idx);
+		MD_U64 write_idx = restart_idx;
+		for (MD_TokenChunkNode* n = relexed.first; n != 0; n = n->next) {
+			md_memory_copy(result.tokens.v + write_idx, n->v, size_of(MD_Token) * n->count);
+			write_idx += n->count;
+		}
+		MD_U64 shift = new_text.size - old_text.size; // wraps when the text shrank, the sums below wrap back
+		for (MD_U64 idx = 0; idx < suffix_count; idx += 1)
+		{
+			MD_Token token = old_tokens.v[old_idx + idx];
+			token.range.md_min += shift;
+			token.range.md_max += shift;
+			result.tokens.v[write_idx + idx] = token;
+		}
+
+		// messages come from the tokens, in the order md_tokenize_from_text pushes them
+		for (MD_U64 idx = 0; idx < result.tokens.count; idx += 1) {
+			if (result.tokens.v[idx].flags & (MD_TokenFlag_BrokenComment | MD_TokenFlag_BrokenStringLiteral)) {
+				md_tokenize__push_token_msgs(ainfo, &result.msgs, result.tokens.v[idx]);
+			}
+		}
+	}
+	scratch_end(scratch);
+	return result;
+}
+
+MD_B32
+md_tokenize_edit_in_place__ainfo(MD_AllocatorInfo ainfo, MD_TokenizeEditResult* tokenize, MD_U64 token_cap, MD_String8 old_text, MD_String8 new_text, MD_Rng1U64 edit)
+{
+	MD_TempArena      scratch     = md_scratch_begin(ainfo);
+	MD_TokenArray     tokens      = tokenize->tokens;
+	MD_TokenChunkList relexed     = {0};
+	MD_U64            restart_idx = 0;
+	MD_U64            old_idx     = 0;
+	md_tokenize__edit_relex(scratch.arena, tokens, old_text, new_text, edit, &restart_idx, &old_idx, &relexed);
+
+	MD_U64 suffix_count = tokens.count - old_idx;
+	MD_U64 count        = restart_idx + relexed.total_token_count + suffix_count;
+	if (count > token_cap) {
+		scratch_end(scratch);
+		return 0;
+	}
+
+	//- Ed: messages of the replaced tokens start in [replaced_min, replaced_opl) of old_text, the ones after get shifted
+	MD_U64 shift        = new_text.size - old_text.size; // wraps when the text shrank, the sums below wrap back
+	MD_U64 replaced_min = restart_idx < tokens.count ? tokens.v[restart_idx].range.md_min : old_text.size;
+	MD_U64 replaced_opl = old_idx     < tokens.count ? tokens.v[old_idx].range.md_min     : MD_MAX_U64;
+
+	//- Ed: the suffix moves over & shifts (neither when it doesn't need to), the re-lexed tokens go in between, the prefix isn't touched
+	MD_Token* suffix = tokens.v + restart_idx + relexed.total_token_count;
+	if (suffix != tokens.v + old_idx) {
+		md_memory_copy(suffix, tokens.v + old_idx, size_of(MD_Token) * suffix_count);
+	}
+	for (MD_U64 idx = 0; idx < suffix_count && shift != 0; idx += 1) {
+		suffix[idx].range.md_min += shift;
+		suffix[idx].range.md_max += shift;
+	}
+	MD_U64 write_idx = restart_idx;
+	for (MD_TokenChunkNode* n = relexed.first; n != 0; n = n->next) {
+		md_memory_copy(tokens.v + write_idx, n->v, size_of(MD_Token) * n->count);
+		write_idx += n->count;
+	}
+	tokenize->tokens.count = count;
+	tokenize->relexed      = md_r1u64(restart_idx, restart_idx + relexed.total_token_count);
+
+	//- Ed: messages before the window are kept, the re-lexed tokens' are pushed, the ones past it kept & shifted
+	MD_MsgList kept    = {0};
+	MD_MsgList after   = {0};
+	MD_Msg*    next    = 0;
+	for (MD_Msg* msg = tokenize->msgs.first; msg != 0; msg = next)
+	{
+		next      = msg->next;
+		msg->next = 0;
+		MD_U64 offset = msg->node->src_offset;
+		if (offset >= replaced_min && offset < replaced_opl) {
+			continue;
+		}
+		MD_MsgList* list = offset < replaced_min ? &kept : &after;
+		if (list == &after) {
+			msg->node->src_offset += shift;
+		}
+		md_sll_queue_push(list->first, list->last, msg);
+		list->count             += 1;
+		list->worst_message_kind = md_max(list->worst_message_kind, msg->kind);
+	}
+	for (MD_U64 idx = tokenize->relexed.md_min; idx < tokenize->relexed.md_max; idx += 1) {
+		if (tokens.v[idx].flags & (MD_TokenFlag_BrokenComment | MD_TokenFlag_BrokenStringLiteral)) {
+			md_tokenize__push_token_msgs(ainfo, &kept, tokens.v[idx]);
+		}
+	}
+	md_msg_list_concat_in_place(&kept, &after);
+	tokenize->msgs = kept;
+	scratch_end(scratch);
+	return 1;
+}
+
+////////////////////////////////
+//~ Ed: Token Cursor Functions
+
+void
+md_token_cursor_init(MD_TokenCursor* cursor, MD_String8 text) {
+	cursor->text       = text;
+	cursor->lex_offset = 0;
+	cursor->first_idx  = 0;
+	cursor->count      = 0;
+	md_memory_zero_struct(&cursor->fold);
+}
+
+MD_B32
+md_token_cursor_fill(MD_TokenCursor* cursor, MD_U64 idx)
+{
+	md_assert(idx >= cursor->first_idx);
+	MD_AllocatorInfo no_msgs  = {0};
+	MD_U8*           text_opl = cursor->text.str + cursor->text.size;
+	for (;idx - cursor->first_idx >= cursor->count;)
+	{
+		MD_U8* byte = cursor->text.str + cursor->lex_offset;
+		if (byte >= text_opl) {
+			return 0;
+		}
+
+		//- Ed: slide the window, the last few tokens may still be peeked
+		MD_U64 keep = md_min(cursor->count, 3);
+		md_memory_copy(cursor->v, cursor->v + cursor->count - keep, size_of(MD_SignificantToken) * keep);
+		cursor->first_idx += cursor->count - keep;
+		cursor->count      = keep;
+
+		//- Ed: lex enough for the rest of the window, a span of bytes can't start more tokens than it has bytes
+		MD_U64            space  = MD_TOKEN_CURSOR_WINDOW - keep;
+		MD_TokenChunkNode node   = { 0, cursor->lex, 0, space };
+		MD_TokenChunkList tokens = { &node, &node, 1, 0 };
+		MD_U8*            stop   = byte + md_min(space, (MD_U64)(text_opl - byte));
+		byte = md_tokenize__text(no_msgs, 0, &tokens, 0, byte, stop, text_opl, cursor->lex_offset, 1);
+		cursor->count     += md_significant_tokens_from_tokens(cursor->lex, node.count, cursor->v + keep, 0, &cursor->fold);
+		cursor->lex_offset = (MD_U64)(byte - cursor->text.str);
+	}
+	return 1;
+}
+
+////////////////////////////////
+//~ Ed: Parallel Text -> Tokens Functions
+
+// NOTE(Ed): Tokenizing carries no state between tokens, so from any real token boundary the rest of the tokens are fixed.
+// Each thread tokenizes its segment assuming the split is a boundary (not inside a string or comment). When the previous
+// segment's tokens actually end elsewhere, the segment is re-tokenized from there one token at a time until a token lines up
+// with a speculative one, which is usually the next line.
+
+// One thread's share of md_tokenize_from_text_parallel
+typedef struct MD_TokenizeSegment MD_TokenizeSegment;
+struct MD_TokenizeSegment
+{
+	MD_String8        text;
+	MD_U64            split_first;
+	MD_U64            split_opl;
+	MD_Arena*         arena;
+
+	//- Ed: speculative pass, assumes split_first is a token boundary
+	MD_TokenChunkList  tokens;
+	MD_U64             token_opl;   // start of the first token at or past split_opl
+
+	//- Ed: fixup, tokens re-tokenized from the real boundary until one lines up with the speculative ones
+	MD_TokenChunkList  fixed;
+	MD_TokenChunkNode* keep_node;
+	MD_U64             keep_idx;
+	MD_U64             token_count;
+
+	//- Ed: bake
+	MD_Token*          dst;
+	MD_U64             broken_count;
+};
+
+md_internal void
+md_tokenize_parallel__tokenize_segment(void* ptr)
+{
+	MD_TokenizeSegment* segment = (MD_TokenizeSegment*)ptr;
+	MD_U8*              first   = segment->text.str;
+	MD_U8*              opl     = md_tokenize__text(md_arena_allocator(segment->arena), segment->arena, &segment->tokens, 0, first + segment->split_first, first + segment->split_opl, first + segment->text.size, segment->split_first, 1);
+	segment->token_opl = (MD_U64)(opl - first);
+}
+
+md_internal void
+md_tokenize_parallel__bake_segment(void* ptr)
+{
+	MD_TokenizeSegment* segment = (MD_TokenizeSegment*)ptr;
+	MD_Token*           dst     = segment->dst;
+	for (MD_TokenChunkNode* n = segment->fixed.first; n != 0; n = n->next) {
+		md_memory_copy(dst, n->v, size_of(MD_Token) * n->count);
+		dst += n->count;
+	}
+	for (MD_TokenChunkNode* n = segment->keep_node; n != 0; n = n->next)
+	{
+		MD_U64 first = (n == segment->keep_node) ? segment->keep_idx : 0;
+		md_memory_copy(dst, n->v + first, size_of(MD_Token) * (n->count - first));
+		dst += n->count - first;
+	}
+
+	// Ed: errors are pushed in token order afterwards, by the thread that owns the result's allocator
+	for (MD_U64 idx = 0; idx < segment->token_count; idx += 1) {
+		segment->broken_count += (segment->dst[idx].flags & (MD_TokenFlag_BrokenComment | MD_TokenFlag_BrokenStringLiteral)) != 0;
+	}
+}
+
+// Ed: runs func over count items of item_size bytes, one thread each (an item_size of 0 gives them all the first item)
+md_internal void
+md_parallel__run(MD_OS_ThreadFunctionType* func, void* items, MD_U64 item_size, MD_OS_Handle* threads, MD_U64 count)
+{
+	MD_U8* first = (MD_U8*)items;
+
+	//- Ed: the calling thread takes the first item
+	for (MD_U64 idx = 1; idx < count; idx += 1) {
+		threads[idx] = md_os_thread_launch(func, first + idx * item_size, 0);
+	}
+	func(first);
+	for (MD_U64 idx = 1; idx < count; idx += 1)
+	{
+		if (md_os_handle_match(threads[idx], md_os_handle_zero())) {
+			func(first + idx * item_size);
+		}
+		else {
+			md_os_thread_join(threads[idx], MD_MAX_U64);
+		}
+	}
+}
+
+MD_TokenizeResult
+md_tokenize_from_text_parallel__ainfo(MD_AllocatorInfo ainfo, MD_String8 text, MD_U64 thread_count)
+{
+	if (thread_count == 0) {
+		thread_count = md_os_get_system_info()->logical_processor_count;
+	}
+	thread_count = md_clamp_top(thread_count, text.size / MD_TOKENIZE_PARALLEL_MIN_SEGMENT_SIZE);
+	if (thread_count <= 1) {
+		return md_tokenize_from_text__ainfo(ainfo, text);
+	}
+
+	MD_TempArena        scratch  = md_scratch_begin(ainfo);
+	MD_TextScanKernels* scan     = md_text_scan_kernels();
+	MD_U8*              text_opl = text.str + text.size;
+	MD_TokenizeSegment* segments = md_push_array(scratch.arena, MD_TokenizeSegment, thread_count);
+	MD_OS_Handle*       threads  = md_push_array(scratch.arena, MD_OS_Handle,       thread_count);
+
+	//- Ed: split just past a newline near each even share, few tokens span one
+	MD_U64 split = 0;
+	for (MD_U64 idx = 0; idx < thread_count; idx += 1)
+	{
+		MD_TokenizeSegment* segment = &segments[idx];
+		segment->text        = text;
+		segment->split_first = split;
+		segment->split_opl   = text.size;
+		segment->arena       = md_arena_alloc(.backing = md_heap(), .block_size = MD_MB(4));
+		if (idx + 1 < thread_count)
+		{
+			MD_U64 even    = md_max(split, text.size * (idx + 1) / thread_count);
+			MD_U8* newline = scan->find_any(text.str + even, text_opl, '\n', '\n', '\n');
+			segment->split_opl = (newline < text_opl) ? (MD_U64)(newline + 1 - text.str) : text.size;
+		}
+		split = segment->split_opl;
+	}
+
+	//- Ed: speculative pass
+	md_parallel__run(md_tokenize_parallel__tokenize_segment, segments, size_of(MD_TokenizeSegment), threads, thread_count);
+
+	//- Ed: fixup, resume is where the real tokens before each segment end
+	MD_U64 resume      = segments[0].token_opl;
+	MD_U64 token_count = segments[0].tokens.total_token_count;
+	segments[0].keep_node   = segments[0].tokens.first;
+	segments[0].token_count = token_count;
+	for (MD_U64 idx = 1; idx < thread_count; idx += 1)
+	{
+		MD_TokenizeSegment* segment  = &segments[idx];
+		MD_TokenChunkNode*  node     = segment->tokens.first;
+		MD_U64              node_idx = 0;
+		MD_U64              skipped  = 0;
+		for (;;)
+		{
+			// Ed: skip speculative tokens that start before the real boundary
+			for (;node != 0 && node->v[node->count - 1].range.md_min < resume; node = node->next) {
+				skipped += node->count - node_idx;
+				node_idx = 0;
+			}
+			for (;node != 0 && node->v[node_idx].range.md_min < resume; node_idx += 1) {
+				skipped += 1;
+			}
+			if (node != 0 && node->v[node_idx].range.md_min == resume) {
+				resume = segment->token_opl;
+				break;
+			}
+			if (resume >= segment->split_opl) {
+				break;
+			}
+			MD_U8* byte = text.str + resume;
+			resume = (MD_U64)(md_tokenize__text(ainfo, scratch.arena, &segment->fixed, 0, byte, byte + 1, text_opl, resume, 1) - text.str);
+		}
+		segment->keep_node   = node;
+		segment->keep_idx    = node_idx;
+		segment->token_count = segment->fixed.total_token_count + (node != 0 ? segment->tokens.total_token_count - skipped : 0);
+		token_count         += segment->token_count;
+	}
+
+	//- Ed: bake
+	MD_TokenizeResult result = {0};
+	result.tokens.count = token_count;
+	result.tokens.v     = md_alloc_array_no_zero(ainfo, MD_Token, token_count);
+	MD_Token* dst = result.tokens.v;
+	for (MD_U64 idx = 0; idx < thread_count; idx += 1) {
+		segments[idx].dst = dst;
+		dst += segments[idx].token_count;
+	}
+	md_parallel__run(md_tokenize_parallel__bake_segment, segments, size_of(MD_TokenizeSegment), threads, thread_count);
+
+	for (MD_U64 idx = 0; idx < thread_count; idx += 1)
+	{
+		MD_TokenizeSegment* segment = &segments[idx];
+		for (MD_U64 token_idx = 0; segment->broken_count != 0 && token_idx < segment->token_count; token_idx += 1) {
+			md_tokenize__push_token_msgs(ainfo, &result.msgs, segment->dst[token_idx]);
+		}
+		md_arena_release(segment->arena);
+	}
+	scratch_end(scratch);
+	return result;
+}
+
+////////////////////////////////
+//~ Ed: Streaming Text -> Tokens Functions
+
+void
+md_tokenize_stream_init(MD_TokenizeStream* stream, MD_AllocatorInfo backing)
+{
+	md_memory_zero_struct(stream);
+	stream->backing = backing;
+	stream->state   = MD_TokenizeState_None;
+}
+
+void
+md_tokenize_stream_release(MD_TokenizeStream* stream)
+{
+	if (stream->carry != 0) {
+		md_alloc_free(stream->backing, stream->carry);
+	}
+	md_tokenize_stream_init(stream, stream->backing);
+}
+
+md_internal void
+md_tokenize_stream__carry(MD_TokenizeStream* stream, MD_U8* first, MD_U8* opl)
+{
+	MD_U64 size = (MD_U64)(opl - first);
+	if (stream->carry_size + size > stream->carry_cap)
+	{
+		MD_U64 new_cap = md_max(md_max(stream->carry_cap * 2, stream->carry_size + size), 256);
+		stream->carry     = (MD_U8*)md_resize(stream->backing, stream->carry, stream->carry_cap, new_cap);
+		stream->carry_cap = new_cap;
+	}
+	md_memory_copy(stream->carry + stream->carry_size, first, size);
+	stream->carry_size += size;
+}
+
+// Advances the pending token over [byte, byte_opl), returns the token's one-past-last once it completes,
+// or byte_opl with *complete left 0 when it continues into the next chunk.
+md_internal MD_U8*
+md_tokenize_stream__feed(MD_TokenizeStream* stream, MD_U8* byte, MD_U8* byte_opl, MD_B32* complete)
+{
+	MD_TextScanKernels* scan = md_text_scan_kernels();
+	*complete = 0;
+
+	//- Ed: start a token
+	if (stream->state == MD_TokenizeState_None)
+	{
+		stream->token_offset  = stream->offset + (MD_U64)(byte - stream->chunk_first);
+		stream->state         = md_token_byte_class(*byte);
+		stream->literal_style = *byte;
+		stream->run           = 0;
+		stream->escaped       = 0;
+		switch (stream->state)
+		{
+			case MD_TokenByteClass_Whitespace:  stream->flags = MD_TokenFlag_Whitespace; break;
+			case MD_TokenByteClass_Identifier:  stream->flags = MD_TokenFlag_Identifier; break;
+			case MD_TokenByteClass_Digit:       stream->flags = MD_TokenFlag_Numeric;    break;
+			case MD_TokenByteClass_Symbol:
+			case MD_TokenByteClass_Slash:
+			case MD_TokenByteClass_NumericSign: stream->flags = MD_TokenFlag_Symbol;     break;
+			case MD_TokenByteClass_Quote:
+			{
+				stream->flags  = MD_TokenFlag_StringLiteral;
+				stream->flags |= (*byte == '\'') * MD_TokenFlag_StringSingleQuote;
+				stream->flags |= (*byte ==  '"') * MD_TokenFlag_StringDoubleQuote;
+				stream->flags |= (*byte ==  '`') * MD_TokenFlag_StringTick;
+				stream->run    = 1;
+			}
+			break;
+
+			case MD_TokenByteClass_Newline:  stream->flags = MD_TokenFlag_Newline;      *complete = 1; break;
+			case MD_TokenByteClass_Reserved: stream->flags = MD_TokenFlag_Reserved | md_token_reserved_flag(*byte); *complete = 1; break;
+			default:                         stream->flags = MD_TokenFlag_BadCharacter; *complete = 1; break;
+		}
+		byte += 1;
+		if (*complete) {
+			return byte;
+		}
+	}
+
+	//- Ed: continue it
+	for (;byte < byte_opl;) switch (stream->state)
+	{
+		case MD_TokenByteClass_Slash:
+		{
+			stream->state = *byte == '/' ? MD_TokenizeState_LineComment : *byte == '*' ? MD_TokenizeState_BlockComment : MD_TokenByteClass_Symbol;
+			if (stream->state != MD_TokenByteClass_Symbol) {
+				stream->flags = MD_TokenFlag_Comment;
+				byte         += 1;
+			}
+		}
+		break;
+
+		case MD_TokenByteClass_NumericSign:
+		{
+			MD_B32 numeric = md_token_byte_class(*byte) == MD_TokenByteClass_Digit;
+			stream->state  = numeric ? MD_TokenByteClass_Digit : MD_TokenByteClass_Symbol;
+			stream->flags  = numeric ? MD_TokenFlag_Numeric    : MD_TokenFlag_Symbol;
+		}
+		break;
+
+		//- Ed: runs
+		case MD_TokenByteClass_Whitespace: { byte = scan->skip_whitespace(byte, byte_opl); if (byte < byte_opl) { *complete = 1; return byte; } } break;
+		case MD_TokenByteClass_Identifier: { byte = scan->skip_identifier(byte, byte_opl); if (byte < byte_opl) { *complete = 1; return byte; } } break;
+		case MD_TokenByteClass_Digit:      { byte = scan->skip_numeric   (byte, byte_opl); if (byte < byte_opl) { *complete = 1; return byte; } } break;
+		case MD_TokenByteClass_Symbol:
+		{
+			for (; byte < byte_opl && md_token_byte_class(*byte) >= MD_TokenByteClass_Symbol; byte += 1);
+			if (byte < byte_opl) {
+				*complete = 1;
+				return byte;
+			}
+		}
+		break;
+
+		//- Ed: opening quotes, run counts how many have been seen
+		case MD_TokenByteClass_Quote:
+		{
+			if (*byte == stream->literal_style) {
+				byte += 1;
+				if (stream->run == 2) {
+					stream->state  = MD_TokenizeState_TripletString;
+					stream->flags |= MD_TokenFlag_StringTriplet;
+					stream->run    = 0;
+				}
+				else {
+					stream->run = 2;
+				}
+			}
+			else if (stream->run == 2) {
+				*complete = 1; // empty literal
+				return byte;
+			}
+			else {
+				stream->state = MD_TokenizeState_SingletString;
+			}
+		}
+		break;
+
+		case MD_TokenizeState_SingletString:
+		{
+			// an escaped newline still breaks the literal
+			if (stream->escaped) {
+				stream->escaped = 0;
+				byte           += (*byte != '\n');
+				break;
+			}
+			byte = scan->find_any(byte, byte_opl, stream->literal_style, '\\', '\n');
+			if (byte == byte_opl) {
+				break;
+			}
+			if (*byte == '\n') {
+				stream->flags |= MD_TokenFlag_BrokenStringLiteral;
+				*complete      = 1;
+				return byte;
+			}
+			byte += 1;
+			if (byte[-1] == '\\') {
+				stream->escaped = 1;
+				break;
+			}
+			*complete = 1;
+			return byte;
+		}
+		break;
+
+		//- Ed: closing quotes, run counts consecutive quotes
+		case MD_TokenizeState_TripletString:
+		{
+			if (*byte != stream->literal_style) {
+				stream->run = 0;
+				byte        = scan->find_any(byte, byte_opl, stream->literal_style, stream->literal_style, stream->literal_style);
+				break;
+			}
+			byte        += 1;
+			stream->run += 1;
+			if (stream->run == 3) {
+				*complete = 1;
+				return byte;
+			}
+		}
+		break;
+
+		case MD_TokenizeState_LineComment:
+		{
+			if (stream->escaped) {
+				stream->escaped = 0;
+				byte           += 1;
+				break;
+			}
+			byte = scan->find_any(byte, byte_opl, '\n', '\\', '\n');
+			if (byte == byte_opl) {
+				break;
+			}
+			if (*byte == '\n') {
+				*complete = 1;
+				return byte;
+			}
+			byte           += 1;
+			stream->escaped = 1;
+		}
+		break;
+
+		//- Ed: run is set when the chunk ended on a '*'
+		case MD_TokenizeState_BlockComment:
+		{
+			if (stream->run && *byte == '/') {
+				*complete = 1;
+				return byte + 1;
+			}
+			MD_U8* star = scan->find_pair(byte, byte_opl, '*', '/');
+			if (star < byte_opl) {
+				*complete = 1;
+				return star + 2;
+			}
+			stream->run = byte_opl[-1] == '*';
+			byte        = byte_opl;
+		}
+		break;
+	}
+	return byte;
+}
+
+md_internal void
+md_tokenize_stream__push_pending(MD_AllocatorInfo ainfo, MD_TokenizeStream* stream, MD_Arena* token_arena, MD_TokenChunkList* tokens, MD_MsgList* msgs, MD_U64 token_opl)
+{
+	MD_Token token = { .range = md_r1u64(stream->token_offset, token_opl), .flags = stream->flags };
+	md_tokenize__push_token(ainfo, token_arena, tokens, msgs, token);
+	stream->state      = MD_TokenizeState_None;
+	stream->carry_size = 0;
+}
+
+MD_TokenizeStreamResult
+md_tokenize_stream_push__ainfo(MD_AllocatorInfo ainfo, MD_TokenizeStream* stream, MD_String8 chunk)
+{
+	MD_TempArena scratch = md_scratch_begin(ainfo);
+
+	MD_TokenChunkList tokens = {0};
+	MD_MsgList        msgs   = {0};
+	MD_String8        spanning_text = {0};
+
+	MD_U8* byte_opl = chunk.str + chunk.size;
+	MD_U8* byte     = chunk.str;
+	stream->chunk_first = chunk.str;
+
+	//- Ed: finish the token carried from earlier chunks
+	if (stream->state != MD_TokenizeState_None && byte < byte_opl)
+	{
+		MD_B32 complete = 0;
+		MD_U8* token_opl = md_tokenize_stream__feed(stream, byte, byte_opl, &complete);
+		md_tokenize_stream__carry(stream, byte, token_opl);
+		byte = token_opl;
+		if (complete) {
+			spanning_text = md_str8_copy(ainfo, md_str8(stream->carry, stream->carry_size));
+			md_tokenize_stream__push_pending(ainfo, stream, scratch.arena, &tokens, &msgs, stream->offset + (MD_U64)(byte - chunk.str));
+		}
+	}
+
+	//- Ed: tokenize the chunk in place, then start carrying the token that reaches its end
+	if (stream->state == MD_TokenizeState_None)
+	{
+		byte = md_tokenize__text(ainfo, scratch.arena, &tokens, &msgs, byte, byte_opl, byte_opl, stream->offset + (MD_U64)(byte - chunk.str), 0);
+		for (;byte < byte_opl;)
+		{
+			MD_B32 complete = 0;
+			MD_U8* token_opl = md_tokenize_stream__feed(stream, byte, byte_opl, &complete);
+			if (complete) {
+				md_tokenize_stream__push_pending(ainfo, stream, scratch.arena, &tokens, &msgs, stream->offset + (MD_U64)(token_opl - chunk.str));
+			}
+			else {
+				md_tokenize_stream__carry(stream, byte, token_opl);
+			}
+			byte = token_opl;
+		}
+	}
+
+	//- Ed: bake, fill & return
+	MD_TokenizeStreamResult result = {0}; {
+		result.tokens        = md_token_array_from_chunk_list(ainfo, &tokens);
+		result.msgs          = msgs;
+		result.spanning_text = spanning_text;
+		result.chunk_offset  = stream->offset;
+	}
+	stream->offset     += chunk.size;
+	stream->chunk_first = 0;
+	scratch_end(scratch);
+	return result;
+}
+
+MD_TokenizeStreamResult
+md_tokenize_stream_finish__ainfo(MD_AllocatorInfo ainfo, MD_TokenizeStream* stream)
+{
+	MD_TempArena scratch = md_scratch_begin(ainfo);
+
+	MD_TokenChunkList tokens = {0};
+	MD_MsgList        msgs   = {0};
+	MD_String8        spanning_text = {0};
+
+	//- Ed: the pending token ends with the text, resolve it the way md_tokenize_from_text does at the end of text
+	if (stream->state != MD_TokenizeState_None)
+	{
+		switch (stream->state)
+		{
+			case MD_TokenByteClass_Slash:
+			case MD_TokenByteClass_NumericSign:   stream->flags  = MD_TokenFlag_Symbol;                                       break;
+			case MD_TokenByteClass_Quote:         stream->flags |= (stream->run == 1) * MD_TokenFlag_BrokenStringLiteral;     break;
+			case MD_TokenizeState_SingletString:
+			case MD_TokenizeState_TripletString:  stream->flags |= MD_TokenFlag_BrokenStringLiteral;                          break;
+			case MD_TokenizeState_BlockComment:   stream->flags |= MD_TokenFlag_BrokenComment;                                break;
+		}
+		spanning_text = md_str8_copy(ainfo, md_str8(stream->carry, stream->carry_size));
+		md_tokenize_stream__push_pending(ainfo, stream, scratch.arena, &tokens, &msgs, stream->offset);
+	}
+
+	MD_TokenizeStreamResult result = {0}; {
+		result.tokens        = md_token_array_from_chunk_list(ainfo, &tokens);
+		result.msgs          = msgs;
+		result.spanning_text = spanning_text;
+		result.chunk_offset  = stream->offset;
+	}
+	scratch_end(scratch);
+	return result;
+}
+
+////////////////////////////////
+//~ rjf: Tokens -> Tree Functions
+
+typedef enum MD_ParseWorkKind MD_ParseWorkKind;
+enum MD_ParseWorkKind
 {
 	ParseWorkKind_Main,
 	ParseWorkKind_MainImplicit,
 	ParseWorkKind_NodeOptionalFollowUp,
 	ParseWorkKind_NodeChildrenStyleScan,
 
-	ParseWorkKind_UnderlyingType = MD_MAX_U32,
+	ParseWorkKind_UnderlyingType = MD_MAX_U32,
+};
+
+typedef struct MD_ParseWorkNode MD_ParseWorkNode;
+struct MD_ParseWorkNode
+{
+	MD_ParseWorkNode* next;
+	MD_ParseWorkKind  kind;
+	MD_Node*          parent;
+	MD_Node*          first_gathered_tag;
+	MD_Node*          last_gathered_tag;
+	MD_NodeFlags      gathered_node_flags;
+	MD_S32            counted_newlines;
+	MD_U64            child_count; // children pushed onto parent
+};
+
+inline
+void md_parse__work_push(MD_ParseWorkKind work_kind, MD_Node* work_parent, MD_ParseWorkNode** work_top, MD_ParseWorkNode** work_free, MD_TempArena* scratch)
+{
+	MD_ParseWorkNode* work_node = *work_free;
+	if (work_node == 0) {
+		work_node = md_push_array(scratch->arena, MD_ParseWorkNode, 1);
+	}
+	else {
+		md_sll_stack_pop(*work_free);
+		md_memory_zero_struct(work_node);
+	}
+	work_node->kind               = (work_kind);
+	work_node->parent             = (work_parent);
+	work_node->first_gathered_tag = md_nil_node();
+	work_node->last_gathered_tag  = md_nil_node();
+	md_sll_stack_push(*work_top, work_node);
+}
+
+inline
+void md_parse__work_pop(MD_ParseWorkNode** work_top, MD_ParseWorkNode** work_free, MD_ParseWorkNode* broken_work, MD_AllocatorInfo ainfo) {
+	MD_ParseWorkNode* popped = *work_top;
+	// Ed: a set's children are all in once its work is popped, the root's (the bottom of the stack) are indexed at the end
+	if (popped->child_count >= MD_CHILD_INDEX_THRESHOLD && popped->next != 0) {
+		md_child_index_from_node(ainfo, popped->parent);
+	}
+	md_sll_stack_pop(*work_top);
+	if (popped != broken_work) {
+		md_sll_stack_push(*work_free, popped);
+	}
+	if (*work_top == 0) {
+		*work_top = broken_work;
+	}
+}
+
+md_force_inline MD_NodeFlags
+md_parse__delimiter_flags(MD_TokenFlags reserved) {
+	return (
+		MD_NodeFlag_HasBraceLeft    *!! (reserved & MD_TokenFlag_BraceLeft   ) |
+		MD_NodeFlag_HasBracketLeft  *!! (reserved & MD_TokenFlag_BracketLeft ) |
+		MD_NodeFlag_HasParenLeft    *!! (reserved & MD_TokenFlag_ParenLeft   ) |
+		MD_NodeFlag_HasBraceRight   *!! (reserved & MD_TokenFlag_BraceRight  ) |
+		MD_NodeFlag_HasBracketRight *!! (reserved & MD_TokenFlag_BracketRight) |
+		MD_NodeFlag_HasParenRight   *!! (reserved & MD_TokenFlag_ParenRight  )
+	);
+}
+
+// NOTE(Ed): The parser reads tokens through this, from an array in any layout or straight from a cursor.
+// Only one of v, compact, significant or cursor is set. Significant tokens (& the cursor's) come with their trivia folded in,
+// every other layout has trivia of 0 and keeps its whitespace, comment & newline tokens.
+typedef struct MD_ParseTokens MD_ParseTokens;
+struct MD_ParseTokens
+{
+	MD_Token*            v;
+	MD_CompactTokenArray compact;
+	MD_SignificantToken* significant;
+	MD_U64               count;
+	MD_TokenCursor*      cursor;
+};
+
+md_force_inline MD_B32
+md_parse__token(MD_ParseTokens* tokens, MD_U64 idx, MD_Token* token, MD_U32* trivia)
+{
+	MD_SignificantToken significant = {0};
+	if (tokens->cursor != 0) {
+		if ( ! md_token_cursor_peek(tokens->cursor, idx, &significant)) {
+			return 0;
+		}
+	}
+	else if (idx >= tokens->count) {
+		return 0;
+	}
+	else if (tokens->significant != 0) {
+		significant = tokens->significant[idx];
+	}
+	else {
+		MD_Token wide = (tokens->v != 0) ? tokens->v[idx] : md_compact_token_at(&tokens->compact, idx);
+		significant.range = wide.range;
+		significant.flags = wide.flags;
+	}
+	token->range = significant.range;
+	token->flags = significant.flags;
+	*trivia      = significant.trivia;
+	return 1;
+}
+
+// Ed: sets within tag arguments are parsed up front, a tag can be dropped before anything reaches it
+md_internal MD_B32
+md_parse__can_defer_set(MD_Node* node)
+{
+	for (MD_Node* n = node; !md_node_is_nil(n); n = n->parent) {
+		if (n->kind == MD_NodeKind_Tag) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+typedef struct MD_SetScanFrame MD_SetScanFrame;
+struct MD_SetScanFrame
+{
+	MD_SetScanFrame* next;
+	MD_ParseWorkKind kind;
+	MD_S32           counted_newlines;
+	MD_String8       label; // for the warning on a label with nothing after its :
+};
+
+typedef struct MD_ParseSkip MD_ParseSkip;
+struct MD_ParseSkip
+{
+	MD_ParseTokens*  tokens;
+	MD_Arena*        arena;
+	MD_SetScanFrame* free_frames;
+	// errors in what gets skipped are reported when msgs is set
+	MD_AllocatorInfo ainfo;
+	MD_String8       text;
+	MD_MsgList*      msgs;
+};
+
+// NOTE(Ed): Runs tokens through the same work stack as md_parse__tokens from a single work of the given kind, keeping only the kinds
+// (no nodes), until that work is popped. So a { only nests where the parser would make a set of it, & with skip->msgs set
+// the same messages come out. Keep the two in sync.
+// Returns the token to resume from (MD_MAX_U64 if the tokens ran out first), *closer gets the token that popped a Main.
+md_internal MD_U64
+md_parse__skip_work(MD_ParseSkip* skip, MD_U64 token_idx, MD_ParseWorkKind kind, MD_String8 label, MD_Token* closer)
+{
+	MD_SetScanFrame  base = { 0, kind, 0, label };
+	MD_SetScanFrame* top  = &base;
+	MD_B32           done = 0;
+
+	#define skip_push(work_kind, work_label) do {                                               \
+		MD_SetScanFrame* frame = skip->free_frames;                                              \
+		if (frame != 0) { md_sll_stack_pop(skip->free_frames); }                                 \
+		else            { frame = md_push_array__no_zero(skip->arena, MD_SetScanFrame, 1); }    \
+		frame->kind             = (work_kind);                                                   \
+		frame->counted_newlines = 0;                                                             \
+		frame->label            = (work_label);                                                  \
+		md_sll_stack_push(top, frame);                                                           \
+	} while (0)
+	#define skip_pop() do {                                      \
+		MD_SetScanFrame* frame = top;                            \
+		md_sll_stack_pop(top);                                   \
+		if (frame == &base) done = 1;                            \
+		else                md_sll_stack_push(skip->free_frames, frame); \
+	} while (0)
+	#define skip_error(msg_kind, string) do {                                                                                                    \
+		if (skip->msgs != 0) {                                                                                                                   \
+			MD_Node* error = md_push_node(skip->ainfo, MD_NodeKind_ErrorMarker, 0, token_string, token_string, token.range.md_min);              \
+			md_msg_list_push(skip->ainfo, skip->msgs, error, (msg_kind), (string));                                                               \
+		}                                                                                                                                        \
+	} while (0)
+
+	MD_Token token      = {0};
+	MD_U32   trivia     = 0;
+	MD_U64   trivia_idx = MD_MAX_U64;
+	for (;!done && md_parse__token(skip->tokens, token_idx, &token, &trivia);)
+	{
+		if (trivia_idx != token_idx)
+		{
+			trivia_idx = token_idx;
+			for (MD_U32 newline_idx = 0; !done && newline_idx < (trivia >> 1); newline_idx += 1)
+			{
+				for (;!done && top->kind == ParseWorkKind_NodeOptionalFollowUp;) {
+					skip_pop();
+				}
+				if      (done) {}
+				else if (top->kind == ParseWorkKind_NodeChildrenStyleScan) top->counted_newlines += 1;
+				else if (top->kind == ParseWorkKind_MainImplicit)          skip_pop();
+			}
+			if (done) {
+				break;
+			}
+		}
+
+		MD_String8    token_string = md_str8_substr(skip->text, token.range);
+		MD_TokenFlags reserved     = token.flags & MD_TokenFlagGroup_ReservedKind;
+		if (token.flags & (MD_TokenFlag_Whitespace | MD_TokenFlagGroup_Comment)) {
+			token_idx += 1;
+			continue;
+		}
+		switch (top->kind)
+		{
+			default: {} break;
+
+			case ParseWorkKind_NodeOptionalFollowUp:
+			{
+				if (reserved == MD_TokenFlag_Colon) {
+					top->kind  = ParseWorkKind_NodeChildrenStyleScan;
+					token_idx += 1;
+				}
+				else {
+					skip_pop();
+				}
+			}
+			break;
+
+			case ParseWorkKind_NodeChildrenStyleScan:
+			{
+				if (reserved & MD_TokenFlagGroup_Opener) {
+					top->kind  = ParseWorkKind_Main;
+					token_idx += 1;
+				}
+				else if (token.flags & MD_TokenFlag_Newline) {
+					top->counted_newlines += 1;
+					token_idx             += 1;
+				}
+				else if (top->counted_newlines >= 2) {
+					skip_error(MD_MsgKind_Warning, md_str8f(skip->ainfo, "More than two newlines following \"%S\", which has implicitly-delimited children, resulting in an empty list of children.", top->label));
+					skip_pop();
+				}
+				else {
+					top->kind = ParseWorkKind_MainImplicit;
+				}
+			}
+			break;
+
+			case ParseWorkKind_Main:
+			case ParseWorkKind_MainImplicit:
+			{
+				MD_B32 implicit = top->kind == ParseWorkKind_MainImplicit;
+				if ((reserved & MD_TokenFlagGroup_Separator) && implicit) {
+					skip_pop();
+				}
+				else if (reserved == MD_TokenFlag_Hash || reserved == MD_TokenFlag_Backslash || reserved == MD_TokenFlag_Colon) {
+					skip_error(MD_MsgKind_Error, md_str8f(skip->ainfo, "Unexpected reserved symbol \"%S\".", token_string));
+					token_idx += 1;
+				}
+				else if (reserved == MD_TokenFlag_At)
+				{
+					MD_Token name_token   = {0};
+					MD_Token paren_token  = {0};
+					MD_U32   name_trivia  = 0;
+					MD_U32   paren_trivia = 0;
+					MD_B32   has_name     = md_parse__token(skip->tokens, token_idx + 1, &name_token,  &name_trivia)  && name_trivia  == 0 && (name_token.flags  & MD_TokenFlagGroup_Label);
+					MD_B32   has_paren    = md_parse__token(skip->tokens, token_idx + 2, &paren_token, &paren_trivia) && paren_trivia == 0 && (paren_token.flags & MD_TokenFlag_ParenLeft);
+					if ( ! has_name) {
+						skip_error(MD_MsgKind_Error, md_str8_lit("Tag label expected after @ symbol."));
+					}
+					else if (has_paren) {
+						skip_push(ParseWorkKind_Main, md_str8_lit(""));
+					}
+					token_idx += has_name ? 2 + has_paren : 1;
+				}
+				else if ((reserved & MD_TokenFlagGroup_Opener) && ! implicit) {
+					skip_push(ParseWorkKind_Main, md_str8_lit(""));
+					token_idx += 1;
+				}
+				else if ((reserved & MD_TokenFlagGroup_Closer) && implicit) {
+					skip_pop();
+				}
+				else if (reserved & MD_TokenFlagGroup_Closer) {
+					*closer = token;
+					skip_pop();
+					token_idx += 1;
+				}
+				else if (reserved == 0 && (token.flags & MD_TokenFlagGroup_Label)) {
+					MD_String8 label = (skip->msgs != 0) ? content_string_from_token_flags_str8(token.flags, token_string) : md_str8_lit("");
+					skip_push(ParseWorkKind_NodeOptionalFollowUp, label);
+					token_idx += 1;
+				}
+				else if (reserved == 0 && (token.flags & MD_TokenFlag_Newline)) {
+					if (implicit) {
+						skip_pop();
+					}
+					token_idx += 1;
+				}
+				else if ((reserved & MD_TokenFlagGroup_Separator) == 0) {
+					// an opener in an implicit list, or a token that can't start a node
+					skip_error(MD_MsgKind_Error, md_str8f(skip->ainfo, "Unexpected \"%S\" token.", token_string));
+					token_idx += 1;
+				}
+				else {
+					token_idx += 1;
+				}
+			}
+			break;
+		}
+	}
+	for (;!done && top != &base;) {
+		skip_pop();
+	}
+	#undef skip_push
+	#undef skip_pop
+	#undef skip_error
+	return done ? token_idx : MD_MAX_U64;
+}
+
+// Ed: leaves a set's children unparsed, returns the token to resume from
+md_internal MD_U64
+md_parse__lazy_set(MD_LazyParse* lazy, MD_Node* node, MD_ParseSkip* skip, MD_U64 opener_idx, MD_Token opener)
+{
+	MD_Token closer = {0};
+	MD_U64   resume = md_parse__skip_work(skip, opener_idx + 1, ParseWorkKind_Main, md_str8_lit(""), &closer);
+	MD_B32   closed = resume != MD_MAX_U64;
+	if ( ! closed || resume > opener_idx + 2)
+	{
+		MD_LazySet*
+		set        = md_alloc_array(lazy->ainfo, MD_LazySet, 1);
+		set->parse = lazy;
+		set->range = md_r1u64(opener.range.md_max, closed ? closer.range.md_max : lazy->text.size);
+		node->lazy = set;
+	}
+	if (closed) {
+		node->flags |= md_parse__delimiter_flags(closer.flags & MD_TokenFlagGroup_ReservedKind);
+	}
+	return resume;
+}
+
+// Ed: whether a top-level node with these tags is kept by the filter
+md_internal MD_B32
+md_parse__filter_match(MD_ParseFilter* filter, MD_Node* first_tag)
+{
+	for md_each_node(tag, first_tag) {
+		for (MD_U64 idx = 0; idx < filter->tags.count; idx += 1) {
+			if (md_str8_match(tag->string, filter->tags.v[idx], 0)) {
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
+
+// NOTE(Ed): Parses tokens [token_first, token_opl) as children of root. With lazy set, explicitly delimited sets are
+// skipped over & left for md_node_materialize. With filter set, root's children without one of its tags are skipped over entirely.
+// Work still open at token_opl is settled on that token (which pops without consuming it, warnings included).
+// root_popped resumes as if a stray closer had already popped root's Main, that frame holds on to what it gathers from then on.
+// With atoms set, label & tag nodes get the atoms of their strings.
+// md_parse__skip_work mirrors the work stack here, keep them in sync.
+md_internal void
+md_parse__tokens_into(MD_AllocatorInfo ainfo, MD_String8 text, MD_ParseTokens* tokens, MD_U64 token_first, MD_U64 token_opl, MD_Node* root, MD_B32 root_popped, MD_LazyParse* lazy, MD_ParseFilter* filter, MD_AtomTable* atoms, MD_MsgList* msgs_out)
+{
+	// Ed: the tree may be built where a released one was (see md_tree_copy)
+	md_tree_generation_bump();
+
+	MD_TempArena scratch = md_scratch_begin(ainfo);
+	MD_MsgList   msgs    = *msgs_out;
+
+	// lazy sets report their errors once they're parsed
+	MD_ParseSkip skip = { tokens, scratch.arena, 0, ainfo, text, &msgs };
+	if (lazy != 0 || (filter != 0 && (filter->flags & MD_ParseFilterFlag_NoSkippedErrors))) {
+		skip.msgs = 0;
+	}
+	MD_B32 skipped_last = 0; // root's last child was filtered out
+	
+	//- rjf: set up parse rule stack
+	MD_ParseWorkNode  first_work  = { 0, ParseWorkKind_Main, root, md_nil_node(), md_nil_node() };
+	MD_ParseWorkNode  broken_work = { 0, ParseWorkKind_Main, root, md_nil_node(), md_nil_node() };
+	MD_ParseWorkNode* work_top    = root_popped ? &broken_work : &first_work;
+	MD_ParseWorkNode* work_free   = 0;
+
+	#define parse_work_push(work_kind, work_parent) md_parse__work_push(work_kind, work_parent, &work_top, &work_free, &scratch)
+	#define parse_work_pop()                        md_parse__work_pop (&work_top, &work_free, &broken_work, ainfo)
+	
+	//- rjf: parse
+	MD_Token token      = {0};
+	MD_U32   trivia     = 0;
+	MD_U64   trivia_idx = MD_MAX_U64;
+	for (MD_U64 token_idx = token_first; (token_idx < token_opl || work_top->parent != root) && md_parse__token(tokens, token_idx, &token, &trivia);)
+	{
+		//- Ed: newlines folded into the token -> each does what its newline token would have (once, the token may not be consumed this pass)
+		if (trivia_idx != token_idx)
+		{
+			trivia_idx = token_idx;
+			for (MD_U32 newline_idx = 0; newline_idx < (trivia >> 1); newline_idx += 1)
+			{
+				for (;work_top->kind == ParseWorkKind_NodeOptionalFollowUp;) {
+					parse_work_pop();
+				}
+				if (work_top->kind == ParseWorkKind_NodeChildrenStyleScan) {
+					work_top->counted_newlines += 1;
+				}
+				else if (work_top->kind == ParseWorkKind_MainImplicit) {
+					parse_work_pop();
+				}
+			}
+		}
+
+		//- rjf: unpack token
+		MD_String8    md_token_string = md_str8_substr(text, token.range);
+		MD_TokenFlags reserved        = token.flags & MD_TokenFlagGroup_ReservedKind;
+		MD_B32        newline_token   = token.flags & MD_TokenFlag_Newline;
+
+		// Note(Ed): Each of the the follwoing conditionals will always terminate the iteration path to end_consume label.
+		
+		// TODO(Ed): Add opt-in support for whitespace awareness
+		//- rjf: whitespace -> always no-op & inc
+		if (token.flags & MD_TokenFlag_Whitespace) {
+			token_idx += 1;
+			goto end_consume;
+			// <whitespace>
+		}
+		
+		// TODO(Ed): Add opt-in support for comment awareness
+		//- rjf: comments -> always no-op & inc
+		if (token.flags & MD_TokenFlagGroup_Comment) {
+			token_idx += 1;
+			goto end_consume;
+			// < // > <content> <unescaped newline>
+			// or 
+			// /* <content> */
+		}
+
+		//- Ed: dispatch on the work kind, then on which reserved symbol the token is (0 for everything else)
+		switch (work_top->kind)
+		{
+			default: {} break;
+
+			case ParseWorkKind_NodeOptionalFollowUp:
+			{
+				//- rjf: [node follow up] : following label -> work top parent has children. 
+				// we need to scan for explicit delimiters, else parse an implicitly delimited set of children
+				if (reserved == MD_TokenFlag_Colon) {
+					MD_Node* parent = work_top->parent;
+					parse_work_pop();
+					parse_work_push(ParseWorkKind_NodeChildrenStyleScan, parent);
+					token_idx += 1;
+					goto end_consume;
+					// .. <label> :
+				}
+				
+				//- rjf: [node follow up] anything but : following label -> node has no children.
+				// just pop & move on
+				parse_work_pop();
+				goto end_consume;
+				// .. <label> 
+			}
+
+			case ParseWorkKind_NodeChildrenStyleScan:
+			{
+				//- rjf: [node children style scan] {s, [s, and (s -> explicitly delimited children
+				if (reserved & MD_TokenFlagGroup_Opener)
+				{
+					MD_Node *parent = work_top->parent;
+					parent->flags |= md_parse__delimiter_flags(reserved);
+					parse_work_pop();
+					if (lazy != 0 && md_parse__can_defer_set(parent)) {
+						token_idx = md_parse__lazy_set(lazy, parent, &skip, token_idx, token);
+						goto end_consume;
+					}
+					parse_work_push(ParseWorkKind_Main, parent);
+					token_idx += 1;
+					goto end_consume;
+				}
+				
+				//- rjf: [node children style scan] count newlines
+				if (newline_token) {
+					work_top->counted_newlines += 1;
+					token_idx += 1;
+					goto end_consume;
+				}
+
+				//- rjf: [node children style scan] anything causing implicit set -> <2 newlines, all good,
+				// >=2 newlines, houston we have a problem
+				if (work_top->counted_newlines >= 2)
+				{
+					MD_Node*   node         = work_top->parent;
+					MD_Node*   error        = md_push_node(ainfo, MD_NodeKind_ErrorMarker, 0, md_token_string, md_token_string, token.range.md_min);
+					MD_String8 error_string = md_str8f(ainfo, "More than two newlines following \"%S\", which has implicitly-delimited children, resulting in an empty list of children.", node->string);
+					md_msg_list_push(ainfo, &msgs, error, MD_MsgKind_Warning, error_string);
+					parse_work_pop();
+				}
+				else
+				{
+					MD_Node *parent = work_top->parent;
+					parse_work_pop();
+					parse_work_push(ParseWorkKind_MainImplicit, parent);
+				}
+				goto end_consume;
+			}
+
+			case ParseWorkKind_Main:
+			case ParseWorkKind_MainImplicit:
+			{
+				MD_B32 implicit = work_top->kind == ParseWorkKind_MainImplicit;
+				switch (reserved)
+				{
+					case MD_TokenFlag_Comma:
+					case MD_TokenFlag_Semicolon:
+					{
+						//- rjf: [main_implicit] separators -> pop
+						if (implicit) {
+							parse_work_pop();
+							goto end_consume;
+						}
+
+						//- rjf: [main] separators -> mark & inc
+						MD_NodeFlags separator    = (reserved == MD_TokenFlag_Comma) ? MD_NodeFlag_IsBeforeComma : MD_NodeFlag_IsBeforeSemicolon;
+						MD_Node*     parent       = work_top->parent;
+						MD_B32       last_skipped = skipped_last && parent == root;
+						if (!md_node_is_nil(parent->last) || last_skipped)
+						{
+							// mark last & working noe with separator flag
+							if ( ! last_skipped) {
+								parent->last->flags |= separator;
+							}
+							work_top->gathered_node_flags |= separator;
+						}
+						token_idx += 1;
+						goto end_consume;
+						// <parent->last> , <work_top>
+						// or
+						// <parent->last> ; <work_top>
+					}
+
+					//- rjf: [main, main_implicit] unexpected reserved tokens
+					case MD_TokenFlag_Hash:
+					case MD_TokenFlag_Backslash:
+					case MD_TokenFlag_Colon:
+					{
+						MD_Node*   error        = md_push_node(ainfo, MD_NodeKind_ErrorMarker, 0, md_token_string, md_token_string, token.range.md_min);
+						MD_String8 error_string = md_str8f(ainfo, "Unexpected reserved symbol \"%S\".", md_token_string);
+						md_msg_list_push(ainfo, &msgs, error, MD_MsgKind_Error, error_string);
+						token_idx += 1;
+						goto end_consume;
+					}
+
+					//- rjf: [main, main_implicit] tag signifier -> create new tag
+					case MD_TokenFlag_At:
+					{
+						// MD_Token after should be label.
+						MD_Token tag_name_token  = {0};
+						MD_U32   tag_name_trivia = 0;
+						md_parse__token(tokens, token_idx + 1, &tag_name_token, &tag_name_trivia);
+						if (tag_name_trivia != 0 || ! (tag_name_token.flags & MD_TokenFlagGroup_Label))
+						{
+							MD_Node*   error        = md_push_node(ainfo, MD_NodeKind_ErrorMarker, 0, md_token_string, md_token_string, token.range.md_min);
+							MD_String8 error_string = md_str8_lit("Tag label expected after @ symbol.");
+							md_msg_list_push(ainfo, &msgs, error, MD_MsgKind_Error, error_string);
+
+							token_idx += 1;
+							goto end_consume;
+							 // <Tag> : @ <???> (was not label)
+						}
+
+						MD_String8 tag_name_raw = md_str8_substr(text, tag_name_token.range);
+						MD_String8 tag_name     = content_string_from_token_flags_str8(tag_name_token.flags, tag_name_raw);
+
+						MD_Node* node = md_push_node(ainfo, MD_NodeKind_Tag, md_node_flags_from_token_flags(tag_name_token.flags), tag_name, tag_name_raw, token.range.md_min);
+						if (atoms != 0) {
+							node->atom = md_atom_from_str8(atoms, tag_name);
+						}
+						md_dll_push_back_npz(md_nil_node(), work_top->first_gathered_tag, work_top->last_gathered_tag, node, next, prev);
+
+						MD_Token paren_token  = {0};
+						MD_U32   paren_trivia = 0;
+						md_parse__token(tokens, token_idx + 2, &paren_token, &paren_trivia);
+						if (paren_trivia == 0 && (paren_token.flags & MD_TokenFlag_ParenLeft)) {
+							token_idx += 3;
+							parse_work_push(ParseWorkKind_Main, node);
+							// <Tag> : @ <TagName> ( 
+						}
+						else {
+							token_idx += 2;
+							// <Tag> : @ <TagName>
+						}
+						goto end_consume;
+					}
+
+					//- rjf: [main] {s, [s, and (s -> create new main
+					case MD_TokenFlag_BraceLeft:
+					case MD_TokenFlag_BracketLeft:
+					case MD_TokenFlag_ParenLeft:
+					{
+						if (implicit) {
+							break;
+						}
+
+						//- Ed: [main] filtered out -> skip past the closer
+						if (filter != 0 && work_top->parent == root && ! md_parse__filter_match(filter, work_top->first_gathered_tag))
+						{
+							MD_Token closer = {0};
+							work_top->gathered_node_flags = 0;
+							work_top->first_gathered_tag  = work_top->last_gathered_tag = md_nil_node();
+							skipped_last = 1;
+							token_idx    = md_parse__skip_work(&skip, token_idx + 1, ParseWorkKind_Main, md_str8_lit(""), &closer);
+							goto end_consume;
+						}
+
+						MD_NodeFlags 
+						flags  = md_node_flags_from_token_flags(token.flags) | work_top->gathered_node_flags;
+						flags |= md_parse__delimiter_flags(reserved);
+
+						work_top->gathered_node_flags = 0;
+
+						MD_Node* 
+						node = md_push_node(ainfo, MD_NodeKind_Main, flags, md_str8_lit(""), md_str8_lit(""), token.range.md_min);
+						node->first_tag = work_top->first_gathered_tag;
+						node->last_tag  = work_top->last_gathered_tag;
+						for (MD_Node* tag = work_top->first_gathered_tag; !md_node_is_nil(tag); tag = tag->next) {
+							tag->parent       = node;
+							node->tag_filter |= md_tag_filter_from_str8(tag->string);
+						}
+						work_top->first_gathered_tag = work_top->last_gathered_tag = md_nil_node();
+
+						// Ed: not md_node_push_child, nothing can have looked into a tree that's still being built (see MD_LookupPath)
+						node->parent = work_top->parent;
+						md_dll_push_back_npz(md_nil_node(), work_top->parent->first, work_top->parent->last, node, next, prev);
+						work_top->child_count += 1;
+						skipped_last &= node->parent != root;
+						if (lazy != 0 && md_parse__can_defer_set(node)) {
+							token_idx = md_parse__lazy_set(lazy, node, &skip, token_idx, token);
+							goto end_consume;
+						}
+						parse_work_push(ParseWorkKind_Main, node);
+						token_idx += 1;
+						goto end_consume;
+						// <main label> : 
+					}
+
+					case MD_TokenFlag_BraceRight:
+					case MD_TokenFlag_BracketRight:
+					case MD_TokenFlag_ParenRight:
+					{
+						//- rjf: [main implicit] }s, ]s, and )s -> pop without advancing
+						if (implicit) {
+							parse_work_pop();
+							goto end_consume;
+							// (deferred)
+						}
+
+						//- rjf: [main] }s, ]s, and )s -> pop
+						MD_Node* parent = work_top->parent;
+						parent->flags |= md_parse__delimiter_flags(reserved);
+						parse_work_pop();
+						token_idx += 1;
+						goto end_consume;
+						// <label> }
+						// or
+						// <label> ]
+						// or
+						// <label> )
+					}
+
+					case 0:
+					{
+						//- rjf: [main, main_implicit] label -> create new main
+						if (token.flags & MD_TokenFlagGroup_Label)
+						{
+							MD_String8   md_node_string_raw = md_token_string;
+							MD_String8   md_node_string     = content_string_from_token_flags_str8(token.flags, md_node_string_raw);
+
+							//- Ed: [main, main_implicit] filtered out -> skip the label & whatever children follow it
+							if (filter != 0 && work_top->parent == root && ! md_parse__filter_match(filter, work_top->first_gathered_tag))
+							{
+								MD_Token closer = {0};
+								work_top->gathered_node_flags = 0;
+								work_top->first_gathered_tag  = work_top->last_gathered_tag = md_nil_node();
+								skipped_last = 1;
+								token_idx    = md_parse__skip_work(&skip, token_idx + 1, ParseWorkKind_NodeOptionalFollowUp, md_node_string, &closer);
+								goto end_consume;
+							}
+
+							MD_NodeFlags flags              = md_node_flags_from_token_flags(token.flags)|work_top->gathered_node_flags;
+
+							work_top->gathered_node_flags = 0;
+
+							MD_Node* node = md_push_node(ainfo, MD_NodeKind_Main, flags, md_node_string, md_node_string_raw, token.range.md_min);
+							if (atoms != 0) {
+								node->atom = md_atom_from_str8(atoms, md_node_string);
+							}
+							node->first_tag = work_top->first_gathered_tag;
+							node->last_tag  = work_top->last_gathered_tag;
+							for (MD_Node* tag = work_top->first_gathered_tag; !md_node_is_nil(tag); tag = tag->next) {
+								tag->parent       = node;
+								node->tag_filter |= md_tag_filter_from_str8(tag->string);
+							}
+							work_top->first_gathered_tag = work_top->last_gathered_tag = md_nil_node();
+
+							node->parent = work_top->parent;
+							md_dll_push_back_npz(md_nil_node(), work_top->parent->first, work_top->parent->last, node, next, prev);
+							work_top->child_count += 1;
+							skipped_last &= node->parent != root;
+							parse_work_push(ParseWorkKind_NodeOptionalFollowUp, node);
+							token_idx += 1;
+							goto end_consume;
+						}
+
+						//- rjf: [main_implicit] newline -> pop
+						if (implicit && newline_token) {
+							parse_work_pop();
+							token_idx += 1;
+							goto end_consume;
+						}
+
+						//- rjf: [main] newline -> no-op & inc
+						if (newline_token) {
+							token_idx += 1;
+							goto end_consume;
+						}
+					}
+					break;
+				}
+			}
+			break;
+		}
+		
+		//- rjf: no consumption -> unexpected token! we don't know what to do with this.
+		{
+			MD_Node*   error        = md_push_node(ainfo, MD_NodeKind_ErrorMarker, 0, md_token_string, md_token_string, token.range.md_min);
+			MD_String8 error_string = md_str8f(ainfo, "Unexpected \"%S\" token.", md_token_string);
+			md_msg_list_push(ainfo, &msgs, error, MD_MsgKind_Error, error_string);
+			token_idx += 1;
+			// ???
+		}
+		
+		end_consume:;
+	}
+
+	// Ed: a range of a parallel parse (token_opl is the only thing that tells) is spliced into the file root, which is indexed after
+	if (token_opl == MD_MAX_U64 && first_work.child_count + broken_work.child_count >= MD_CHILD_INDEX_THRESHOLD) {
+		md_child_index_from_node(ainfo, root);
+	}
+	
+	*msgs_out = msgs;
+	scratch_end(scratch);
+}
+
+md_internal MD_ParseResult
+md_parse__tokens(MD_AllocatorInfo ainfo, MD_String8 filename, MD_String8 text, MD_ParseTokens* tokens)
+{
+	MD_ParseResult result = {0};
+	result.root = md_push_node(ainfo, MD_NodeKind_File, 0, filename, text, 0);
+	md_parse__tokens_into(ainfo, text, tokens, 0, MD_MAX_U64, result.root, 0, 0, 0, 0, &result.msgs);
+	return result;
+}
+
+#undef parse_work_push
+#undef parse_work_pop
+
+MD_ParseResult
+md_parse_from_text_tokens__ainfo(MD_AllocatorInfo ainfo, MD_String8 filename, MD_String8 text, MD_TokenArray tokens) {
+	MD_ParseTokens parse_tokens = {0};
+	parse_tokens.v     = tokens.v;
+	parse_tokens.count = tokens.count;
+	return md_parse__tokens(ainfo, filename, text, &parse_tokens);
+}
+
+MD_ParseResult
+md_parse_from_text_compact_tokens__ainfo(MD_AllocatorInfo ainfo, MD_String8 filename, MD_String8 text, MD_CompactTokenArray tokens) {
+	MD_ParseTokens parse_tokens = {0};
+	parse_tokens.compact = tokens;
+	parse_tokens.count   = tokens.count;
+	return md_parse__tokens(ainfo, filename, text, &parse_tokens);
+}
+
+MD_ParseResult
+md_parse_from_text_significant_tokens__ainfo(MD_AllocatorInfo ainfo, MD_String8 filename, MD_String8 text, MD_SignificantTokenArray tokens) {
+	MD_ParseTokens parse_tokens = {0};
+	parse_tokens.significant = tokens.v;
+	parse_tokens.count       = tokens.count;
+	return md_parse__tokens(ainfo, filename, text, &parse_tokens);
+}
+
+MD_ParseResult
+md_parse_from_text_fused__ainfo(MD_AllocatorInfo ainfo, MD_String8 filename, MD_String8 text) {
+	MD_TempArena    scratch = md_scratch_begin(ainfo);
+	MD_TokenCursor* cursor  = md_push_array__no_zero(scratch.arena, MD_TokenCursor, 1);
+	md_token_cursor_init(cursor, text);
+
+	MD_ParseTokens parse_tokens = {0};
+	parse_tokens.cursor = cursor;
+	MD_ParseResult parse = md_parse__tokens(ainfo, filename, text, &parse_tokens);
+	scratch_end(scratch);
+	return parse;
+}
+
+MD_ParseResult
+md_parse_filtered_from_text__ainfo(MD_AllocatorInfo ainfo, MD_String8 filename, MD_String8 text, MD_ParseFilter filter) {
+	MD_TempArena    scratch = md_scratch_begin(ainfo);
+	MD_TokenCursor* cursor  = md_push_array__no_zero(scratch.arena, MD_TokenCursor, 1);
+	md_token_cursor_init(cursor, text);
+
+	MD_ParseTokens parse_tokens = {0};
+	parse_tokens.cursor = cursor;
+	MD_ParseResult parse = {0};
+	parse.root = md_push_node(ainfo, MD_NodeKind_File, 0, filename, text, 0);
+	md_parse__tokens_into(ainfo, text, &parse_tokens, 0, MD_MAX_U64, parse.root, 0, 0, &filter, 0, &parse.msgs);
+	scratch_end(scratch);
+	return parse;
+}
+
+////////////////////////////////
+//~ rjf: Bundled Text -> Tree Functions
+
+MD_ParseResult
+md_parse_from_text__ainfo(MD_AllocatorInfo ainfo, MD_String8 filename, MD_String8 text) {
+	MD_ParseResult parse = md_parse_from_text_fused__ainfo(ainfo, filename, text);
+	return parse;
+}
+
+MD_ParseResult
+md_parse_from_text_atoms__ainfo(MD_AllocatorInfo ainfo, MD_AtomTable* atoms, MD_String8 filename, MD_String8 text) {
+	MD_TempArena    scratch = md_scratch_begin(ainfo);
+	MD_TokenCursor* cursor  = md_push_array__no_zero(scratch.arena, MD_TokenCursor, 1);
+	md_token_cursor_init(cursor, text);
+
+	MD_ParseTokens parse_tokens = {0};
+	parse_tokens.cursor = cursor;
+	MD_ParseResult parse = {0};
+	parse.root = md_push_node(ainfo, MD_NodeKind_File, 0, filename, text, 0);
+	md_parse__tokens_into(ainfo, text, &parse_tokens, 0, MD_MAX_U64, parse.root, 0, 0, 0, atoms, &parse.msgs);
+	scratch_end(scratch);
+	return parse;
+}
+
+////////////////////////////////
+//~ Ed: Flat Tree Functions
+
+typedef struct MD_FlatTreeFrame MD_FlatTreeFrame;
+struct MD_FlatTreeFrame
+{
+	MD_Node*    node;
+	MD_FlatNode idx;
+	MD_FlatNode last; // last tag or child linked so far
+};
+
+// Pre-order step within root's subtree, visiting a node's tags before its children
+md_internal MD_Node*
+md_flat_tree__next_pre(MD_Node* node, MD_Node* root)
+{
+	if ( ! md_node_is_nil(node->first_tag)) return node->first_tag;
+	if ( ! md_node_is_nil(md_node_first(node))) return node->first;
+	for (MD_Node* n = node; !md_node_is_nil(n) && n != root; n = n->parent)
+	{
+		if ( ! md_node_is_nil(n->next)) {
+			return n->next;
+		}
+		MD_Node* parent = n->parent;
+		if (n == parent->last_tag && ! md_node_is_nil(md_node_first(parent))) {
+			return parent->first;
+		}
+	}
+	return md_nil_node();
+}
+
+md_internal MD_B32
+md_flat_tree__string_in_text(MD_String8 text, MD_String8 string) {
+	return string.str >= text.str && string.str + string.size <= text.str + text.size;
+}
+
+md_internal void
+md_flat_tree__store_string(MD_FlatTree* tree, MD_U64* extra_size, MD_String8 string, MD_U32* offset, MD_U32* size)
+{
+	*size = (MD_U32)string.size;
+	if (string.size == 0) {
+		*offset = 0;
+	}
+	else if (md_flat_tree__string_in_text(tree->text, string)) {
+		*offset = (MD_U32)(string.str - tree->text.str);
+	}
+	else {
+		md_memory_copy(tree->extra.str + *extra_size, string.str, string.size);
+		*offset      = (MD_U32)(tree->text.size + *extra_size);
+		*extra_size += string.size;
+	}
+}
+
+// Ed: node count of the flat tree of root (nil included) & the bytes of strings that live outside of text
+md_internal MD_U64
+md_flat_tree__measure(MD_Node* root, MD_String8 text, MD_U64* extra_size)
+{
+	MD_U64 count = 1;
+	*extra_size  = 0;
+	for (MD_Node* node = root; !md_node_is_nil(node); node = md_flat_tree__next_pre(node, root))
+	{
+		count += 1;
+		if ( ! md_flat_tree__string_in_text(text, node->string)) {
+			*extra_size += node->string.size;
+		}
+		MD_B32 raw_is_string = node->raw_string.str == node->string.str && node->raw_string.size == node->string.size;
+		if ( ! raw_is_string && ! md_flat_tree__string_in_text(text, node->raw_string)) {
+			*extra_size += node->raw_string.size;
+		}
+	}
+	return count;
+}
+
+MD_FlatTree
+md_flat_tree_from_node__ainfo(MD_AllocatorInfo ainfo, MD_Node* root, MD_String8 text)
+{
+	MD_FlatTree tree = {0};
+	tree.text = text;
+
+	//- Ed: count nodes & the bytes of strings that live outside of text
+	MD_U64 extra_size = 0;
+	tree.count = md_flat_tree__measure(root, text, &extra_size);
+	md_assert(text.size + extra_size <= MD_MAX_U32);
+	md_assert(tree.count             <= MD_MAX_U32);
+
+	tree.kinds          = md_alloc_array(ainfo, MD_U8,        tree.count);
+	tree.flags          = md_alloc_array(ainfo, MD_NodeFlags, tree.count);
+	tree.string_offsets = md_alloc_array(ainfo, MD_U32,       tree.count);
+	tree.string_sizes   = md_alloc_array(ainfo, MD_U32,       tree.count);
+	tree.raw_offsets    = md_alloc_array(ainfo, MD_U32,       tree.count);
+	tree.raw_sizes      = md_alloc_array(ainfo, MD_U32,       tree.count);
+	tree.src_offsets    = md_alloc_array(ainfo, MD_U32,       tree.count);
+	tree.parents        = md_alloc_array(ainfo, MD_FlatNode,  tree.count);
+	tree.firsts         = md_alloc_array(ainfo, MD_FlatNode,  tree.count);
+	tree.nexts          = md_alloc_array(ainfo, MD_FlatNode,  tree.count);
+	tree.first_tags     = md_alloc_array(ainfo, MD_FlatNode,  tree.count);
+	tree.extra.str      = md_alloc_array_no_zero(ainfo, MD_U8, extra_size);
+	tree.extra.size     = extra_size;
+	if (tree.count == 1) {
+		return tree;
+	}
+
+	//- Ed: fill, keeping the chain of ancestors to link each node onto its parent's last tag or child
+	MD_TempArena      scratch     = md_scratch_begin(ainfo);
+	MD_FlatTreeFrame* stack       = md_push_array__no_zero(scratch.arena, MD_FlatTreeFrame, tree.count);
+	MD_U64            stack_count = 0;
+	MD_U64            extra_pos   = 0;
+	MD_FlatNode       idx         = 1;
+	for (MD_Node* node = root; !md_node_is_nil(node); node = md_flat_tree__next_pre(node, root), idx += 1)
+	{
+		tree.kinds      [idx] = (MD_U8)node->kind;
+		tree.flags      [idx] = node->flags;
+		tree.src_offsets[idx] = (MD_U32)node->src_offset;
+		md_flat_tree__store_string(&tree, &extra_pos, node->string, &tree.string_offsets[idx], &tree.string_sizes[idx]);
+		if (node->raw_string.str == node->string.str && node->raw_string.size == node->string.size) {
+			tree.raw_offsets[idx] = tree.string_offsets[idx];
+			tree.raw_sizes  [idx] = tree.string_sizes  [idx];
+		}
+		else {
+			md_flat_tree__store_string(&tree, &extra_pos, node->raw_string, &tree.raw_offsets[idx], &tree.raw_sizes[idx]);
+		}
+
+		if (node != root)
+		{
+			while (stack[stack_count - 1].node != node->parent) {
+				stack_count -= 1;
+			}
+			MD_FlatTreeFrame* parent = &stack[stack_count - 1];
+			tree.parents[idx] = parent->idx;
+			if      (node == node->parent->first_tag) tree.first_tags[parent->idx] = idx;
+			else if (node == node->parent->first)     tree.firsts    [parent->idx] = idx;
+			else                                      tree.nexts     [parent->last] = idx;
+			parent->last = idx;
+		}
+		stack[stack_count].node = node;
+		stack[stack_count].idx  = idx;
+		stack[stack_count].last = 0;
+		stack_count += 1;
+	}
+	scratch_end(scratch);
+	return tree;
+}
+
+MD_Node*
+md_node_from_flat_tree__ainfo(MD_AllocatorInfo ainfo, MD_FlatTree* tree)
+{
+	if (tree->count <= 1) {
+		return md_nil_node();
+	}
+	md_tree_generation_bump();
+	MD_Node* nodes = md_alloc_array(ainfo, MD_Node, tree->count);
+	for (MD_FlatNode idx = 1; idx < tree->count; idx += 1)
+	{
+		MD_Node*
+		node             = &nodes[idx];
+		node->first      = node->last = node->parent = node->next = node->prev = node->first_tag = node->last_tag = md_nil_node();
+		node->kind       = (MD_NodeKind)tree->kinds[idx];
+		node->flags      = tree->flags[idx];
+		node->string     = md_flat_node_string    (tree, idx);
+		node->raw_string = md_flat_node_raw_string(tree, idx);
+		node->src_offset = tree->src_offsets[idx];
+
+		// nodes come in pre-order, so pushing onto the back keeps each chain's order
+		MD_FlatNode parent_idx = tree->parents[idx];
+		if (parent_idx != 0)
+		{
+			MD_Node* parent = &nodes[parent_idx];
+			node->parent    = parent;
+			MD_B32 is_tag   = tree->firsts[parent_idx] == 0 || idx < tree->firsts[parent_idx];
+			if (is_tag) {
+				parent->tag_filter |= md_tag_filter_from_str8(node->string);
+				md_dll_push_back_npz(md_nil_node(), parent->first_tag, parent->last_tag, node, next, prev);
+			}
+			else md_dll_push_back_npz(md_nil_node(), parent->first, parent->last, node, next, prev);
+		}
+	}
+	for (MD_FlatNode idx = 1; idx < tree->count; idx += 1) {
+		md_child_index__build_if_wide(ainfo, &nodes[idx]);
+	}
+	return &nodes[1];
+}
+
+MD_FlatParseResult
+md_parse_flat_from_text__ainfo(MD_AllocatorInfo ainfo, MD_String8 filename, MD_String8 text)
+{
+	MD_TempArena   scratch = md_scratch_begin(ainfo);
+	MD_ParseResult parse   = md_parse_from_text(scratch.arena, filename, text);
+
+	MD_FlatParseResult result = {0};
+	result.tree = md_flat_tree_from_node(ainfo, parse.root, text);
+
+	// messages (and the nodes they point at) were made in scratch
+	for (MD_Msg* msg = parse.msgs.first; msg != 0; msg = msg->next)
+	{
+		MD_Node*   src_node = msg->node;
+		MD_String8 string   = src_node->string;
+		MD_String8 raw      = src_node->raw_string;
+		if ( ! md_flat_tree__string_in_text(text, string)) string = md_str8_copy(ainfo, string);
+		if ( ! md_flat_tree__string_in_text(text, raw))    raw    = md_str8_copy(ainfo, raw);
+		MD_Node* node = md_push_node(ainfo, src_node->kind, src_node->flags, string, raw, src_node->src_offset);
+		md_msg_list_push(ainfo, &result.msgs, node, msg->kind, md_str8_copy(ainfo, msg->string));
+	}
+	scratch_end(scratch);
+	return result;
+}
+
+////////////////////////////////
+//~ Ed: Flat Tree File Functions
+
+// Size of one node's element in each array section (the strings section is sized by the header)
+md_global MD_U64 md_flat_tree_file__element_sizes[MD_FlatTreeSection_COUNT] = {
+	sizeof(MD_U8),       sizeof(MD_NodeFlags), sizeof(MD_U32),      sizeof(MD_U32),
+	sizeof(MD_U32),      sizeof(MD_U32),       sizeof(MD_U32),      sizeof(MD_FlatNode),
+	sizeof(MD_FlatNode), sizeof(MD_FlatNode),  sizeof(MD_FlatNode), 0,
+};
+
+md_internal MD_U64
+md_flat_tree_file__section_size(MD_FlatTreeFileHeader* header, MD_FlatTreeSection section) {
+	if (section == MD_FlatTreeSection_Strings) {
+		return header->text_size + header->extra_size;
+	}
+	return header->count * md_flat_tree_file__element_sizes[section];
+}
+
+// Fills the header's section offsets, returns the size of the whole file
+md_internal MD_U64
+md_flat_tree_file__layout(MD_FlatTreeFileHeader* header)
+{
+	MD_U64 pos = sizeof(MD_FlatTreeFileHeader);
+	for (md_each_enum_val(MD_FlatTreeSection, section)) {
+		pos                              = md_align_pow2(pos, 8);
+		header->section_offsets[section] = pos;
+		pos                             += md_flat_tree_file__section_size(header, section);
+	}
+	return pos;
+}
+
+MD_String8List
+md_flat_tree_file_parts__ainfo(MD_AllocatorInfo ainfo, MD_FlatTree* tree)
+{
+	MD_String8List parts = {0};
+
+	MD_FlatTreeFileHeader*
+	header             = md_alloc_array(ainfo, MD_FlatTreeFileHeader, 1);
+	header->magic      = MD_FLAT_TREE_FILE_MAGIC;
+	header->version    = MD_FLAT_TREE_FILE_VERSION;
+	header->count      = tree->count;
+	header->text_size  = tree->text.size;
+	header->extra_size = tree->extra.size;
+	MD_U64 file_size   = md_flat_tree_file__layout(header);
+	md_str8_list_push(ainfo, &parts, md_str8((MD_U8*)header, sizeof(*header)));
+
+	void* sections[MD_FlatTreeSection_COUNT] = {
+		tree->kinds, tree->flags, tree->string_offsets, tree->string_sizes, tree->raw_offsets, tree->raw_sizes,
+		tree->src_offsets, tree->parents, tree->firsts, tree->nexts, tree->first_tags, 0,
+	};
+	md_local_persist MD_U8 zeroes[8] = {0};
+	for (md_each_enum_val(MD_FlatTreeSection, section))
+	{
+		MD_U64 padding = header->section_offsets[section] - parts.total_size;
+		if (padding > 0) {
+			md_str8_list_push(ainfo, &parts, md_str8(zeroes, padding));
+		}
+		if (section == MD_FlatTreeSection_Strings) {
+			md_str8_list_push(ainfo, &parts, tree->text);
+			md_str8_list_push(ainfo, &parts, tree->extra);
+		}
+		else {
+			md_str8_list_push(ainfo, &parts, md_str8((MD_U8*)sections[section], md_flat_tree_file__section_size(header, section)));
+		}
+	}
+	md_assert(parts.total_size == file_size);
+	return parts;
+}
+
+MD_B32
+md_flat_tree_write_to_file_path(MD_FlatTree* tree, MD_String8 path)
+{
+	MD_TempArena   scratch = md_scratch_begin(0, 0);
+	MD_String8List parts   = md_flat_tree_file_parts(scratch.arena, tree);
+	MD_B32         result  = md_os_write_data_list_to_file_path(path, parts);
+	scratch_end(scratch);
+	return result;
+}
+
+MD_FlatTree
+md_flat_tree_from_file_data(MD_String8 data)
+{
+	MD_FlatTree tree = {0};
+
+	//- Ed: check the header, then that the layout it describes is the one we'd write & fits in data
+	MD_FlatTreeFileHeader* header = (MD_FlatTreeFileHeader*)data.str;
+	if (data.size < sizeof(MD_FlatTreeFileHeader)          ||
+		header->magic   != MD_FLAT_TREE_FILE_MAGIC         ||
+		header->version != MD_FLAT_TREE_FILE_VERSION       ||
+		header->count      == 0 || header->count      > MD_MAX_U32 ||
+		header->text_size  > MD_MAX_U32 || header->extra_size > MD_MAX_U32) {
+		return tree;
+	}
+	MD_FlatTreeFileHeader layout = *header;
+	MD_U64 file_size = md_flat_tree_file__layout(&layout);
+	if (file_size > data.size || md_memory_compare(layout.section_offsets, header->section_offsets, sizeof(layout.section_offsets)) != 0) {
+		return tree;
+	}
+
+	MD_U8* base = data.str;
+	MD_U8* strings      = base + header->section_offsets[MD_FlatTreeSection_Strings];
+	tree.text           = md_str8(strings,                     header->text_size);
+	tree.extra          = md_str8(strings + header->text_size, header->extra_size);
+	tree.count          = header->count;
+	tree.kinds          = (MD_U8*)       (base + header->section_offsets[MD_FlatTreeSection_Kinds]);
+	tree.flags          = (MD_NodeFlags*)(base + header->section_offsets[MD_FlatTreeSection_Flags]);
+	tree.string_offsets = (MD_U32*)      (base + header->section_offsets[MD_FlatTreeSection_StringOffsets]);
+	tree.string_sizes   = (MD_U32*)      (base + header->section_offsets[MD_FlatTreeSection_StringSizes]);
+	tree.raw_offsets    = (MD_U32*)      (base + header->section_offsets[MD_FlatTreeSection_RawOffsets]);
+	tree.raw_sizes      = (MD_U32*)      (base + header->section_offsets[MD_FlatTreeSection_RawSizes]);
+	tree.src_offsets    = (MD_U32*)      (base + header->section_offsets[MD_FlatTreeSection_SrcOffsets]);
+	tree.parents        = (MD_FlatNode*) (base + header->section_offsets[MD_FlatTreeSection_Parents]);
+	tree.firsts         = (MD_FlatNode*) (base + header->section_offsets[MD_FlatTreeSection_Firsts]);
+	tree.nexts          = (MD_FlatNode*) (base + header->section_offsets[MD_FlatTreeSection_Nexts]);
+	tree.first_tags     = (MD_FlatNode*) (base + header->section_offsets[MD_FlatTreeSection_FirstTags]);
+	if ( ! md_flat_tree_validate(&tree)) {
+		md_memory_zero_struct(&tree);
+	}
+	return tree;
+}
+
+// Ed: offset & size are checked against the half md_flat_tree__string reads them from
+md_internal MD_B32
+md_flat_tree__string_is_valid(MD_FlatTree* tree, MD_U32 offset, MD_U32 size) {
+	if (offset < tree->text.size) {
+		return (MD_U64)offset + size <= tree->text.size;
+	}
+	return (MD_U64)offset + size <= tree->text.size + tree->extra.size;
+}
+
+MD_B32
+md_flat_tree_validate(MD_FlatTree* tree)
+{
+	if (tree->count == 0 || tree->count > MD_MAX_U32) {
+		return 0;
+	}
+	if (tree->parents[0] != 0 || tree->firsts[0] != 0 || tree->nexts[0] != 0 || tree->first_tags[0] != 0) {
+		return 0;
+	}
+	for (MD_U64 idx = 1; idx < tree->count; idx += 1)
+	{
+		MD_FlatNode parent     = tree->parents   [idx];
+		MD_FlatNode first      = tree->firsts    [idx];
+		MD_FlatNode next       = tree->nexts     [idx];
+		MD_FlatNode first_tag  = tree->first_tags[idx];
+		MD_B32      links_fit  = (idx == 1 ? parent == 0 : parent != 0 && parent < idx) &&
+			(first     == 0 || (first     > idx && first     < tree->count)) &&
+			(next      == 0 || (next      > idx && next      < tree->count)) &&
+			(first_tag == 0 || (first_tag > idx && first_tag < tree->count));
+		MD_B32 fields_fit = tree->kinds[idx] < MD_NodeKind_COUNT &&
+			md_flat_tree__string_is_valid(tree, tree->string_offsets[idx], tree->string_sizes[idx]) &&
+			md_flat_tree__string_is_valid(tree, tree->raw_offsets   [idx], tree->raw_sizes   [idx]);
+		if ( ! links_fit || ! fields_fit) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+MD_FlatTreeMap
+md_flat_tree_map_open(MD_String8 path)
+{
+	MD_FlatTreeMap result = {0};
+	result.file = md_os_file_open(MD_OS_AccessFlag_Read | MD_OS_AccessFlag_ShareRead, path);
+	if (md_os_handle_match(result.file, md_os_handle_zero())) {
+		return result;
+	}
+	MD_U64 size  = md_os_properties_from_file(result.file).size;
+	result.map   = md_os_file_map_open(MD_OS_AccessFlag_Read, result.file);
+	result.range = md_r1u64(0, size);
+	if (size > 0 && ! md_os_handle_match(result.map, md_os_handle_zero())) {
+		result.view = md_os_file_map_view_open(result.map, MD_OS_AccessFlag_Read, result.range);
+	}
+	if (result.view != 0) {
+		result.tree = md_flat_tree_from_file_data(md_str8((MD_U8*)result.view, size));
+	}
+	return result;
+}
+
+void
+md_flat_tree_map_close(MD_FlatTreeMap* map)
+{
+	if (map->view != 0) {
+		md_os_file_map_view_close(map->map, map->view, map->range);
+	}
+	if ( ! md_os_handle_match(map->map, md_os_handle_zero())) {
+		md_os_file_map_close(map->map);
+	}
+	if ( ! md_os_handle_match(map->file, md_os_handle_zero())) {
+		md_os_file_close(map->file);
+	}
+	md_memory_zero_struct(map);
+}
+
+////////////////////////////////
+//~ Ed: Lazy Parse Functions
+
+MD_LazyParseResult
+md_parse_lazy_from_text__ainfo(MD_AllocatorInfo ainfo, MD_String8 filename, MD_String8 text)
+{
+	MD_LazyParseResult result = {0};
+	result.root       = md_push_node(ainfo, MD_NodeKind_File, 0, filename, text, 0);
+	result.lazy       = md_alloc_array(ainfo, MD_LazyParse, 1);
+	result.lazy->ainfo = ainfo;
+	result.lazy->text  = text;
+
+	MD_TempArena    scratch = md_scratch_begin(ainfo);
+	MD_TokenCursor* cursor  = md_push_array__no_zero(scratch.arena, MD_TokenCursor, 1);
+	md_token_cursor_init(cursor, text);
+
+	MD_ParseTokens parse_tokens = {0};
+	parse_tokens.cursor = cursor;
+	md_parse__tokens_into(ainfo, text, &parse_tokens, 0, MD_MAX_U64, result.root, 0, result.lazy, 0, 0, &result.lazy->msgs);
+	scratch_end(scratch);
+	return result;
+}
+
+void
+md_node_materialize(MD_Node* node)
+{
+	MD_LazySet* set = node->has_child_index ? 0 : node->lazy;
+	if (set == 0) {
+		return;
+	}
+	node->lazy = 0;
+
+	// lexing is stateless, so a fresh cursor over the set's span gives the same tokens as the whole text did.
+	// The closer is parsed too, it settles whatever the set's last child left pending (with the same warnings).
+	MD_LazyParse*   lazy    = set->parse;
+	MD_TempArena    scratch = md_scratch_begin(lazy->ainfo);
+	MD_TokenCursor* cursor  = md_push_array__no_zero(scratch.arena, MD_TokenCursor, 1);
+	md_token_cursor_init(cursor, md_str8_prefix(lazy->text, set->range.md_max));
+	cursor->lex_offset = set->range.md_min;
+
+	MD_ParseTokens parse_tokens = {0};
+	parse_tokens.cursor = cursor;
+	md_parse__tokens_into(lazy->ainfo, lazy->text, &parse_tokens, 0, MD_MAX_U64, node, 0, lazy, 0, 0, &lazy->msgs);
+	lazy->sets_parsed += 1;
+	scratch_end(scratch);
+}
+
+////////////////////////////////
+//~ Ed: Parallel Tokens -> Tree Functions
+
+// NOTE(Ed): Top-level nodes don't share any parse state once the work stack is back down to the file's Main with nothing
+// gathered (no tags or separator flags waiting on the next node), short of whether a stray closer has popped that Main already.
+// So a range starting at such a node, told which, parses exactly as it would have in place. The split points come from a serial
+// pass of md_parse__skip_work over each top-level node, then every range is parsed into its own placeholder root & the child
+// lists are spliced under the file in order.
+// Workers allocate through arenas whose blocks come from the result's allocator (behind a lock), so nothing gets copied.
+
+typedef struct MD_ParseLockedBacking MD_ParseLockedBacking;
+struct MD_ParseLockedBacking
+{
+	MD_AllocatorInfo ainfo;
+	MD_OS_Handle     mutex;
+};
+
+// One thread's share of md_parse_from_text_tokens_parallel, a run of whole top-level nodes
+typedef struct MD_ParseRange MD_ParseRange;
+struct MD_ParseRange
+{
+	MD_AllocatorInfo backing;     // the result's allocator, behind a lock
+	MD_String8       text;
+	MD_TokenArray    tokens;
+	MD_U64           token_first;
+	MD_U64           token_opl;
+	MD_B32           root_popped; // a stray closer before the range popped the file's Main
+	MD_Node*         file_root;
+
+	//- Ed: parsed, the children are re-parented to file_root before they're spliced in
+	MD_Node          root;
+	MD_MsgList       msgs;
+};
+
+md_internal void*
+md_parse_parallel__backing_proc(void* allocator_data, MD_AllocatorMode mode, MD_SSIZE size, MD_SSIZE alignment, void* old_memory, MD_SSIZE old_size, MD_U64 flags)
+{
+	MD_ParseLockedBacking* backing = (MD_ParseLockedBacking*)allocator_data;
+	void*                  result  = 0;
+	switch (mode)
+	{
+		case MD_AllocatorMode_Alloc:
+		{
+			md_os_mutex_take(backing->mutex);
+			result = backing->ainfo.proc(backing->ainfo.data, mode, size, alignment, old_memory, old_size, flags);
+			md_os_mutex_drop(backing->mutex);
+		}
+		break;
+
+		// Ed: the blocks belong to the result, they're never freed through here
+		case MD_AllocatorMode_QueryType:    result = (void*)MD_AllocatorType_Heap;   break;
+		case MD_AllocatorMode_QuerySupport: result = (void*)MD_AllocatorQuery_Alloc; break;
+		default: break;
+	}
+	return result;
+}
+
+// Ed: starts ranges near even shares of the tokens, returns the range count
+md_internal MD_U64
+md_parse_parallel__find_splits(MD_ParseTokens* tokens, MD_String8 text, MD_Arena* arena, MD_ParseRange* ranges, MD_U64 range_count_max)
+{
+	MD_ParseSkip skip        = { tokens, arena, 0, {0}, text, 0 };
+	MD_U64       range_count = 1;
+	MD_U64       target      = tokens->count / range_count_max;
+	MD_B32       gathered    = 0;
+	MD_B32       popped      = 0;
+	MD_Token     token       = {0};
+	MD_Token     closer      = {0};
+	MD_U32       trivia      = 0;
+	for (MD_U64 token_idx = 0; range_count < range_count_max && md_parse__token(tokens, token_idx, &token, &trivia);)
+	{
+		MD_TokenFlags reserved = token.flags & MD_TokenFlagGroup_ReservedKind;
+		MD_B32        label    = reserved == 0 && (token.flags & MD_TokenFlagGroup_Label);
+		MD_B32        opener   = (reserved & MD_TokenFlagGroup_Opener) != 0;
+		if ((label || opener) && ! gathered && token_idx >= target) {
+			ranges[range_count].token_first = token_idx;
+			ranges[range_count].root_popped = popped;
+			range_count += 1;
+			target       = tokens->count * range_count / range_count_max;
+		}
+
+		if (label) {
+			token_idx = md_parse__skip_work(&skip, token_idx + 1, ParseWorkKind_NodeOptionalFollowUp, md_str8_lit(""), &closer);
+			gathered  = 0;
+		}
+		else if (opener) {
+			token_idx = md_parse__skip_work(&skip, token_idx + 1, ParseWorkKind_Main, md_str8_lit(""), &closer);
+			gathered  = 0;
+		}
+		else if (reserved == MD_TokenFlag_At)
+		{
+			MD_Token name_token   = {0};
+			MD_Token paren_token  = {0};
+			MD_U32   name_trivia  = 0;
+			MD_U32   paren_trivia = 0;
+			MD_B32   has_name     = md_parse__token(tokens, token_idx + 1, &name_token,  &name_trivia)  && name_trivia  == 0 && (name_token.flags  & MD_TokenFlagGroup_Label);
+			MD_B32   has_paren    = md_parse__token(tokens, token_idx + 2, &paren_token, &paren_trivia) && paren_trivia == 0 && (paren_token.flags & MD_TokenFlag_ParenLeft);
+			gathered |= has_name;
+			if (has_name && has_paren) {
+				token_idx = md_parse__skip_work(&skip, token_idx + 3, ParseWorkKind_Main, md_str8_lit(""), &closer);
+			}
+			else {
+				token_idx += has_name ? 2 : 1;
+			}
+		}
+		else {
+			// a separator's flags go to the next node, a closer pops the file's Main, anything else leaves it as it was
+			gathered  |= (reserved & MD_TokenFlagGroup_Separator) != 0;
+			popped    |= (reserved & MD_TokenFlagGroup_Closer)    != 0;
+			token_idx += 1;
+		}
+	}
+	return range_count;
+}
+
+md_internal void
+md_parse_parallel__parse_range(void* ptr)
+{
+	MD_ParseRange* range = (MD_ParseRange*)ptr;
+	MD_Arena*      arena = md_arena_alloc(.backing = range->backing, .block_size = MD_MB(1));
+
+	MD_ParseTokens parse_tokens = {0};
+	parse_tokens.v     = range->tokens.v;
+	parse_tokens.count = range->tokens.count;
+	md_memory_copy_struct(&range->root, range->file_root);
+	md_parse__tokens_into(md_arena_allocator(arena), range->text, &parse_tokens, range->token_first, range->token_opl, &range->root, range->root_popped, 0, 0, 0, &range->msgs);
+	for md_each_node(child, range->root.first) {
+		child->parent = range->file_root;
+	}
+}
+
+MD_ParseResult
+md_parse_from_text_tokens_parallel__ainfo(MD_AllocatorInfo ainfo, MD_String8 filename, MD_String8 text, MD_TokenArray tokens, MD_U64 thread_count)
+{
+	if (thread_count == 0) {
+		thread_count = md_os_get_system_info()->logical_processor_count;
+	}
+	thread_count = md_clamp_top(thread_count, tokens.count / MD_PARSE_PARALLEL_MIN_RANGE_TOKENS);
+	if (thread_count <= 1) {
+		return md_parse_from_text_tokens__ainfo(ainfo, filename, text, tokens);
+	}
+
+	MD_TempArena   scratch      = md_scratch_begin(ainfo);
+	MD_ParseTokens parse_tokens = {0};
+	parse_tokens.v     = tokens.v;
+	parse_tokens.count = tokens.count;
+
+	MD_ParseRange* ranges      = md_push_array(scratch.arena, MD_ParseRange, thread_count);
+	MD_U64         range_count = md_parse_parallel__find_splits(&parse_tokens, text, scratch.arena, ranges, thread_count);
+	if (range_count <= 1) {
+		scratch_end(scratch);
+		return md_parse_from_text_tokens__ainfo(ainfo, filename, text, tokens);
+	}
+
+	MD_ParseResult result = {0};
+	result.root = md_push_node(ainfo, MD_NodeKind_File, 0, filename, text, 0);
+
+	MD_ParseLockedBacking locked  = { ainfo, md_os_mutex_alloc() };
+	MD_AllocatorInfo      backing = { md_parse_parallel__backing_proc, &locked };
+	MD_OS_Handle*         threads = md_push_array(scratch.arena, MD_OS_Handle, range_count);
+	for (MD_U64 idx = 0; idx < range_count; idx += 1)
+	{
+		MD_ParseRange* range = &ranges[idx];
+		range->backing     = backing;
+		range->text        = text;
+		range->tokens      = tokens;
+		range->token_opl   = (idx + 1 < range_count) ? ranges[idx + 1].token_first : tokens.count;
+		range->file_root   = result.root;
+	}
+	md_parallel__run(md_parse_parallel__parse_range, ranges, size_of(MD_ParseRange), threads, range_count);
+
+	//- Ed: splice in source order, a stray closer at the top level marks the file
+	MD_Node* root = result.root;
+	for (MD_U64 idx = 0; idx < range_count; idx += 1)
+	{
+		MD_ParseRange* range = &ranges[idx];
+		root->flags |= range->root.flags;
+		if ( ! md_node_is_nil(range->root.first))
+		{
+			if (md_node_is_nil(root->last)) {
+				root->first = range->root.first;
+			}
+			else {
+				root->last->next        = range->root.first;
+				range->root.first->prev = root->last;
+			}
+			root->last = range->root.last;
+		}
+		md_msg_list_concat_in_place(&result.msgs, &range->msgs);
+	}
+	md_child_index__build_if_wide(ainfo, root);
+	md_os_mutex_release(locked.mutex);
+	scratch_end(scratch);
+	return result;
+}
+
+////////////////////////////////
+//~ Ed: Parallel Files -> Tree Functions
+
+// NOTE(Ed): Files are handed out one at a time off a shared counter, so a few large files don't leave the other threads idle.
+// Each worker loads & parses into its own arena, with blocks from the result's allocator like md_parse_from_text_tokens_parallel.
+
+// Shared by the workers of md_parse_files_parallel, each takes the next path off the queue until it's empty
+typedef struct MD_ParseFilesQueue MD_ParseFilesQueue;
+struct MD_ParseFilesQueue
+{
+	MD_String8Array  paths;
+	MD_AllocatorInfo backing;   // the result's allocator, behind a lock
+	MD_ParseResult*  results;   // one per path
+	volatile MD_U64  next_path;
+};
+
+md_internal void
+md_parse_files_parallel__worker(void* ptr)
+{
+	MD_ParseFilesQueue* queue = (MD_ParseFilesQueue*)ptr;
+	MD_Arena*           arena = 0;
+	for (;;)
+	{
+		MD_U64 path_idx = md_ins_atomic_u64_inc_eval(&queue->next_path) - 1;
+		if (path_idx >= queue->paths.count) {
+			break;
+		}
+		if (arena == 0) {
+			arena = md_arena_alloc(.backing = queue->backing, .block_size = MD_MB(1));
+		}
+		MD_String8        path  = md_str8_copy(arena, queue->paths.v[path_idx]);
+		MD_OS_Handle      file  = md_os_file_open(MD_OS_AccessFlag_Read | MD_OS_AccessFlag_ShareRead, path);
+		MD_FileProperties props = md_os_properties_from_file(file);
+		MD_String8        text  = md_os_string_from_file_range(arena, file, md_r1u64(0, props.size));
+		md_os_file_close(file);
+		queue->results[path_idx] = md_parse_from_text(arena, path, text);
+
+		// Ed: an unreadable path still gets its (empty) file node, with an error so it isn't taken for an empty file
+		if (md_os_handle_match(file, md_os_handle_zero())) {
+			MD_String8 error_string = md_str8f(arena, "Couldn't read file \"%S\".", path);
+			md_msg_list_push(arena, &queue->results[path_idx].msgs, queue->results[path_idx].root, MD_MsgKind_Error, error_string);
+		}
+	}
+}
+
+MD_ParseResult
+md_parse_files_parallel__ainfo(MD_AllocatorInfo ainfo, MD_String8Array paths, MD_U64 thread_count)
+{
+	if (thread_count == 0) {
+		thread_count = md_os_get_system_info()->logical_processor_count;
+	}
+	thread_count = md_clamp(1, thread_count, paths.count);
+
+	MD_ParseResult result = {0};
+	result.root = md_push_node(ainfo, MD_NodeKind_List, 0, md_str8_zero(), md_str8_zero(), 0);
+	if (paths.count == 0) {
+		md_tree_generation_bump();
+		return result;
+	}
+
+	MD_TempArena          scratch = md_scratch_begin(ainfo);
+	MD_ParseLockedBacking locked  = { ainfo, md_os_mutex_alloc() };
+	MD_ParseFilesQueue    queue   = {0};
+	queue.paths   = paths;
+	queue.backing = (MD_AllocatorInfo){ md_parse_parallel__backing_proc, &locked };
+	queue.results = md_push_array(scratch.arena, MD_ParseResult, paths.count);
+
+	//- Ed: every worker shares the queue
+	MD_OS_Handle* threads = md_push_array(scratch.arena, MD_OS_Handle, thread_count);
+	md_parallel__run(md_parse_files_parallel__worker, &queue, 0, threads, thread_count);
+
+	for (MD_U64 path_idx = 0; path_idx < paths.count; path_idx += 1) {
+		md_node_push_child(result.root, queue.results[path_idx].root);
+		md_msg_list_concat_in_place(&result.msgs, &queue.results[path_idx].msgs);
+	}
+	md_child_index__build_if_wide(ainfo, result.root);
+	md_os_mutex_release(locked.mutex);
+	scratch_end(scratch);
+	return result;
+}
+
+////////////////////////////////
+//~ Ed: Parse Cache Functions
+
+md_global volatile MD_U64 md_parse_cache__temp_counter = 0;
+
+MD_U64
+md_parse_cache_key(MD_ParseCache* cache, MD_String8 text)
+{
+	MD_U64 versions[] = {
+		MD_PARSE_CACHE_VERSION, MD_FLAT_TREE_FILE_VERSION,
+		MD_BUILD_VERSION_MAJOR, MD_BUILD_VERSION_MINOR, MD_BUILD_VERSION_PATCH,
+		cache->options_hash,
+	};
+	MD_U64 seed = md_hash_u64_from_str8(0, md_str8((MD_U8*)versions, sizeof(versions)));
+	return md_hash_u64_from_str8(seed, text);
+}
+
+md_internal MD_String8
+md_parse_cache__entry_path(MD_Arena* arena, MD_ParseCache* cache, MD_U64 key) {
+	return md_str8f(arena, "%S/%016llx.mdpc", cache->dir, key);
+}
+
+// Fills out from the entry in data when it's whole & made from text, strings that aren't in text are copied
+md_internal MD_B32
+md_parse_cache__result_from_entry(MD_AllocatorInfo ainfo, MD_String8 data, MD_U64 key, MD_String8 filename, MD_String8 text, MD_ParseResult* out)
+{
+	//- Ed: header & messages fit
+	MD_ParseCacheEntryHeader* header = (MD_ParseCacheEntryHeader*)data.str;
+	if (data.size < sizeof(*header) ||
+		header->magic   != MD_PARSE_CACHE_MAGIC   ||
+		header->version != MD_PARSE_CACHE_VERSION ||
+		header->key     != key                    ||
+		header->msg_count > header->msgs_size / sizeof(MD_ParseCacheMsg) ||
+		header->msgs_size > data.size - sizeof(*header)) {
+		return 0;
+	}
+	MD_ParseCacheMsg* msgs         = (MD_ParseCacheMsg*)(header + 1);
+	MD_U8*            strings      = (MD_U8*)(msgs + header->msg_count);
+	MD_U64            strings_size = header->msgs_size - header->msg_count * sizeof(MD_ParseCacheMsg);
+	MD_U64            needed_size  = 0;
+	for (MD_U64 msg_idx = 0; msg_idx < header->msg_count; msg_idx += 1) {
+		needed_size += (MD_U64)msgs[msg_idx].node_string_size + msgs[msg_idx].node_raw_string_size + msgs[msg_idx].string_size;
+	}
+	if (needed_size != strings_size) {
+		return 0;
+	}
+	for (MD_U64 msg_idx = 0; msg_idx < header->msg_count; msg_idx += 1) {
+		if (msgs[msg_idx].kind > MD_MsgKind_FatalError || msgs[msg_idx].node_kind >= MD_NodeKind_COUNT) {
+			return 0;
+		}
+	}
+
+	//- Ed: the tree, which has to be of this exact text (its nodes are checked by md_flat_tree_from_file_data, the
+	// directory may be shared & an entry damaged)
+	MD_U64      tree_pos = md_align_pow2(sizeof(*header) + header->msgs_size, 8);
+	MD_FlatTree tree     = md_flat_tree_from_file_data(md_str8_skip(data, tree_pos));
+	if (tree.count <= 1 || ! md_str8_match(tree.text, text, 0)) {
+		return 0;
+	}
+	tree.text  = text;
+	tree.extra = md_str8_copy(ainfo, tree.extra);
+	out->root  = md_node_from_flat_tree(ainfo, &tree);
+	out->root->string = filename;
+	out->msgs  = (MD_MsgList){0};
+
+	MD_U8* string_at = strings;
+	for (MD_U64 msg_idx = 0; msg_idx < header->msg_count; msg_idx += 1)
+	{
+		MD_ParseCacheMsg* msg    = &msgs[msg_idx];
+		MD_String8        string = md_str8_copy(ainfo, md_str8(string_at, msg->node_string_size));     string_at += msg->node_string_size;
+		MD_String8        raw    = md_str8_copy(ainfo, md_str8(string_at, msg->node_raw_string_size)); string_at += msg->node_raw_string_size;
+		MD_String8        note   = md_str8_copy(ainfo, md_str8(string_at, msg->string_size));          string_at += msg->string_size;
+		MD_Node*          node   = md_push_node(ainfo, (MD_NodeKind)msg->node_kind, msg->node_flags, string, raw, msg->node_src_offset);
+		md_msg_list_push(ainfo, &out->msgs, node, (MD_MsgKind)msg->kind, note);
+	}
+	return 1;
+}
+
+md_internal MD_B32
+md_parse_cache__load(MD_AllocatorInfo ainfo, MD_ParseCache* cache, MD_U64 key, MD_String8 filename, MD_String8 text, MD_ParseResult* out)
+{
+	MD_TempArena   scratch = md_scratch_begin(ainfo);
+	MD_B32         result  = 0;
+	MD_FlatTreeMap map     = {0};
+	map.file = md_os_file_open(MD_OS_AccessFlag_Read | MD_OS_AccessFlag_ShareRead, md_parse_cache__entry_path(scratch.arena, cache, key));
+	if ( ! md_os_handle_match(map.file, md_os_handle_zero()))
+	{
+		map.range = md_r1u64(0, md_os_properties_from_file(map.file).size);
+		map.map   = md_os_file_map_open(MD_OS_AccessFlag_Read, map.file);
+		if (map.range.md_max > 0 && ! md_os_handle_match(map.map, md_os_handle_zero())) {
+			map.view = md_os_file_map_view_open(map.map, MD_OS_AccessFlag_Read, map.range);
+		}
+		if (map.view != 0) {
+			result = md_parse_cache__result_from_entry(ainfo, md_str8((MD_U8*)map.view, map.range.md_max), key, filename, text, out);
+		}
+	}
+	md_flat_tree_map_close(&map);
+	scratch_end(scratch);
+	return result;
+}
+
+md_internal void
+md_parse_cache__store(MD_ParseCache* cache, MD_U64 key, MD_String8 text, MD_ParseResult parse)
+{
+	MD_TempArena   scratch = md_scratch_begin(0, 0);
+	MD_String8List parts   = {0};
+
+	//- Ed: header, message records & their strings
+	MD_ParseCacheEntryHeader*
+	header            = md_push_array(scratch.arena, MD_ParseCacheEntryHeader, 1);
+	header->magic     = MD_PARSE_CACHE_MAGIC;
+	header->version   = MD_PARSE_CACHE_VERSION;
+	header->key       = key;
+	header->msg_count = parse.msgs.count;
+	md_str8_list_push(scratch.arena, &parts, md_str8((MD_U8*)header, sizeof(*header)));
+
+	MD_ParseCacheMsg* records = md_push_array(scratch.arena, MD_ParseCacheMsg, parse.msgs.count);
+	md_str8_list_push(scratch.arena, &parts, md_str8((MD_U8*)records, parse.msgs.count * sizeof(MD_ParseCacheMsg)));
+	MD_U64 msg_idx = 0;
+	for (MD_Msg* msg = parse.msgs.first; msg != 0; msg = msg->next, msg_idx += 1)
+	{
+		MD_ParseCacheMsg*
+		record                       = &records[msg_idx];
+		record->kind                 = (MD_U32)msg->kind;
+		record->node_kind            = (MD_U32)msg->node->kind;
+		record->node_flags           = msg->node->flags;
+		record->node_src_offset      = (MD_U32)msg->node->src_offset;
+		record->node_string_size     = (MD_U32)msg->node->string.size;
+		record->node_raw_string_size = (MD_U32)msg->node->raw_string.size;
+		record->string_size          = (MD_U32)msg->string.size;
+		md_str8_list_push(scratch.arena, &parts, msg->node->string);
+		md_str8_list_push(scratch.arena, &parts, msg->node->raw_string);
+		md_str8_list_push(scratch.arena, &parts, msg->string);
+	}
+	header->msgs_size = parts.total_size - sizeof(*header);
+
+	md_local_persist MD_U8 zeroes[8] = {0};
+	md_str8_list_push(scratch.arena, &parts, md_str8(zeroes, md_align_pow2(parts.total_size, 8) - parts.total_size));
+
+	//- Ed: the entry's size from the layout of its tree, before any of it is built: the text is stored whole, so past the limit
+	// on its own it isn't walked either
+	if (cache->max_entry_size != 0)
+	{
+		MD_FlatTreeFileHeader layout = {0};
+		layout.text_size = text.size;
+		MD_B32 fits = parts.total_size + text.size <= cache->max_entry_size;
+		if (fits) {
+			layout.count = md_flat_tree__measure(parse.root, text, &layout.extra_size);
+			fits         = parts.total_size + md_flat_tree_file__layout(&layout) <= cache->max_entry_size;
+		}
+		if ( ! fits) {
+			scratch_end(scratch);
+			return;
+		}
+	}
+
+	//- Ed: then the tree
+	MD_FlatTree    tree       = md_flat_tree_from_node(scratch.arena, parse.root, text);
+	MD_String8List tree_parts = md_flat_tree_file_parts(scratch.arena, &tree);
+	md_str8_list_concat_in_place(&parts, &tree_parts);
+
+	//- Ed: written beside the entry, then renamed over it
+	md_os_make_directory(cache->dir);
+	MD_U64     counter    = md_ins_atomic_u64_inc_eval(&md_parse_cache__temp_counter);
+	MD_String8 temp_path  = md_str8f(scratch.arena, "%S/%016llx.%u.%llu.tmp", cache->dir, key, md_os_get_process_info()->pid, counter);
+	MD_String8 entry_path = md_parse_cache__entry_path(scratch.arena, cache, key);
+	MD_B32     stored     = md_os_write_data_list_to_file_path(temp_path, parts) && md_os_move_file_path(entry_path, temp_path);
+	if ( ! stored) {
+		md_os_delete_file_at_path(temp_path);
+	}
+	scratch_end(scratch);
+
+	//- Ed: keep the directory near max_total_size without a trim after every store
+	if (stored && md_ins_atomic_u64_inc_eval(&cache->store_count) % MD_PARSE_CACHE_TRIM_INTERVAL == 0 && cache->max_total_size != 0) {
+		md_parse_cache_trim(cache);
+	}
+}
+
+MD_ParseResult
+md_parse_from_text_cached__ainfo(MD_AllocatorInfo ainfo, MD_ParseCache* cache, MD_String8 filename, MD_String8 text)
+{
+	MD_ParseResult result = {0};
+	MD_U64         key    = md_parse_cache_key(cache, text);
+	if ( ! md_parse_cache__load(ainfo, cache, key, filename, text, &result)) {
+		result = md_parse_from_text(ainfo, filename, text);
+		md_parse_cache__store(cache, key, text, result);
+	}
+	return result;
+}
+
+typedef struct MD_ParseCacheFile MD_ParseCacheFile;
+struct MD_ParseCacheFile
+{
+	MD_String8   name;
+	MD_U64       size;
+	MD_DenseTime modified;
+};
+
+md_internal int
+md_parse_cache__file_newer(MD_ParseCacheFile* a, MD_ParseCacheFile* b) {
+	return (a->modified < b->modified) - (a->modified > b->modified);
+}
+
+MD_U64
+md_parse_cache_trim(MD_ParseCache* cache)
+{
+	MD_TempArena scratch = md_scratch_begin(0, 0);
+
+	//- Ed: every entry, newest first (temporary files may be another process's store in flight, they're left alone)
+	MD_U64             file_cap   = 1024;
+	MD_U64             file_count = 0;
+	MD_ParseCacheFile* files      = md_push_array(scratch.arena, MD_ParseCacheFile, file_cap);
+	MD_OS_FileIter*    iter       = md_os_file_iter_begin(scratch.arena, cache->dir, MD_OS_FileIterFlag_SkipFolders);
+	for (MD_OS_FileInfo info = {0}; md_os_file_iter_next(scratch.arena, iter, &info);)
+	{
+		if ( ! md_str8_ends_with_lit(info.name, ".mdpc", 0)) {
+			continue;
+		}
+		if (file_count == file_cap) {
+			MD_ParseCacheFile* grown = md_push_array(scratch.arena, MD_ParseCacheFile, file_cap * 2);
+			md_memory_copy(grown, files, file_cap * sizeof(MD_ParseCacheFile));
+			files     = grown;
+			file_cap *= 2;
+		}
+		files[file_count].name     = info.name;
+		files[file_count].size     = info.props.size;
+		files[file_count].modified = info.props.modified;
+		file_count += 1;
+	}
+	md_os_file_iter_end(iter);
+	md_quick_sort(files, file_count, sizeof(MD_ParseCacheFile), md_parse_cache__file_newer);
+
+	//- Ed: keep what fits
+	MD_U64 deleted    = 0;
+	MD_U64 total_size = 0;
+	for (MD_U64 file_idx = 0; file_idx < file_count; file_idx += 1)
+	{
+		total_size += files[file_idx].size;
+		if (cache->max_total_size != 0 && total_size > cache->max_total_size) {
+			deleted += md_os_delete_file_at_path(md_str8f(scratch.arena, "%S/%S", cache->dir, files[file_idx].name));
+		}
+	}
+	scratch_end(scratch);
+	return deleted;
+}
+
+////////////////////////////////
+//~ Ed: Selector Functions
+
+md_internal MD_B32
+md_selector__is_name_byte(MD_U8 byte)
+{
+	return ! (
+		byte == ' ' || byte == '\t' || byte == '\r' || byte == '\n' ||
+		byte == '/' || byte == '['  || byte == ']'  || byte == '='  || byte == '@' || byte == '*' || byte == '!' ||
+		byte == '"' || byte == '\'' || byte == '`'
+	);
+}
+
+md_internal MD_U64
+md_selector__skip_whitespace(MD_String8 source, MD_U64 pos)
+{
+	while (pos < source.size && (source.str[pos] == ' ' || source.str[pos] == '\t' || source.str[pos] == '\r' || source.str[pos] == '\n')) {
+		pos += 1;
+	}
+	return pos;
+}
+
+md_internal void
+md_selector__error(MD_AllocatorInfo ainfo, MD_Selector* selector, MD_U64 offset, MD_String8 string)
+{
+	MD_Node* marker = md_push_node(ainfo, MD_NodeKind_ErrorMarker, 0, md_str8_lit(""), md_str8_lit(""), offset);
+	md_msg_list_push(ainfo, &selector->msgs, marker, MD_MsgKind_Error, string);
+}
+
+// Ed: the label or value at *pos, bare or quoted
+md_internal MD_String8
+md_selector__name(MD_AllocatorInfo ainfo, MD_Selector* selector, MD_U64* pos, MD_String8 expected)
+{
+	MD_String8 source = selector->source;
+	MD_U64     start  = *pos;
+	if (start < source.size && (source.str[start] == '"' || source.str[start] == '\'' || source.str[start] == '`'))
+	{
+		MD_U64 end = start + 1;
+		while (end < source.size && source.str[end] != source.str[start]) {
+			end += 1;
+		}
+		if (end == source.size) {
+			md_selector__error(ainfo, selector, start, md_str8_lit("Unterminated quoted string."));
+			*pos = end;
+			return md_str8_zero();
+		}
+		*pos = end + 1;
+		return md_str8_substr(source, md_r1u64(start + 1, end));
+	}
+	while (*pos < source.size && md_selector__is_name_byte(source.str[*pos])) {
+		*pos += 1;
+	}
+	if (*pos == start) {
+		md_selector__error(ainfo, selector, start, expected);
+	}
+	return md_str8_substr(source, md_r1u64(start, *pos));
+}
+
+MD_Selector
+md_selector_compile__ainfo(MD_AllocatorInfo ainfo, MD_String8 source)
+{
+	MD_Selector selector = {0};
+	selector.source = md_str8_copy(ainfo, source);
+	MD_String8 text = selector.source;
+
+	//- Ed: every step but the first follows a /, every predicate opens with [ or is an @tag step
+	MD_U64 step_cap = 1;
+	MD_U64 pred_cap = 1;
+	for (MD_U64 idx = 0; idx < text.size; idx += 1) {
+		step_cap += text.str[idx] == '/';
+		pred_cap += text.str[idx] == '[' || text.str[idx] == '@';
+	}
+	selector.steps = md_alloc_array(ainfo, MD_SelectorStep, step_cap);
+	selector.preds = md_alloc_array(ainfo, MD_SelectorPred, pred_cap);
+
+	MD_U64               pos   = md_selector__skip_whitespace(text, 0);
+	MD_SelectorStepFlags flags = 0;
+	if (pos + 1 < text.size && text.str[pos] == '/' && text.str[pos + 1] == '/') {
+		flags = MD_SelectorStepFlag_Descendants;
+		pos  += 2;
+	}
+	else if (pos < text.size && text.str[pos] == '/') {
+		pos += 1;
+	}
+	while (selector.msgs.count == 0)
+	{
+		MD_SelectorStep*
+		step             = &selector.steps[selector.step_count];
+		step->flags      = flags;
+		step->first_pred = selector.pred_count;
+		selector.step_count += 1;
+
+		//- Ed: label, * or @tag
+		pos = md_selector__skip_whitespace(text, pos);
+		if (pos < text.size && text.str[pos] == '*') {
+			step->flags |= MD_SelectorStepFlag_AnyLabel;
+			pos         += 1;
+		}
+		else if (pos < text.size && text.str[pos] == '@')
+		{
+			pos += 1;
+			MD_SelectorPred*
+			pred       = &selector.preds[selector.pred_count];
+			pred->kind = MD_SelectorPredKind_HasTag;
+			pred->key  = md_selector__name(ainfo, &selector, &pos, md_str8_lit("Expected a tag after @."));
+			selector.pred_count += 1;
+			step->flags         |= MD_SelectorStepFlag_AnyLabel;
+		}
+		else {
+			step->label = md_selector__name(ainfo, &selector, &pos, md_str8_lit("Expected a label, * or @tag."));
+		}
+
+		//- Ed: predicates
+		pos = md_selector__skip_whitespace(text, pos);
+		while (selector.msgs.count == 0 && pos < text.size && text.str[pos] == '[')
+		{
+			MD_SelectorPred* pred = &selector.preds[selector.pred_count];
+			selector.pred_count += 1;
+			pos = md_selector__skip_whitespace(text, pos + 1);
+			if (pos < text.size && text.str[pos] == '!') {
+				pred->negate = 1;
+				pos = md_selector__skip_whitespace(text, pos + 1);
+			}
+			if (pos < text.size && text.str[pos] == '@') {
+				pos        += 1;
+				pred->kind  = MD_SelectorPredKind_HasTag;
+				pred->key   = md_selector__name(ainfo, &selector, &pos, md_str8_lit("Expected a tag after @."));
+			}
+			else {
+				pred->kind = MD_SelectorPredKind_HasChild;
+				pred->key  = md_selector__name(ainfo, &selector, &pos, md_str8_lit("Expected @tag or a child label."));
+			}
+			pos = md_selector__skip_whitespace(text, pos);
+			if (selector.msgs.count == 0 && pos < text.size && text.str[pos] == '=')
+			{
+				pos         = md_selector__skip_whitespace(text, pos + 1);
+				pred->kind  = pred->kind == MD_SelectorPredKind_HasTag ? MD_SelectorPredKind_TagArgEquals : MD_SelectorPredKind_ChildEquals;
+				pred->value = md_selector__name(ainfo, &selector, &pos, md_str8_lit("Expected a value after =."));
+				pos         = md_selector__skip_whitespace(text, pos);
+			}
+			if (selector.msgs.count == 0 && (pos == text.size || text.str[pos] != ']')) {
+				md_selector__error(ainfo, &selector, pos, md_str8_lit("Expected ]."));
+			}
+			pos = md_selector__skip_whitespace(text, pos + 1);
+		}
+		step->pred_count = selector.pred_count - step->first_pred;
+
+		//- Ed: / or // to the next step
+		if (selector.msgs.count != 0 || pos == text.size) {
+			break;
+		}
+		if (pos + 1 < text.size && text.str[pos] == '/' && text.str[pos + 1] == '/') {
+			flags = MD_SelectorStepFlag_Descendants;
+			pos  += 2;
+		}
+		else if (text.str[pos] == '/') {
+			flags = 0;
+			pos  += 1;
+		}
+		else {
+			md_selector__error(ainfo, &selector, pos, md_str8_lit("Expected / or // between steps."));
+		}
+	}
+	if (selector.msgs.count == 0 && selector.step_count > MD_SELECTOR_MAX_STEPS) {
+		md_selector__error(ainfo, &selector, 0, md_str8_lit("Too many steps in selector."));
+	}
+	if (selector.msgs.count != 0) {
+		selector.step_count = 0;
+	}
+	return selector;
+}
+
+MD_B32
+md_selector_step_match(MD_Selector* selector, MD_SelectorStep* step, MD_Node* node)
+{
+	if ( ! (step->flags & MD_SelectorStepFlag_AnyLabel) && ! md_str8_match(node->string, step->label, 0)) {
+		return 0;
+	}
+	for (MD_U64 pred_idx = step->first_pred; pred_idx < step->first_pred + step->pred_count; pred_idx += 1)
+	{
+		MD_SelectorPred* pred = &selector->preds[pred_idx];
+		MD_B32           pass = 0;
+		switch (pred->kind)
+		{
+			default: {} break;
+			case MD_SelectorPredKind_HasTag:   { pass = md_node_has_tag  (node, pred->key, 0); } break;
+			case MD_SelectorPredKind_HasChild: { pass = md_node_has_child(node, pred->key, 0); } break;
+			case MD_SelectorPredKind_TagArgEquals:
+			{
+				MD_Node* arg = md_node_first(md_tag_from_string(node, pred->key, 0));
+				pass = ! md_node_is_nil(arg) && md_str8_match(arg->string, pred->value, 0);
+			}
+			break;
+			case MD_SelectorPredKind_ChildEquals:
+			{
+				MD_Node* value = md_node_first(md_child_from_string(node, pred->key, 0));
+				pass = ! md_node_is_nil(value) && md_str8_match(value->string, pred->value, 0);
+			}
+			break;
+		}
+		if (pass == pred->negate) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+// NOTE(Ed): The walk is a preorder over the tree carrying the set of steps each node is tested against, as a bitmask.
+// A node that matches step s puts s + 1 in its children's set (or is a result when s is the last), & a descendants step stays
+// in the set of everything below where it started. Subtrees whose set goes empty are skipped, each node is visited once so
+// results come out in document order without duplicates. Siblings share a set, so the walk keeps one per depth & climbs back
+// out through parent links.
+// Each top-level child of a root is a unit searched on its own, which is what md_select_parallel splits across threads.
+
+typedef struct MD_SelectChunk MD_SelectChunk;
+struct MD_SelectChunk
+{
+	MD_SelectChunk* next;
+	MD_U64          count;
+	MD_Node*        v[256];
 };
 
-typedef struct MD_ParseWorkNode MD_ParseWorkNode;
-struct MD_ParseWorkNode
+typedef struct MD_SelectJob MD_SelectJob;
+struct MD_SelectJob
 {
-	MD_ParseWorkNode* next;
-	MD_ParseWorkKind  kind;
-	MD_Node*          parent;
-	MD_Node*          first_gathered_tag;
-	MD_Node*          last_gathered_tag;
-	MD_NodeFlags      gathered_node_flags;
-	MD_S32            counted_newlines;
+	MD_Selector*    selector;
+	MD_Arena*       arena;
+	MD_Node**       units;
+	MD_U64          unit_count;
+	MD_U64*         depth_steps;      // steps the nodes at each depth below the unit are tested against
+	MD_U64          depth_cap;
+	MD_U64          descendant_steps; // mask of steps with MD_SelectorStepFlag_Descendants
+	MD_SelectChunk* first;
+	MD_SelectChunk* last;
+	MD_U64          count;
 };
 
-inline
-void md_parse__work_push(MD_ParseWorkKind work_kind, MD_Node* work_parent, MD_ParseWorkNode* work_top, MD_ParseWorkNode* work_free, MD_TempArena* scratch)
+md_internal void
+md_select__emit(MD_SelectJob* job, MD_Node* node)
 {
-	MD_ParseWorkNode* work_node = work_free;
-	if (work_node == 0) {
-		work_node = md_push_array(scratch->arena, MD_ParseWorkNode, 1);
-	}
-	else {
-		md_sll_stack_pop(work_free);
+	if (job->last == 0 || job->last->count == md_array_count(job->last->v))
+	{
+		MD_SelectChunk* chunk = md_push_array(job->arena, MD_SelectChunk, 1);
+		md_sll_queue_push(job->first, job->last, chunk);
 	}
-	work_node->kind   = (work_kind);
-	work_node->parent = (work_parent);
-	md_sll_stack_push(work_top, work_node);
+	job->last->v[job->last->count] = node;
+	job->last->count += 1;
+	job->count       += 1;
 }
 
-inline
-void md_parse__work_pop(MD_ParseWorkNode* work_top, MD_ParseWorkNode* broken_work) {
-	md_sll_stack_pop(work_top);
-	if (work_top == 0) {
-		work_top = broken_work;
+// Ed: most steps are a bare label, matched here without the call into md_selector_step_match
+md_force_inline MD_B32
+md_select__step_match(MD_Selector* selector, MD_SelectorStep* step, MD_Node* node)
+{
+	if ( ! (step->flags & MD_SelectorStepFlag_AnyLabel) && ! md_str8_match(node->string, step->label, 0)) {
+		return 0;
 	}
+	return step->pred_count == 0 || md_selector_step_match(selector, step, node);
 }
 
-MD_ParseResult
-md_parse_from_text_tokens__ainfo(MD_AllocatorInfo ainfo, MD_String8 filename, MD_String8 text, MD_TokenArray tokens)
+// Ed: searches the units from first up to opl
+md_internal void
+md_select__units(MD_SelectJob* job, MD_Node* first_unit, MD_Node* opl)
 {
-	MD_TempArena scratch = md_scratch_begin(ainfo);
-	
-	//- rjf: set up outputs
-	MD_MsgList msgs = {0};
-	MD_Node*   root = md_push_node(ainfo, MD_NodeKind_File, 0, filename, text, 0);
-	
-	//- rjf: set up parse rule stack
-	MD_ParseWorkNode  first_work  = { 0, ParseWorkKind_Main, root };
-	MD_ParseWorkNode  broken_work = { 0, ParseWorkKind_Main, root };
-	MD_ParseWorkNode* work_top    = &first_work;
-	MD_ParseWorkNode* work_free   = 0;
-
-	#define parse_work_push(work_kind, work_parent) md_parse__work_push(work_kind, work_parent, work_top, work_free, &scratch)
-	#define parse_work_pop()                        md_parse__work_pop (work_top, &broken_work)
-	
-	//- rjf: parse
-	MD_Token* tokens_first = tokens.v;
-	MD_Token* tokens_opl   = tokens_first + tokens.count;
-	MD_Token* token        = tokens_first;
-	for (;token < tokens_opl;)
+	// Ed: read once up here, emitting writes through job so the compiler would reload them for every node
+	MD_Selector*     selector         = job->selector;
+	MD_SelectorStep* selector_steps   = selector->steps;
+	MD_U64           descendant_steps = job->descendant_steps;
+	MD_U64           last_step        = 1ull << (selector->step_count - 1);
+	MD_U64*          depth_steps      = job->depth_steps;
+	MD_U64           depth            = 0;
+	depth_steps[0] = 1;
+	for (MD_Node* node = first_unit; ! md_node_is_nil(node) && node != opl;)
 	{
-		//- rjf: unpack token
-		MD_String8 md_token_string = md_str8_substr(text, token[0].range);
+		MD_U64 steps       = depth_steps[depth];
+		MD_U64 child_steps = steps & descendant_steps;
+		for (MD_U64 remaining = steps; remaining != 0; remaining &= remaining - 1)
+		{
+			MD_U64 step_bit = remaining & (~remaining + 1);
+			if (md_select__step_match(selector, &selector_steps[md_ctz64(step_bit)], node)) {
+				if (step_bit == last_step) md_select__emit(job, node);
+				else                       child_steps |= step_bit << 1;
+			}
+		}
 
-		// Note(Ed): Each of the the follwoing conditionals will always terminate the iteration path to end_consume label.
-		
-		// TODO(Ed): Add opt-in support for whitespace awareness
-		//- rjf: whitespace -> always no-op & inc
-		if (token->flags & MD_TokenFlag_Whitespace) {
-			token += 1;
-			goto end_consume;
-			// <whitespace>
+		//- Ed: down into the children with steps left for them
+		MD_Node* first = child_steps != 0 ? md_node_first(node) : md_nil_node();
+		if ( ! md_node_is_nil(first))
+		{
+			depth += 1;
+			if (depth == job->depth_cap)
+			{
+				MD_U64* grown = md_push_array__no_zero(job->arena, MD_U64, job->depth_cap * 2);
+				md_memory_copy(grown, depth_steps, sizeof(MD_U64) * depth);
+				job->depth_steps = depth_steps = grown;
+				job->depth_cap  *= 2;
+			}
+			depth_steps[depth] = child_steps;
+			node = first;
+			continue;
 		}
-		
-		// TODO(Ed): Add opt-in support for comment awareness
-		//- rjf: comments -> always no-op & inc
-		if (token->flags & MD_TokenFlagGroup_Comment) {
-			token += 1;
-			goto end_consume;
-			// < // > <content> <unescaped newline>
-			// or 
-			// /* <content> */
+
+		//- Ed: up until there's a next sibling
+		for (; depth != 0 && md_node_is_nil(node->next); depth -= 1) {
+			node = node->parent;
 		}
-		
-		//- rjf: [node follow up] : following label -> work top parent has children. 
-		// we need to scan for explicit delimiters, else parse an implicitly delimited set of children
-		if (work_top->kind == ParseWorkKind_NodeOptionalFollowUp && md_str8_match(md_token_string, md_str8_lit(":"), 0)) {
-			MD_Node* parent = work_top->parent;
-			parse_work_pop();
-			parse_work_push(ParseWorkKind_NodeChildrenStyleScan, parent);
-			token += 1;
-			goto end_consume;
-			// .. <label> :
+		node = node->next;
+	}
+}
+
+md_internal void
+md_select__job_begin(MD_SelectJob* job, MD_Selector* selector, MD_Arena* arena)
+{
+	job->selector  = selector;
+	job->arena     = arena;
+	job->depth_cap   = 64;
+	job->depth_steps = md_push_array(arena, MD_U64, job->depth_cap);
+	for (MD_U64 step_idx = 0; step_idx < selector->step_count; step_idx += 1) {
+		if (selector->steps[step_idx].flags & MD_SelectorStepFlag_Descendants) job->descendant_steps |= 1ull << step_idx;
+	}
+}
+
+md_internal void
+md_select__worker(void* ptr)
+{
+	MD_SelectJob* job = (MD_SelectJob*)ptr;
+	md_select__job_begin(job, job->selector, md_arena_alloc(.backing = md_heap(), .block_size = MD_MB(1)));
+	for (MD_U64 unit_idx = 0; unit_idx < job->unit_count; unit_idx += 1) {
+		md_select__units(job, job->units[unit_idx], job->units[unit_idx]->next);
+	}
+}
+
+md_internal void
+md_select__jobs_into_array(MD_SelectJob* jobs, MD_U64 job_count, MD_NodeArray* array)
+{
+	for (MD_U64 job_idx = 0; job_idx < job_count; job_idx += 1) {
+		for (MD_SelectChunk* chunk = jobs[job_idx].first; chunk != 0; chunk = chunk->next) {
+			md_memory_copy(array->v + array->count, chunk->v, sizeof(MD_Node*) * chunk->count);
+			array->count += chunk->count;
 		}
-		
-		//- rjf: [node follow up] anything but : following label -> node has no children.
-		// just pop & move on
-		if (work_top->kind == ParseWorkKind_NodeOptionalFollowUp) {
-			parse_work_pop();
-			goto end_consume;
-			// .. <label> 
+	}
+}
+
+MD_NodeArray
+md_select__ainfo(MD_AllocatorInfo ainfo, MD_Selector* selector, MD_Node* root)
+{
+	MD_NodeArray result = {0};
+	if (selector->step_count == 0) {
+		return result;
+	}
+	MD_TempArena scratch = md_scratch_begin(ainfo);
+	MD_SelectJob job     = {0};
+	md_select__job_begin(&job, selector, scratch.arena);
+	md_select__units(&job, md_node_first(root), md_nil_node());
+	result.v = md_alloc_array_no_zero(ainfo, MD_Node*, job.count);
+	md_select__jobs_into_array(&job, 1, &result);
+	scratch_end(scratch);
+	return result;
+}
+
+MD_NodeArray
+md_select_parallel__ainfo(MD_AllocatorInfo ainfo, MD_Selector* selector, MD_NodeArray roots, MD_U64 thread_count)
+{
+	MD_NodeArray result = {0};
+	if (selector->step_count == 0) {
+		return result;
+	}
+	MD_TempArena scratch = md_scratch_begin(ainfo);
+
+	//- Ed: units in order across the roots, each thread takes a contiguous run of them
+	MD_U64 unit_count = 0;
+	for (MD_U64 root_idx = 0; root_idx < roots.count; root_idx += 1) {
+		for md_each_child(unit, roots.v[root_idx]) { unit_count += 1; }
+	}
+	MD_Node** units    = md_push_array__no_zero(scratch.arena, MD_Node*, unit_count);
+	MD_U64    unit_idx = 0;
+	for (MD_U64 root_idx = 0; root_idx < roots.count; root_idx += 1) {
+		for md_each_child(unit, roots.v[root_idx]) {
+			units[unit_idx] = unit;
+			unit_idx += 1;
 		}
+	}
+	if (thread_count == 0) {
+		thread_count = md_os_get_system_info()->logical_processor_count;
+	}
+	thread_count = md_clamp(1, thread_count, md_max(unit_count, 1));
 
-		MD_B32 reserved_token  = token->flags & MD_TokenFlag_Reserved;
+	MD_SelectJob* jobs    = md_push_array(scratch.arena, MD_SelectJob, thread_count);
+	MD_OS_Handle* threads = md_push_array(scratch.arena, MD_OS_Handle, thread_count);
+	for (MD_U64 job_idx = 0; job_idx < thread_count; job_idx += 1)
+	{
+		MD_U64 begin = unit_count *  job_idx      / thread_count;
+		MD_U64 end   = unit_count * (job_idx + 1) / thread_count;
+		jobs[job_idx].selector   = selector;
+		jobs[job_idx].units      = units + begin;
+		jobs[job_idx].unit_count = end - begin;
+	}
+	md_parallel__run(md_select__worker, jobs, size_of(MD_SelectJob), threads, thread_count);
 
-		MD_NodeFlags separator = (
-			MD_NodeFlag_IsBeforeComma     *!! md_str8_match(md_token_string, md_str8_lit(","), 0) |
-			MD_NodeFlag_IsBeforeSemicolon *!! md_str8_match(md_token_string, md_str8_lit(";"), 0)
-		);
-		MD_B32 found_separator = reserved_token && separator;
-		
-		//- rjf: [main] separators -> mark & inc
-		if (work_top->kind == ParseWorkKind_Main && found_separator)
-		{
-			MD_Node* parent = work_top->parent;
-			if (!md_node_is_nil(parent->last))
-			{
-				// mark last & working noe with separator flag
-				parent->last->flags           |= separator;
-				work_top->gathered_node_flags |= separator;
-			}
-			token += 1;
-			goto end_consume;
-			// <parent->last> , <work_top>
-			// or
-			// <parent->last> ; <work_top>
+	MD_U64 count = 0;
+	for (MD_U64 job_idx = 0; job_idx < thread_count; job_idx += 1) {
+		count += jobs[job_idx].count;
+	}
+	result.v = md_alloc_array_no_zero(ainfo, MD_Node*, count);
+	md_select__jobs_into_array(jobs, thread_count, &result);
+	for (MD_U64 job_idx = 0; job_idx < thread_count; job_idx += 1) {
+		md_arena_release(jobs[job_idx].arena);
+	}
+	scratch_end(scratch);
+	return result;
+}
+
+////////////////////////////////
+//~ Ed: Lookup Path Functions
+
+MD_LookupPath
+md_lookup_path_compile__ainfo(MD_AllocatorInfo ainfo, MD_String8 path, MD_StringMatchFlags flags)
+{
+	MD_LookupPath result = {0};
+	result.flags  = flags;
+	result.labels = md_alloc_array(ainfo, MD_String8, 1 + path.size / 2);
+	for (MD_U64 pos = 0; pos < path.size;)
+	{
+		MD_U64 end = pos;
+		while (end < path.size && path.str[end] != '/') {
+			end += 1;
 		}
-		
-		//- rjf: [main_implicit] separators -> pop
-		if(work_top->kind == ParseWorkKind_MainImplicit && token->flags & found_separator) {
-			parse_work_pop();
-			goto end_consume;
+		if (end > pos) {
+			result.labels[result.count] = md_str8_copy(ainfo, md_str8_substr(path, md_r1u64(pos, end)));
+			result.count += 1;
 		}
+		pos = end + 1;
+	}
+	return result;
+}
 
-		MD_B32 mode_main_or_main_implict = (work_top->kind == ParseWorkKind_Main || work_top->kind == ParseWorkKind_MainImplicit);
-		MD_B32 found_unexpected          = reserved_token && (md_str8_match(md_token_string, md_str8_lit("#"), 0) || md_str8_match(md_token_string, md_str8_lit("\\"), 0) || md_str8_match(md_token_string, md_str8_lit(":"), 0));
-		
-		//- rjf: [main, main_implicit] unexpected reserved tokens
-		if (mode_main_or_main_implict && found_unexpected) {
-			MD_Node*   error        = md_push_node(ainfo, MD_NodeKind_ErrorMarker, 0, md_token_string, md_token_string, token->range.md_min);
-			MD_String8 error_string = md_str8f(ainfo, "Unexpected reserved symbol \"%S\".", md_token_string);
-			md_msg_list_push(ainfo, &msgs, error, MD_MsgKind_Error, error_string);
-			token += 1;
-			goto end_consume;
-		}
+MD_Node*
+md_lookup_path__resolve(MD_LookupPath* path, MD_Node* root)
+{
+	// Ed: read before the walk, an edit during it leaves the memo stale rather than wrong
+	MD_U64   generation = md_tree_generation();
+	MD_Node* node       = root;
+	for (MD_U64 idx = 0; idx < path->count && ! md_node_is_nil(node); idx += 1) {
+		node = md_child_from_string(node, path->labels[idx], path->flags);
+	}
+	if (md_node_is_nil(node)) {
+		node = md_nil_node();
+	}
+	path->root       = root;
+	path->node       = node;
+	path->generation = generation;
+	return node;
+}
+
+////////////////////////////////
+//~ Ed: Tree Hash Functions
+
+md_force_inline MD_U64
+md_tree_hash__mix(MD_U64 hash, MD_U64 value) {
+	hash ^= value * 0xC2B2AE3D27D4EB4Full;
+	hash  = ((hash << 31) | (hash >> 33)) * 0x9E3779B185EBCA87ull;
+	return hash;
+}
+
+md_force_inline MD_U64
+md_tree_hash__label(MD_Node* node) {
+	return md_hash_u64_from_str8(node->kind, node->string);
+}
+
+md_force_inline MD_Node* md_tree_hashes__node(MD_TreeHashes* hashes, MD_U64 entry) { return hashes->chunks[entry / MD_TREE_HASH_CHUNK_SIZE]->nodes [entry % MD_TREE_HASH_CHUNK_SIZE]; }
+md_force_inline MD_U64   md_tree_hashes__hash(MD_TreeHashes* hashes, MD_U64 entry) { return hashes->chunks[entry / MD_TREE_HASH_CHUNK_SIZE]->hashes[entry % MD_TREE_HASH_CHUNK_SIZE]; }
+md_force_inline MD_U64   md_tree_hashes__size(MD_TreeHashes* hashes, MD_U64 entry) { return hashes->chunks[entry / MD_TREE_HASH_CHUNK_SIZE]->sizes [entry % MD_TREE_HASH_CHUNK_SIZE]; }
+
+typedef struct MD_TreeHashFrame MD_TreeHashFrame;
+struct MD_TreeHashFrame
+{
+	MD_U64 entry;
+	MD_U64 hash;        // own label, then each finished tag & child mixed in as it's left
+	MD_U64 tag_count;
+	MD_U64 child_count;
+};
+
+md_internal void
+md_tree_hashes__build(MD_TreeHashes* hashes)
+{
+	// Ed: read before the walk, an edit during it leaves the hashes stale rather than wrong
+	MD_AllocatorInfo ainfo      = hashes->ainfo;
+	MD_U64           generation = md_tree_generation();
 
-		MD_B32 found_tag = reserved_token && md_str8_match(md_token_string, md_str8_lit("@"), 0);
+	MD_TempArena scratch = md_scratch_begin(ainfo);
 
-		//- rjf: [main, main_implicit] tag signifier -> create new tag
-		if (mode_main_or_main_implict && found_tag)
+	//- Ed: one walk, in preorder through tags before children; a node's hash is finished on the way back up & mixed into its
+	// parent's frame, so every node is read once
+	MD_TreeHashChunk** chunks    = 0;
+	MD_U64             chunk_cap = 0;
+	MD_U64             count     = 0;
+	MD_TreeHashFrame*  frames    = 0;
+	MD_U64             frame_cap = 0;
+	MD_U64             depth     = 0;
+	for (MD_Node* node = hashes->root; ! md_node_is_nil(node);)
+	{
+		//- Ed: enter
+		if (count % MD_TREE_HASH_CHUNK_SIZE == 0)
 		{
-			// MD_Token after should be label.
-			if (token + 1 >= tokens_opl || !(token[1].flags & MD_TokenFlagGroup_Label))
+			MD_U64 chunk_idx = count / MD_TREE_HASH_CHUNK_SIZE;
+			if (chunk_idx == chunk_cap)
 			{
-				MD_Node*   error        = md_push_node(ainfo, MD_NodeKind_ErrorMarker, 0, md_token_string, md_token_string, token->range.md_min);
-				MD_String8 error_string = md_str8_lit("Tag label expected after @ symbol.");
-				md_msg_list_push(ainfo, &msgs, error, MD_MsgKind_Error, error_string);
+				MD_U64             grown_cap = md_max(16, chunk_cap * 2);
+				MD_TreeHashChunk** grown     = md_alloc_array_no_zero(ainfo, MD_TreeHashChunk*, grown_cap);
+				md_memory_copy(grown, chunks, sizeof(MD_TreeHashChunk*) * chunk_idx);
+				md_alloc_free(ainfo, chunks);
+				chunks    = grown;
+				chunk_cap = grown_cap;
+			}
+			chunks[chunk_idx] = md_alloc_array_no_zero(ainfo, MD_TreeHashChunk, 1);
+		}
+		if (depth == frame_cap)
+		{
+			frame_cap = md_max(64, frame_cap * 2);
+			MD_TreeHashFrame* grown = md_push_array__no_zero(scratch.arena, MD_TreeHashFrame, frame_cap);
+			md_memory_copy(grown, frames, sizeof(MD_TreeHashFrame) * depth);
+			frames = grown;
+		}
+		MD_Node* first = md_node_first(node);
+		frames[depth] = (MD_TreeHashFrame){ count, md_hash_u64_from_str8(((MD_U64)node->kind << 32) | node->flags, node->string), 0, 0 };
+		depth += 1;
+		chunks[count / MD_TREE_HASH_CHUNK_SIZE]->nodes[count % MD_TREE_HASH_CHUNK_SIZE] = node;
+		count += 1;
+		if ( ! md_node_is_nil(node->first_tag)) { node = node->first_tag; continue; }
+		if ( ! md_node_is_nil(first))           { node = first;           continue; }
 
-				token += 1;
-				goto end_consume;
-				 // <Tag> : @ <???> (was not label)
+		//- Ed: leave every node that has nothing left under it, up to the first with a next sibling or tags done
+		for (;;)
+		{
+			depth -= 1;
+			MD_TreeHashFrame* frame = &frames[depth];
+			MD_U64            hash  = frame->hash;
+			if (frame->child_count == 0) {
+				hash = md_tree_hash__mix(hash, frame->tag_count);
+			}
+			hash  = md_tree_hash__mix(hash, frame->child_count);
+			hash ^= hash >> 33;
+			hash *= 0xC2B2AE3D27D4EB4Full;
+			hash ^= hash >> 29;
+			MD_TreeHashChunk* chunk = chunks[frame->entry / MD_TREE_HASH_CHUNK_SIZE];
+			chunk->hashes[frame->entry % MD_TREE_HASH_CHUNK_SIZE] = hash;
+			chunk->sizes [frame->entry % MD_TREE_HASH_CHUNK_SIZE] = count - frame->entry;
+			if (depth == 0) {
+				node = md_nil_node();
+				break;
+			}
+			MD_TreeHashFrame* parent = &frames[depth - 1];
+			if (node->kind == MD_NodeKind_Tag) {
+				parent->hash       = md_tree_hash__mix(parent->hash, hash);
+				parent->tag_count += 1;
 			}
 			else
 			{
-				MD_String8 tag_name_raw = md_str8_substr(text, token[1].range);
-				MD_String8 tag_name     = content_string_from_token_flags_str8(token[1].flags, tag_name_raw);
-
-				MD_Node* node = md_push_node(ainfo, MD_NodeKind_Tag, md_node_flags_from_token_flags(token[1].flags), tag_name, tag_name_raw, token[0].range.md_min);
-				md_dll_push_back_npz(md_nil_node(), work_top->first_gathered_tag, work_top->last_gathered_tag, node, next, prev);
-
-				MD_B32 found_argument_paren = token[2].flags & MD_TokenFlag_Reserved && md_str8_match(md_str8_substr(text, token[2].range), md_str8_lit("("), 0);
-
-				if (token + 2 < tokens_opl && found_argument_paren) {
-					token += 3;
-					parse_work_push(ParseWorkKind_Main, node);
-					// <Tag> : @ <TagName> ( 
-				}
-				else {
-					token += 2;
-					// <Tag> : @ <TagName>
+				if (parent->child_count == 0) {
+					parent->hash = md_tree_hash__mix(parent->hash, parent->tag_count);
 				}
-				goto end_consume;
+				parent->hash         = md_tree_hash__mix(parent->hash, hash);
+				parent->child_count += 1;
 			}
+			if ( ! md_node_is_nil(node->next)) {
+				node = node->next;
+				break;
+			}
+			if (node->kind == MD_NodeKind_Tag && ! md_node_is_nil(md_node_first(node->parent))) {
+				node = node->parent->first;
+				break;
+			}
+			node = node->parent;
 		}
-		
-		//- rjf: [main, main_implicit] label -> create new main
-		if (mode_main_or_main_implict && token->flags & MD_TokenFlagGroup_Label)
-		{
-			MD_String8   md_node_string_raw = md_token_string;
-			MD_String8   md_node_string     = content_string_from_token_flags_str8(token->flags, md_node_string_raw);
-			MD_NodeFlags flags              = md_node_flags_from_token_flags(token->flags)|work_top->gathered_node_flags;
+	}
 
-			work_top->gathered_node_flags = 0;
+	scratch_end(scratch);
 
-			MD_Node* node = md_push_node(ainfo, MD_NodeKind_Main, flags, md_node_string, md_node_string_raw, token[0].range.md_min);
-			node->first_tag = work_top->first_gathered_tag;
-			node->last_tag  = work_top->last_gathered_tag;
-			for (MD_Node* tag = work_top->first_gathered_tag; !md_node_is_nil(tag); tag = tag->next) {
-				tag->parent = node;
-			}
-			work_top->first_gathered_tag = work_top->last_gathered_tag = md_nil_node();
+	hashes->generation = generation;
+	hashes->count      = count;
+	hashes->chunks     = chunks;
+	hashes->chunk_cap  = chunk_cap;
+}
 
-			md_node_push_child(work_top->parent, node);
-			parse_work_push(ParseWorkKind_NodeOptionalFollowUp, node);
-			token += 1;
-			goto end_consume;
+// Ed: node -> entry, built on the first lookup of a node past the root (the diff walks entries & never needs it)
+md_internal void
+md_tree_hashes__build_slots(MD_TreeHashes* hashes)
+{
+	MD_U64 slot_count = 16;
+	while (slot_count < hashes->count * 2) {
+		slot_count *= 2;
+	}
+	MD_U64* slots = md_alloc_array(hashes->ainfo, MD_U64, slot_count);
+	for (MD_U64 idx = 0; idx < hashes->count; idx += 1)
+	{
+		MD_U64 slot_idx = md_child_index__hash_node(md_tree_hashes__node(hashes, idx)) & (slot_count - 1);
+		while (slots[slot_idx] != 0) {
+			slot_idx = (slot_idx + 1) & (slot_count - 1);
 		}
+		slots[slot_idx] = idx + 1;
+	}
+	hashes->slots     = slots;
+	hashes->slot_mask = slot_count - 1;
+}
 
-		MD_NodeFlags opening_delimiter = (
-			MD_NodeFlag_HasBraceLeft   *!! md_str8_match(md_token_string, md_str8_lit("{"), 0) |
-			MD_NodeFlag_HasBracketLeft *!! md_str8_match(md_token_string, md_str8_lit("["), 0) |
-			MD_NodeFlag_HasParenLeft   *!! md_str8_match(md_token_string, md_str8_lit("("), 0)
-		);
-		MD_B32 found_opening_delimiter = reserved_token && opening_delimiter & (MD_NodeFlag_HasBraceLeft | MD_NodeFlag_HasBracketLeft | MD_NodeFlag_HasParenLeft);
-		
-		//- rjf: [main] {s, [s, and (s -> create new main
-		if (work_top->kind == ParseWorkKind_Main && found_opening_delimiter)
-		{
-			MD_NodeFlags 
-			flags  = md_node_flags_from_token_flags(token->flags) | work_top->gathered_node_flags;
-			flags |= opening_delimiter;
+// Ed: entry of node, count when it isn't under the root
+md_internal MD_U64
+md_tree_hashes__entry(MD_TreeHashes* hashes, MD_Node* node)
+{
+	if (hashes->count > 0 && node == hashes->root) {
+		return 0;
+	}
+	if (hashes->slots == 0 && hashes->count > 0) {
+		md_tree_hashes__build_slots(hashes);
+	}
+	MD_U64 result = hashes->count;
+	if (hashes->slots != 0) for (MD_U64 slot_idx = md_child_index__hash_node(node) & hashes->slot_mask; hashes->slots[slot_idx] != 0; slot_idx = (slot_idx + 1) & hashes->slot_mask)
+	{
+		if (md_tree_hashes__node(hashes, hashes->slots[slot_idx] - 1) == node) {
+			result = hashes->slots[slot_idx] - 1;
+			break;
+		}
+	}
+	return result;
+}
 
-			work_top->gathered_node_flags = 0;
+MD_TreeHashes
+md_tree_hashes_from_tree__ainfo(MD_AllocatorInfo ainfo, MD_Node* root)
+{
+	MD_TreeHashes hashes = {0};
+	hashes.ainfo = ainfo;
+	hashes.root  = root;
+	md_tree_hashes__build(&hashes);
+	return hashes;
+}
 
-			MD_Node* 
-			node = md_push_node(ainfo, MD_NodeKind_Main, flags, md_str8_lit(""), md_str8_lit(""), token[0].range.md_min);
-			node->first_tag = work_top->first_gathered_tag;
-			node->last_tag  = work_top->last_gathered_tag;
-			for (MD_Node* tag = work_top->first_gathered_tag; !md_node_is_nil(tag); tag = tag->next) {
-				tag->parent = node;
-			}
-			work_top->first_gathered_tag = work_top->last_gathered_tag = md_nil_node();
+void
+md_tree_hashes_refresh(MD_TreeHashes* hashes)
+{
+	if (hashes->generation != md_tree_generation()) {
+		md_tree_hashes_release(hashes);
+		md_tree_hashes__build(hashes);
+	}
+}
 
-			md_node_push_child(work_top->parent, node);
-			parse_work_push(ParseWorkKind_Main, node);
-			token += 1;
-			goto end_consume;
-			// <main label> : 
+void
+md_tree_hashes_release(MD_TreeHashes* hashes)
+{
+	for (MD_U64 base = 0; base < hashes->count; base += MD_TREE_HASH_CHUNK_SIZE) {
+		md_alloc_free(hashes->ainfo, hashes->chunks[base / MD_TREE_HASH_CHUNK_SIZE]);
+	}
+	md_alloc_free(hashes->ainfo, hashes->chunks);
+	md_alloc_free(hashes->ainfo, hashes->slots);
+	hashes->count     = 0;
+	hashes->chunks    = 0;
+	hashes->chunk_cap = 0;
+	hashes->slots     = 0;
+}
+
+MD_U64
+md_tree_hash_from_node(MD_TreeHashes* hashes, MD_Node* node)
+{
+	md_tree_hashes_refresh(hashes);
+	MD_U64 entry = md_tree_hashes__entry(hashes, node);
+	return entry < hashes->count ? md_tree_hashes__hash(hashes, entry) : 0;
+}
+
+MD_B32
+md_tree_match_hashed(MD_TreeHashes* a_hashes, MD_Node* a, MD_TreeHashes* b_hashes, MD_Node* b)
+{
+	md_tree_hashes_refresh(a_hashes);
+	md_tree_hashes_refresh(b_hashes);
+	MD_U64 a_entry = md_tree_hashes__entry(a_hashes, a);
+	MD_U64 b_entry = md_tree_hashes__entry(b_hashes, b);
+	if (a_entry == a_hashes->count || b_entry == b_hashes->count) {
+		return tree_match(a, b, 0);
+	}
+	return md_tree_hashes__hash(a_hashes, a_entry) == md_tree_hashes__hash(b_hashes, b_entry);
+}
+
+//- Ed: diff
+
+typedef struct MD_TreeDiffPair MD_TreeDiffPair;
+struct MD_TreeDiffPair
+{
+	MD_U64 a;
+	MD_U64 b;
+};
+
+typedef struct MD_TreeDiffStack MD_TreeDiffStack;
+struct MD_TreeDiffStack
+{
+	MD_TreeDiffPair* v;
+	MD_U64           count;
+	MD_U64           cap;
+};
+
+md_internal void
+md_tree_diff__push_pair(MD_Arena* arena, MD_TreeDiffStack* stack, MD_U64 a, MD_U64 b)
+{
+	if (stack->count == stack->cap)
+	{
+		MD_U64           cap   = md_max(64, stack->cap * 2);
+		MD_TreeDiffPair* grown = md_push_array__no_zero(arena, MD_TreeDiffPair, cap);
+		md_memory_copy(grown, stack->v, sizeof(MD_TreeDiffPair) * stack->count);
+		stack->v   = grown;
+		stack->cap = cap;
+	}
+	stack->v[stack->count] = (MD_TreeDiffPair){ a, b };
+	stack->count          += 1;
+}
+
+md_internal void
+md_tree_diff__push_entry(MD_AllocatorInfo ainfo, MD_TreeDiffList* list, MD_Node* a, MD_Node* b)
+{
+	MD_TreeDiffEntry* entry = md_alloc_array(ainfo, MD_TreeDiffEntry, 1);
+	entry->a = a;
+	entry->b = b;
+	md_sll_queue_push(list->first, list->last, entry);
+	list->count += 1;
+}
+
+// Ed: pairs up two sibling lists (entries la & lb), pairs go on pending in order, what's left is added or removed
+md_internal void
+md_tree_diff__align(MD_Arena* arena, MD_AllocatorInfo ainfo, MD_TreeDiff* diff, MD_TreeDiffStack* pending,
+	MD_TreeHashes* a, MD_Node* a_owner, MD_U64* la, MD_U64 a_count,
+	MD_TreeHashes* b, MD_Node* b_owner, MD_U64* lb, MD_U64 b_count)
+{
+	//- Ed: equal runs at either end, most edits leave long runs of siblings alone
+	MD_U64 lo   = 0;
+	MD_U64 hi_a = a_count;
+	MD_U64 hi_b = b_count;
+	for (; lo < a_count && lo < b_count && md_tree_hashes__hash(a, la[lo]) == md_tree_hashes__hash(b, lb[lo]); lo += 1);
+	for (; hi_a > lo && hi_b > lo && md_tree_hashes__hash(a, la[hi_a - 1]) == md_tree_hashes__hash(b, lb[hi_b - 1]); hi_a -= 1, hi_b -= 1);
+
+	//- Ed: pair the middle by label, in order: b's siblings queued per label, each of a's takes the first still ahead
+	MD_U64* b_match = md_push_array__no_zero(arena, MD_U64, md_max(hi_a - lo, 1));
+	for (MD_U64 idx = lo; idx < hi_a; idx += 1) {
+		b_match[idx - lo] = MD_MAX_U64;
+	}
+	if (hi_a > lo && hi_b > lo)
+	{
+		MD_U64 slot_count = 16;
+		while (slot_count < (hi_b - lo) * 2) {
+			slot_count *= 2;
 		}
-		
-		//- rjf: [node children style scan] {s, [s, and (s -> explicitly delimited children
-		if (work_top->kind == ParseWorkKind_NodeChildrenStyleScan && found_opening_delimiter)
+		// Ed: per label, its first b position (+ 1, 0 is an empty slot) & the queue of positions still unpaired (+ 1)
+		MD_U64* slot_reps  = md_push_array         (arena, MD_U64, slot_count);
+		MD_U64* slot_keys  = md_push_array__no_zero(arena, MD_U64, slot_count);
+		MD_U64* slot_heads = md_push_array__no_zero(arena, MD_U64, slot_count);
+		MD_U64* slot_tails = md_push_array__no_zero(arena, MD_U64, slot_count);
+		MD_U64* next       = md_push_array         (arena, MD_U64, hi_b - lo);
+		for (MD_U64 side = 0; side < 2; side += 1)
 		{
-			MD_Node *parent = work_top->parent;
-			parent->flags |= opening_delimiter;
-			parse_work_pop();
-			parse_work_push(ParseWorkKind_Main, parent);
-			token += 1;
-			goto end_consume;
+			MD_TreeHashes* hashes   = side == 0 ? b  : a;
+			MD_U64*        list     = side == 0 ? lb : la;
+			MD_U64         opl      = side == 0 ? hi_b : hi_a;
+			MD_U64         b_cursor = lo;
+			for (MD_U64 pos = lo; pos < opl; pos += 1)
+			{
+				MD_Node* node     = md_tree_hashes__node(hashes, list[pos]);
+				MD_U64   key      = md_tree_hash__label(node);
+				MD_U64   slot_idx = key & (slot_count - 1);
+				for (; slot_reps[slot_idx] != 0; slot_idx = (slot_idx + 1) & (slot_count - 1))
+				{
+					MD_Node* rep = md_tree_hashes__node(b, lb[slot_reps[slot_idx] - 1]);
+					if (slot_keys[slot_idx] == key && rep->kind == node->kind && md_str8_match(rep->string, node->string, 0)) {
+						break;
+					}
+				}
+				if (side == 0)
+				{
+					if (slot_reps[slot_idx] == 0) {
+						slot_reps [slot_idx] = pos + 1;
+						slot_keys [slot_idx] = key;
+						slot_heads[slot_idx] = pos + 1;
+					}
+					else next[slot_tails[slot_idx] - 1 - lo] = pos + 1;
+					slot_tails[slot_idx] = pos + 1;
+				}
+				else if (slot_reps[slot_idx] != 0)
+				{
+					MD_U64* head = &slot_heads[slot_idx];
+					for (; *head != 0 && *head - 1 < b_cursor; *head = next[*head - 1 - lo]);
+					if (*head != 0) {
+						b_match[pos - lo] = *head - 1;
+						b_cursor          = *head;
+						*head             = next[*head - 1 - lo];
+					}
+				}
+			}
 		}
+	}
 
-		MD_B32 newline_token = token->flags & MD_TokenFlag_Newline;
-		
-		//- rjf: [node children style scan] count newlines
-		if (work_top->kind == ParseWorkKind_NodeChildrenStyleScan && newline_token) {
-			work_top->counted_newlines += 1;
-			token += 1;
-			goto end_consume;
+	//- Ed: between two pairs, leftover leaves pair by position (a value that was edited), the rest were removed or added
+	// only unequal pairs go on pending, the equal runs at either end never do
+	MD_U64 a_pos = lo;
+	MD_U64 b_pos = lo;
+	for (;;)
+	{
+		MD_U64 a_next = a_pos;
+		for (; a_next < hi_a && b_match[a_next - lo] == MD_MAX_U64; a_next += 1);
+		MD_U64 b_next = a_next < hi_a ? b_match[a_next - lo] : hi_b;
+		for (; a_pos < a_next && b_pos < b_next && md_tree_hashes__size(a, la[a_pos]) == 1 && md_tree_hashes__size(b, lb[b_pos]) == 1; a_pos += 1, b_pos += 1) {
+			if (md_tree_hashes__hash(a, la[a_pos]) != md_tree_hashes__hash(b, lb[b_pos])) md_tree_diff__push_pair(arena, pending, la[a_pos], lb[b_pos]);
 		}
-		
-		//- rjf: [main_implicit] newline -> pop
-		if (work_top->kind == ParseWorkKind_MainImplicit && newline_token) {
-			parse_work_pop();
-			token += 1;
-			goto end_consume;
+		for (; a_pos < a_next; a_pos += 1) {
+			md_tree_diff__push_entry(ainfo, &diff->removed, md_tree_hashes__node(a, la[a_pos]), b_owner);
+		}
+		for (; b_pos < b_next; b_pos += 1) {
+			md_tree_diff__push_entry(ainfo, &diff->added, a_owner, md_tree_hashes__node(b, lb[b_pos]));
+		}
+		if (a_next == hi_a) {
+			break;
+		}
+		if (md_tree_hashes__hash(a, la[a_next]) != md_tree_hashes__hash(b, lb[b_next])) md_tree_diff__push_pair(arena, pending, la[a_next], lb[b_next]);
+		a_pos = a_next + 1;
+		b_pos = b_next + 1;
+	}
+}
+
+MD_TreeDiff
+md_tree_diff__ainfo(MD_AllocatorInfo ainfo, MD_TreeHashes* a, MD_TreeHashes* b)
+{
+	MD_TreeDiff diff = {0};
+	md_tree_hashes_refresh(a);
+	md_tree_hashes_refresh(b);
+	if (a->count == 0 || b->count == 0) {
+		return diff;
+	}
+	MD_TempArena     scratch = md_scratch_begin(ainfo);
+	MD_TreeDiffStack stack   = {0};
+	MD_TreeDiffStack pending = {0};
+	md_tree_diff__push_pair(scratch.arena, &stack, 0, 0);
+	while (stack.count > 0)
+	{
+		stack.count -= 1;
+		MD_TreeDiffPair pair = stack.v[stack.count];
+		if (md_tree_hashes__hash(a, pair.a) == md_tree_hashes__hash(b, pair.b)) {
+			continue;
 		}
-		
-		//- rjf: [all but main_implicit] newline -> no-op & inc
-		if (work_top->kind != ParseWorkKind_MainImplicit && newline_token) {
-			token += 1;
-			goto end_consume;
+		MD_Node* a_node = md_tree_hashes__node(a, pair.a);
+		MD_Node* b_node = md_tree_hashes__node(b, pair.b);
+		if (a_node->kind != b_node->kind || a_node->flags != b_node->flags || ! md_str8_match(a_node->string, b_node->string, 0)) {
+			md_tree_diff__push_entry(ainfo, &diff.changed, a_node, b_node);
 		}
 
-		//- rjf: [node children style scan] anything causing implicit set -> <2 newlines, all good,
-		// >=2 newlines, houston we have a problem
-		if (work_top->kind == ParseWorkKind_NodeChildrenStyleScan)
+		//- Ed: tags, then children, paired up in order & pushed reversed so the diff comes out in document order. Tags are
+		// counted from the list, the children are whatever is left of the subtree, stepped over by size.
+		pending.count = 0;
+		MD_U64 a_next = pair.a + 1;
+		MD_U64 b_next = pair.b + 1;
+		for (MD_U64 lists = 0; lists < 2; lists += 1)
 		{
-			if (work_top->counted_newlines >= 2)
-			{
-				MD_Node*   node         = work_top->parent;
-				MD_Node*   error        = md_push_node(ainfo, MD_NodeKind_ErrorMarker, 0, md_token_string, md_token_string, token->range.md_min);
-				MD_String8 error_string = md_str8f(ainfo, "More than two newlines following \"%S\", which has implicitly-delimited children, resulting in an empty list of children.", node->string);
-				md_msg_list_push(ainfo, &msgs, error, MD_MsgKind_Warning, error_string);
-				parse_work_pop();
+			MD_U64 a_count = 0;
+			MD_U64 b_count = 0;
+			if (lists == 0) {
+				for (MD_Node* it = a_node->first_tag; ! md_node_is_nil(it); it = it->next) a_count += 1;
+				for (MD_Node* it = b_node->first_tag; ! md_node_is_nil(it); it = it->next) b_count += 1;
 			}
-			else
-			{
-				MD_Node *parent = work_top->parent;
-				parse_work_pop();
-				parse_work_push(ParseWorkKind_MainImplicit, parent);
+			else {
+				for (MD_U64 it = a_next; it < pair.a + md_tree_hashes__size(a, pair.a); it += md_tree_hashes__size(a, it)) a_count += 1;
+				for (MD_U64 it = b_next; it < pair.b + md_tree_hashes__size(b, pair.b); it += md_tree_hashes__size(b, it)) b_count += 1;
 			}
-			goto end_consume;
-		}
-
-		MD_NodeFlags closing_delimiter = (
-			MD_NodeFlag_HasBraceRight   *!! md_str8_match(md_token_string, md_str8_lit("}"), 0) | 
-			MD_NodeFlag_HasBracketRight *!! md_str8_match(md_token_string, md_str8_lit("]"), 0) |
-			MD_NodeFlag_HasParenRight   *!! md_str8_match(md_token_string, md_str8_lit(")"), 0)
-		);
-		MD_B32 found_closing_delimiter = reserved_token && closing_delimiter & (MD_NodeFlag_HasBraceRight | MD_NodeFlag_HasBracketRight | MD_NodeFlag_HasParenRight);
-		
-		//- rjf: [main] }s, ]s, and )s -> pop
-		if (work_top->kind == ParseWorkKind_Main && found_closing_delimiter) {
-			MD_Node* parent = work_top->parent;
-			parent->flags |= closing_delimiter;
-			parse_work_pop();
-			token += 1;
-			goto end_consume;
-			// <label> }
-			// or
-			// <label> ]
-			// or
-			// <label> )
-		}
-		
-		//- rjf: [main implicit] }s, ]s, and )s -> pop without advancing
-		if (work_top->kind == ParseWorkKind_MainImplicit && reserved_token && found_closing_delimiter) {
-			parse_work_pop();
-			goto end_consume;
-			// <label> }
-			// or
-			// <label> ]
-			// or
-			// <label> )
-			// (deferred)
+			MD_U64* la = md_push_array__no_zero(scratch.arena, MD_U64, md_max(a_count, 1));
+			MD_U64* lb = md_push_array__no_zero(scratch.arena, MD_U64, md_max(b_count, 1));
+			for (MD_U64 idx = 0; idx < a_count; idx += 1) { la[idx] = a_next; a_next += md_tree_hashes__size(a, a_next); }
+			for (MD_U64 idx = 0; idx < b_count; idx += 1) { lb[idx] = b_next; b_next += md_tree_hashes__size(b, b_next); }
+			md_tree_diff__align(scratch.arena, ainfo, &diff, &pending, a, a_node, la, a_count, b, b_node, lb, b_count);
 		}
-		
-		//- rjf: no consumption -> unexpected token! we don't know what to do with this.
-		{
-			MD_Node*   error        = md_push_node(ainfo, MD_NodeKind_ErrorMarker, 0, md_token_string, md_token_string, token->range.md_min);
-			MD_String8 error_string = md_str8f(ainfo, "Unexpected \"%S\" token.", md_token_string);
-			md_msg_list_push(ainfo, &msgs, error, MD_MsgKind_Error, error_string);
-			token += 1;
-			// ???
+		for (MD_U64 idx = pending.count; idx > 0; idx -= 1) {
+			md_tree_diff__push_pair(scratch.arena, &stack, pending.v[idx - 1].a, pending.v[idx - 1].b);
 		}
-		
-		end_consume:;
 	}
-	
-	//- rjf: fill & return
-	MD_ParseResult result = {0};
-	result.root = root;
-	result.msgs = msgs;
-	scratch_end(scratch);
-	return result;
-}
-
-#undef parse_work_push
-#undef parse_work_pop
-
-////////////////////////////////
-//~ rjf: Bundled Text -> Tree Functions
-
-MD_ParseResult
-md_parse_from_text__ainfo(MD_AllocatorInfo ainfo, MD_String8 filename, MD_String8 text) {
-	MD_TempArena      scratch  = md_scratch_begin(ainfo);
-	MD_TokenizeResult tokenize = md_tokenize_from_text(scratch.arena, text);
-	MD_ParseResult    parse    = md_parse_from_text_tokens__ainfo(ainfo, filename, text, tokenize.tokens); 
 	scratch_end(scratch);
-	return parse;
+	return diff;
 }
 
 ////////////////////////////////
@@ -1167,3 +4977,649 @@ md_debug_string_list_from_tree__ainfo(MD_AllocatorInfo ainfo, MD_Node* root)
 	}
 	return strings;
 }
+
+////////////////////////////////
+//~ Ed: Canonical Tree -> Text Functions
+
+MD_Emitter
+md_emitter_alloc__ainfo(MD_AllocatorInfo ainfo, MD_U64 cap)
+{
+	MD_Emitter emitter = {0};
+	emitter.ainfo = ainfo;
+	emitter.cap   = cap != 0 ? cap : MD_KB(64);
+	emitter.str   = md_alloc_array_no_zero(ainfo, MD_U8, emitter.cap);
+	return emitter;
+}
+
+MD_Emitter
+md_emitter_from_file__ainfo(MD_AllocatorInfo ainfo, MD_OS_Handle file, MD_U64 block_size)
+{
+	MD_Emitter emitter = md_emitter_alloc__ainfo(ainfo, block_size != 0 ? block_size : MD_MB(1));
+	emitter.file = file;
+	return emitter;
+}
+
+MD_Emitter
+md_emitter_from_sink__ainfo(MD_AllocatorInfo ainfo, MD_EmitterSinkFunc* sink, void* sink_data, MD_U64 block_size)
+{
+	MD_Emitter emitter = md_emitter_alloc__ainfo(ainfo, block_size != 0 ? block_size : MD_MB(1));
+	emitter.sink      = sink;
+	emitter.sink_data = sink_data;
+	return emitter;
+}
+
+md_force_inline MD_B32 md_emitter__streams(MD_Emitter* emitter) { return emitter->sink != 0 || ! md_os_handle_match(emitter->file, md_os_handle_zero()); }
+
+md_internal void
+md_emitter__write_out(MD_Emitter* emitter, MD_U8* data, MD_U64 size)
+{
+	if (emitter->sink != 0) {
+		emitter->failed |= ! emitter->sink(emitter->sink_data, md_str8(data, size));
+	}
+	else {
+		MD_U64 written = md_os_file_write(emitter->file, md_r1u64(emitter->file_offset, emitter->file_offset + size), data);
+		emitter->failed |= written != size;
+	}
+	emitter->file_offset += size;
+}
+
+void
+md_emitter_flush(MD_Emitter* emitter)
+{
+	if ( ! md_emitter__streams(emitter) || emitter->size == 0) {
+		return;
+	}
+	md_emitter__write_out(emitter, emitter->str, emitter->size);
+	emitter->size = 0;
+}
+
+void
+md_emitter_release(MD_Emitter* emitter)
+{
+	md_emitter_flush(emitter);
+	md_alloc_free(emitter->ainfo, emitter->str);
+	emitter->str  = 0;
+	emitter->size = 0;
+	emitter->cap  = 0;
+}
+
+void
+md_emit_bytes(MD_Emitter* emitter, MD_String8 string)
+{
+	if (emitter->cap - emitter->size < string.size)
+	{
+		if (md_emitter__streams(emitter))
+		{
+			md_emitter_flush(emitter);
+			if (string.size > emitter->cap) {
+				md_emitter__write_out(emitter, string.str, string.size);
+				return;
+			}
+		}
+		else
+		{
+			MD_U64 cap = md_max(emitter->cap * 2, emitter->size + string.size);
+			MD_U8* str = md_alloc_array_no_zero(emitter->ainfo, MD_U8, cap);
+			md_memory_copy(str, emitter->str, emitter->size);
+			md_alloc_free(emitter->ainfo, emitter->str);
+			emitter->str = str;
+			emitter->cap = cap;
+		}
+	}
+	md_memory_copy(emitter->str + emitter->size, string.str, string.size);
+	emitter->size += string.size;
+}
+
+md_force_inline void
+md_emit__write(MD_Emitter* emitter, void const* data, MD_U64 size)
+{
+	if (md_likely(emitter->cap - emitter->size >= size)) {
+		md_memory_copy(emitter->str + emitter->size, data, size);
+		emitter->size += size;
+	}
+	else md_emit_bytes(emitter, md_str8((MD_U8*)data, size));
+}
+
+md_force_inline void md_emit__byte(MD_Emitter* emitter, MD_U8 byte) { md_emit__write(emitter, &byte, 1); }
+
+md_internal void
+md_emit__newline(MD_Emitter* emitter, MD_U64 depth)
+{
+	md_local_persist MD_U8 tabs[] = "\n\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t";
+	md_emit__write(emitter, tabs, 1 + md_min(depth, sizeof(tabs) - 2));
+	for (MD_U64 idx = sizeof(tabs) - 2; idx < depth; idx += 1) {
+		md_emit__byte(emitter, '\t');
+	}
+}
+
+// Ed: would the tokenizer read string back as a single identifier, number or symbol run
+md_internal MD_B32
+md_emit__is_bare(MD_String8 string)
+{
+	if (string.size == 0) {
+		return 0;
+	}
+	MD_U8  first  = string.str[0];
+	MD_B32 result = 1;
+	#define is_identifier(byte) (('A' <= (byte) && (byte) <= 'Z') || ('a' <= (byte) && (byte) <= 'z') || (byte) == '_' || (byte) >= 0x80)
+	#define is_digit(byte)      ('0' <= (byte) && (byte) <= '9')
+	#define is_symbol(byte) (                                                                      \
+		(byte) == '~' || (byte) == '!' || (byte) == '$' || (byte) == '%' || (byte) == '^' || (byte) == '&' || \
+		(byte) == '*' || (byte) == '-' || (byte) == '=' || (byte) == '+' || (byte) == '<' || (byte) == '.' || \
+		(byte) == '>' || (byte) == '/' || (byte) == '?' || (byte) == '|'                                      \
+	)
+	if (is_identifier(first)) {
+		for (MD_U64 idx = 1; idx < string.size && result; idx += 1) result = is_identifier(string.str[idx]) || is_digit(string.str[idx]);
+	}
+	else if (is_digit(first) || ((first == '.' || first == '-') && string.size > 1 && is_digit(string.str[1]))) {
+		for (MD_U64 idx = 1; idx < string.size && result; idx += 1) result = is_identifier(string.str[idx]) || is_digit(string.str[idx]) || string.str[idx] == '.';
+	}
+	else if (is_symbol(first) && ! ((first == '.' || first == '-') && string.size > 1 && is_digit(string.str[1]))) {
+		for (MD_U64 idx = 1; idx < string.size && result; idx += 1) {
+			result = is_symbol(string.str[idx]) && ! (string.str[idx - 1] == '/' && (string.str[idx] == '/' || string.str[idx] == '*'));
+		}
+	}
+	else result = 0;
+	#undef is_identifier
+	#undef is_digit
+	#undef is_symbol
+	return result;
+}
+
+md_internal void
+md_emit__label(MD_Emitter* emitter, MD_Node* node)
+{
+	MD_NodeFlags flags = node->flags;
+	if ( ! (flags & MD_NodeFlag_StringLiteral) && ((flags & (MD_NodeFlag_Identifier | MD_NodeFlag_Numeric | MD_NodeFlag_Symbol)) || md_emit__is_bare(node->string))) {
+		md_emit__write(emitter, node->string.str, node->string.size);
+		return;
+	}
+
+	//- Ed: quoted as the flags say, labels made by hand that can't be bare get the first quoting that holds them
+	MD_U8  quote   = (flags & MD_NodeFlag_StringTick) ? '`' : (flags & MD_NodeFlag_StringSingleQuote) ? '\'' : '"';
+	MD_B32 triplet = (flags & MD_NodeFlag_StringTriplet) != 0;
+	if ( ! (flags & MD_NodeFlag_MaskStringDelimiters))
+	{
+		md_local_persist MD_U8 styles[3] = { '"', '\'', '`' };
+		MD_B32 found   = 0;
+		MD_B32 special = md_str8_find_needle(node->string, 0, md_str8_lit("\n"), 0) < node->string.size ||
+		                 md_str8_find_needle(node->string, 0, md_str8_lit("\\"), 0) < node->string.size;
+		for (MD_U64 idx = 0; idx < md_array_count(styles) && ! found && ! special; idx += 1) {
+			MD_U8 single[1] = { styles[idx] };
+			found = md_str8_find_needle(node->string, 0, md_str8(single, 1), 0) == node->string.size;
+			quote = styles[idx];
+		}
+		for (MD_U64 idx = 0; idx < md_array_count(styles) && ! found; idx += 1) {
+			MD_U8 triple[3] = { styles[idx], styles[idx], styles[idx] };
+			found   = md_str8_find_needle(node->string, 0, md_str8(triple, 3), 0) == node->string.size &&
+			          (node->string.size == 0 || node->string.str[node->string.size - 1] != styles[idx]);
+			quote   = styles[idx];
+			triplet = 1;
+		}
+	}
+	MD_U8 quotes[3] = { quote, quote, quote };
+	md_emit__write(emitter, quotes, triplet ? 3 : 1);
+	md_emit__write(emitter, node->string.str, node->string.size);
+	md_emit__write(emitter, quotes, triplet ? 3 : 1);
+}
+
+// NOTE(Ed): The parser marks the nodes on both sides of a separator with its IsBefore flag, so one is written between two
+// siblings that share it, & after the last sibling only when the one before it doesn't (the trailing separator is otherwise
+// the same tree without it). IsAfter flags are read the same way for trees marked on the far side.
+md_internal MD_B32
+md_emit__separator(MD_Emitter* emitter, MD_Node* node, MD_Node* prev, MD_Node* next)
+{
+	MD_B32 result = 0;
+	md_local_persist MD_NodeFlags separators[2] = { MD_NodeFlag_IsBeforeComma, MD_NodeFlag_IsBeforeSemicolon };
+	md_local_persist MD_U8        bytes     [2] = { ',', ';' };
+	for (MD_U64 idx = 0; idx < md_array_count(separators); idx += 1)
+	{
+		MD_NodeFlags before = separators[idx];
+		MD_NodeFlags after  = MD_NodeFlag_AfterFromBefore(before);
+		if ( ! (node->flags & before)) {
+			continue;
+		}
+		MD_B32 between  = ! md_node_is_nil(next) && (next->flags & (before | after));
+		MD_B32 trailing =   md_node_is_nil(next) && (md_node_is_nil(prev) || ! (prev->flags & before) || (node->flags & after));
+		if (between || trailing) {
+			md_emit__byte(emitter, bytes[idx]);
+			result = 1;
+		}
+	}
+	return result;
+}
+
+typedef MD_U32 MD_EmitLayout;
+enum
+{
+	MD_EmitLayout_File,     // a node per line
+	MD_EmitLayout_Block,    // a node per line, indented, inside braces
+	MD_EmitLayout_Inline,   // nodes on one line inside ( ) or [ ]
+	MD_EmitLayout_Implicit, // "label: a b c", ended by the newline after it
+};
+
+typedef struct MD_EmitFrame MD_EmitFrame;
+struct MD_EmitFrame
+{
+	MD_Node*      owner;
+	MD_Node*      first;
+	MD_Node*      next;
+	MD_Node*      opl;
+	MD_EmitLayout layout;
+	MD_U8         close;
+	MD_B8         after_implicit; // the last node's implicit set needs a newline to end it, a separator ends it otherwise
+	MD_U64        depth;
+};
+
+// Ed: can node's children be written as an implicit set & read back as one
+md_internal MD_B32
+md_emit__implicit_ok(MD_Node* node)
+{
+	if (node->string.size == 0 && ! (node->flags & MD_NodeFlag_StringLiteral)) {
+		return 0;
+	}
+	for md_each_child(child, node)
+	{
+		MD_B32 unlabeled = child->string.size == 0 && ! (child->flags & MD_NodeFlag_StringLiteral);
+		MD_B32 implicit  = ! md_node_is_nil(md_node_first(child)) && ! (child->flags & MD_NodeFlag_MaskSetDelimiters);
+		if (unlabeled || (child->flags & MD_NodeFlag_MaskSeparators) || (implicit && ! md_node_is_nil(child->next))) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+md_internal void
+md_emit__nodes(MD_Emitter* emitter, MD_Node* owner, MD_Node* first, MD_Node* opl, MD_EmitLayout layout, MD_U64 depth)
+{
+	MD_TempArena  scratch     = md_scratch_begin(emitter->ainfo);
+	MD_U64        frame_cap   = 64;
+	MD_U64        frame_count = 1;
+	MD_EmitFrame* frames      = md_push_array(scratch.arena, MD_EmitFrame, frame_cap);
+	frames[0] = (MD_EmitFrame){ owner, first, first, opl, layout, 0, 0, depth };
+	for (;;)
+	{
+		MD_EmitFrame* frame = &frames[frame_count - 1];
+		MD_Node*      node  = frame->next;
+
+		//- Ed: end of a set, close it & write the separator after its owner
+		if (md_node_is_nil(node) || node == frame->opl)
+		{
+			if (frame->layout == MD_EmitLayout_Block && frame->next != frame->first) {
+				md_emit__newline(emitter, frame->depth - 1);
+			}
+			if (frame->close != 0) {
+				md_emit__byte(emitter, frame->close);
+			}
+			MD_Node*      set_owner = frame->owner;
+			MD_EmitLayout closed    = frame->layout;
+			frame_count -= 1;
+			if (frame_count == 0) {
+				break;
+			}
+			frame = &frames[frame_count - 1];
+			MD_B32 separated = md_emit__separator(emitter, set_owner, set_owner == frame->first ? md_nil_node() : set_owner->prev, set_owner->next == frame->opl ? md_nil_node() : set_owner->next);
+			frame->after_implicit = closed == MD_EmitLayout_Implicit && ! separated;
+			continue;
+		}
+		frame->next = node->next;
+		if (node->kind == MD_NodeKind_ErrorMarker) {
+			continue;
+		}
+
+		//- Ed: space before the node
+		MD_B32 is_first = node == frame->first;
+		switch (frame->layout)
+		{
+			case MD_EmitLayout_File:     { if ( ! is_first) md_emit__byte(emitter, '\n'); } break;
+			case MD_EmitLayout_Block:    { md_emit__newline(emitter, frame->depth); } break;
+			case MD_EmitLayout_Implicit: { md_emit__byte(emitter, ' '); } break;
+			case MD_EmitLayout_Inline:
+			{
+				if (frame->after_implicit) md_emit__newline(emitter, frame->depth);
+				else if ( ! is_first)      md_emit__byte(emitter, ' ');
+			}
+			break;
+		}
+		frame->after_implicit = 0;
+
+		//- Ed: tags, label
+		for md_each_node(tag, node->first_tag)
+		{
+			md_emit__byte (emitter, '@');
+			md_emit__label(emitter, tag);
+			if ( ! md_node_is_nil(md_node_first(tag)) || (tag->flags & MD_NodeFlag_MaskSetDelimiters)) {
+				md_emit__byte (emitter, '(');
+				md_emit__nodes(emitter, tag, tag->first, md_nil_node(), MD_EmitLayout_Inline, frame->depth + 1);
+				md_emit__byte (emitter, (tag->flags & MD_NodeFlag_HasBraceRight) ? '}' : (tag->flags & MD_NodeFlag_HasBracketRight) ? ']' : ')');
+			}
+			md_emit__byte(emitter, ' ');
+		}
+		MD_Node* child   = md_node_first(node);
+		MD_B32   has_set = ! md_node_is_nil(child) || (node->flags & MD_NodeFlag_MaskSetDelimiters);
+		MD_B32   labeled = node->string.size != 0 || (node->flags & MD_NodeFlag_StringLiteral);
+		if (labeled || ! has_set) {
+			md_emit__label(emitter, node);
+		}
+
+		//- Ed: no children, or open its set
+		if ( ! has_set) {
+			md_emit__separator(emitter, node, is_first ? md_nil_node() : node->prev, node->next == frame->opl ? md_nil_node() : node->next);
+			continue;
+		}
+		MD_NodeFlags  delimiters = node->flags & MD_NodeFlag_MaskSetDelimiters;
+		MD_EmitLayout set_layout = MD_EmitLayout_Implicit;
+		MD_U8         open       = 0;
+		MD_U8         close      = 0;
+		if (delimiters == 0 && ! (frame->layout == MD_EmitLayout_Implicit && node->next != frame->opl && ! md_node_is_nil(node->next)) && md_emit__implicit_ok(node)) {
+			set_layout = MD_EmitLayout_Implicit;
+		}
+		else
+		{
+			// Ed: a set missing one side (only from broken text or by hand) gets the other side's match
+			MD_NodeFlags left  = delimiters & (MD_NodeFlag_HasParenLeft  | MD_NodeFlag_HasBracketLeft  | MD_NodeFlag_HasBraceLeft);
+			MD_NodeFlags right = delimiters & (MD_NodeFlag_HasParenRight | MD_NodeFlag_HasBracketRight | MD_NodeFlag_HasBraceRight);
+			if (left  == 0) left  = right != 0 ? right >> 1 : MD_NodeFlag_HasBraceLeft;
+			if (right == 0) right = left << 1;
+			open       = (left  & MD_NodeFlag_HasBraceLeft)  ? '{' : (left  & MD_NodeFlag_HasBracketLeft)  ? '[' : '(';
+			close      = (right & MD_NodeFlag_HasBraceRight) ? '}' : (right & MD_NodeFlag_HasBracketRight) ? ']' : ')';
+			set_layout = open == '{' ? MD_EmitLayout_Block : MD_EmitLayout_Inline;
+		}
+		if (labeled) {
+			md_emit__byte(emitter, ':');
+			if (open != 0) md_emit__byte(emitter, ' ');
+		}
+		if (open != 0) {
+			md_emit__byte(emitter, open);
+		}
+		if (frame_count == frame_cap)
+		{
+			MD_EmitFrame* grown = md_push_array(scratch.arena, MD_EmitFrame, frame_cap * 2);
+			md_memory_copy(grown, frames, sizeof(MD_EmitFrame) * frame_count);
+			frames     = grown;
+			frame_cap *= 2;
+		}
+		frames[frame_count] = (MD_EmitFrame){ node, child, child, md_nil_node(), set_layout, close, 0, frames[frame_count - 1].depth + 1 };
+		frame_count += 1;
+	}
+	scratch_end(scratch);
+}
+
+void
+md_emit_node(MD_Emitter* emitter, MD_Node* node)
+{
+	md_emit__nodes(emitter, node->parent, node, node->next, MD_EmitLayout_File, 0);
+	md_emit__byte(emitter, '\n');
+}
+
+void
+md_emit_children(MD_Emitter* emitter, MD_Node* parent)
+{
+	MD_Node* first = md_node_first(parent);
+	if ( ! md_node_is_nil(first)) {
+		md_emit__nodes(emitter, parent, first, md_nil_node(), MD_EmitLayout_File, 0);
+		md_emit__byte(emitter, '\n');
+	}
+}
+
+MD_String8
+md_text_from_tree__ainfo(MD_AllocatorInfo ainfo, MD_Node* root)
+{
+	// Ed: parse roots hold their source, the text comes out about that size
+	MD_Emitter emitter = md_emitter_alloc__ainfo(ainfo, root->kind == MD_NodeKind_File ? root->raw_string.size + root->raw_string.size / 8 : 0);
+	if (root->kind == MD_NodeKind_File) md_emit_children(&emitter, root);
+	else                                md_emit_node    (&emitter, root);
+	return md_emitter_string(&emitter);
+}
+
+MD_B32
+md_tree_write_to_file_path(MD_Node* root, MD_String8 path)
+{
+	MD_OS_Handle file = md_os_file_open(MD_OS_AccessFlag_Write, path);
+	if (md_os_handle_match(file, md_os_handle_zero())) {
+		return 0;
+	}
+	MD_TempArena scratch = md_scratch_begin(0, 0);
+	MD_Emitter   emitter = md_emitter_from_file(scratch.arena, file, MD_MB(1));
+	if (root->kind == MD_NodeKind_File) md_emit_children(&emitter, root);
+	else                                md_emit_node    (&emitter, root);
+	md_emitter_flush(&emitter);
+	md_os_file_close(file);
+	scratch_end(scratch);
+	return ! emitter.failed;
+}
+
+////////////////////////////////
+//~ Ed: Tree Export Functions
+
+md_global MD_String8 md_export__kind_names[MD_NodeKind_COUNT] = {
+	md_str8_lit_comp("Nil"),
+	md_str8_lit_comp("File"),
+	md_str8_lit_comp("ErrorMarker"),
+	md_str8_lit_comp("Main"),
+	md_str8_lit_comp("Tag"),
+	md_str8_lit_comp("List"),
+	md_str8_lit_comp("Reference"),
+};
+
+//- Ed: json
+
+md_internal void
+md_export__json_string(MD_Emitter* emitter, MD_TextScanKernels* scan, MD_String8 string)
+{
+	md_local_persist MD_U8 hex[] = "0123456789abcdef";
+	MD_U8* byte     = string.str;
+	MD_U8* byte_opl = string.str + string.size;
+	md_emit__byte(emitter, '"');
+	for (;;)
+	{
+		MD_U8* run_opl = scan->find_escape(byte, byte_opl);
+		md_emit__write(emitter, byte, (MD_U64)(run_opl - byte));
+		if (run_opl == byte_opl) {
+			break;
+		}
+		MD_U8  c          = *run_opl;
+		MD_U8  escape[6]  = { '\\', c, 'u', '0', '0', 0 };
+		MD_U64 escape_len = 2;
+		switch (c)
+		{
+			case '"': case '\\': break;
+			case '\n': { escape[1] = 'n'; } break;
+			case '\t': { escape[1] = 't'; } break;
+			case '\r': { escape[1] = 'r'; } break;
+			case '\b': { escape[1] = 'b'; } break;
+			case '\f': { escape[1] = 'f'; } break;
+			default:
+			{
+				escape[1]  = 'u';
+				escape[2]  = '0';
+				escape[4]  = hex[c >> 4];
+				escape[5]  = hex[c & 15];
+				escape_len = 6;
+			}
+			break;
+		}
+		md_emit__write(emitter, escape, escape_len);
+		byte = run_opl + 1;
+	}
+	md_emit__byte(emitter, '"');
+}
+
+md_internal void
+md_export__json_u64(MD_Emitter* emitter, MD_U64 value)
+{
+	MD_U8  digits[20];
+	MD_U64 count = 0;
+	do {
+		digits[sizeof(digits) - 1 - count] = (MD_U8)('0' + value % 10);
+		value /= 10;
+		count += 1;
+	} while (value != 0);
+	md_emit__write(emitter, digits + sizeof(digits) - count, count);
+}
+
+//- Ed: msgpack, every size & number big-endian in the smallest encoding that holds it
+
+md_internal void
+md_export__msgpack_head(MD_Emitter* emitter, MD_U8 code, MD_U64 value, MD_U64 width)
+{
+	MD_U8 bytes[9] = { code };
+	for (MD_U64 idx = 0; idx < width; idx += 1) {
+		bytes[1 + idx] = (MD_U8)(value >> (8 * (width - 1 - idx)));
+	}
+	md_emit__write(emitter, bytes, 1 + width);
+}
+
+md_internal void
+md_export__msgpack_u64(MD_Emitter* emitter, MD_U64 value)
+{
+	if      (value <  0x80)       md_emit__byte         (emitter, (MD_U8)value);
+	else if (value <= 0xFF)       md_export__msgpack_head(emitter, 0xcc, value, 1);
+	else if (value <= 0xFFFF)     md_export__msgpack_head(emitter, 0xcd, value, 2);
+	else if (value <= 0xFFFFFFFF) md_export__msgpack_head(emitter, 0xce, value, 4);
+	else                          md_export__msgpack_head(emitter, 0xcf, value, 8);
+}
+
+md_internal void
+md_export__msgpack_string(MD_Emitter* emitter, MD_String8 string)
+{
+	if      (string.size <  32)     md_emit__byte         (emitter, (MD_U8)(0xa0 | string.size));
+	else if (string.size <= 0xFF)   md_export__msgpack_head(emitter, 0xd9, string.size, 1);
+	else if (string.size <= 0xFFFF) md_export__msgpack_head(emitter, 0xda, string.size, 2);
+	else                            md_export__msgpack_head(emitter, 0xdb, string.size, 4);
+	md_emit__write(emitter, string.str, string.size);
+}
+
+md_internal void
+md_export__msgpack_array(MD_Emitter* emitter, MD_U64 count)
+{
+	if      (count <  16)     md_emit__byte         (emitter, (MD_U8)(0x90 | count));
+	else if (count <= 0xFFFF) md_export__msgpack_head(emitter, 0xdc, count, 2);
+	else                      md_export__msgpack_head(emitter, 0xdd, count, 4);
+}
+
+//- Ed: node objects, opened up to the start of their tags & closed after their children
+
+md_internal void
+md_export__open(MD_Emitter* emitter, MD_TextScanKernels* scan, MD_Node* node, MD_ExportFormat format)
+{
+	md_node_first(node);
+	MD_String8 kind = md_export__kind_names[node->kind < MD_NodeKind_COUNT ? node->kind : MD_NodeKind_Nil];
+	if (format == MD_ExportFormat_JSON)
+	{
+		md_emit__write        (emitter, "{\"label\":", 9);
+		md_export__json_string(emitter, scan, node->string);
+		md_emit__write        (emitter, ",\"kind\":\"", 9);
+		md_emit__write        (emitter, kind.str, kind.size);
+		md_emit__write        (emitter, "\",\"flags\":", 10);
+		md_export__json_u64   (emitter, node->flags);
+		md_emit__write        (emitter, ",\"tags\":[", 9);
+	}
+	else
+	{
+		md_emit__write           (emitter, "\x85\xa5label", 7);
+		md_export__msgpack_string(emitter, node->string);
+		md_emit__write           (emitter, "\xa4kind", 5);
+		md_export__msgpack_string(emitter, kind);
+		md_emit__write           (emitter, "\xa5" "flags", 6);
+		md_export__msgpack_u64   (emitter, node->flags);
+		md_emit__write           (emitter, "\xa4tags", 5);
+		md_export__msgpack_array (emitter, md_tag_count_from_node(node));
+	}
+}
+
+md_internal void
+md_export__children(MD_Emitter* emitter, MD_Node* node, MD_ExportFormat format)
+{
+	if (format == MD_ExportFormat_JSON) {
+		md_emit__write(emitter, "],\"children\":[", 14);
+	}
+	else {
+		md_emit__write          (emitter, "\xa8" "children", 9);
+		md_export__msgpack_array(emitter, md_child_count_from_node(node));
+	}
+}
+
+md_force_inline void md_export__close    (MD_Emitter* emitter, MD_ExportFormat format) { if (format == MD_ExportFormat_JSON) md_emit__write(emitter, "]}", 2); }
+md_force_inline void md_export__separator(MD_Emitter* emitter, MD_ExportFormat format) { if (format == MD_ExportFormat_JSON) md_emit__byte (emitter, ','); }
+
+// NOTE(Ed): Tags point back at the node they're on through parent, so like md_node_rec_depth_first the walk only needs the
+// node it's on: down into tags, then children, & at the end of a list back up to the owner, which either starts its children
+// (the list was its tags) or closes.
+void
+md_export_tree(MD_Emitter* emitter, MD_Node* root, MD_ExportFormat format)
+{
+	MD_TextScanKernels* scan = md_text_scan_kernels();
+	MD_Node*            node = root;
+	md_export__open(emitter, scan, node, format);
+	for (;;)
+	{
+		//- Ed: down into the first tag, or the first child
+		if ( ! md_node_is_nil(node->first_tag)) {
+			node = node->first_tag;
+			md_export__open(emitter, scan, node, format);
+			continue;
+		}
+		md_export__children(emitter, node, format);
+		if ( ! md_node_is_nil(md_node_first(node))) {
+			node = node->first;
+			md_export__open(emitter, scan, node, format);
+			continue;
+		}
+		md_export__close(emitter, format);
+
+		//- Ed: up until there's a next node to open
+		MD_B32 opened = 0;
+		while (node != root)
+		{
+			if ( ! md_node_is_nil(node->next)) {
+				md_export__separator(emitter, format);
+				node = node->next;
+				md_export__open(emitter, scan, node, format);
+				opened = 1;
+				break;
+			}
+			MD_Node* owner = node->parent;
+			if (node->kind == MD_NodeKind_Tag)
+			{
+				md_export__children(emitter, owner, format);
+				if ( ! md_node_is_nil(md_node_first(owner))) {
+					node = owner->first;
+					md_export__open(emitter, scan, node, format);
+					opened = 1;
+					break;
+				}
+			}
+			md_export__close(emitter, format);
+			node = owner;
+		}
+		if ( ! opened) {
+			break;
+		}
+	}
+}
+
+MD_String8
+md_export_from_tree__ainfo(MD_AllocatorInfo ainfo, MD_Node* root, MD_ExportFormat format)
+{
+	// Ed: for parse roots, a few times their source covers the keys json & msgpack repeat per node
+	MD_Emitter emitter = md_emitter_alloc__ainfo(ainfo, root->kind == MD_NodeKind_File ? root->raw_string.size * 4 : 0);
+	md_export_tree(&emitter, root, format);
+	return md_emitter_string(&emitter);
+}
+
+MD_B32
+md_export_tree_to_file_path(MD_Node* root, MD_String8 path, MD_ExportFormat format)
+{
+	MD_OS_Handle file = md_os_file_open(MD_OS_AccessFlag_Write, path);
+	if (md_os_handle_match(file, md_os_handle_zero())) {
+		return 0;
+	}
+	MD_TempArena scratch = md_scratch_begin(0, 0);
+	MD_Emitter   emitter = md_emitter_from_file(scratch.arena, file, MD_MB(1));
+	md_export_tree(&emitter, root, format);
+	md_emitter_flush(&emitter);
+	md_os_file_close(file);
+	scratch_end(scratch);
+	return ! emitter.failed;
+}
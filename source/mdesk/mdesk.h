@@ -56,8 +56,7 @@ struct MD_MsgList
 typedef MD_U32 MD_TokenFlags;
 enum
 {
-	// TODO(Ed): Track type of comment, and opening/closing main delimiter. 
-	// (The parser needs that info later and just forces md_str_matches that werent necessary)
+	// TODO(Ed): Track type of comment.
 
 	// rjf: base kind info
 	MD_TokenFlag_Identifier          = (1 << 0),
@@ -79,6 +78,20 @@ enum
 	MD_TokenFlag_BrokenComment       = (1 << 12),
 	MD_TokenFlag_BrokenStringLiteral = (1 << 13),
 	MD_TokenFlag_BadCharacter        = (1 << 14),
+
+	// Ed: which reserved symbol, so the parser never has to compare the token's text
+	MD_TokenFlag_BraceLeft           = (1 << 15),
+	MD_TokenFlag_BraceRight          = (1 << 16),
+	MD_TokenFlag_BracketLeft         = (1 << 17),
+	MD_TokenFlag_BracketRight        = (1 << 18),
+	MD_TokenFlag_ParenLeft           = (1 << 19),
+	MD_TokenFlag_ParenRight          = (1 << 20),
+	MD_TokenFlag_Colon               = (1 << 21),
+	MD_TokenFlag_Semicolon           = (1 << 22),
+	MD_TokenFlag_Comma               = (1 << 23),
+	MD_TokenFlag_At                  = (1 << 24),
+	MD_TokenFlag_Hash                = (1 << 25),
+	MD_TokenFlag_Backslash           = (1 << 26),
 };
 
 typedef MD_U32 MD_TokenFlagGroups;
@@ -90,6 +103,13 @@ enum
 	MD_TokenFlagGroup_Regular    = ~MD_TokenFlagGroup_Irregular,
 	MD_TokenFlagGroup_Label      = (MD_TokenFlag_Identifier | MD_TokenFlag_Numeric | MD_TokenFlag_StringLiteral | MD_TokenFlag_Symbol),
 	MD_TokenFlagGroup_Error      = (MD_TokenFlag_BrokenComment | MD_TokenFlag_BrokenStringLiteral | MD_TokenFlag_BadCharacter),
+	MD_TokenFlagGroup_Opener     = (MD_TokenFlag_BraceLeft  | MD_TokenFlag_BracketLeft  | MD_TokenFlag_ParenLeft),
+	MD_TokenFlagGroup_Closer     = (MD_TokenFlag_BraceRight | MD_TokenFlag_BracketRight | MD_TokenFlag_ParenRight),
+	MD_TokenFlagGroup_Separator  = (MD_TokenFlag_Comma | MD_TokenFlag_Semicolon),
+	MD_TokenFlagGroup_ReservedKind = (
+		MD_TokenFlagGroup_Opener | MD_TokenFlagGroup_Closer | MD_TokenFlagGroup_Separator |
+		MD_TokenFlag_Colon | MD_TokenFlag_At | MD_TokenFlag_Hash | MD_TokenFlag_Backslash
+	),
 };
 
 typedef struct MD_Token MD_Token;
@@ -124,6 +144,123 @@ struct MD_TokenArray
 	MD_U64    count;
 };
 
+// NOTE(Ed): Structure-of-arrays layout of an MD_TokenArray: a 32-bit offset, size & flags is 12 bytes a token,
+// where MD_Token pads out to 24. Text over 4 GB falls back to 64-bit offsets & sizes (the wide arrays), only one pair is set.
+
+typedef struct MD_CompactTokenArray MD_CompactTokenArray;
+struct MD_CompactTokenArray
+{
+	MD_U64  count;
+	MD_U32* flags;
+	MD_U32* offsets;
+	MD_U32* sizes;
+	MD_U64* offsets_wide;
+	MD_U64* sizes_wide;
+};
+
+typedef struct MD_CompactTokenChunkNode MD_CompactTokenChunkNode;
+struct MD_CompactTokenChunkNode
+{
+	MD_CompactTokenChunkNode* next;
+	MD_CompactTokenArray      v;
+	MD_U64                    cap;
+};
+
+typedef struct MD_CompactTokenChunkList MD_CompactTokenChunkList;
+struct MD_CompactTokenChunkList
+{
+	MD_CompactTokenChunkNode* first;
+	MD_CompactTokenChunkNode* last;
+	MD_U64 chunk_count;
+	MD_U64 total_token_count;
+	MD_B32 wide;
+};
+
+// NOTE(Ed): A token the parser acts on, with the whitespace, comment & newline tokens since the previous one folded into it.
+// trivia holds the newline count shifted above a bit that's set when there was any trivia at all (tags & their argument
+// parens must directly follow). Same size as MD_Token, which pads out to 24 bytes.
+typedef struct MD_SignificantToken MD_SignificantToken;
+struct MD_SignificantToken
+{
+	MD_Rng1U64    range;
+	MD_TokenFlags flags;
+	MD_U32        trivia;
+};
+
+#define MD_TOKEN_TRIVIA_NEWLINE_MAX (MD_MAX_U32 >> 1)
+
+typedef struct MD_SignificantTokenChunkNode MD_SignificantTokenChunkNode;
+struct MD_SignificantTokenChunkNode
+{
+	MD_SignificantTokenChunkNode* next;
+	MD_SignificantToken*          v;
+	MD_Rng1U64*                   comments;
+	MD_U64                        count;
+	MD_U64                        cap;
+};
+
+typedef struct MD_SignificantTokenChunkList MD_SignificantTokenChunkList;
+struct MD_SignificantTokenChunkList
+{
+	MD_SignificantTokenChunkNode* first;
+	MD_SignificantTokenChunkNode* last;
+	MD_U64 chunk_count;
+	MD_U64 total_token_count;
+};
+
+typedef struct MD_SignificantTokenArray MD_SignificantTokenArray;
+struct MD_SignificantTokenArray
+{
+	MD_SignificantToken* v;
+	MD_Rng1U64*          comments; // only when asked for: from the first to the last comment folded into each token, empty without one
+	MD_U64               count;
+};
+
+// Trivia carried between md_significant_tokens_from_tokens calls, for folding a token stream a window at a time
+typedef struct MD_SignificantTokenFold MD_SignificantTokenFold;
+struct MD_SignificantTokenFold
+{
+	MD_U32     trivia;
+	MD_Rng1U64 comment;
+};
+
+////////////////////////////////
+//~ Ed: Atom Types
+
+// Interned id of a string, equal strings interned in the same MD_AtomTable get the same atom.
+// 0 is no atom: the empty string & strings that weren't interned.
+typedef MD_U32 MD_Atom;
+
+typedef struct MD_AtomEntry MD_AtomEntry;
+struct MD_AtomEntry
+{
+	MD_AtomEntry* next;
+	MD_U64        hash;
+	MD_String8    string;
+	MD_Atom       atom;
+};
+
+typedef struct MD_AtomBuckets MD_AtomBuckets;
+struct MD_AtomBuckets
+{
+	MD_AtomBuckets*         prev; // the buckets these replaced, kept until release for lookups still walking them
+	MD_AtomEntry* volatile* buckets;
+	MD_U64                  bucket_count; // power of two
+};
+
+// NOTE(Ed): Entries are only ever pushed onto the front of a bucket's chain once they're fully written, so lookups never lock
+// & any number of threads (parallel parses included) can share a table. Interning a string that isn't in it yet takes the mutex.
+// Once there are more entries than buckets, the entries are copied into twice the buckets & those are swapped in,
+// the old ones stay around until release, so sizing the table for the distinct strings expected still saves memory.
+typedef struct MD_AtomTable MD_AtomTable;
+struct MD_AtomTable
+{
+	MD_AllocatorInfo         ainfo; // buckets, entries & copies of their strings, only used under the mutex
+	MD_OS_Handle             mutex;
+	MD_AtomBuckets* volatile buckets;
+	volatile MD_U64          count;
+};
+
 ////////////////////////////////
 //~ rjf: MD_Node Types
 
@@ -171,6 +308,9 @@ enum
 };
 #define MD_NodeFlag_AfterFromBefore(f) ((f) << 1)
 
+typedef struct MD_LazySet    MD_LazySet;
+typedef struct MD_ChildIndex MD_ChildIndex;
+
 typedef struct MD_Node MD_Node;
 struct MD_Node
 {
@@ -201,8 +341,22 @@ struct MD_Node
 	// to nodes)
 	MD_U64 user_gen;
 	
-	// rjf: extra padding to 128 bytes
-	MD_U64 _unused_[2];
+	// Ed: set whose children haven't been parsed yet (see md_node_materialize), or once they have been, an index of them
+	// (see md_child_index_from_node). A set has no children to index until it's parsed, has_child_index tells which it is.
+	union {
+		MD_LazySet*    lazy;
+		MD_ChildIndex* child_index;
+	};
+
+	// Ed: string's atom, when parsed with an MD_AtomTable (see md_parse_from_text_atoms)
+	MD_Atom atom;
+
+	MD_B16 has_child_index;
+
+	// Ed: bloom filter of the tags' strings (see md_tag_filter_from_str8), kept by the parser, md_node_push_tag & md_node_insert_tag.
+	// 0 when the tags weren't added through those, lookups then always walk the tags. Code that links tags in by hand or
+	// changes a tag's string on a node that already has some must call md_node_refresh_tag_filter, or exact lookups may miss.
+	MD_U16 tag_filter;
 };
 
 typedef struct MD_NodeRec MD_NodeRec;
@@ -213,9 +367,89 @@ struct MD_NodeRec
 	MD_S32   pop_count;
 };
 
+////////////////////////////////
+//~ Ed: Child Index Types
+
+// NOTE(Ed): md_child_from_string, md_child_from_index, md_child_count_from_node & md_index_from_node walk the sibling list,
+// which makes resolving every key of a wide node (asset or string tables) quadratic. A node can carry an index instead: its
+// children in an array, a hash of their labels & a hash of their positions, which those lookups use when it's there.
+// The parsers (lazy sets included), flat tree & parse cache loads & md_tree_copy give every node with at least
+// MD_CHILD_INDEX_THRESHOLD children one, made with the tree's own allocator so it goes with the tree. Lookups never build one,
+// md_child_index_from_node does for trees built by hand. Nodes without one, & tags which never have one, walk the whole list:
+// md_tag_count_from_node & md_index_from_node on a tag are linear in the node's tag count.
+// Pushing, inserting or unhooking a node's children drops its index (the memory stays with the allocator until it's released),
+// modifying a tree through its links directly won't, call md_child_index_release after doing so.
+
+#ifndef MD_CHILD_INDEX_THRESHOLD
+#define MD_CHILD_INDEX_THRESHOLD 64
+#endif
+
+struct MD_ChildIndex
+{
+	MD_Node*  node;
+	MD_Node** children;
+	MD_U64    count;
+	MD_U32*   slots;          // open addressed by the hash of a label, position of the first child with it + 1, 0 if empty
+	MD_U32*   position_slots; // open addressed by the hash of a child's address, its position + 1, 0 if empty
+	MD_U64    slot_mask;
+};
+
+////////////////////////////////
+//~ Ed: Text Scanning Kernel Types
+
+// NOTE(Ed): The tokenizer spends most of its time finding where a run of bytes ends
+// (whitespace, identifiers, numerics, string & comment bodies). These kernels do that
+// 16 (SSE2) or 32 (AVX2) bytes at a time. The widest level supported by the cpu is
+// selected the first time they're used, a scalar fallback is always available.
+
+typedef enum MD_TextScanLevel MD_TextScanLevel;
+enum MD_TextScanLevel
+{
+	MD_TextScanLevel_Scalar,
+	MD_TextScanLevel_SSE2,
+	MD_TextScanLevel_AVX2,
+	MD_TextScanLevel_COUNT,
+};
+
+typedef MD_U8* MD_TextScanFindAnyProc(MD_U8* byte, MD_U8* byte_opl, MD_U8 a, MD_U8 b, MD_U8 c);
+typedef MD_U8* MD_TextScanFindPairProc(MD_U8* byte, MD_U8* byte_opl, MD_U8 first, MD_U8 second);
+typedef MD_U8* MD_TextScanSkipProc(MD_U8* byte, MD_U8* byte_opl);
+
+typedef struct MD_TextScanKernels MD_TextScanKernels;
+struct MD_TextScanKernels
+{
+	MD_TextScanLevel         level;
+	MD_TextScanFindAnyProc*  find_any;        // first byte equal to a, b, or c
+	MD_TextScanFindPairProc* find_pair;       // first `first` immediately followed by `second`
+	MD_TextScanSkipProc*     skip_whitespace; // first byte that isn't ' ', '\t', '\v', '\r'
+	MD_TextScanSkipProc*     skip_identifier; // first byte that isn't [A-Za-z0-9_] or a utf8 leading byte
+	MD_TextScanSkipProc*     skip_numeric;    // first byte that isn't [A-Za-z0-9_.]
+	MD_TextScanSkipProc*     find_escape;     // first '"', '\\' or control byte below 0x20 (what a json string has to escape)
+};
+
 ////////////////////////////////
 //~ rjf: Text -> Tokens Types
 
+// NOTE(Ed): Every byte maps to the class of token it can start, the tokenizer dispatches on it once per token.
+// Slash & NumericSign need one byte of lookahead to pick between a comment/numeric and a symbol run.
+typedef MD_U8 MD_TokenByteClass;
+enum
+{
+	MD_TokenByteClass_Bad,
+	MD_TokenByteClass_Whitespace,  // ' ' '\t' '\v' '\r'
+	MD_TokenByteClass_Newline,
+	MD_TokenByteClass_Identifier,  // A-Z a-z _ & utf8 leading bytes
+	MD_TokenByteClass_Digit,
+	MD_TokenByteClass_Quote,       // " ' `
+	MD_TokenByteClass_Reserved,    // { } ( ) [ ] # , \ : ; @
+
+	// NOTE(Ed): Symbol classes must stay last, symbol runs continue while (class >= MD_TokenByteClass_Symbol)
+	MD_TokenByteClass_Symbol,      // ~ ! $ % ^ & * = + < > ? |
+	MD_TokenByteClass_Slash,       // '/'
+	MD_TokenByteClass_NumericSign, // '.' '-'
+	MD_TokenByteClass_COUNT
+};
+
 typedef struct MD_TokenizeResult MD_TokenizeResult;
 struct MD_TokenizeResult
 {
@@ -223,6 +457,93 @@ struct MD_TokenizeResult
   MD_MsgList    msgs;
 };
 
+typedef struct MD_TokenizeCompactResult MD_TokenizeCompactResult;
+struct MD_TokenizeCompactResult
+{
+	MD_CompactTokenArray tokens;
+	MD_MsgList           msgs;
+};
+
+typedef struct MD_TokenizeSignificantResult MD_TokenizeSignificantResult;
+struct MD_TokenizeSignificantResult
+{
+	MD_SignificantTokenArray tokens;
+	MD_MsgList               msgs;
+};
+
+typedef struct MD_TokenizeEditResult MD_TokenizeEditResult;
+struct MD_TokenizeEditResult
+{
+	MD_TokenArray tokens;
+	MD_MsgList    msgs;
+	MD_Rng1U64    relexed; // indices of the tokens that were lexed again, every other token was copied from the old array
+};
+
+////////////////////////////////
+//~ Ed: Token Cursor Types
+
+// Tokens a cursor holds at once, the parser looks at most 2 past the one it's on
+#ifndef MD_TOKEN_CURSOR_WINDOW
+#define MD_TOKEN_CURSOR_WINDOW 512
+#endif
+
+// NOTE(Ed): Lexes significant tokens on demand, a window at a time, for md_parse_from_text_fused.
+// Only the window is ever in memory, a peek past it slides the window forward (keeping the last few tokens).
+typedef struct MD_TokenCursor MD_TokenCursor;
+struct MD_TokenCursor
+{
+	MD_String8              text;
+	MD_U64                  lex_offset; // where lexing picks up
+	MD_U64                  first_idx;  // index of v[0] in the whole significant token stream
+	MD_U64                  count;
+	MD_SignificantTokenFold fold;
+	MD_SignificantToken     v  [MD_TOKEN_CURSOR_WINDOW];
+	MD_Token                lex[MD_TOKEN_CURSOR_WINDOW]; // staging for each fill, before the trivia is folded out
+};
+
+////////////////////////////////
+//~ Ed: Parallel Text -> Tokens Types
+
+// Below this many bytes per thread, md_tokenize_from_text_parallel doesn't split the text
+#ifndef MD_TOKENIZE_PARALLEL_MIN_SEGMENT_SIZE
+#define MD_TOKENIZE_PARALLEL_MIN_SEGMENT_SIZE MD_KB(256)
+#endif
+
+////////////////////////////////
+//~ Ed: Streaming Text -> Tokens Types
+
+// NOTE(Ed): Tokenizes text that arrives in chunks (pipes, decompression, etc) without buffering all of it.
+// Complete tokens are emitted as each chunk is pushed, the one token that reaches the end of a chunk is
+// carried (with its scan state) into the next. The carry buffer only grows to the longest token seen.
+// Output matches md_tokenize_from_text on the concatenated chunks.
+typedef struct MD_TokenizeStream MD_TokenizeStream;
+struct MD_TokenizeStream
+{
+	MD_AllocatorInfo backing;      // owns the carry buffer
+	MD_U64           offset;       // stream offset of the next chunk
+	MD_U8*           chunk_first;
+
+	//- Ed: pending token
+	MD_U8*        carry;
+	MD_U64        carry_size;
+	MD_U64        carry_cap;
+	MD_U64        token_offset;
+	MD_TokenFlags flags;
+	MD_U32        state;
+	MD_U8         literal_style;
+	MD_U8         run;           // quotes seen (strings) or a trailing '*' (block comments)
+	MD_B8         escaped;
+};
+
+typedef struct MD_TokenizeStreamResult MD_TokenizeStreamResult;
+struct MD_TokenizeStreamResult
+{
+	MD_TokenArray tokens;        // ranges are offsets from the start of the stream
+	MD_MsgList    msgs;
+	MD_String8    spanning_text; // text of tokens.v[0] when it began in an earlier chunk
+	MD_U64        chunk_offset;  // stream offset of the pushed chunk
+};
+
 ////////////////////////////////
 //~ rjf: Tokens -> Tree Types
 
@@ -233,6 +554,408 @@ struct MD_ParseResult
 	MD_MsgList msgs;
 };
 
+typedef MD_U32 MD_ParseFilterFlags;
+enum
+{
+	MD_ParseFilterFlag_NoSkippedErrors = (1 << 0), // don't report errors from the nodes that get skipped
+};
+
+// Ed: top-level nodes are only built when one of their tags is named in tags (matched exactly), the rest are skipped without allocating.
+// The tags of a skipped node are still parsed, they're needed to tell.
+typedef struct MD_ParseFilter MD_ParseFilter;
+struct MD_ParseFilter
+{
+	MD_String8Array     tags;
+	MD_ParseFilterFlags flags;
+};
+
+////////////////////////////////
+//~ Ed: Flat Tree Types
+
+// Index of a node in an MD_FlatTree, 0 is nil
+typedef MD_U32 MD_FlatNode;
+
+// NOTE(Ed): Read-only MD_Node tree with each field in its own array, indexed by MD_FlatNode. 41 bytes a node (MD_Node is 128).
+// Nodes are in pre-order with a node's tags ahead of its children, so every subtree is a contiguous range of indices.
+// Strings are offsets into text, strings that weren't in text are copied into extra, whose offsets start at text.size.
+// Holds up to 4 GB of strings & 4G nodes, user_gen isn't kept.
+typedef struct MD_FlatTree MD_FlatTree;
+struct MD_FlatTree
+{
+	MD_String8    text;
+	MD_String8    extra;
+	MD_U64        count; // including the nil node
+	MD_U8*        kinds;
+	MD_NodeFlags* flags;
+	MD_U32*       string_offsets;
+	MD_U32*       string_sizes;
+	MD_U32*       raw_offsets;
+	MD_U32*       raw_sizes;
+	MD_U32*       src_offsets;
+	MD_FlatNode*  parents;
+	MD_FlatNode*  firsts;
+	MD_FlatNode*  nexts;
+	MD_FlatNode*  first_tags;
+};
+
+typedef struct MD_FlatParseResult MD_FlatParseResult;
+struct MD_FlatParseResult
+{
+	MD_FlatTree tree;
+	MD_MsgList  msgs;
+};
+
+////////////////////////////////
+//~ Ed: Flat Tree File Types
+
+#define MD_FLAT_TREE_FILE_MAGIC   0x5446444D // "MDFT", in native byte order
+#define MD_FLAT_TREE_FILE_VERSION 1
+
+typedef enum MD_FlatTreeSection MD_FlatTreeSection;
+enum MD_FlatTreeSection
+{
+	MD_FlatTreeSection_Kinds,
+	MD_FlatTreeSection_Flags,
+	MD_FlatTreeSection_StringOffsets,
+	MD_FlatTreeSection_StringSizes,
+	MD_FlatTreeSection_RawOffsets,
+	MD_FlatTreeSection_RawSizes,
+	MD_FlatTreeSection_SrcOffsets,
+	MD_FlatTreeSection_Parents,
+	MD_FlatTreeSection_Firsts,
+	MD_FlatTreeSection_Nexts,
+	MD_FlatTreeSection_FirstTags,
+	MD_FlatTreeSection_Strings, // the tree's text, then its extra
+	MD_FlatTreeSection_COUNT
+};
+
+// NOTE(Ed): An MD_FlatTree as it is in memory, each array in its own 8-byte aligned section after this header.
+// Nodes link by index & strings are offsets into the string section, so a loaded file is used in place.
+typedef struct MD_FlatTreeFileHeader MD_FlatTreeFileHeader;
+struct MD_FlatTreeFileHeader
+{
+	MD_U32 magic;
+	MD_U32 version;
+	MD_U64 count;
+	MD_U64 text_size;
+	MD_U64 extra_size;
+	MD_U64 section_offsets[MD_FlatTreeSection_COUNT]; // from the start of the file
+};
+
+// A flat tree file mapped into memory, tree points into the view
+typedef struct MD_FlatTreeMap MD_FlatTreeMap;
+struct MD_FlatTreeMap
+{
+	MD_FlatTree  tree; // count of 0 when the file couldn't be mapped or isn't a flat tree file
+	MD_OS_Handle file;
+	MD_OS_Handle map;
+	void*        view;
+	MD_Rng1U64   range;
+};
+
+////////////////////////////////
+//~ Ed: Lazy Parse Types
+
+// NOTE(Ed): Shared by every node of a lazily parsed tree. Explicitly delimited sets ({}, [] & ()) are left as a node holding
+// the span of text between their delimiters, which is lexed & parsed the first time the children are reached through md_node_first.
+// No tokens are kept around, so memory goes with what gets touched. Tag arguments are always parsed up front.
+typedef struct MD_LazyParse MD_LazyParse;
+struct MD_LazyParse
+{
+	MD_AllocatorInfo ainfo;
+	MD_String8       text;
+	MD_MsgList       msgs; // grows as sets are parsed
+	MD_U64           sets_parsed;
+};
+
+struct MD_LazySet
+{
+	MD_LazyParse* parse;
+	MD_Rng1U64    range; // just past the opener, through the closer (or the end of the text)
+};
+
+typedef struct MD_LazyParseResult MD_LazyParseResult;
+struct MD_LazyParseResult
+{
+	MD_Node*      root;
+	MD_LazyParse* lazy;
+};
+
+////////////////////////////////
+//~ Ed: Parallel Tokens -> Tree Types
+
+// Below this many tokens per thread, md_parse_from_text_tokens_parallel doesn't split the tokens
+#ifndef MD_PARSE_PARALLEL_MIN_RANGE_TOKENS
+#define MD_PARSE_PARALLEL_MIN_RANGE_TOKENS (1 << 16)
+#endif
+
+////////////////////////////////
+//~ Ed: Parse Cache Types
+
+#define MD_PARSE_CACHE_MAGIC   0x4350444D // "MDPC", in native byte order
+#define MD_PARSE_CACHE_VERSION 1          // bump whenever the parser's output for the same text changes
+
+// Every this many stores through an MD_ParseCache with a max_total_size, the store trims the directory
+#ifndef MD_PARSE_CACHE_TRIM_INTERVAL
+#define MD_PARSE_CACHE_TRIM_INTERVAL 64
+#endif
+
+// NOTE(Ed): Entries are keyed by a hash of the text, seeded with the library & cache versions & options_hash,
+// so a change to any of them just misses & stale entries age out through md_parse_cache_trim.
+// Stores trim every MD_PARSE_CACHE_TRIM_INTERVAL stores, so between trims the directory can run over max_total_size
+// by that many entries (and by whatever other processes store), call md_parse_cache_trim for an exact cut.
+typedef struct MD_ParseCache MD_ParseCache;
+struct MD_ParseCache
+{
+	MD_String8 dir;            // made on the first store if it doesn't exist
+	MD_U64     options_hash;   // anything else that changes what the caller parses
+	MD_U64     max_entry_size; // larger entries aren't stored, 0 for no limit
+	MD_U64     max_total_size; // the oldest entries past this are evicted by trims, 0 for no limit
+	MD_U64     store_count;    // entries stored through this cache, counts toward the next trim
+};
+
+// An entry: this header, msg_count records, the strings of the messages, then (8-byte aligned) a flat tree file
+typedef struct MD_ParseCacheEntryHeader MD_ParseCacheEntryHeader;
+struct MD_ParseCacheEntryHeader
+{
+	MD_U32 magic;
+	MD_U32 version;
+	MD_U64 key;
+	MD_U64 msg_count;
+	MD_U64 msgs_size; // records & strings, not including padding
+};
+
+typedef struct MD_ParseCacheMsg MD_ParseCacheMsg;
+struct MD_ParseCacheMsg
+{
+	MD_U32       kind;
+	MD_U32       node_kind;
+	MD_NodeFlags node_flags;
+	MD_U32       node_src_offset;
+	MD_U32       node_string_size;
+	MD_U32       node_raw_string_size;
+	MD_U32       string_size;
+	MD_U32       _pad;
+};
+
+////////////////////////////////
+//~ Ed: Selector Types
+
+// NOTE(Ed): A selector is a path of steps compiled once & run over any number of trees, instead of hand-written loops:
+//
+//   @table/*[@required]/name     children of the root tagged table, their children tagged required, their children labeled name
+//   //entry[kind=texture]        entries at any depth whose child kind has the child texture
+//
+// Steps are separated by / (children of the previous step's matches) or // (descendants at any depth), a leading // searches
+// the whole tree. A step is * (any node), a label, or @tag (any node with that tag), followed by any number of predicates:
+//
+//   [@tag]  [@tag=arg]  has the tag, whose first argument is arg
+//   [child] [child=v]   has a child labeled child, whose first child is v
+//   [!...]              none of the above
+//
+// Labels & values are runs of anything but whitespace & / [ ] = @ * ! or quoted with " ' or `. Matches are exact.
+// A selector is for convenience, not speed: a walk costs about what the equivalent hand-written loop does, a little more.
+
+#ifndef MD_SELECTOR_MAX_STEPS
+// The engine tracks the steps each node is tested against in a U64
+#define MD_SELECTOR_MAX_STEPS 64
+#endif
+
+typedef struct MD_NodeArray MD_NodeArray;
+struct MD_NodeArray
+{
+	MD_Node** v;
+	MD_U64    count;
+};
+
+typedef enum MD_SelectorPredKind MD_SelectorPredKind;
+enum MD_SelectorPredKind
+{
+	MD_SelectorPredKind_HasTag,
+	MD_SelectorPredKind_TagArgEquals,
+	MD_SelectorPredKind_HasChild,
+	MD_SelectorPredKind_ChildEquals,
+	MD_SelectorPredKind_COUNT,
+};
+
+typedef struct MD_SelectorPred MD_SelectorPred;
+struct MD_SelectorPred
+{
+	MD_SelectorPredKind kind;
+	MD_B32              negate;
+	MD_String8          key;   // tag or child label
+	MD_String8          value; // its first argument or child
+};
+
+typedef MD_U32 MD_SelectorStepFlags;
+enum
+{
+	MD_SelectorStepFlag_Descendants = (1 << 0), // matches at any depth below the previous step's matches, not only children
+	MD_SelectorStepFlag_AnyLabel    = (1 << 1),
+};
+
+typedef struct MD_SelectorStep MD_SelectorStep;
+struct MD_SelectorStep
+{
+	MD_SelectorStepFlags flags;
+	MD_String8           label;
+	MD_U64               first_pred;
+	MD_U64               pred_count;
+};
+
+typedef struct MD_Selector MD_Selector;
+struct MD_Selector
+{
+	MD_String8       source;
+	MD_SelectorStep* steps;
+	MD_U64           step_count; // 0 when source had errors
+	MD_SelectorPred* preds;
+	MD_U64           pred_count;
+	MD_MsgList       msgs;       // ErrorMarker nodes' src_offset is the byte offset into source
+};
+
+////////////////////////////////
+//~ Ed: Lookup Path Types
+
+// NOTE(Ed): A lookup path is a chain of md_child_from_string calls, "renderer/shadows/cascade_count", split into labels once
+// & resolved through md_lookup_path_resolve, which remembers the node it found. The memo holds while the tree generation is
+// unchanged, every function that edits a tree's structure (md_node_push_child, md_node_insert_child, md_node_push_tag,
+// md_node_insert_tag, md_unhook) bumps it, as does every function that builds a tree (parses, md_tree_copy, flat tree &
+// parse cache loads) since a new tree can land at the address of one whose arena was cleared. Nodes have no room for a
+// generation of their own so the counter is shared by all trees: an edit anywhere sends handles back through the walk once.
+// Code that edits MD_Node links or strings directly, or builds a tree out of md_push_node, should call md_tree_generation_bump after.
+//
+// A handle's memo isn't synchronized, threads resolving the same path each want their own copy of it.
+
+typedef struct MD_LookupPath MD_LookupPath;
+struct MD_LookupPath
+{
+	MD_String8*         labels;
+	MD_U64              count;
+	MD_StringMatchFlags flags;
+
+	// Ed: last resolve, node may be nil
+	MD_Node*            root;
+	MD_Node*            node;
+	MD_U64              generation;
+};
+
+////////////////////////////////
+//~ Ed: Tree Hash Types
+
+// NOTE(Ed): MD_TreeHashes holds a hash of every subtree under a root, taken bottom up over what tree_match compares: kind,
+// flags, string, tags (with their arguments) & children, in order. Source offsets & raw strings aren't part of it, so the same
+// tree parsed from differently spaced or commented text hashes the same. Hashes are 64 bit & equal ones are taken as equal
+// trees (md_tree_match_hashed, md_tree_diff), mistaking two different trees for each other takes a collision.
+//
+// Nodes have no room for a hash, so they're kept in preorder entries next to the tree: a node, each of its tags followed by
+// the tag's arguments, then its children, with the size of each subtree so a list of siblings can be stepped over without the
+// nodes. Entries are filled in chunks during a single walk, the count isn't known before it. Like MD_LookupPath they hold
+// while the tree generation is unchanged & are rebuilt by md_tree_hashes_refresh.
+
+#ifndef MD_TREE_HASH_CHUNK_SIZE
+#define MD_TREE_HASH_CHUNK_SIZE 4096
+#endif
+
+typedef struct MD_TreeHashChunk MD_TreeHashChunk;
+struct MD_TreeHashChunk
+{
+	MD_Node* nodes [MD_TREE_HASH_CHUNK_SIZE];
+	MD_U64   hashes[MD_TREE_HASH_CHUNK_SIZE];
+	MD_U64   sizes [MD_TREE_HASH_CHUNK_SIZE]; // entries in each node's subtree, itself included
+};
+
+typedef struct MD_TreeHashes MD_TreeHashes;
+struct MD_TreeHashes
+{
+	MD_AllocatorInfo   ainfo;
+	MD_Node*           root;
+	MD_U64             generation; // md_tree_generation() when hashed
+	MD_U64             count;      // nodes under root, root, tags & tag arguments included
+	MD_TreeHashChunk** chunks;     // entry i is in chunks[i / MD_TREE_HASH_CHUNK_SIZE]
+	MD_U64             chunk_cap;
+	MD_U64*            slots;      // node -> entry + 1, open addressed by pointer (0 is empty), built on the first lookup below the root
+	MD_U64             slot_mask;
+};
+
+// NOTE(Ed): md_tree_diff pairs up nodes of the two trees from their roots down, only looking under pairs whose hashes differ.
+// Siblings are paired by kind & string in order (the first unpaired one with the same label), leaves left over between two
+// pairs are paired by position (an edited value), & what's still left was removed from a or added to b. A pair whose own
+// kind, flags or string differ is changed. Added & removed subtrees are listed by their root only.
+//
+// Each entry has a node from both trees, src_offset gives where in the text: for added nodes a is the node in a that
+// gained the child (or tag), for removed ones b is the node in b that lost it.
+
+typedef struct MD_TreeDiffEntry MD_TreeDiffEntry;
+struct MD_TreeDiffEntry
+{
+	MD_TreeDiffEntry* next;
+	MD_Node*          a;
+	MD_Node*          b;
+};
+
+typedef struct MD_TreeDiffList MD_TreeDiffList;
+struct MD_TreeDiffList
+{
+	MD_TreeDiffEntry* first;
+	MD_TreeDiffEntry* last;
+	MD_U64            count;
+};
+
+typedef struct MD_TreeDiff MD_TreeDiff;
+struct MD_TreeDiff
+{
+	MD_TreeDiffList added;
+	MD_TreeDiffList removed;
+	MD_TreeDiffList changed;
+};
+
+////////////////////////////////
+//~ Ed: Canonical Text Emitter Types
+
+// NOTE(Ed): md_emit_node & md_emit_children write trees back out as metadesk text that parses to the same tree: tags, labels
+// quoted the way their string flags say, set delimiters & separators are kept, comments & the original spacing aren't.
+// Sets opened with a brace get a child per line indented with tabs, other sets stay on one line, & sets without delimiters
+// are written as implicit sets ("label: a b c") wherever the parser would read them back as one.
+//
+// The text goes into a single buffer that doubles when it fills (an arena keeps the blocks it outgrew), or into a block
+// that's written to a file or handed to a sink each time it fills.
+
+// Ed: takes a filled block, returns 0 if it couldn't take it (the emitter keeps going, but remembers it failed)
+typedef MD_B32 MD_EmitterSinkFunc(void* user_data, MD_String8 block);
+
+typedef struct MD_Emitter MD_Emitter;
+struct MD_Emitter
+{
+	MD_AllocatorInfo    ainfo;
+	MD_U8*              str;
+	MD_U64              size;        // bytes in str, not yet written when emitting to a file or sink
+	MD_U64              cap;
+	MD_OS_Handle        file;        // zero when emitting into memory
+	MD_EmitterSinkFunc* sink;        // used over file when set
+	void*               sink_data;
+	MD_U64              file_offset; // bytes written to the file or sink so far
+	MD_B32              failed;      // a write to the file or sink came up short
+};
+
+////////////////////////////////
+//~ Ed: Tree Export Types
+
+// NOTE(Ed): md_export_tree writes a tree out for tools that don't read metadesk, as JSON or MessagePack. Every node, tags
+// included, becomes an object (a map in MessagePack) with the same keys in the same order:
+//   {"label":"...","kind":"Main","flags":2048,"tags":[...],"children":[...]}
+// Tags are nodes of kind "Tag" whose children are their arguments, flags are the MD_NodeFlags bits as a number. Nothing is
+// left out & nothing depends on where the tree came from, so a tree always exports to the same bytes. Labels are written
+// byte for byte, JSON only escapes '"', '\\' & control bytes, so a label that isn't utf8 won't be either.
+
+typedef MD_U32 MD_ExportFormat;
+enum
+{
+	MD_ExportFormat_JSON,
+	MD_ExportFormat_MsgPack,
+	MD_ExportFormat_COUNT,
+};
+
 ////////////////////////////////
 // MD_Context
 
@@ -354,6 +1077,35 @@ md_token_match(MD_Token a, MD_Token b) {
 			a.flags     == b.flags       );
 }
 
+////////////////////////////////
+//~ Ed: Compact MD_Token Type Functions
+
+MD_API void                 md_compact_token_chunk_list_push__ainfo       (MD_AllocatorInfo ainfo, MD_CompactTokenChunkList* list, MD_U64 cap, MD_Token token);
+MD_API MD_CompactTokenArray md_compact_token_array_from_chunk_list__ainfo (MD_AllocatorInfo ainfo, MD_CompactTokenChunkList* chunks);
+MD_API MD_CompactTokenArray md_compact_token_array_from_token_array__ainfo(MD_AllocatorInfo ainfo, MD_TokenArray tokens);
+
+#define md_compact_token_chunk_list_push(allocator, list, cap, token)  _Generic(allocator, MD_Arena*: md_compact_token_chunk_list_push__arena,        MD_AllocatorInfo: md_compact_token_chunk_list_push__ainfo,        default: md_assert_generic_sel_fail) md_generic_call(allocator, list, cap, token)
+#define md_compact_token_array_from_chunk_list(allocator, chunks)      _Generic(allocator, MD_Arena*: md_compact_token_array_from_chunk_list__arena,  MD_AllocatorInfo: md_compact_token_array_from_chunk_list__ainfo,  default: md_assert_generic_sel_fail) md_generic_call(allocator, chunks)
+#define md_compact_token_array_from_token_array(allocator, tokens)     _Generic(allocator, MD_Arena*: md_compact_token_array_from_token_array__arena, MD_AllocatorInfo: md_compact_token_array_from_token_array__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, tokens)
+
+md_force_inline void                 md_compact_token_chunk_list_push__arena       (MD_Arena* arena, MD_CompactTokenChunkList* list, MD_U64 cap, MD_Token token) { md_compact_token_chunk_list_push__ainfo(md_arena_allocator(arena), list, cap, token); }
+md_force_inline MD_CompactTokenArray md_compact_token_array_from_chunk_list__arena (MD_Arena* arena, MD_CompactTokenChunkList* chunks)                           { return md_compact_token_array_from_chunk_list__ainfo(md_arena_allocator(arena), chunks); }
+md_force_inline MD_CompactTokenArray md_compact_token_array_from_token_array__arena(MD_Arena* arena, MD_TokenArray tokens)                                        { return md_compact_token_array_from_token_array__ainfo(md_arena_allocator(arena), tokens); }
+
+inline MD_Rng1U64
+md_compact_token_range(MD_CompactTokenArray* tokens, MD_U64 idx) {
+	if (tokens->offsets_wide != 0) {
+		return md_r1u64(tokens->offsets_wide[idx], tokens->offsets_wide[idx] + tokens->sizes_wide[idx]);
+	}
+	return md_r1u64(tokens->offsets[idx], (MD_U64)tokens->offsets[idx] + tokens->sizes[idx]);
+}
+
+inline MD_Token
+md_compact_token_at(MD_CompactTokenArray* tokens, MD_U64 idx) {
+	MD_Token token = { md_compact_token_range(tokens, idx), tokens->flags[idx] };
+	return token;
+}
+
 ////////////////////////////////
 //~ rjf: MD_Node Type Functions
 
@@ -400,7 +1152,42 @@ void md_node_push_child  (MD_Node* parent, MD_Node* node);
 void md_node_push_tag    (MD_Node* parent, MD_Node* node);
 void md_unhook           (MD_Node* node);
 
-inline MD_Node* md_push_node__arena(MD_Arena* arena, MD_NodeKind kind, MD_NodeFlags flags, MD_String8 string, MD_String8 raw_string, MD_U64 src_offset) { md_push_node__ainfo(md_arena_allocator(arena), kind, flags, string, raw_string, src_offset); }
+// Ed: count of structural edits made through the functions above, for memoized lookups (see MD_LookupPath)
+MD_API MD_U64 md_tree_generation     (void);
+MD_API void   md_tree_generation_bump(void);
+
+MD_U16 md_tag_filter_from_str8   (MD_String8 string);
+void   md_node_refresh_tag_filter(MD_Node* node);
+
+// Ed: the node's child index, building it from allocator if it doesn't have one yet (0 for nil).
+// Not synchronized with lookups on the node, like any other edit.
+MD_API MD_ChildIndex* md_child_index_from_node__ainfo(MD_AllocatorInfo ainfo, MD_Node* node);
+// Ed: the node's child index if it has one, never builds
+       MD_ChildIndex* md_child_index_lookup          (MD_Node* node);
+       void           md_child_index_release         (MD_Node* node);
+// Ed: the first child labeled exactly string, nil if there's none
+MD_API MD_Node*       md_child_index_find            (MD_ChildIndex* index, MD_String8 string);
+// Ed: the child's position among the indexed node's children, MD_MAX_U64 if it isn't one of them
+MD_API MD_U64         md_child_index_position        (MD_ChildIndex* index, MD_Node* child);
+
+#define md_child_index_from_node(allocator, node) _Generic(allocator, MD_Arena*: md_child_index_from_node__arena, MD_AllocatorInfo: md_child_index_from_node__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, node)
+
+md_force_inline MD_ChildIndex* md_child_index_from_node__arena(MD_Arena* arena, MD_Node* node) { return md_child_index_from_node__ainfo(md_arena_allocator(arena), node); }
+
+// Ed: an index that was copied along with its node (by value) belongs to the original, it reads as none
+inline MD_ChildIndex*
+md_child_index_lookup(MD_Node* node) {
+	return (node->has_child_index && node->child_index != 0 && node->child_index->node == node) ? node->child_index : 0;
+}
+
+// Ed: the pointer goes first, a node with has_child_index set & no pointer reads as unindexed rather than as a lazy set
+inline void
+md_child_index_release(MD_Node* node) {
+	node->child_index     = 0;
+	node->has_child_index = 0;
+}
+
+inline MD_Node* md_push_node__arena(MD_Arena* arena, MD_NodeKind kind, MD_NodeFlags flags, MD_String8 string, MD_String8 raw_string, MD_U64 src_offset) { return md_push_node__ainfo(md_arena_allocator(arena), kind, flags, string, raw_string, src_offset); }
 
 inline MD_Node*
 md_push_node__ainfo(MD_AllocatorInfo ainfo, MD_NodeKind kind, MD_NodeFlags flags, MD_String8 string, MD_String8 raw_string, MD_U64 src_offset) {
@@ -414,34 +1201,77 @@ md_push_node__ainfo(MD_AllocatorInfo ainfo, MD_NodeKind kind, MD_NodeFlags flags
 	return node;
 }
 
+// Ed: bits a tag's string sets in MD_Node::tag_filter, two of the sixteen picked by a hash of its size & up to 8 bytes at each end.
+// Hashing the whole string would cost more than the walk it saves for short tag lists.
+inline MD_U16
+md_tag_filter_from_str8(MD_String8 string)
+{
+	MD_U64 head = 0;
+	MD_U64 tail = 0;
+	md_memory_copy(&head, string.str, md_min(string.size, 8));
+	if (string.size > 8) {
+		md_memory_copy(&tail, string.str + string.size - 8, 8);
+	}
+	MD_U64 hash = (head ^ (tail * 0xC2B2AE3D27D4EB4Full) ^ string.size) * 0x9E3779B97F4A7C15ull;
+	hash ^= hash >> 29;
+	return (MD_U16)((1u << (hash >> 60)) | (1u << ((hash >> 56) & 15)));
+}
+
+// Ed: rebuilds node's tag filter from its tags, for after they were linked in or renamed without md_node_push_tag/md_node_insert_tag
+inline void
+md_node_refresh_tag_filter(MD_Node* node)
+{
+	MD_U16 tag_filter = 0;
+	for md_each_node(tag, node->first_tag) {
+		tag_filter |= md_tag_filter_from_str8(tag->string);
+	}
+	node->tag_filter = tag_filter;
+}
+
 inline void
 md_node_insert_child(MD_Node* parent, MD_Node* prev_child, MD_Node* node) {
+	if (parent->has_child_index) md_child_index_release(parent);
+	md_tree_generation_bump();
 	node->parent = parent;
 	md_dll_insert_npz(md_nil_node(), parent->first, parent->last, prev_child, node, next, prev);
 }
 
 inline void
 md_node_insert_tag(MD_Node* parent, MD_Node* prev_child, MD_Node* node) {
-	node->kind   = MD_NodeKind_Tag;
-	node->parent = parent;
+	node->kind          = MD_NodeKind_Tag;
+	node->parent        = parent;
+	parent->tag_filter |= md_tag_filter_from_str8(node->string);
+	md_tree_generation_bump();
 	md_dll_insert_npz(md_nil_node(), parent->first_tag, parent->last_tag, prev_child, node, next, prev);
 }
 
 inline void
 md_node_push_child(MD_Node* parent, MD_Node* node) {
+  if (parent->has_child_index) md_child_index_release(parent);
+  md_tree_generation_bump();
   node->parent = parent;
   md_dll_push_back_npz(md_nil_node(), parent->first, parent->last, node, next, prev);
 }
 
 inline void
 md_node_push_tag(MD_Node* parent, MD_Node* node) {
-  node->kind   = MD_NodeKind_Tag;
-  node->parent = parent;
+  node->kind          = MD_NodeKind_Tag;
+  node->parent        = parent;
+  parent->tag_filter |= md_tag_filter_from_str8(node->string);
+  md_tree_generation_bump();
   md_dll_push_back_npz(md_nil_node(), parent->first_tag, parent->last_tag, node, next, prev);
 }
 
 //- rjf: tree introspection
 
+MD_API void md_node_materialize(MD_Node* node);
+
+// Ed: children of a node, parsing them first if the node is a lazy set
+inline MD_Node* md_node_first(MD_Node* node) { if (node->lazy != 0 && ! node->has_child_index) md_node_materialize(node); return node->first; }
+inline MD_Node* md_node_last (MD_Node* node) { if (node->lazy != 0 && ! node->has_child_index) md_node_materialize(node); return node->last;  }
+
+#define md_each_child(it, node) (MD_Node* it = md_node_first(node); !md_node_is_nil(it); it = it->next)
+
 MD_Node* md_node_from_chain_string(MD_Node* first, MD_Node* opl, MD_String8 string, MD_StringMatchFlags flags);
 MD_Node* md_node_from_chain_index (MD_Node* first, MD_Node* opl, MD_U64 index);
 MD_Node* md_node_from_chain_flags (MD_Node* first, MD_Node* opl, MD_NodeFlags flags);
@@ -455,6 +1285,12 @@ MD_Node* md_tag_arg_from_index    (MD_Node* node, MD_String8 tag_string, MD_Stri
 MD_Node* md_tag_arg_from_string   (MD_Node* node, MD_String8 tag_string, MD_StringMatchFlags tag_str_flags, MD_String8 arg_string, MD_StringMatchFlags arg_str_flags);
 MD_B32   md_node_has_child        (MD_Node* node, MD_String8 string, MD_StringMatchFlags flags);
 MD_B32   md_node_has_tag          (MD_Node* node, MD_String8 string, MD_StringMatchFlags flags);
+MD_Node* md_node_from_chain_atom  (MD_Node* first, MD_Node* opl, MD_Atom atom);
+MD_Node* md_child_from_atom       (MD_Node* node, MD_Atom child_atom);
+MD_Node* md_tag_from_atom         (MD_Node* node, MD_Atom tag_atom);
+MD_Node* md_tag_arg_from_atom     (MD_Node* node, MD_Atom tag_atom, MD_Atom arg_atom);
+MD_B32   md_node_has_child_atom   (MD_Node* node, MD_Atom atom);
+MD_B32   md_node_has_tag_atom     (MD_Node* node, MD_Atom atom);
 MD_U64   md_child_count_from_node (MD_Node* node);
 MD_U64   md_tag_count_from_node   (MD_Node* node);
 
@@ -507,7 +1343,15 @@ md_node_from_chain_flags(MD_Node* first, MD_Node* opl, MD_NodeFlags flags) {
 }
 
 inline MD_U64
-md_index_from_node(MD_Node* node) {
+md_index_from_node(MD_Node* node)
+{
+	// Ed: a child of an indexed parent is looked up by address, anything else (tags included) walks back to the first sibling
+	MD_Node*       parent      = node->parent;
+	MD_ChildIndex* child_index = (node->kind != MD_NodeKind_Tag && parent->has_child_index) ? md_child_index_lookup(parent) : 0;
+	MD_U64         position    = child_index != 0 ? md_child_index_position(child_index, node) : MD_MAX_U64;
+	if (position != MD_MAX_U64) {
+		return position;
+	}
 	MD_U64 index = 0;
 	for (MD_Node* n = node->prev; !md_node_is_nil(n); n = n->prev) {
 		index += 1;
@@ -524,10 +1368,48 @@ md_root_from_node(MD_Node* node) {
 	return result;
 }
 
-inline MD_Node* md_child_from_string(MD_Node* node, MD_String8 child_string, MD_StringMatchFlags flags) { return md_node_from_chain_string(node->first,     md_nil_node(), child_string, flags); }
-inline MD_Node* md_tag_from_string  (MD_Node* node, MD_String8 tag_string,   MD_StringMatchFlags flags) { return md_node_from_chain_string(node->first_tag, md_nil_node(), tag_string,   flags); }
-inline MD_Node* md_child_from_index (MD_Node* node, MD_U64 index)                                       { return md_node_from_chain_index (node->first,     md_nil_node(), index); }
-inline MD_Node* md_tag_from_index   (MD_Node* node, MD_U64 index)                                       { return md_node_from_chain_index (node->first_tag, md_nil_node(), index); }
+inline MD_Node*
+md_child_from_string(MD_Node* node, MD_String8 child_string, MD_StringMatchFlags flags)
+{
+	// Ed: the index only hashes exact labels, other matches always walk
+	MD_ChildIndex* index = (flags == 0 && node->has_child_index) ? md_child_index_lookup(node) : 0;
+	if (index != 0) {
+		return md_child_index_find(index, child_string);
+	}
+	for (MD_Node* n = md_node_first(node); !md_node_is_nil(n); n = n->next)
+	{
+		if (md_str8_match(n->string, child_string, flags)) {
+			return n;
+		}
+	}
+	return md_nil_node();
+}
+
+inline MD_Node*
+md_child_from_index(MD_Node* node, MD_U64 index)
+{
+	MD_ChildIndex* child_index = node->has_child_index ? md_child_index_lookup(node) : 0;
+	if (child_index != 0) {
+		return index < child_index->count ? child_index->children[index] : md_nil_node();
+	}
+	return md_node_from_chain_index(md_node_first(node), md_nil_node(), index);
+}
+
+inline MD_Node*
+md_tag_from_string(MD_Node* node, MD_String8 tag_string, MD_StringMatchFlags flags)
+{
+	// Ed: most lookups are misses, the filter rules out exact matches without walking the tags
+	if (flags == 0 && node->tag_filter != 0)
+	{
+		MD_U16 bits = md_tag_filter_from_str8(tag_string);
+		if ((node->tag_filter & bits) != bits) {
+			return md_nil_node();
+		}
+	}
+	return md_node_from_chain_string(node->first_tag, md_nil_node(), tag_string, flags);
+}
+
+inline MD_Node* md_tag_from_index   (MD_Node* node, MD_U64 index)                                       { return md_node_from_chain_index (node->first_tag,      md_nil_node(), index); }
 
 inline MD_Node*
 md_tag_arg_from_index(MD_Node* node, MD_String8 tag_string, MD_StringMatchFlags flags, MD_U64 index) {
@@ -545,10 +1427,35 @@ md_tag_arg_from_string(MD_Node* node, MD_String8 tag_string, MD_StringMatchFlags
 inline MD_B32 md_node_has_child(MD_Node* node, MD_String8 string, MD_StringMatchFlags flags) { return !md_node_is_nil(md_child_from_string(node, string, flags)); }
 inline MD_B32 md_node_has_tag  (MD_Node* node, MD_String8 string, MD_StringMatchFlags flags) { return !md_node_is_nil(md_tag_from_string  (node, string, flags)); }
 
+// Ed: lookups by atom, an exact match on the string compared as an integer (atom 0 never matches)
+inline MD_Node*
+md_node_from_chain_atom(MD_Node* first, MD_Node* opl, MD_Atom atom)
+{
+	MD_Node* result = md_nil_node();
+	for (MD_Node* n = first; atom != 0 && !md_node_is_nil(n) && n != opl; n = n->next)
+	{
+		if (n->atom == atom) {
+			result = n;
+			break;
+		}
+	}
+	return result;
+}
+
+inline MD_Node* md_child_from_atom    (MD_Node* node, MD_Atom child_atom)                { return md_node_from_chain_atom(md_node_first(node), md_nil_node(), child_atom); }
+inline MD_Node* md_tag_from_atom      (MD_Node* node, MD_Atom tag_atom)                  { return md_node_from_chain_atom(node->first_tag,      md_nil_node(), tag_atom); }
+inline MD_Node* md_tag_arg_from_atom  (MD_Node* node, MD_Atom tag_atom, MD_Atom arg_atom) { return md_child_from_atom(md_tag_from_atom(node, tag_atom), arg_atom); }
+inline MD_B32   md_node_has_child_atom(MD_Node* node, MD_Atom atom)                      { return !md_node_is_nil(md_child_from_atom(node, atom)); }
+inline MD_B32   md_node_has_tag_atom  (MD_Node* node, MD_Atom atom)                      { return !md_node_is_nil(md_tag_from_atom  (node, atom)); }
+
 inline MD_U64
 md_child_count_from_node(MD_Node *node) {
+	MD_ChildIndex* index = node->has_child_index ? md_child_index_lookup(node) : 0;
+	if (index != 0) {
+		return index->count;
+	}
 	MD_U64 result = 0;
-	for (MD_Node* child = node->first; !md_node_is_nil(child); child = child->next) {
+	for (MD_Node* child = md_node_first(node); !md_node_is_nil(child); child = child->next) {
 		result += 1;
 	}
 	return result;
@@ -577,9 +1484,79 @@ MD_API MD_Node* md_tree_copy__ainfo(MD_AllocatorInfo ainfo, MD_Node* src_root);
 
 md_force_inline MD_Node* md_tree_copy__arena(MD_Arena* arena, MD_Node* src_root) { return md_tree_copy__ainfo(md_arena_allocator(arena), src_root); }
 
+////////////////////////////////
+//~ Ed: Atom Table Functions
+
+MD_API MD_AtomTable* md_atom_table_alloc__ainfo(MD_AllocatorInfo ainfo, MD_U64 bucket_count);
+// Frees the table, its entries & their strings (no other thread may be using it)
+MD_API void          md_atom_table_release     (MD_AtomTable* table);
+// The string's atom, interning a copy of it if it's new
+MD_API MD_Atom       md_atom_from_str8         (MD_AtomTable* table, MD_String8 string);
+// The string's atom if it's been interned, 0 otherwise (never locks)
+MD_API MD_Atom       md_atom_lookup            (MD_AtomTable* table, MD_String8 string);
+
+#define md_atom_table_alloc(allocator, bucket_count) _Generic(allocator, MD_Arena*: md_atom_table_alloc__arena, MD_AllocatorInfo: md_atom_table_alloc__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, bucket_count)
+
+md_force_inline MD_AtomTable* md_atom_table_alloc__arena(MD_Arena* arena, MD_U64 bucket_count) { return md_atom_table_alloc__ainfo(md_arena_allocator(arena), bucket_count); }
+
+////////////////////////////////
+//~ Ed: Text Scanning Kernel Functions
+
+MD_API MD_TextScanLevel    md_text_scan_level_supported(void);
+MD_API MD_TextScanKernels* md_text_scan_kernels        (void);
+// Clamped to md_text_scan_level_supported(), mostly useful for testing & benchmarking the fallbacks.
+MD_API void                md_text_scan_set_level      (MD_TextScanLevel level);
+
 ////////////////////////////////
 //~ rjf: Text -> Tokens Functions
 
+inline MD_TokenByteClass
+md_token_byte_class(MD_U8 byte)
+{
+	md_read_only md_local_persist
+	MD_TokenByteClass lookup_table[256] = {
+		0,0,0,0,0,0,0,0,0,1,2,1,0,1,0,0,
+		0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+		1,7,5,6,7,7,7,5,6,6,7,7,6,9,9,8,
+		4,4,4,4,4,4,4,4,4,4,6,6,7,7,7,7,
+		6,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,
+		3,3,3,3,3,3,3,3,3,3,3,6,6,6,7,3,
+		5,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,
+		3,3,3,3,3,3,3,3,3,3,3,6,7,6,7,0,
+		0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+		0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+		0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+		0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+		3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,
+		3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,
+		3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,
+		3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,
+	};
+	return lookup_table[byte];
+}
+
+// The MD_TokenFlagGroup_ReservedKind flag of a reserved byte, 0 for any other byte
+inline MD_TokenFlags
+md_token_reserved_flag(MD_U8 byte)
+{
+	switch (byte)
+	{
+		case '{':  return MD_TokenFlag_BraceLeft;
+		case '}':  return MD_TokenFlag_BraceRight;
+		case '[':  return MD_TokenFlag_BracketLeft;
+		case ']':  return MD_TokenFlag_BracketRight;
+		case '(':  return MD_TokenFlag_ParenLeft;
+		case ')':  return MD_TokenFlag_ParenRight;
+		case ':':  return MD_TokenFlag_Colon;
+		case ';':  return MD_TokenFlag_Semicolon;
+		case ',':  return MD_TokenFlag_Comma;
+		case '@':  return MD_TokenFlag_At;
+		case '#':  return MD_TokenFlag_Hash;
+		case '\\': return MD_TokenFlag_Backslash;
+	}
+	return 0;
+}
+
 MD_API MD_TokenizeResult md_tokenize_from_text__arena(MD_Arena*        arena, MD_String8 text);
 MD_API MD_TokenizeResult md_tokenize_from_text__ainfo(MD_AllocatorInfo ainfo, MD_String8 text);
 
@@ -587,6 +1564,111 @@ MD_API MD_TokenizeResult md_tokenize_from_text__ainfo(MD_AllocatorInfo ainfo, MD
 
 md_force_inline MD_TokenizeResult md_tokenize_from_text__arena(MD_Arena* arena, MD_String8 text) {  return md_tokenize_from_text__ainfo(md_arena_allocator(arena), text); }
 
+////////////////////////////////
+//~ Ed: Text -> Compact Tokens Functions
+
+// Same tokens as md_tokenize_from_text, without ever holding the whole text's tokens in the wide layout
+MD_API MD_TokenizeCompactResult md_tokenize_compact_from_text__ainfo(MD_AllocatorInfo ainfo, MD_String8 text);
+
+#define md_tokenize_compact_from_text(allocator, text) _Generic(allocator, MD_Arena*: md_tokenize_compact_from_text__arena, MD_AllocatorInfo: md_tokenize_compact_from_text__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, text)
+
+md_force_inline MD_TokenizeCompactResult md_tokenize_compact_from_text__arena(MD_Arena* arena, MD_String8 text) { return md_tokenize_compact_from_text__ainfo(md_arena_allocator(arena), text); }
+
+////////////////////////////////
+//~ Ed: Text -> Significant Tokens Functions
+
+// Folds the trivia out of count tokens into out (which has room for count), returns how many were written.
+// comments may be null. Trivia after the last token stays in fold for the next call.
+MD_API MD_U64 md_significant_tokens_from_tokens(MD_Token* tokens, MD_U64 count, MD_SignificantToken* out, MD_Rng1U64* comments, MD_SignificantTokenFold* fold);
+
+// Same tokens as md_tokenize_from_text without the whitespace, comment & newline tokens, which are folded into the next token
+MD_API MD_TokenizeSignificantResult md_tokenize_significant_from_text__ainfo(MD_AllocatorInfo ainfo, MD_String8 text, MD_B32 keep_comments);
+
+#define md_tokenize_significant_from_text(allocator, text, keep_comments) _Generic(allocator, MD_Arena*: md_tokenize_significant_from_text__arena, MD_AllocatorInfo: md_tokenize_significant_from_text__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, text, keep_comments)
+
+md_force_inline MD_TokenizeSignificantResult md_tokenize_significant_from_text__arena(MD_Arena* arena, MD_String8 text, MD_B32 keep_comments) { return md_tokenize_significant_from_text__ainfo(md_arena_allocator(arena), text, keep_comments); }
+
+inline MD_U32 md_significant_token_newline_count(MD_SignificantToken token) { return token.trivia >> 1; }
+inline MD_B32 md_significant_token_is_adjacent  (MD_SignificantToken token) { return token.trivia == 0;  }
+
+////////////////////////////////
+//~ Ed: Incremental Text -> Tokens Functions
+
+// Tokens of new_text, after edit (a range of old_text) was replaced with new_text[edit.min, edit.max + new_text.size - old_text.size).
+// Only lexes from shortly before the edit until a token starts where one of old_tokens did, the rest are copied with their offsets shifted.
+// Same result as md_tokenize_from_text(new_text). The copy & its messages make it linear in the token count all the same,
+// md_tokenize_edit_in_place isn't.
+MD_API MD_TokenizeEditResult md_tokenize_from_text_edit__ainfo(MD_AllocatorInfo ainfo, MD_TokenArray old_tokens, MD_String8 old_text, MD_String8 new_text, MD_Rng1U64 edit);
+
+#define md_tokenize_from_text_edit(allocator, old_tokens, old_text, new_text, edit) _Generic(allocator, MD_Arena*: md_tokenize_from_text_edit__arena, MD_AllocatorInfo: md_tokenize_from_text_edit__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, old_tokens, old_text, new_text, edit)
+
+md_force_inline MD_TokenizeEditResult md_tokenize_from_text_edit__arena(MD_Arena* arena, MD_TokenArray old_tokens, MD_String8 old_text, MD_String8 new_text, MD_Rng1U64 edit) { return md_tokenize_from_text_edit__ainfo(md_arena_allocator(arena), old_tokens, old_text, new_text, edit); }
+
+// The same edit applied to tokenize in place, for editors re-lexing as the text changes: the tokens before the re-lexed ones
+// aren't touched, the ones after are moved over & shifted, & only the re-lexed tokens' messages are redone (tokenize->msgs
+// must be the messages of tokenize->tokens, as md_tokenize_from_text or md_tokenize_from_text_edit gave them).
+// tokenize->tokens.v must have room for token_cap tokens, false & nothing changed when the edited tokens wouldn't fit.
+MD_API MD_B32 md_tokenize_edit_in_place__ainfo(MD_AllocatorInfo ainfo, MD_TokenizeEditResult* tokenize, MD_U64 token_cap, MD_String8 old_text, MD_String8 new_text, MD_Rng1U64 edit);
+
+#define md_tokenize_edit_in_place(allocator, tokenize, token_cap, old_text, new_text, edit) _Generic(allocator, MD_Arena*: md_tokenize_edit_in_place__arena, MD_AllocatorInfo: md_tokenize_edit_in_place__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, tokenize, token_cap, old_text, new_text, edit)
+
+md_force_inline MD_B32 md_tokenize_edit_in_place__arena(MD_Arena* arena, MD_TokenizeEditResult* tokenize, MD_U64 token_cap, MD_String8 old_text, MD_String8 new_text, MD_Rng1U64 edit) { return md_tokenize_edit_in_place__ainfo(md_arena_allocator(arena), tokenize, token_cap, old_text, new_text, edit); }
+
+////////////////////////////////
+//~ Ed: Token Cursor Functions
+
+MD_API void   md_token_cursor_init(MD_TokenCursor* cursor, MD_String8 text);
+MD_API MD_B32 md_token_cursor_fill(MD_TokenCursor* cursor, MD_U64 idx);
+
+// Significant token idx of the text, false past the last one. idx can't be behind the window (md_token_cursor_fill keeps the last 3 tokens)
+inline MD_B32
+md_token_cursor_peek(MD_TokenCursor* cursor, MD_U64 idx, MD_SignificantToken* token)
+{
+	if (idx - cursor->first_idx >= cursor->count && ! md_token_cursor_fill(cursor, idx)) {
+		return 0;
+	}
+	*token = cursor->v[idx - cursor->first_idx];
+	return 1;
+}
+
+////////////////////////////////
+//~ Ed: Parallel Text -> Tokens Functions
+
+// Tokenizes text across thread_count threads (0 uses every logical processor), the result is identical to md_tokenize_from_text.
+MD_API MD_TokenizeResult md_tokenize_from_text_parallel__ainfo(MD_AllocatorInfo ainfo, MD_String8 text, MD_U64 thread_count);
+
+#define md_tokenize_from_text_parallel(allocator, text, thread_count) _Generic(allocator, MD_Arena*: md_tokenize_from_text_parallel__arena, MD_AllocatorInfo: md_tokenize_from_text_parallel__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, text, thread_count)
+
+md_force_inline MD_TokenizeResult md_tokenize_from_text_parallel__arena(MD_Arena* arena, MD_String8 text, MD_U64 thread_count) { return md_tokenize_from_text_parallel__ainfo(md_arena_allocator(arena), text, thread_count); }
+
+////////////////////////////////
+//~ Ed: Streaming Text -> Tokens Functions
+
+MD_API void md_tokenize_stream_init   (MD_TokenizeStream* stream, MD_AllocatorInfo backing);
+MD_API void md_tokenize_stream_release(MD_TokenizeStream* stream);
+
+MD_API MD_TokenizeStreamResult md_tokenize_stream_push__arena  (MD_Arena*        arena, MD_TokenizeStream* stream, MD_String8 chunk);
+MD_API MD_TokenizeStreamResult md_tokenize_stream_push__ainfo  (MD_AllocatorInfo ainfo, MD_TokenizeStream* stream, MD_String8 chunk);
+MD_API MD_TokenizeStreamResult md_tokenize_stream_finish__arena(MD_Arena*        arena, MD_TokenizeStream* stream);
+MD_API MD_TokenizeStreamResult md_tokenize_stream_finish__ainfo(MD_AllocatorInfo ainfo, MD_TokenizeStream* stream);
+
+#define md_tokenize_stream_push(allocator, stream, chunk) _Generic(allocator, MD_Arena*: md_tokenize_stream_push__arena,   MD_AllocatorInfo: md_tokenize_stream_push__ainfo,   default: md_assert_generic_sel_fail) md_generic_call(allocator, stream, chunk)
+#define md_tokenize_stream_finish(allocator, stream)      _Generic(allocator, MD_Arena*: md_tokenize_stream_finish__arena, MD_AllocatorInfo: md_tokenize_stream_finish__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, stream)
+
+md_force_inline MD_TokenizeStreamResult md_tokenize_stream_push__arena  (MD_Arena* arena, MD_TokenizeStream* stream, MD_String8 chunk) { return md_tokenize_stream_push__ainfo  (md_arena_allocator(arena), stream, chunk); }
+md_force_inline MD_TokenizeStreamResult md_tokenize_stream_finish__arena(MD_Arena* arena, MD_TokenizeStream* stream)                   { return md_tokenize_stream_finish__ainfo(md_arena_allocator(arena), stream); }
+
+// Text of a token from the result of pushing chunk
+inline MD_String8
+md_tokenize_stream_token_string(MD_TokenizeStreamResult* result, MD_String8 chunk, MD_U64 token_idx)
+{
+	MD_Token token = result->tokens.v[token_idx];
+	if (token_idx == 0 && result->spanning_text.size != 0) {
+		return result->spanning_text;
+	}
+	return md_str8_substr(chunk, md_r1u64(token.range.md_min - result->chunk_offset, token.range.md_max - result->chunk_offset));
+}
+
 ////////////////////////////////
 //~ rjf: Tokens -> Tree Functions
 
@@ -597,6 +1679,31 @@ MD_API MD_ParseResult md_parse_from_text_tokens__ainfo(MD_AllocatorInfo ainfo, M
 
 md_force_inline MD_ParseResult md_parse_from_text_tokens__arena(MD_Arena* arena, MD_String8 filename, MD_String8 text, MD_TokenArray tokens) { return md_parse_from_text_tokens__ainfo(md_arena_allocator(arena), filename, text, tokens); }
 
+MD_API MD_ParseResult md_parse_from_text_compact_tokens__ainfo(MD_AllocatorInfo ainfo, MD_String8 filename, MD_String8 text, MD_CompactTokenArray tokens);
+
+#define md_parse_from_text_compact_tokens(allocator, filename, text, tokens) _Generic(allocator, MD_Arena*: md_parse_from_text_compact_tokens__arena, MD_AllocatorInfo: md_parse_from_text_compact_tokens__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, filename, text, tokens)
+
+md_force_inline MD_ParseResult md_parse_from_text_compact_tokens__arena(MD_Arena* arena, MD_String8 filename, MD_String8 text, MD_CompactTokenArray tokens) { return md_parse_from_text_compact_tokens__ainfo(md_arena_allocator(arena), filename, text, tokens); }
+
+MD_API MD_ParseResult md_parse_from_text_significant_tokens__ainfo(MD_AllocatorInfo ainfo, MD_String8 filename, MD_String8 text, MD_SignificantTokenArray tokens);
+
+#define md_parse_from_text_significant_tokens(allocator, filename, text, tokens) _Generic(allocator, MD_Arena*: md_parse_from_text_significant_tokens__arena, MD_AllocatorInfo: md_parse_from_text_significant_tokens__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, filename, text, tokens)
+
+md_force_inline MD_ParseResult md_parse_from_text_significant_tokens__arena(MD_Arena* arena, MD_String8 filename, MD_String8 text, MD_SignificantTokenArray tokens) { return md_parse_from_text_significant_tokens__ainfo(md_arena_allocator(arena), filename, text, tokens); }
+
+// Parses straight from the text through an MD_TokenCursor, there's never a token array
+MD_API MD_ParseResult md_parse_from_text_fused__ainfo(MD_AllocatorInfo ainfo, MD_String8 filename, MD_String8 text);
+
+#define md_parse_from_text_fused(allocator, filename, text) _Generic(allocator, MD_Arena*: md_parse_from_text_fused__arena, MD_AllocatorInfo: md_parse_from_text_fused__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, filename, text)
+
+md_force_inline MD_ParseResult md_parse_from_text_fused__arena(MD_Arena* arena, MD_String8 filename, MD_String8 text) { return md_parse_from_text_fused__ainfo(md_arena_allocator(arena), filename, text); }
+
+// Like md_parse_from_text_fused, keeping only the top-level nodes that pass the filter
+MD_API MD_ParseResult md_parse_filtered_from_text__ainfo(MD_AllocatorInfo ainfo, MD_String8 filename, MD_String8 text, MD_ParseFilter filter);
+
+#define md_parse_filtered_from_text(allocator, filename, text, filter) _Generic(allocator, MD_Arena*: md_parse_filtered_from_text__arena, MD_AllocatorInfo: md_parse_filtered_from_text__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, filename, text, filter)
+
+md_force_inline MD_ParseResult md_parse_filtered_from_text__arena(MD_Arena* arena, MD_String8 filename, MD_String8 text, MD_ParseFilter filter) { return md_parse_filtered_from_text__ainfo(md_arena_allocator(arena), filename, text, filter); }
 
 ////////////////////////////////
 //~ rjf: Bundled Text -> Tree Functions
@@ -609,6 +1716,218 @@ MD_API MD_ParseResult md_parse_from_text__ainfo(MD_AllocatorInfo ainfo, MD_Strin
 
 md_force_inline MD_ParseResult md_parse_from_text__arena(MD_Arena* arena, MD_String8 filename, MD_String8 text) { return md_parse_from_text__ainfo(md_arena_allocator(arena), filename, text); }
 
+// Ed: md_parse_from_text, setting the atom of every label & tag node from atoms
+MD_API MD_ParseResult md_parse_from_text_atoms__ainfo(MD_AllocatorInfo ainfo, MD_AtomTable* atoms, MD_String8 filename, MD_String8 text);
+
+#define md_parse_from_text_atoms(allocator, atoms, filename, text) _Generic(allocator, MD_Arena*: md_parse_from_text_atoms__arena, MD_AllocatorInfo: md_parse_from_text_atoms__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, atoms, filename, text)
+
+md_force_inline MD_ParseResult md_parse_from_text_atoms__arena(MD_Arena* arena, MD_AtomTable* atoms, MD_String8 filename, MD_String8 text) { return md_parse_from_text_atoms__ainfo(md_arena_allocator(arena), atoms, filename, text); }
+
+////////////////////////////////
+//~ Ed: Flat Tree Functions
+
+// Parses into an MD_FlatTree, the MD_Node tree only lives in scratch
+MD_API MD_FlatParseResult md_parse_flat_from_text__ainfo(MD_AllocatorInfo ainfo, MD_String8 filename, MD_String8 text);
+// Flattens root & everything under it, strings inside text are referenced instead of copied
+MD_API MD_FlatTree        md_flat_tree_from_node__ainfo(MD_AllocatorInfo ainfo, MD_Node* root, MD_String8 text);
+// Rebuilds the MD_Node tree (returns the root), strings still point into the flat tree's text & extra
+MD_API MD_Node*           md_node_from_flat_tree__ainfo(MD_AllocatorInfo ainfo, MD_FlatTree* tree);
+
+#define md_parse_flat_from_text(allocator, filename, text) _Generic(allocator, MD_Arena*: md_parse_flat_from_text__arena, MD_AllocatorInfo: md_parse_flat_from_text__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, filename, text)
+#define md_flat_tree_from_node(allocator, root, text)      _Generic(allocator, MD_Arena*: md_flat_tree_from_node__arena,  MD_AllocatorInfo: md_flat_tree_from_node__ainfo,  default: md_assert_generic_sel_fail) md_generic_call(allocator, root, text)
+#define md_node_from_flat_tree(allocator, tree)            _Generic(allocator, MD_Arena*: md_node_from_flat_tree__arena,  MD_AllocatorInfo: md_node_from_flat_tree__ainfo,  default: md_assert_generic_sel_fail) md_generic_call(allocator, tree)
+
+md_force_inline MD_FlatParseResult md_parse_flat_from_text__arena(MD_Arena* arena, MD_String8 filename, MD_String8 text) { return md_parse_flat_from_text__ainfo(md_arena_allocator(arena), filename, text); }
+md_force_inline MD_FlatTree        md_flat_tree_from_node__arena (MD_Arena* arena, MD_Node* root, MD_String8 text)         { return md_flat_tree_from_node__ainfo (md_arena_allocator(arena), root, text); }
+md_force_inline MD_Node*           md_node_from_flat_tree__arena (MD_Arena* arena, MD_FlatTree* tree)                      { return md_node_from_flat_tree__ainfo (md_arena_allocator(arena), tree); }
+
+//- Ed: introspection, mirrors the MD_Node functions
+
+#define md_each_flat_node(it, tree, first) (MD_FlatNode it = (first); it != 0; it = (tree)->nexts[it])
+
+inline MD_FlatNode md_flat_tree_root       (MD_FlatTree* tree)                   { return tree->count > 1 ? 1 : 0; }
+inline MD_B32      md_flat_node_is_nil     (MD_FlatNode node)                    { return node == 0; }
+inline MD_NodeKind md_flat_node_kind       (MD_FlatTree* tree, MD_FlatNode node) { return (MD_NodeKind)tree->kinds[node]; }
+
+inline MD_String8
+md_flat_tree__string(MD_FlatTree* tree, MD_U32 offset, MD_U32 size) {
+	if (offset < tree->text.size) {
+		return md_str8(tree->text.str + offset, size);
+	}
+	return md_str8(tree->extra.str + (offset - tree->text.size), size);
+}
+
+inline MD_String8 md_flat_node_string    (MD_FlatTree* tree, MD_FlatNode node) { return md_flat_tree__string(tree, tree->string_offsets[node], tree->string_sizes[node]); }
+inline MD_String8 md_flat_node_raw_string(MD_FlatTree* tree, MD_FlatNode node) { return md_flat_tree__string(tree, tree->raw_offsets   [node], tree->raw_sizes   [node]); }
+
+inline MD_FlatNode
+md_flat_node_from_chain_string(MD_FlatTree* tree, MD_FlatNode first, MD_String8 string, MD_StringMatchFlags flags) {
+	for md_each_flat_node(node, tree, first) {
+		if (md_str8_match(md_flat_node_string(tree, node), string, flags)) {
+			return node;
+		}
+	}
+	return 0;
+}
+
+inline MD_FlatNode md_flat_child_from_string(MD_FlatTree* tree, MD_FlatNode node, MD_String8 child_string, MD_StringMatchFlags flags) { return md_flat_node_from_chain_string(tree, tree->firsts    [node], child_string, flags); }
+inline MD_FlatNode md_flat_tag_from_string  (MD_FlatTree* tree, MD_FlatNode node, MD_String8 tag_string,   MD_StringMatchFlags flags) { return md_flat_node_from_chain_string(tree, tree->first_tags[node], tag_string,   flags); }
+
+inline MD_U64
+md_flat_child_count_from_node(MD_FlatTree* tree, MD_FlatNode node) {
+	MD_U64 result = 0;
+	for md_each_flat_node(child, tree, tree->firsts[node]) {
+		result += 1;
+	}
+	return result;
+}
+
+// One past the last node of node's subtree (tags included)
+inline MD_FlatNode
+md_flat_node_subtree_opl(MD_FlatTree* tree, MD_FlatNode node) {
+	for (MD_FlatNode n = node; n != 0; n = tree->parents[n]) {
+		if (tree->nexts[n] != 0) {
+			return tree->nexts[n];
+		}
+		MD_FlatNode parent = tree->parents[n];
+		if (parent != 0 && tree->firsts[parent] > n) {
+			// n ends its parent's tags, the parent's children come next
+			return tree->firsts[parent];
+		}
+	}
+	return (MD_FlatNode)tree->count;
+}
+
+////////////////////////////////
+//~ Ed: Flat Tree File Functions
+
+// The file's bytes, the arrays & strings are referenced by the list rather than copied
+MD_API MD_String8List md_flat_tree_file_parts__ainfo(MD_AllocatorInfo ainfo, MD_FlatTree* tree);
+MD_API MD_B32         md_flat_tree_write_to_file_path(MD_FlatTree* tree, MD_String8 path);
+
+#define md_flat_tree_file_parts(allocator, tree) _Generic(allocator, MD_Arena*: md_flat_tree_file_parts__arena, MD_AllocatorInfo: md_flat_tree_file_parts__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, tree)
+
+md_force_inline MD_String8List md_flat_tree_file_parts__arena(MD_Arena* arena, MD_FlatTree* tree) { return md_flat_tree_file_parts__ainfo(md_arena_allocator(arena), tree); }
+
+// NOTE(Ed): Loading checks the header, that every section fits in data, then every node with md_flat_tree_validate, so a
+// damaged or foreign file loads as an empty tree (count of 0). The tree points into data (nothing is allocated).
+MD_API MD_FlatTree    md_flat_tree_from_file_data(MD_String8 data);
+// Every link is 0 or another node's index (a parent comes before its node, tags, children & the next sibling after it),
+// every kind is an MD_NodeKind & every string is inside text or extra. Holds for any tree md_flat_tree_from_node made.
+MD_API MD_B32         md_flat_tree_validate      (MD_FlatTree* tree);
+MD_API MD_FlatTreeMap md_flat_tree_map_open      (MD_String8 path);
+MD_API void           md_flat_tree_map_close     (MD_FlatTreeMap* map);
+
+////////////////////////////////
+//~ Ed: Lazy Parse Functions
+
+// Parses everything outside of explicitly delimited sets, ainfo & text have to outlive the tree (sets are parsed into ainfo on access)
+MD_API MD_LazyParseResult md_parse_lazy_from_text__ainfo(MD_AllocatorInfo ainfo, MD_String8 filename, MD_String8 text);
+
+#define md_parse_lazy_from_text(allocator, filename, text) _Generic(allocator, MD_Arena*: md_parse_lazy_from_text__arena, MD_AllocatorInfo: md_parse_lazy_from_text__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, filename, text)
+
+md_force_inline MD_LazyParseResult md_parse_lazy_from_text__arena(MD_Arena* arena, MD_String8 filename, MD_String8 text) { return md_parse_lazy_from_text__ainfo(md_arena_allocator(arena), filename, text); }
+
+////////////////////////////////
+//~ Ed: Parallel Tokens -> Tree Functions
+
+// Parses tokens across thread_count threads (0 uses every logical processor), split between top-level nodes.
+// The tree & messages are identical to md_parse_from_text_tokens.
+MD_API MD_ParseResult md_parse_from_text_tokens_parallel__ainfo(MD_AllocatorInfo ainfo, MD_String8 filename, MD_String8 text, MD_TokenArray tokens, MD_U64 thread_count);
+
+#define md_parse_from_text_tokens_parallel(allocator, filename, text, tokens, thread_count) _Generic(allocator, MD_Arena*: md_parse_from_text_tokens_parallel__arena, MD_AllocatorInfo: md_parse_from_text_tokens_parallel__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, filename, text, tokens, thread_count)
+
+md_force_inline MD_ParseResult md_parse_from_text_tokens_parallel__arena(MD_Arena* arena, MD_String8 filename, MD_String8 text, MD_TokenArray tokens, MD_U64 thread_count) { return md_parse_from_text_tokens_parallel__ainfo(md_arena_allocator(arena), filename, text, tokens, thread_count); }
+
+////////////////////////////////
+//~ Ed: Parallel Files -> Tree Functions
+
+// Loads & parses each file on one of thread_count threads (0 uses every logical processor). The result's root is a List
+// of the file roots in the order of paths, with the messages of each file in that same order. A path that can't be read
+// gives an empty file root with an error on it.
+MD_API MD_ParseResult md_parse_files_parallel__ainfo(MD_AllocatorInfo ainfo, MD_String8Array paths, MD_U64 thread_count);
+
+#define md_parse_files_parallel(allocator, paths, thread_count) _Generic(allocator, MD_Arena*: md_parse_files_parallel__arena, MD_AllocatorInfo: md_parse_files_parallel__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, paths, thread_count)
+
+md_force_inline MD_ParseResult md_parse_files_parallel__arena(MD_Arena* arena, MD_String8Array paths, MD_U64 thread_count) { return md_parse_files_parallel__ainfo(md_arena_allocator(arena), paths, thread_count); }
+
+////////////////////////////////
+//~ Ed: Parse Cache Functions
+
+// Same result as md_parse_from_text, loaded from the cache when an entry for the text exists (its bytes are compared, a hash collision just misses).
+// Otherwise parses & stores an entry, written to a temporary file & renamed into place so concurrent processes only ever see whole entries.
+MD_API MD_ParseResult md_parse_from_text_cached__ainfo(MD_AllocatorInfo ainfo, MD_ParseCache* cache, MD_String8 filename, MD_String8 text);
+MD_API MD_U64         md_parse_cache_key             (MD_ParseCache* cache, MD_String8 text);
+// Deletes the oldest entries until the rest fit in max_total_size, returns how many were deleted
+MD_API MD_U64         md_parse_cache_trim            (MD_ParseCache* cache);
+
+#define md_parse_from_text_cached(allocator, cache, filename, text) _Generic(allocator, MD_Arena*: md_parse_from_text_cached__arena, MD_AllocatorInfo: md_parse_from_text_cached__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, cache, filename, text)
+
+md_force_inline MD_ParseResult md_parse_from_text_cached__arena(MD_Arena* arena, MD_ParseCache* cache, MD_String8 filename, MD_String8 text) { return md_parse_from_text_cached__ainfo(md_arena_allocator(arena), cache, filename, text); }
+
+////////////////////////////////
+//~ Ed: Selector Functions
+
+// Ed: step_count is 0 & msgs holds the errors (src_offset is the byte in source) when it doesn't compile
+MD_API MD_Selector  md_selector_compile__ainfo(MD_AllocatorInfo ainfo, MD_String8 source);
+// Ed: does node pass the step's label & predicates
+MD_API MD_B32       md_selector_step_match    (MD_Selector* selector, MD_SelectorStep* step, MD_Node* node);
+// Ed: every match under root in document order, each node once
+MD_API MD_NodeArray md_select__ainfo          (MD_AllocatorInfo ainfo, MD_Selector* selector, MD_Node* root);
+// Ed: md_select over each root, with their top-level children split across thread_count threads (0 uses every logical processor).
+// Same result as calling md_select on each root in turn & concatenating.
+MD_API MD_NodeArray md_select_parallel__ainfo (MD_AllocatorInfo ainfo, MD_Selector* selector, MD_NodeArray roots, MD_U64 thread_count);
+
+#define md_selector_compile(allocator, source)                      _Generic(allocator, MD_Arena*: md_selector_compile__arena, MD_AllocatorInfo: md_selector_compile__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, source)
+#define md_select(allocator, selector, root)                        _Generic(allocator, MD_Arena*: md_select__arena,           MD_AllocatorInfo: md_select__ainfo,           default: md_assert_generic_sel_fail) md_generic_call(allocator, selector, root)
+#define md_select_parallel(allocator, selector, roots, thread_count) _Generic(allocator, MD_Arena*: md_select_parallel__arena,  MD_AllocatorInfo: md_select_parallel__ainfo,  default: md_assert_generic_sel_fail) md_generic_call(allocator, selector, roots, thread_count)
+
+md_force_inline MD_Selector  md_selector_compile__arena(MD_Arena* arena, MD_String8 source)                                              { return md_selector_compile__ainfo(md_arena_allocator(arena), source); }
+md_force_inline MD_NodeArray md_select__arena          (MD_Arena* arena, MD_Selector* selector, MD_Node* root)                          { return md_select__ainfo          (md_arena_allocator(arena), selector, root); }
+md_force_inline MD_NodeArray md_select_parallel__arena (MD_Arena* arena, MD_Selector* selector, MD_NodeArray roots, MD_U64 thread_count) { return md_select_parallel__ainfo (md_arena_allocator(arena), selector, roots, thread_count); }
+
+////////////////////////////////
+//~ Ed: Lookup Path Functions
+
+// Ed: labels are separated by /, empty ones are skipped
+MD_API MD_LookupPath md_lookup_path_compile__ainfo(MD_AllocatorInfo ainfo, MD_String8 path, MD_StringMatchFlags flags);
+// Ed: walks the path from root & remembers the result, md_lookup_path_resolve only calls this when the memo is stale
+MD_API MD_Node*      md_lookup_path__resolve      (MD_LookupPath* path, MD_Node* root);
+
+#define md_lookup_path_compile(allocator, path, flags) _Generic(allocator, MD_Arena*: md_lookup_path_compile__arena, MD_AllocatorInfo: md_lookup_path_compile__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, path, flags)
+
+md_force_inline MD_LookupPath md_lookup_path_compile__arena(MD_Arena* arena, MD_String8 path, MD_StringMatchFlags flags) { return md_lookup_path_compile__ainfo(md_arena_allocator(arena), path, flags); }
+
+// Ed: the node at the end of the path from root, nil if some label along it is missing
+inline MD_Node*
+md_lookup_path_resolve(MD_LookupPath* path, MD_Node* root)
+{
+	if (path->root == root && path->generation == md_tree_generation()) {
+		return path->node;
+	}
+	return md_lookup_path__resolve(path, root);
+}
+
+////////////////////////////////
+//~ Ed: Tree Hash Functions
+
+MD_API MD_TreeHashes md_tree_hashes_from_tree__ainfo(MD_AllocatorInfo ainfo, MD_Node* root);
+// Ed: rehashes the whole tree if it was edited since it was hashed
+MD_API void          md_tree_hashes_refresh         (MD_TreeHashes* hashes);
+MD_API void          md_tree_hashes_release         (MD_TreeHashes* hashes);
+// Ed: hash of node's subtree, node has to be under the hashed root (0 when it isn't)
+MD_API MD_U64        md_tree_hash_from_node         (MD_TreeHashes* hashes, MD_Node* node);
+// Ed: tree_match with exact strings, settled by comparing the two subtree hashes
+MD_API MD_B32        md_tree_match_hashed           (MD_TreeHashes* a_hashes, MD_Node* a, MD_TreeHashes* b_hashes, MD_Node* b);
+// Ed: what changed from a->root to b->root, both are refreshed first
+MD_API MD_TreeDiff   md_tree_diff__ainfo            (MD_AllocatorInfo ainfo, MD_TreeHashes* a, MD_TreeHashes* b);
+
+#define md_tree_hashes_from_tree(allocator, root) _Generic(allocator, MD_Arena*: md_tree_hashes_from_tree__arena, MD_AllocatorInfo: md_tree_hashes_from_tree__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, root)
+#define md_tree_diff(allocator, a, b)             _Generic(allocator, MD_Arena*: md_tree_diff__arena,             MD_AllocatorInfo: md_tree_diff__ainfo,             default: md_assert_generic_sel_fail) md_generic_call(allocator, a, b)
+
+md_force_inline MD_TreeHashes md_tree_hashes_from_tree__arena(MD_Arena* arena, MD_Node* root)                 { return md_tree_hashes_from_tree__ainfo(md_arena_allocator(arena), root); }
+md_force_inline MD_TreeDiff   md_tree_diff__arena            (MD_Arena* arena, MD_TreeHashes* a, MD_TreeHashes* b) { return md_tree_diff__ainfo            (md_arena_allocator(arena), a, b); }
+
 ////////////////////////////////
 //~ rjf: Tree -> Text Functions
 
@@ -618,3 +1937,48 @@ MD_API MD_String8List md_debug_string_list_from_tree__ainfo(MD_AllocatorInfo ain
 #define md_debug_string_list_from_tree(allocator, string) _Generic(allocator, MD_Arena*: md_debug_string_list_from_tree__arena, MD_AllocatorInfo: md_debug_string_list_from_tree__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, string)
 
 md_force_inline MD_String8List md_debug_string_list_from_tree__arena(MD_Arena* arena, MD_Node* root) { return md_debug_string_list_from_tree__ainfo(md_arena_allocator(arena), root); }
+
+////////////////////////////////
+//~ Ed: Canonical Tree -> Text Functions
+
+// Ed: cap 0 starts at 64 KB, block_size 0 writes 1 MB at a time
+MD_API MD_Emitter md_emitter_alloc__ainfo    (MD_AllocatorInfo ainfo, MD_U64 cap);
+MD_API MD_Emitter md_emitter_from_file__ainfo(MD_AllocatorInfo ainfo, MD_OS_Handle file, MD_U64 block_size);
+MD_API MD_Emitter md_emitter_from_sink__ainfo(MD_AllocatorInfo ainfo, MD_EmitterSinkFunc* sink, void* sink_data, MD_U64 block_size);
+// Ed: writes what's buffered to the file or sink, does nothing for emitters in memory
+MD_API void       md_emitter_flush           (MD_Emitter* emitter);
+// Ed: flushes & frees the buffer, the file stays open
+MD_API void       md_emitter_release         (MD_Emitter* emitter);
+MD_API void       md_emit_bytes              (MD_Emitter* emitter, MD_String8 string);
+// Ed: node with its tags & children as a top-level node, then a newline
+MD_API void       md_emit_node               (MD_Emitter* emitter, MD_Node* node);
+// Ed: parent's children as the top level of a file
+MD_API void       md_emit_children           (MD_Emitter* emitter, MD_Node* parent);
+// Ed: File nodes (parse roots) give their children's text, other nodes their own
+MD_API MD_String8 md_text_from_tree__ainfo   (MD_AllocatorInfo ainfo, MD_Node* root);
+MD_API MD_B32     md_tree_write_to_file_path (MD_Node* root, MD_String8 path);
+
+inline MD_String8 md_emitter_string(MD_Emitter* emitter) { return md_str8(emitter->str, emitter->size); }
+
+#define md_emitter_alloc(allocator, cap)                    _Generic(allocator, MD_Arena*: md_emitter_alloc__arena,     MD_AllocatorInfo: md_emitter_alloc__ainfo,     default: md_assert_generic_sel_fail) md_generic_call(allocator, cap)
+#define md_emitter_from_file(allocator, file, block_size)   _Generic(allocator, MD_Arena*: md_emitter_from_file__arena, MD_AllocatorInfo: md_emitter_from_file__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, file, block_size)
+#define md_emitter_from_sink(allocator, sink, sink_data, block_size) _Generic(allocator, MD_Arena*: md_emitter_from_sink__arena, MD_AllocatorInfo: md_emitter_from_sink__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, sink, sink_data, block_size)
+#define md_text_from_tree(allocator, root)                  _Generic(allocator, MD_Arena*: md_text_from_tree__arena,    MD_AllocatorInfo: md_text_from_tree__ainfo,    default: md_assert_generic_sel_fail) md_generic_call(allocator, root)
+
+md_force_inline MD_Emitter md_emitter_alloc__arena    (MD_Arena* arena, MD_U64 cap)                                { return md_emitter_alloc__ainfo    (md_arena_allocator(arena), cap); }
+md_force_inline MD_Emitter md_emitter_from_file__arena(MD_Arena* arena, MD_OS_Handle file, MD_U64 block_size) { return md_emitter_from_file__ainfo(md_arena_allocator(arena), file, block_size); }
+md_force_inline MD_Emitter md_emitter_from_sink__arena(MD_Arena* arena, MD_EmitterSinkFunc* sink, void* sink_data, MD_U64 block_size) { return md_emitter_from_sink__ainfo(md_arena_allocator(arena), sink, sink_data, block_size); }
+md_force_inline MD_String8 md_text_from_tree__arena   (MD_Arena* arena, MD_Node* root)                            { return md_text_from_tree__ainfo   (md_arena_allocator(arena), root); }
+
+////////////////////////////////
+//~ Ed: Tree Export Functions
+
+// Ed: one pass over root, its tags & everything under it, walked through parent links (no recursion & no stack)
+MD_API void       md_export_tree              (MD_Emitter* emitter, MD_Node* root, MD_ExportFormat format);
+MD_API MD_String8 md_export_from_tree__ainfo  (MD_AllocatorInfo ainfo, MD_Node* root, MD_ExportFormat format);
+MD_API MD_B32     md_export_tree_to_file_path (MD_Node* root, MD_String8 path, MD_ExportFormat format);
+
+#define md_export_from_tree(allocator, root, format) _Generic(allocator, MD_Arena*: md_export_from_tree__arena, MD_AllocatorInfo: md_export_from_tree__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, root, format)
+
+md_force_inline MD_String8 md_export_from_tree__arena(MD_Arena* arena, MD_Node* root, MD_ExportFormat format) { return md_export_from_tree__ainfo(md_arena_allocator(arena), root, format); }
+
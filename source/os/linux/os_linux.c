@@ -273,6 +273,17 @@ md_os_copy_file_path(MD_String8 dst, MD_String8 src)
 	return result;
 }
 
+MD_B32
+md_os_move_file_path(MD_String8 dst, MD_String8 src)
+{
+	MD_TempArena scratch  = md_scratch_begin(0, 0);
+	MD_String8   dst_copy = md_push_str8_copy(scratch.arena, dst);
+	MD_String8   src_copy = md_push_str8_copy(scratch.arena, src);
+	MD_B32       result   = rename((char*)src_copy.str, (char*)dst_copy.str) != -1;
+	scratch_end(scratch);
+	return result;
+}
+
 MD_String8
 md_os_full_path_from_path__ainfo(MD_AllocatorInfo ainfo, MD_String8 path)
 {
@@ -339,6 +350,9 @@ md_os_file_map_view_open(MD_OS_Handle map, MD_OS_AccessFlags flags, MD_Rng1U64 r
 	int    fd        = (int)map.u64[0];
 	int    map_flags = MAP_PRIVATE;
 	void*  base      = mmap(0, md_dim_1u64(range), prot_flags, map_flags, fd, range.md_min);
+	if (base == MAP_FAILED) {
+		base = 0;
+	}
 	return base;
 }
 
@@ -358,7 +372,7 @@ md_os_file_iter_begin__ainfo(MD_AllocatorInfo ainfo, MD_String8 path, MD_OS_File
 
 	MD_OS_LNX_FileIter* iter = (MD_OS_LNX_FileIter*)base_iter->memory;
 	{
-		MD_String8 path_copy = md_str8_copy(arena, path);
+		MD_String8 path_copy = md_str8_copy(ainfo, path);
 		iter->dir  = opendir((char*)path_copy.str);
 		iter->path = path_copy;
 	}
@@ -366,7 +380,7 @@ md_os_file_iter_begin__ainfo(MD_AllocatorInfo ainfo, MD_String8 path, MD_OS_File
 }
 
 MD_B32
-md_os_file_iter_next(MD_Arena* arena, MD_OS_FileIter* iter, MD_OS_FileInfo* info_out)
+md_os_file_iter_next__ainfo(MD_AllocatorInfo ainfo, MD_OS_FileIter* iter, MD_OS_FileInfo* info_out)
 {
 	MD_B32 good = 0;
 	MD_OS_LNX_FileIter* lnx_iter = (MD_OS_LNX_FileIter*)iter->memory;
@@ -381,7 +395,7 @@ md_os_file_iter_next(MD_Arena* arena, MD_OS_FileIter* iter, MD_OS_FileInfo* info
 		int stat_result = 0;
 		if(good)
 		{
-			MD_TempArena scratch     = md_scratch_begin(&arena, 1);
+			MD_TempArena scratch     = md_scratch_begin(ainfo);
 			MD_String8   full_path   = md_str8f(scratch.arena, "%S/%s", lnx_iter->path, lnx_iter->dp->d_name);
 			          stat_result = stat((char *)full_path.str, &st);
 			scratch_end(scratch);
@@ -400,7 +414,7 @@ md_os_file_iter_next(MD_Arena* arena, MD_OS_FileIter* iter, MD_OS_FileInfo* info
 		// rjf: output & exit, if good & unfiltered
 		if (good && !filtered)
 		{
-			info_out->name = md_str8_copy(arena, md_str8_cstring(lnx_iter->dp->d_name));
+			info_out->name = md_str8_copy(ainfo, md_str8_cstring(lnx_iter->dp->d_name));
 			if (stat_result != -1) {
 				info_out->props = md_os_lnx_file_properties_from_stat(&st);
 			}
@@ -216,6 +216,7 @@ MD_API MD_FileProperties md_os_properties_from_file      (MD_OS_Handle file);
 MD_API MD_OS_FileID      md_os_id_from_file              (MD_OS_Handle file);
 MD_API MD_B32            md_os_delete_file_at_path       (MD_String8   path);
 MD_API MD_B32            md_os_copy_file_path            (MD_String8   dst,   MD_String8 src);
+MD_API MD_B32            md_os_move_file_path            (MD_String8   dst,   MD_String8 src); // replaces dst atomically
 MD_API MD_B32            md_os_file_path_exists          (MD_String8   path);
 MD_API MD_FileProperties md_os_properties_from_file_path (MD_String8   path);
 MD_API MD_String8        md_os_full_path_from_path__arena(MD_Arena*        arena, MD_String8 path);
@@ -238,11 +239,11 @@ MD_API MD_OS_FileIter* md_os_file_iter_begin__ainfo(MD_AllocatorInfo ainfo, MD_S
 MD_API MD_B32          md_os_file_iter_next__ainfo (MD_AllocatorInfo arena, MD_OS_FileIter* iter, MD_OS_FileInfo*     info_out);
 MD_API void         md_os_file_iter_end         (                     MD_OS_FileIter* iter);
 
-#define md_os_file_iter_begin(allocator, path, flags)   _Generic(allocator, MD_Arena*: md_os_file_iter_begin__arena, MD_AllocatorInfo: md_os_file_iter_begin__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, path)
-#define md_os_file_iter_next(allocator, iter, info_out) _Generic(allocator, MD_Arena*: md_os_file_iter_next__arena,  MD_AllocatorInfo: md_os_file_iter_next__ainfo,  default: md_assert_generic_sel_fail) md_generic_call(allocator, path)
+#define md_os_file_iter_begin(allocator, path, flags)   _Generic(allocator, MD_Arena*: md_os_file_iter_begin__arena, MD_AllocatorInfo: md_os_file_iter_begin__ainfo, default: md_assert_generic_sel_fail) md_generic_call(allocator, path, flags)
+#define md_os_file_iter_next(allocator, iter, info_out) _Generic(allocator, MD_Arena*: md_os_file_iter_next__arena,  MD_AllocatorInfo: md_os_file_iter_next__ainfo,  default: md_assert_generic_sel_fail) md_generic_call(allocator, iter, info_out)
 
-md_force_inline MD_OS_FileIter* md_os_file_iter_begin__arena(MD_Arena* arena, MD_String8      path, MD_OS_FileIterFlags flags)    { reutrn (); }
-md_force_inline MD_B32          md_os_file_iter_next__arena (MD_Arena* arena, MD_OS_FileIter* iter, MD_OS_FileInfo*     info_out) { reutrn (); }
+md_force_inline MD_OS_FileIter* md_os_file_iter_begin__arena(MD_Arena* arena, MD_String8      path, MD_OS_FileIterFlags flags)    { return md_os_file_iter_begin__ainfo(md_arena_allocator(arena), path, flags); }
+md_force_inline MD_B32          md_os_file_iter_next__arena (MD_Arena* arena, MD_OS_FileIter* iter, MD_OS_FileInfo*     info_out) { return md_os_file_iter_next__ainfo (md_arena_allocator(arena), iter, info_out); }
 
 //- rjf: directory creation
 MD_API MD_B32 md_os_make_directory(MD_String8 path);
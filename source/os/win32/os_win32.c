@@ -345,6 +345,17 @@ md_os_copy_file_path(MD_String8 dst, MD_String8 src)
 	return result;
 }
 
+MD_B32
+md_os_move_file_path(MD_String8 dst, MD_String8 src)
+{
+	MD_TempArena scratch = md_scratch_begin(0, 0);
+	MD_String16  dst16   = md_str16_from(scratch.arena, dst);
+	MD_String16  src16   = md_str16_from(scratch.arena, src);
+	MD_B32 result = MoveFileExW((WCHAR*)src16.str, (WCHAR*)dst16.str, MOVEFILE_REPLACE_EXISTING);
+	scratch_end(scratch);
+	return result;
+}
+
 MD_String8
 md_os_full_path_from_path__ainfo(MD_AllocatorInfo ainfo, MD_String8 path)
 {
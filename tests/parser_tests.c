@@ -0,0 +1,1541 @@
+//$ exe //
+
+#include "metadesk.c"
+
+MD_Arena* arena = 0;
+
+static struct
+{
+	int number_of_tests;
+	int number_passed;
+}
+test_ctx;
+
+static void
+begin_test(char* name)
+{
+	int length = (int)md_cstring_length((MD_U8*)name);
+	int spaces = 25 - length;
+	if (spaces < 0) {
+		spaces = 0;
+	}
+	printf("\"%s\" %.*s [", name, spaces, "------------------------------");
+	test_ctx.number_of_tests = 0;
+	test_ctx.number_passed   = 0;
+}
+
+static void
+test_result(MD_B32 result)
+{
+	test_ctx.number_of_tests += 1;
+	test_ctx.number_passed   += !!result;
+	printf(result ? "." : "X");
+}
+
+static void
+end_test(void)
+{
+	int spaces = 20 - test_ctx.number_of_tests;
+	if (spaces < 0) { spaces = 0; }
+	printf("]%.*s ", spaces, "                                      ");
+	printf("[%i/%i] %i passed, %i tests, ",
+		test_ctx.number_passed, test_ctx.number_of_tests,
+		test_ctx.number_passed, test_ctx.number_of_tests);
+	if (test_ctx.number_of_tests == test_ctx.number_passed) {
+		printf("SUCCESS ( )");
+	}
+	else {
+		printf("FAILED  (X)");
+	}
+	printf("\n");
+}
+
+#define test(name) for(int _i_ = (begin_test(name), 0); !_i_; _i_ += 1, end_test())
+
+//- random text made of fragments that exercise every parse rule, including the error paths
+
+static MD_U32 rng_state = 1;
+
+static MD_U32
+rng_next(void) {
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 17;
+	rng_state ^= rng_state << 5;
+	return rng_state;
+}
+
+static MD_String8
+random_text(MD_Arena* arena, MD_U64 max_size)
+{
+	md_local_persist char* fragments[] = {
+		"a", "b_2", "123", "\"str\"", "'c'", "```raw```", "+-", " ", " ", " ", "\n", "\n\n\n",
+		":", ":", "{", "}", "(", ")", "[", "]", ",", ";", "@", "@tag", "@tag(", "#", "\\",
+		"// comment\n", "/* block */", "'broken\n",
+	};
+	MD_U8* str  = md_push_array(arena, MD_U8, max_size);
+	MD_U64 size = 0;
+	for (;;)
+	{
+		MD_String8 fragment = md_str8_cstring(fragments[rng_next() % md_array_count(fragments)]);
+		if (size + fragment.size > max_size) {
+			break;
+		}
+		md_memory_copy(str + size, fragment.str, fragment.size);
+		size += fragment.size;
+	}
+	return md_str8(str, size);
+}
+
+//- node-for-node comparison, including tags & source offsets
+
+static MD_B32
+trees_match_exactly(MD_Node* a, MD_Node* b)
+{
+	MD_B32 result = (
+		a->kind       == b->kind       &&
+		a->flags      == b->flags      &&
+		a->src_offset == b->src_offset &&
+		a->tag_filter == b->tag_filter &&
+		md_str8_match(a->string,     b->string,     0) &&
+		md_str8_match(a->raw_string, b->raw_string, 0)
+	);
+	MD_Node* a_tag = a->first_tag;
+	MD_Node* b_tag = b->first_tag;
+	for (;result && !md_node_is_nil(a_tag) && !md_node_is_nil(b_tag); a_tag = a_tag->next, b_tag = b_tag->next) {
+		result = trees_match_exactly(a_tag, b_tag);
+	}
+	MD_Node* a_child = a->first;
+	MD_Node* b_child = b->first;
+	for (;result && !md_node_is_nil(a_child) && !md_node_is_nil(b_child); a_child = a_child->next, b_child = b_child->next) {
+		result = trees_match_exactly(a_child, b_child);
+	}
+	return result && md_node_is_nil(a_tag) == md_node_is_nil(b_tag) && md_node_is_nil(a_child) == md_node_is_nil(b_child);
+}
+
+static MD_B32
+parse_results_match(MD_ParseResult a, MD_ParseResult b)
+{
+	MD_B32 result = a.msgs.count == b.msgs.count && trees_match_exactly(a.root, b.root);
+	for (MD_Msg* ma = a.msgs.first, *mb = b.msgs.first; result && ma != 0 && mb != 0; ma = ma->next, mb = mb->next) {
+		result = ma->kind == mb->kind && ma->node->src_offset == mb->node->src_offset && md_str8_match(ma->string, mb->string, 0);
+	}
+	return result;
+}
+
+// every tag's found through the filter & misses agree with a walk of the tags
+static MD_B32
+tag_filters_hold(MD_Node* node, MD_String8 miss)
+{
+	MD_B32 result = md_node_is_nil(node->first_tag) || node->tag_filter != 0;
+	result = result && md_tag_from_string(node, miss, 0) == md_node_from_chain_string(node->first_tag, md_nil_node(), miss, 0);
+	for (MD_Node* tag = node->first_tag; result && !md_node_is_nil(tag); tag = tag->next) {
+		result = md_tag_from_string(node, tag->string, 0) == md_node_from_chain_string(node->first_tag, md_nil_node(), tag->string, 0) && tag_filters_hold(tag, miss);
+	}
+	for (MD_Node* child = node->first; result && !md_node_is_nil(child); child = child->next) {
+		result = tag_filters_hold(child, miss);
+	}
+	return result;
+}
+
+static void
+materialize_all(MD_Node* node)
+{
+	for md_each_node(tag, node->first_tag) { materialize_all(tag); }
+	for md_each_child(child, node)         { materialize_all(child); }
+}
+
+// same messages, in any order (lazy sets report theirs when they're parsed)
+static MD_B32
+msgs_match_unordered(MD_MsgList a, MD_MsgList b)
+{
+	MD_B32 result = a.count == b.count;
+	for (MD_Msg* ma = a.first; result && ma != 0; ma = ma->next)
+	{
+		result = 0;
+		for (MD_Msg* mb = b.first; !result && mb != 0; mb = mb->next) {
+			result = ma->kind == mb->kind && ma->node->src_offset == mb->node->src_offset && md_str8_match(ma->string, mb->string, 0);
+		}
+	}
+	return result;
+}
+
+// the top-level nodes of full that pass the filter, matched in order against filtered's
+static MD_B32
+filtered_parse_matches(MD_ParseResult full, MD_ParseResult filtered, MD_ParseFilter filter)
+{
+	MD_Node* kept = filtered.root->first;
+	for md_each_node(node, full.root->first)
+	{
+		MD_B32 pass = 0;
+		for (MD_U64 idx = 0; idx < filter.tags.count; idx += 1) {
+			pass |= md_node_has_tag(node, filter.tags.v[idx], 0);
+		}
+		if (pass) {
+			if (md_node_is_nil(kept) || ! trees_match_exactly(node, kept)) {
+				return 0;
+			}
+			kept = kept->next;
+		}
+	}
+	return md_node_is_nil(kept);
+}
+
+static MD_ParseResult
+parse_from_token_array(MD_Arena* arena, MD_String8 text)
+{
+	MD_TokenizeResult tokenize = md_tokenize_from_text(arena, text);
+	return md_parse_from_text_tokens(arena, md_str8_lit("text"), text, tokenize.tokens);
+}
+
+//- every label & tag has its string's atom, everything else has none
+
+static MD_B32
+atoms_match_table(MD_AtomTable* atoms, MD_Node* node)
+{
+	MD_B32 labeled = node->kind == MD_NodeKind_Main || node->kind == MD_NodeKind_Tag;
+	MD_B32 result  = node->atom == (labeled ? md_atom_lookup(atoms, node->string) : 0);
+	for (MD_Node* tag = node->first_tag; result && !md_node_is_nil(tag); tag = tag->next) {
+		result = atoms_match_table(atoms, tag);
+	}
+	for (MD_Node* child = node->first; result && !md_node_is_nil(child); child = child->next) {
+		result = atoms_match_table(atoms, child);
+	}
+	return result;
+}
+
+typedef struct AtomParseJob AtomParseJob;
+struct AtomParseJob
+{
+	MD_AtomTable* atoms;
+	MD_String8*   samples;
+	MD_U64        sample_count;
+	MD_U64        first_sample;
+	MD_B32        match;
+};
+
+static void
+atom_parse_job(void* ptr)
+{
+	AtomParseJob* job          = (AtomParseJob*)ptr;
+	MD_Arena*     thread_arena = md_arena_alloc(.backing = md_varena_allocator(md_varena_alloc(0)));
+	job->match = 1;
+	for (MD_U64 idx = 0; idx < 4 * job->sample_count && job->match; idx += 1)
+	{
+		MD_TempArena   temp  = md_temp_begin(thread_arena);
+		MD_ParseResult parse = md_parse_from_text_atoms(temp.arena, job->atoms, md_str8_lit("text"), job->samples[(job->first_sample + idx) % job->sample_count]);
+		job->match = atoms_match_table(job->atoms, parse.root);
+		md_temp_end(temp);
+	}
+	md_arena_release(thread_arena);
+}
+
+//- selectors checked against a step at a time over the whole tree in preorder
+
+static void
+random_selector_text(MD_Arena* arena, MD_String8List* list, MD_U64 depth)
+{
+	md_local_persist char* labels[] = { "a", "b", "c" };
+	md_local_persist char* tags[]   = { "", "", "@x ", "@y ", "@x(a) ", "@y(b) @x " };
+	MD_U64 count = rng_next() % 5;
+	for (MD_U64 idx = 0; idx < count; idx += 1)
+	{
+		md_str8_list_push(arena, list, md_str8_cstring(tags[rng_next() % md_array_count(tags)]));
+		md_str8_list_push(arena, list, md_str8_cstring(labels[rng_next() % md_array_count(labels)]));
+		if (depth < 6 && rng_next() % 3 != 0) {
+			md_str8_list_push(arena, list, md_str8_lit(": {"));
+			random_selector_text(arena, list, depth + 1);
+			md_str8_list_push(arena, list, md_str8_lit("}"));
+		}
+		md_str8_list_push(arena, list, md_str8_lit(" "));
+	}
+}
+
+static MD_B32
+node_is_under(MD_Node* node, MD_Node* ancestor)
+{
+	for (MD_Node* parent = node->parent; !md_node_is_nil(parent); parent = parent->parent) {
+		if (parent == ancestor) return 1;
+	}
+	return 0;
+}
+
+static void
+preorder_push(MD_Node** nodes, MD_U64* count, MD_Node* node)
+{
+	nodes[*count] = node;
+	*count += 1;
+	for md_each_child(child, node) { preorder_push(nodes, count, child); }
+}
+
+static MD_B32
+select_matches_reference(MD_Arena* arena, MD_Selector* selector, MD_Node* root, MD_NodeArray selected)
+{
+	MD_U64    count = 0;
+	MD_Node** nodes = md_push_array(arena, MD_Node*, 1 << 16);
+	preorder_push(nodes, &count, root);
+	MD_B32* in  = md_push_array(arena, MD_B32, count);
+	MD_B32* out = md_push_array(arena, MD_B32, count);
+	in[0] = 1;
+	for (MD_U64 step_idx = 0; step_idx < selector->step_count; step_idx += 1)
+	{
+		MD_SelectorStep* step = &selector->steps[step_idx];
+		md_memory_zero(out, sizeof(MD_B32) * count);
+		for (MD_U64 idx = 0; idx < count; idx += 1) {
+			for (MD_U64 below = idx + 1; in[idx] && below < count && node_is_under(nodes[below], nodes[idx]); below += 1) {
+				MD_B32 reached = (step->flags & MD_SelectorStepFlag_Descendants) || nodes[below]->parent == nodes[idx];
+				out[below] |= reached && md_selector_step_match(selector, step, nodes[below]);
+			}
+		}
+		md_memory_copy(in, out, sizeof(MD_B32) * count);
+	}
+	MD_U64 selected_idx = 0;
+	for (MD_U64 idx = 1; idx < count; idx += 1) {
+		if (in[idx]) {
+			if (selected_idx == selected.count || selected.v[selected_idx] != nodes[idx]) return 0;
+			selected_idx += 1;
+		}
+	}
+	return selected_idx == selected.count;
+}
+
+//- same tree from different text: everything but source offsets & raw strings
+
+static MD_B32
+trees_match_shape(MD_Node* a, MD_Node* b)
+{
+	MD_B32 result = a->kind == b->kind && a->flags == b->flags && md_str8_match(a->string, b->string, 0);
+	MD_Node* a_tag = a->first_tag;
+	MD_Node* b_tag = b->first_tag;
+	for (;result && !md_node_is_nil(a_tag) && !md_node_is_nil(b_tag); a_tag = a_tag->next, b_tag = b_tag->next) {
+		result = trees_match_shape(a_tag, b_tag);
+	}
+	MD_Node* a_child = a->first;
+	MD_Node* b_child = b->first;
+	for (;result && !md_node_is_nil(a_child) && !md_node_is_nil(b_child); a_child = a_child->next, b_child = b_child->next) {
+		result = trees_match_shape(a_child, b_child);
+	}
+	return result && md_node_is_nil(a_tag) == md_node_is_nil(b_tag) && md_node_is_nil(a_child) == md_node_is_nil(b_child);
+}
+
+// every set has both of its delimiters or neither (the parser takes an unclosed set or a stray closer without a message)
+static MD_B32
+sets_are_closed(MD_Node* node)
+{
+	MD_NodeFlags left   = node->flags & (MD_NodeFlag_HasParenLeft  | MD_NodeFlag_HasBracketLeft  | MD_NodeFlag_HasBraceLeft);
+	MD_NodeFlags right  = node->flags & (MD_NodeFlag_HasParenRight | MD_NodeFlag_HasBracketRight | MD_NodeFlag_HasBraceRight);
+	MD_B32       result = (left == 0) == (right == 0) && (node->kind != MD_NodeKind_File || left == 0);
+	for (MD_Node* tag = node->first_tag; result && !md_node_is_nil(tag); tag = tag->next) {
+		for (MD_Node* arg = tag->first; result && !md_node_is_nil(arg); arg = arg->next) {
+			result = sets_are_closed(arg);
+		}
+	}
+	for (MD_Node* child = node->first; result && !md_node_is_nil(child); child = child->next) {
+		result = sets_are_closed(child);
+	}
+	return result;
+}
+
+// text parses back to root's tree & emits the same text again
+static MD_B32
+text_round_trips(MD_Arena* arena, MD_Node* root, MD_String8 text)
+{
+	MD_ParseResult parse = md_parse_from_text(arena, md_str8_lit("text"), text);
+	MD_B32 result = parse.msgs.count == 0 && md_str8_match(root->string, parse.root->string, 0);
+	for (MD_Node* a = root->first, *b = parse.root->first; result && (!md_node_is_nil(a) || !md_node_is_nil(b)); a = a->next, b = b->next) {
+		result = !md_node_is_nil(a) && !md_node_is_nil(b) && trees_match_shape(a, b);
+	}
+	return result && md_str8_match(text, md_text_from_tree(arena, parse.root), 0);
+}
+
+//- tree export checks
+
+static MD_U64
+tree_node_count(MD_Node* node)
+{
+	MD_U64 result = 1;
+	for (MD_Node* tag = node->first_tag; !md_node_is_nil(tag); tag = tag->next) {
+		result += tree_node_count(tag);
+	}
+	for (MD_Node* child = node->first; !md_node_is_nil(child); child = child->next) {
+		result += tree_node_count(child);
+	}
+	return result;
+}
+
+// one well-formed msgpack value of the kinds the exporter writes, counting the maps in it
+static MD_B32
+msgpack_skip(MD_U8** at, MD_U8* opl, MD_U64* map_count)
+{
+	if (*at >= opl) {
+		return 0;
+	}
+	MD_U8  code   = **at;
+	MD_U64 length = 0;
+	MD_U64 width  = 0;
+	MD_U64 items  = 0;
+	*at += 1;
+	if      (code < 0x80)                  { return 1; }
+	else if ((code & 0xF0) == 0x80)        { items  = (MD_U64)(code & 0x0F) * 2; *map_count += 1; }
+	else if ((code & 0xF0) == 0x90)        { items  = code & 0x0F; }
+	else if ((code & 0xE0) == 0xA0)        { length = code & 0x1F; }
+	else if (code >= 0xcc && code <= 0xcf) { width  = (MD_U64)1 << (code - 0xcc); }
+	else if (code >= 0xd9 && code <= 0xdb) { width  = (MD_U64)1 << (code - 0xd9); }
+	else if (code == 0xdc || code == 0xdd) { width  = code == 0xdc ? 2 : 4; }
+	else return 0;
+	if (*at + width > opl) {
+		return 0;
+	}
+	MD_U64 value = 0;
+	for (MD_U64 idx = 0; idx < width; idx += 1) {
+		value = (value << 8) | (*at)[idx];
+	}
+	*at += width;
+	if (code >= 0xd9 && code <= 0xdb) length = value;
+	if (code == 0xdc || code == 0xdd) items  = value;
+	if (*at + length > opl) {
+		return 0;
+	}
+	*at += length;
+	MD_B32 result = 1;
+	for (MD_U64 idx = 0; idx < items && result; idx += 1) {
+		result = msgpack_skip(at, opl, map_count);
+	}
+	return result;
+}
+
+static MD_B32
+export_sink_append(void* user_data, MD_String8 block)
+{
+	MD_String8List* blocks = (MD_String8List*)user_data;
+	md_str8_list_push(arena, blocks, md_str8_copy(arena, block));
+	return 1;
+}
+
+int main(int argc, char** argv)
+{
+	MD_Context ctx = {0};
+	md_init(&ctx);
+	arena = md_arena_alloc(.backing = md_varena_allocator(md_varena_alloc(0)));
+
+	// Paths are relative to the repo root, which defaults to the parent of build/
+	MD_String8 root = md_str8_lit("..");
+	if (argc > 1) {
+		root = md_str8_cstring(argv[1]);
+	}
+
+	md_local_persist char* sample_paths[] = {
+		"docs/metadesk_reference.mdesk",
+		"examples/expr/expr_c_like.mdesk",
+		"examples/expr/expr_intro.mdesk",
+		"examples/intro/hello_world.mdesk",
+		"examples/intro/labels.mdesk",
+		"examples/intro/sets.mdesk",
+		"examples/type_metadata/bad_types.mdesk",
+		"examples/type_metadata/types.mdesk",
+		"examples/user_errors/user_errors.mdesk",
+	};
+	MD_String8 samples[md_array_count(sample_paths)];
+	for (MD_U64 path_idx = 0; path_idx < md_array_count(sample_paths); path_idx += 1) {
+		samples[path_idx] = md_os_data_from_file_path(arena, md_str8f(arena, "%S/%s", root, sample_paths[path_idx]));
+	}
+
+	test("Parse Structure")
+	{
+		MD_Node* tree = md_parse_from_text(arena, md_str8_lit("text"), md_str8_lit("@tag(x) a: { b c }, d: e\nf")).root;
+		MD_Node* a    = md_node_from_chain_string(tree->first, md_nil_node(), md_str8_lit("a"), 0);
+		MD_Node* d    = md_node_from_chain_string(tree->first, md_nil_node(), md_str8_lit("d"), 0);
+		test_result(md_child_count_from_node(tree) == 3);
+		test_result(md_child_count_from_node(a) == 2 && md_tag_count_from_node(a) == 1 && (a->flags & MD_NodeFlag_IsBeforeComma));
+		test_result(md_child_count_from_node(d) == 1 && md_str8_match(d->first->string, md_str8_lit("e"), 0));
+	}
+
+	test("Fused Parse")
+	{
+		for (MD_U64 sample_idx = 0; sample_idx < md_array_count(samples); sample_idx += 1)
+		{
+			MD_TempArena temp = md_temp_begin(arena);
+			test_result(samples[sample_idx].size > 0 && parse_results_match(parse_from_token_array(temp.arena, samples[sample_idx]), md_parse_from_text_fused(temp.arena, md_str8_lit("text"), samples[sample_idx])));
+			md_temp_end(temp);
+		}
+
+		// large enough to slide the cursor's window many times, tags & their lookahead straddle the window's edge
+		MD_B32 match = 1;
+		for (MD_U64 iter = 0; iter < 2000 && match; iter += 1)
+		{
+			MD_TempArena temp = md_temp_begin(arena);
+			MD_String8   text = random_text(temp.arena, rng_next() % MD_KB(8));
+			match = parse_results_match(parse_from_token_array(temp.arena, text), md_parse_from_text_fused(temp.arena, md_str8_lit("text"), text));
+			md_temp_end(temp);
+		}
+		test_result(match);
+	}
+
+	test("Significant Parse")
+	{
+		for (MD_U64 sample_idx = 0; sample_idx < md_array_count(samples); sample_idx += 1)
+		{
+			MD_TempArena                 temp        = md_temp_begin(arena);
+			MD_TokenizeSignificantResult significant = md_tokenize_significant_from_text(temp.arena, samples[sample_idx], 0);
+			test_result(parse_results_match(parse_from_token_array(temp.arena, samples[sample_idx]), md_parse_from_text_significant_tokens(temp.arena, md_str8_lit("text"), samples[sample_idx], significant.tokens)));
+			md_temp_end(temp);
+		}
+
+		// newline runs between implicit sets, tags & args split by trivia
+		MD_B32 match = 1;
+		for (MD_U64 iter = 0; iter < 2000 && match; iter += 1)
+		{
+			MD_TempArena                 temp        = md_temp_begin(arena);
+			MD_String8                   text        = random_text(temp.arena, rng_next() % MD_KB(2));
+			MD_TokenizeSignificantResult significant = md_tokenize_significant_from_text(temp.arena, text, 0);
+			match = parse_results_match(parse_from_token_array(temp.arena, text), md_parse_from_text_significant_tokens(temp.arena, md_str8_lit("text"), text, significant.tokens));
+			md_temp_end(temp);
+		}
+		test_result(match);
+	}
+
+	test("Flat Tree")
+	{
+		for (MD_U64 sample_idx = 0; sample_idx < md_array_count(samples); sample_idx += 1)
+		{
+			MD_TempArena       temp      = md_temp_begin(arena);
+			MD_ParseResult     parse     = md_parse_from_text(temp.arena, md_str8_lit("text"), samples[sample_idx]);
+			MD_FlatParseResult flat      = md_parse_flat_from_text(temp.arena, md_str8_lit("text"), samples[sample_idx]);
+			MD_ParseResult     roundtrip = { md_node_from_flat_tree(temp.arena, &flat.tree), flat.msgs };
+			MD_B32             match     = parse_results_match(parse, roundtrip) && flat.tree.extra.size == md_str8_lit("text").size; // only the filename is copied
+
+			// lookups land on the same nodes, subtrees are contiguous
+			MD_FlatNode flat_root = md_flat_tree_root(&flat.tree);
+			match = match && md_flat_child_count_from_node(&flat.tree, flat_root) == md_child_count_from_node(parse.root);
+			match = match && md_flat_node_subtree_opl(&flat.tree, flat_root) == flat.tree.count;
+			for (MD_Node* child = parse.root->first; match && !md_node_is_nil(child); child = child->next)
+			{
+				MD_Node*    expected = md_child_from_string(parse.root, child->string, 0);
+				MD_FlatNode found    = md_flat_child_from_string(&flat.tree, flat_root, child->string, 0);
+				match = !md_flat_node_is_nil(found) && flat.tree.src_offsets[found] == expected->src_offset;
+				if (match && !md_node_is_nil(expected->first_tag)) {
+					MD_FlatNode tag = md_flat_tag_from_string(&flat.tree, found, expected->first_tag->string, 0);
+					match = md_flat_node_kind(&flat.tree, tag) == MD_NodeKind_Tag && flat.tree.parents[tag] == found;
+				}
+			}
+			test_result(match);
+			md_temp_end(temp);
+		}
+
+		MD_B32 match = 1;
+		for (MD_U64 iter = 0; iter < 1000 && match; iter += 1)
+		{
+			MD_TempArena       temp = md_temp_begin(arena);
+			MD_String8         text = random_text(temp.arena, rng_next() % MD_KB(4));
+			MD_FlatParseResult flat = md_parse_flat_from_text(temp.arena, md_str8_lit("text"), text);
+			MD_ParseResult     roundtrip = { md_node_from_flat_tree(temp.arena, &flat.tree), flat.msgs };
+			match = parse_results_match(md_parse_from_text(temp.arena, md_str8_lit("text"), text), roundtrip);
+
+			// a subtree runs up to the first node that isn't a descendant
+			for (MD_FlatNode node = 1; match && node < flat.tree.count; node += 1)
+			{
+				MD_FlatNode opl = md_flat_node_subtree_opl(&flat.tree, node);
+				for (MD_FlatNode desc = node + 1; match && desc <= opl && desc < flat.tree.count; desc += 1)
+				{
+					MD_FlatNode ancestor = flat.tree.parents[desc];
+					for (;ancestor != 0 && ancestor != node; ancestor = flat.tree.parents[ancestor]) {}
+					match = (ancestor == node) == (desc < opl);
+				}
+			}
+			md_temp_end(temp);
+		}
+		test_result(match);
+
+		// strings from outside the source text (the filename too) get copied into extra
+		{
+			MD_TempArena temp = md_temp_begin(arena);
+			MD_String8   text = md_str8_lit("a: b");
+			MD_Node*     root = md_parse_from_text(temp.arena, md_str8_lit("text"), text).root;
+			MD_Node*     tag  = md_push_node(temp.arena, MD_NodeKind_Tag, 0, md_str8_lit("generated"), md_str8_lit("@generated"), 0);
+			md_node_push_tag(root->first, tag);
+			MD_String8   c    = md_str8_lit("c");
+			md_node_push_child(root->first, md_push_node(temp.arena, MD_NodeKind_Main, MD_NodeFlag_Identifier, c, c, 0));
+			MD_FlatTree flat = md_flat_tree_from_node(temp.arena, root, text);
+			test_result(flat.count == 6 && flat.extra.size == 24 && trees_match_exactly(root, md_node_from_flat_tree(temp.arena, &flat)));
+			md_temp_end(temp);
+		}
+
+		// a lazy tree flattens with its unparsed sets parsed, the same as the eager one
+		match = 1;
+		for (MD_U64 sample_idx = 0; sample_idx < md_array_count(samples) && match; sample_idx += 1)
+		{
+			MD_TempArena       temp       = md_temp_begin(arena);
+			MD_Node*           eager      = md_parse_from_text(temp.arena, md_str8_lit("text"), samples[sample_idx]).root;
+			MD_LazyParseResult lazy       = md_parse_lazy_from_text(temp.arena, md_str8_lit("text"), samples[sample_idx]);
+			MD_FlatTree        eager_flat = md_flat_tree_from_node(temp.arena, eager, samples[sample_idx]);
+			MD_FlatTree        lazy_flat  = md_flat_tree_from_node(temp.arena, lazy.root, samples[sample_idx]);
+			match = lazy_flat.count == eager_flat.count && trees_match_exactly(eager, md_node_from_flat_tree(temp.arena, &lazy_flat));
+			md_temp_end(temp);
+		}
+		test_result(match);
+	}
+
+	test("Flat Tree File")
+	{
+		MD_String8 path = md_str8_lit("flat_tree_test.mdft");
+		for (MD_U64 sample_idx = 0; sample_idx < md_array_count(samples); sample_idx += 1)
+		{
+			MD_TempArena       temp  = md_temp_begin(arena);
+			MD_ParseResult     parse = md_parse_from_text(temp.arena, md_str8_lit("text"), samples[sample_idx]);
+			MD_FlatParseResult flat  = md_parse_flat_from_text(temp.arena, md_str8_lit("text"), samples[sample_idx]);
+
+			// loaded in place from data, then from a mapped file
+			MD_String8List parts  = md_flat_tree_file_parts(temp.arena, &flat.tree);
+			MD_String8     data   = md_str8_list_join(temp.arena, &parts, 0);
+			MD_FlatTree    loaded = md_flat_tree_from_file_data(data);
+			MD_B32         match  = loaded.count == flat.tree.count && loaded.kinds >= data.str && loaded.kinds < data.str + data.size;
+			match = match && trees_match_exactly(parse.root, md_node_from_flat_tree(temp.arena, &loaded));
+
+			match = match && md_flat_tree_write_to_file_path(&flat.tree, path);
+			MD_FlatTreeMap map = md_flat_tree_map_open(path);
+			match = match && map.view != 0 && map.range.md_max == data.size && md_memory_compare(map.view, data.str, data.size) == 0;
+			match = match && trees_match_exactly(parse.root, md_node_from_flat_tree(temp.arena, &map.tree));
+			match = match && md_flat_child_count_from_node(&map.tree, md_flat_tree_root(&map.tree)) == md_child_count_from_node(parse.root);
+			md_flat_tree_map_close(&map);
+			test_result(match && map.view == 0);
+			md_temp_end(temp);
+		}
+
+		// anything that isn't a whole file of this version loads as an empty tree
+		{
+			MD_TempArena       temp  = md_temp_begin(arena);
+			MD_FlatParseResult flat  = md_parse_flat_from_text(temp.arena, md_str8_lit("text"), samples[0]);
+			MD_String8List     parts = md_flat_tree_file_parts(temp.arena, &flat.tree);
+			MD_String8         data  = md_str8_list_join(temp.arena, &parts, 0);
+			MD_B32             match = md_flat_tree_from_file_data(data).count == flat.tree.count;
+			match = match && md_flat_tree_from_file_data(md_str8_prefix(data, data.size - 1)).count == 0;
+			match = match && md_flat_tree_from_file_data(md_str8_prefix(data, sizeof(MD_FlatTreeFileHeader) - 1)).count == 0;
+			match = match && md_flat_tree_from_file_data(samples[0]).count == 0;
+
+			MD_FlatTreeFileHeader* header = (MD_FlatTreeFileHeader*)data.str;
+			header->version += 1;
+			match = match && md_flat_tree_from_file_data(data).count == 0;
+			header->version -= 1;
+			header->section_offsets[MD_FlatTreeSection_Strings] += 8;
+			match = match && md_flat_tree_from_file_data(data).count == 0;
+			header->section_offsets[MD_FlatTreeSection_Strings] -= 8;
+			header->count = MD_MAX_U64;
+			match = match && md_flat_tree_from_file_data(data).count == 0;
+			header->count = flat.tree.count;
+			test_result(match);
+
+			// a whole file with damaged nodes doesn't load either: a parent after its node, links out of range or back
+			// into a cycle, a string past the strings section, a kind that isn't one
+			MD_FlatTree view = md_flat_tree_from_file_data(data);
+			MD_FlatNode last = (MD_FlatNode)(view.count - 1);
+			MD_U32* fields[] = { &view.parents[last], &view.firsts[1], &view.nexts[last], &view.first_tags[last], &view.string_sizes[last], &view.raw_offsets[last] };
+			MD_U32  values[] = { last,                (MD_U32)view.count, 1,              last,                  MD_MAX_U32,               MD_MAX_U32 };
+			match = view.count > 2;
+			for (MD_U64 idx = 0; idx < md_array_count(fields); idx += 1)
+			{
+				MD_U32 saved = *fields[idx];
+				*fields[idx] = values[idx];
+				match = match && md_flat_tree_from_file_data(data).count == 0;
+				*fields[idx] = saved;
+			}
+			view.kinds[last] = MD_NodeKind_COUNT;
+			match = match && md_flat_tree_from_file_data(data).count == 0;
+			view.kinds[last] = (MD_U8)flat.tree.kinds[last];
+			test_result(match && md_flat_tree_from_file_data(data).count == flat.tree.count);
+
+			// random damage to the node sections either fails to load or loads a tree that can be rebuilt
+			MD_U64 nodes_begin = header->section_offsets[MD_FlatTreeSection_Kinds];
+			MD_U64 nodes_opl   = header->section_offsets[MD_FlatTreeSection_Strings];
+			for (MD_U64 iter = 0; iter < 2000; iter += 1)
+			{
+				MD_U64 pos   = nodes_begin + rng_next() % (nodes_opl - nodes_begin);
+				MD_U8  saved = data.str[pos];
+				data.str[pos] = (MD_U8)rng_next();
+				MD_FlatTree damaged = md_flat_tree_from_file_data(data);
+				if (damaged.count != 0) {
+					md_node_from_flat_tree(temp.arena, &damaged);
+				}
+				data.str[pos] = saved;
+			}
+			test_result(md_flat_tree_from_file_data(data).count == flat.tree.count);
+
+			MD_FlatTreeMap missing = md_flat_tree_map_open(md_str8_lit("flat_tree_missing.mdft"));
+			test_result(missing.tree.count == 0 && missing.view == 0);
+			md_flat_tree_map_close(&missing);
+			md_temp_end(temp);
+		}
+		md_os_delete_file_at_path(path);
+	}
+
+	test("Atoms")
+	{
+		MD_TempArena  temp  = md_temp_begin(arena);
+		MD_AtomTable* atoms = md_atom_table_alloc(temp.arena, 16);
+		MD_Atom       a     = md_atom_from_str8(atoms, md_str8_lit("a"));
+		MD_Atom       b     = md_atom_from_str8(atoms, md_str8_lit("b"));
+		test_result(a != 0 && b != 0 && a != b && md_atom_from_str8(atoms, md_str8_lit("a")) == a);
+		test_result(md_atom_lookup(atoms, md_str8_lit("b")) == b && md_atom_lookup(atoms, md_str8_lit("c")) == 0 && md_atom_from_str8(atoms, md_str8_zero()) == 0);
+
+		// same tree as a plain parse, atom lookups land on the same nodes as string lookups
+		for (MD_U64 sample_idx = 0; sample_idx < md_array_count(samples); sample_idx += 1)
+		{
+			MD_ParseResult parse    = md_parse_from_text_atoms(temp.arena, atoms, md_str8_lit("text"), samples[sample_idx]);
+			MD_ParseResult expected = md_parse_from_text(temp.arena, md_str8_lit("text"), samples[sample_idx]);
+			MD_B32         match    = parse_results_match(expected, parse) && atoms_match_table(atoms, parse.root);
+			for (MD_Node* child = parse.root->first; match && !md_node_is_nil(child); child = child->next)
+			{
+				if (child->string.size == 0) {
+					continue;
+				}
+				MD_Atom atom = md_atom_lookup(atoms, child->string);
+				match = md_child_from_atom(parse.root, atom) == md_child_from_string(parse.root, child->string, 0);
+				for (MD_Node* tag = child->first_tag; match && !md_node_is_nil(tag); tag = tag->next)
+				{
+					match = md_tag_from_atom(child, tag->atom) == md_tag_from_string(child, tag->string, 0) && md_node_has_tag_atom(child, tag->atom);
+					if (tag->first->string.size > 0) {
+						match = match && md_tag_arg_from_atom(child, tag->atom, tag->first->atom) == md_tag_arg_from_string(child, tag->string, 0, tag->first->string, 0);
+					}
+				}
+			}
+			test_result(match && md_node_is_nil(md_child_from_atom(parse.root, 0)));
+		}
+		md_atom_table_release(atoms);
+
+		// threads interning into one table agree on every atom
+		{
+			AtomParseJob  jobs[8];
+			MD_OS_Handle  threads[8];
+			MD_AtomTable* shared = md_atom_table_alloc(temp.arena, 16);
+			for (MD_U64 idx = 0; idx < md_array_count(jobs); idx += 1) {
+				jobs[idx]    = (AtomParseJob){ shared, samples, md_array_count(samples), idx, 0 };
+				threads[idx] = md_os_thread_launch(atom_parse_job, &jobs[idx], 0);
+			}
+			MD_B32 match = 1;
+			for (MD_U64 idx = 0; idx < md_array_count(jobs); idx += 1) {
+				md_os_thread_join(threads[idx], MD_MAX_U64);
+				match = match && jobs[idx].match;
+			}
+			MD_AtomTable* serial = md_atom_table_alloc(temp.arena, 16);
+			for (MD_U64 sample_idx = 0; sample_idx < md_array_count(samples); sample_idx += 1) {
+				md_parse_from_text_atoms(temp.arena, serial, md_str8_lit("text"), samples[sample_idx]);
+			}
+			test_result(match && shared->count == serial->count);
+			md_atom_table_release(shared);
+			md_atom_table_release(serial);
+		}
+
+		// a heap table grows past its buckets while threads intern into it, & release frees all of it
+		{
+			MD_String8   texts[8];
+			AtomParseJob jobs[8];
+			MD_OS_Handle threads[8];
+			for (MD_U64 text_idx = 0; text_idx < md_array_count(texts); text_idx += 1)
+			{
+				MD_String8List labels = {0};
+				for (MD_U64 idx = 0; idx < 200; idx += 1) {
+					md_str8_list_pushf(temp.arena, &labels, "shared_%c%c own_%c_%c%c ", (char)('a' + idx / 26), (char)('a' + idx % 26), (char)('a' + text_idx), (char)('a' + idx / 26), (char)('a' + idx % 26));
+				}
+				texts[text_idx] = md_str8_list_join(temp.arena, &labels, 0);
+			}
+			MD_AtomTable* grown = md_atom_table_alloc(md_heap(), 16);
+			for (MD_U64 idx = 0; idx < md_array_count(jobs); idx += 1) {
+				jobs[idx]    = (AtomParseJob){ grown, texts, md_array_count(texts), idx, 0 };
+				threads[idx] = md_os_thread_launch(atom_parse_job, &jobs[idx], 0);
+			}
+			MD_B32 match = 1;
+			for (MD_U64 idx = 0; idx < md_array_count(jobs); idx += 1) {
+				md_os_thread_join(threads[idx], MD_MAX_U64);
+				match = match && jobs[idx].match;
+			}
+			MD_U64 heap_count = grown->count;
+			for (MD_U64 idx = 0; match && idx < 200; idx += 1) {
+				MD_Atom shared = md_atom_lookup(grown, md_str8f(temp.arena, "shared_%c%c", (char)('a' + idx / 26), (char)('a' + idx % 26)));
+				MD_Atom own    = md_atom_lookup(grown, md_str8f(temp.arena, "own_h_%c%c",  (char)('a' + idx / 26), (char)('a' + idx % 26)));
+				match = shared != 0 && own != 0 && shared != own;
+			}
+			test_result(match && heap_count == 9 * 200 && grown->buckets->bucket_count >= heap_count && grown->buckets->prev != 0);
+			md_atom_table_release(grown);
+		}
+		md_temp_end(temp);
+	}
+
+	test("Child Index")
+	{
+		MD_TempArena   temp = md_temp_begin(arena);
+		MD_String8List keys = {0};
+		for (MD_U64 idx = 0; idx < 1000; idx += 1) {
+			md_str8_list_pushf(temp.arena, &keys, "k%c%c%c ", (char)('a' + idx / 676), (char)('a' + idx / 26 % 26), (char)('a' + idx % 26));
+		}
+		md_str8_list_push(temp.arena, &keys, md_str8_lit("kaaf: dup"));
+		MD_Node* root  = md_parse_from_text(temp.arena, md_str8_lit("text"), md_str8_list_join(temp.arena, &keys, 0)).root;
+		MD_Node* small = md_parse_from_text(temp.arena, md_str8_lit("text"), md_str8_lit("a b c")).root;
+
+		// wide nodes index themselves, lookups land where a walk would (the first of duplicate labels)
+		MD_B32 match = 1;
+		MD_U64 idx   = 0;
+		for (MD_Node* child = root->first; match && !md_node_is_nil(child); child = child->next, idx += 1) {
+			match = md_child_from_string(root, child->string, 0) == md_node_from_chain_string(root->first, md_nil_node(), child->string, 0) && md_child_from_index(root, idx) == child && md_index_from_node(child) == idx;
+		}
+		test_result(match && md_child_index_lookup(root) != 0 && md_child_count_from_node(root) == 1001 && md_node_is_nil(md_child_from_index(root, 1001)));
+		test_result(md_node_is_nil(md_child_from_string(root, md_str8_lit("kzzz"), 0)) && md_node_is_nil(md_child_from_string(root, md_str8_lit("kaaf"), 0)->first));
+		test_result(md_child_from_string(root, md_str8_lit("KBML"), MD_StringMatchFlag_CaseInsensitive) == root->last->prev);
+		test_result(md_str8_match(md_child_from_index(small, 2)->string, md_str8_lit("c"), 0) && md_node_is_nil(md_child_from_string(small, md_str8_lit("d"), 0)) && md_child_index_lookup(small) == 0);
+
+		// nested sets, lazy sets & copies are indexed when they're built, the getters never build one, tags are never indexed
+		MD_String8 nested_text = md_str8f(temp.arena, "outer: { %S }", md_str8_list_join(temp.arena, &keys, 0));
+		MD_Node*   nested      = md_parse_from_text(temp.arena, md_str8_lit("text"), nested_text).root->first;
+		MD_Node*   lazy        = md_parse_lazy_from_text(temp.arena, md_str8_lit("text"), nested_text).root->first;
+		MD_Node*   copied      = md_treecopy(temp.arena, root);
+		MD_Node*   tagged      = md_parse_from_text(temp.arena, md_str8_lit("text"), md_str8_lit("@x @y a")).root->first;
+		test_result(md_child_index_lookup(nested) != 0 && md_child_from_index(nested, 1000) == nested->last && md_child_index_lookup(copied) != 0 && md_child_count_from_node(copied) == 1001);
+		test_result(md_child_index_lookup(lazy) == 0 && md_child_from_string(lazy, md_str8_lit("kbml"), 0) == lazy->last->prev && md_child_index_lookup(lazy) != 0);
+		test_result(md_index_from_node(tagged->last_tag) == 1 && md_index_from_node(tagged) == 0 && md_tag_count_from_node(tagged) == 2 && md_index_from_node(md_nil_node()) == 0);
+
+		// pushing, inserting & unhooking children drop the index, lookups walk until one is built again
+		MD_Node* pushed = md_push_node(temp.arena, MD_NodeKind_Main, MD_NodeFlag_Identifier, md_str8_lit("pushed"), md_str8_lit("pushed"), 0);
+		md_node_push_child(root, pushed);
+		test_result(md_child_index_lookup(root) == 0 && md_child_from_string(root, md_str8_lit("pushed"), 0) == pushed && md_child_from_index(root, 1001) == pushed);
+		MD_Node* inserted = md_push_node(temp.arena, MD_NodeKind_Main, MD_NodeFlag_Identifier, md_str8_lit("inserted"), md_str8_lit("inserted"), 0);
+		md_node_insert_child(root, root->first, inserted);
+		test_result(md_child_index_lookup(root) == 0 && md_child_from_index(root, 1) == inserted && md_child_from_string(root, md_str8_lit("inserted"), 0) == inserted);
+		MD_Node* katg = md_child_from_string(root, md_str8_lit("katg"), 0);
+		md_unhook(katg);
+		test_result(md_child_index_lookup(root) == 0 && md_node_is_nil(md_child_from_string(root, md_str8_lit("katg"), 0)) && md_child_count_from_node(root) == 1002);
+		test_result(md_index_from_node(root->last) == 1001 && md_node_is_nil(md_child_from_index(root, 1002)) && md_child_index_lookup(root) == 0);
+		MD_U64         pos     = md_arena_pos(temp.arena);
+		MD_ChildIndex* rebuilt = md_child_index_from_node(temp.arena, root);
+		test_result(rebuilt != 0 && rebuilt == md_child_index_lookup(root) && md_arena_pos(temp.arena) > pos);
+		test_result(md_str8_match(md_child_from_index(root, 501)->string, md_str8_lit("kath"), 0) && md_index_from_node(md_child_from_index(root, 501)) == 501);
+		md_child_index_release(root);
+		test_result(md_child_index_lookup(root) == 0 && md_child_from_index(root, 501) == katg->next && md_child_index_from_node(temp.arena, md_nil_node()) == 0);
+		md_temp_end(temp);
+
+		// indices live in the tree's arena & go with it, parsing over & over into a reset arena keeps indexing every wide set
+		MD_String8List sets = {0};
+		for (MD_U64 set_idx = 0; set_idx < 1000; set_idx += 1) {
+			md_str8_list_push(arena, &sets, md_str8_lit("{a b c d e f g h a b c d e f g h a b c d e f g h a b c d e f g h a b c d e f g h a b c d e f g h a b c d e f g h a b c d e f g h}\n"));
+		}
+		MD_String8 sets_text = md_str8_list_join(arena, &sets, 0);
+		MD_U64     indexed   = 0;
+		for (MD_U64 pass = 0; pass < 80; pass += 1)
+		{
+			temp = md_temp_begin(arena);
+			MD_Node* reparsed = md_parse_from_text(temp.arena, md_str8_lit("text"), sets_text).root;
+			for md_each_child(set, reparsed) {
+				indexed += md_child_index_lookup(set) != 0 && md_child_from_index(set, 63) == set->last;
+			}
+			md_temp_end(temp);
+		}
+		test_result(indexed == 80 * 1000);
+	}
+
+	test("Tag Filter")
+	{
+		MD_TempArena temp = md_temp_begin(arena);
+		for (MD_U64 sample_idx = 0; sample_idx < md_array_count(samples); sample_idx += 1)
+		{
+			MD_Node* root = md_parse_from_text(temp.arena, md_str8_lit("text"), samples[sample_idx]).root;
+			test_result(tag_filters_hold(root, md_str8_lit("not_a_tag")) && tag_filters_hold(root, md_str8_lit("")));
+		}
+
+		// most misses are ruled out by the filter alone
+		MD_Node* node   = md_parse_from_text(temp.arena, md_str8_lit("text"), md_str8_lit("@a @c(x) node")).root->first;
+		MD_U64   misses = 0;
+		for (MD_U64 idx = 0; idx < 1000; idx += 1) {
+			MD_U16 bits = md_tag_filter_from_str8(md_str8f(temp.arena, "miss_%llu", idx));
+			misses += (node->tag_filter & bits) != bits;
+		}
+		test_result(node->tag_filter != 0 && misses > 800 && md_str8_match(md_tag_arg_from_string(node, md_str8_lit("c"), 0, md_str8_lit("x"), 0)->string, md_str8_lit("x"), 0));
+
+		// pushed & inserted tags are added to it, tags linked in by hand or renamed need a refresh
+		MD_Node* pushed   = md_push_node(temp.arena, MD_NodeKind_Tag, MD_NodeFlag_Identifier, md_str8_lit("pushed"),   md_str8_lit("pushed"),   0);
+		MD_Node* inserted = md_push_node(temp.arena, MD_NodeKind_Tag, MD_NodeFlag_Identifier, md_str8_lit("inserted"), md_str8_lit("inserted"), 0);
+		md_node_push_tag(node, pushed);
+		md_node_insert_tag(node, md_nil_node(), inserted);
+		test_result(md_tag_from_string(node, md_str8_lit("pushed"), 0) == pushed && md_tag_from_index(node, 0) == inserted && md_node_has_tag(node, md_str8_lit("inserted"), 0));
+		MD_Node* bare    = md_push_node(temp.arena, MD_NodeKind_Main, MD_NodeFlag_Identifier, md_str8_lit("bare"),   md_str8_lit("bare"),   0);
+		MD_Node* by_hand = md_push_node(temp.arena, MD_NodeKind_Tag, MD_NodeFlag_Identifier, md_str8_lit("by_hand"), md_str8_lit("by_hand"), 0);
+		bare->first_tag = bare->last_tag = by_hand;
+		test_result(bare->tag_filter == 0 && md_node_has_tag(bare, md_str8_lit("by_hand"), 0) && md_node_has_tag(node, md_str8_lit("PUSHED"), MD_StringMatchFlag_CaseInsensitive));
+		MD_U64 linked = 0;
+		for (MD_U64 idx = 0; idx < 100; idx += 1) {
+			MD_String8 string = md_str8f(temp.arena, "linked_%llu", idx);
+			MD_Node*   tag    = md_push_node(temp.arena, MD_NodeKind_Tag, MD_NodeFlag_Identifier, string, string, 0);
+			tag->parent = node;
+			md_dll_push_back_npz(md_nil_node(), node->first_tag, node->last_tag, tag, next, prev);
+			md_node_refresh_tag_filter(node);
+			linked += md_tag_from_string(node, string, 0) == tag;
+		}
+		pushed->string = md_str8_lit("renamed");
+		md_node_refresh_tag_filter(node);
+		test_result(linked == 100 && md_tag_from_string(node, md_str8_lit("renamed"), 0) == pushed && tag_filters_hold(node, md_str8_lit("not_a_tag")));
+		md_temp_end(temp);
+	}
+
+	test("Lazy Parse")
+	{
+		MD_LazyParseResult lazy = md_parse_lazy_from_text(arena, md_str8_lit("text"), md_str8_lit("a: { b: { c } }\nd: [e, f] g: () @tag(x, y) h"));
+		MD_Node*           a    = md_child_from_string(lazy.root, md_str8_lit("a"), 0);
+		MD_Node*           d    = md_child_from_string(lazy.root, md_str8_lit("d"), 0);
+		test_result(lazy.lazy->sets_parsed == 0 && md_child_count_from_node(lazy.root) == 4 && md_tag_count_from_node(md_child_from_index(lazy.root, 3)) == 1);
+		test_result(a->lazy != 0 && (a->flags & MD_NodeFlag_HasBraceRight) && d->lazy != 0 && (d->flags & MD_NodeFlag_HasBracketRight));
+		MD_Node* b = md_child_from_string(a, md_str8_lit("b"), 0);
+		test_result(lazy.lazy->sets_parsed == 1 && b->lazy != 0 && d->lazy != 0);
+		test_result(md_child_count_from_node(d) == 2 && lazy.lazy->sets_parsed == 2 && md_str8_match(md_node_last(d)->string, md_str8_lit("f"), 0));
+
+		for (MD_U64 sample_idx = 0; sample_idx < md_array_count(samples); sample_idx += 1)
+		{
+			MD_TempArena       temp  = md_temp_begin(arena);
+			MD_ParseResult     eager = parse_from_token_array(temp.arena, samples[sample_idx]);
+			MD_LazyParseResult lazy  = md_parse_lazy_from_text(temp.arena, md_str8_lit("text"), samples[sample_idx]);
+			materialize_all(lazy.root);
+			test_result(trees_match_exactly(eager.root, lazy.root) && msgs_match_unordered(eager.msgs, lazy.lazy->msgs));
+			md_temp_end(temp);
+		}
+
+		// stray & mismatched delimiters, sets opened inside implicit lists, unterminated sets
+		MD_B32 match = 1;
+		for (MD_U64 iter = 0; iter < 2000 && match; iter += 1)
+		{
+			MD_TempArena       temp  = md_temp_begin(arena);
+			MD_String8         text  = random_text(temp.arena, rng_next() % MD_KB(2));
+			MD_ParseResult     eager = parse_from_token_array(temp.arena, text);
+			MD_LazyParseResult lazy  = md_parse_lazy_from_text(temp.arena, md_str8_lit("text"), text);
+			materialize_all(lazy.root);
+			match = trees_match_exactly(eager.root, lazy.root) && msgs_match_unordered(eager.msgs, lazy.lazy->msgs);
+			md_temp_end(temp);
+		}
+		test_result(match);
+	}
+
+	test("Filtered Parse")
+	{
+		md_local_persist MD_String8 table_tags[] = { md_str8_lit_comp("table"), md_str8_lit_comp("enum") };
+		MD_ParseFilter filter = { { table_tags, md_array_count(table_tags) }, 0 };
+		MD_String8     text   = md_str8_lit("@table(x) a: { b c }, d: e f\n@enum g: [h]\n@other i: { # }\n@table {j}; k");
+		MD_ParseResult parse  = md_parse_filtered_from_text(arena, md_str8_lit("text"), text, filter);
+		MD_Node*       a      = md_child_from_index(parse.root, 0);
+		test_result(md_child_count_from_node(parse.root) == 3 && md_str8_match(a->string, md_str8_lit("a"), 0) && md_child_count_from_node(a) == 2);
+		test_result(parse.msgs.count == 1 && filtered_parse_matches(md_parse_from_text(arena, md_str8_lit("text"), text), parse, filter));
+		filter.flags = MD_ParseFilterFlag_NoSkippedErrors;
+		test_result(md_parse_filtered_from_text(arena, md_str8_lit("text"), text, filter).msgs.count == 0);
+
+		for (MD_U64 sample_idx = 0; sample_idx < md_array_count(samples); sample_idx += 1)
+		{
+			md_local_persist MD_String8 sample_tags[] = { md_str8_lit_comp("struct"), md_str8_lit_comp("table"), md_str8_lit_comp("enum"), md_str8_lit_comp("c_type") };
+			MD_ParseFilter sample_filter = { { sample_tags, md_array_count(sample_tags) }, 0 };
+			MD_TempArena   temp          = md_temp_begin(arena);
+			MD_ParseResult full          = md_parse_from_text(temp.arena, md_str8_lit("text"), samples[sample_idx]);
+			MD_ParseResult filtered      = md_parse_filtered_from_text(temp.arena, md_str8_lit("text"), samples[sample_idx], sample_filter);
+			test_result(filtered_parse_matches(full, filtered, sample_filter) && parse_results_match((MD_ParseResult){ full.root, full.msgs }, (MD_ParseResult){ full.root, filtered.msgs }));
+			md_temp_end(temp);
+		}
+
+		// skipped nodes report the same errors, in the same order
+		md_local_persist MD_String8 random_tags[] = { md_str8_lit_comp("tag") };
+		MD_ParseFilter random_filter = { { random_tags, md_array_count(random_tags) }, 0 };
+		MD_B32         match         = 1;
+		for (MD_U64 iter = 0; iter < 2000 && match; iter += 1)
+		{
+			MD_TempArena   temp     = md_temp_begin(arena);
+			MD_String8     text     = random_text(temp.arena, rng_next() % MD_KB(2));
+			MD_ParseResult full     = md_parse_from_text(temp.arena, md_str8_lit("text"), text);
+			MD_ParseResult filtered = md_parse_filtered_from_text(temp.arena, md_str8_lit("text"), text, random_filter);
+			match = filtered_parse_matches(full, filtered, random_filter) && parse_results_match((MD_ParseResult){ full.root, full.msgs }, (MD_ParseResult){ full.root, filtered.msgs });
+			md_temp_end(temp);
+		}
+		test_result(match);
+	}
+
+	test("Parallel Parse")
+	{
+		// splits fall after tags, separators & stray closers as well as between plain nodes
+		MD_String8List sample_parts = {0};
+		for (MD_U64 idx = 0; sample_parts.total_size < MD_MB(2); idx += 1) {
+			md_str8_list_push(arena, &sample_parts, samples[idx % md_array_count(samples)]);
+			md_str8_list_push(arena, &sample_parts, md_str8_lit("\n"));
+		}
+		// random text mostly nests deeper & deeper, enough closers bring it back to the top level every so often
+		MD_String8List random_parts = {0};
+		for (MD_U64 idx = 0; random_parts.total_size < MD_MB(2); idx += 1) {
+			md_str8_list_push(arena, &random_parts, random_text(arena, 1 + rng_next() % 512));
+			md_str8_list_push(arena, &random_parts, md_str8_lit("}}}}]]]]))))}}}}]]]]))))\n"));
+		}
+		MD_String8List nested_parts = {0};
+		md_str8_list_push(arena, &nested_parts, md_str8_lit("one_node: {\n"));
+		for (MD_U64 idx = 0; nested_parts.total_size < MD_MB(1); idx += 1) {
+			md_str8_list_push(arena, &nested_parts, md_str8_lit("@tag a: b, c; {d}\n"));
+		}
+		MD_String8 texts[] = {
+			md_str8_list_join(arena, &sample_parts, 0),
+			md_str8_list_join(arena, &random_parts, 0),
+			md_str8_list_join(arena, &nested_parts, 0),
+		};
+		MD_U64 thread_counts[] = { 2, 3, 7, 16 };
+		for (MD_U64 text_idx = 0; text_idx < md_array_count(texts); text_idx += 1)
+		{
+			MD_TokenizeResult tokenize = md_tokenize_from_text(arena, texts[text_idx]);
+			MD_ParseResult    expected = md_parse_from_text_tokens(arena, md_str8_lit("text"), texts[text_idx], tokenize.tokens);
+			MD_B32            match    = 1;
+			for (MD_U64 count_idx = 0; count_idx < md_array_count(thread_counts) && match; count_idx += 1)
+			{
+				MD_TempArena   temp     = md_temp_begin(arena);
+				MD_ParseResult parallel = md_parse_from_text_tokens_parallel(temp.arena, md_str8_lit("text"), texts[text_idx], tokenize.tokens, thread_counts[count_idx]);
+				match = parse_results_match(expected, parallel);
+				for md_each_node(child, parallel.root->first) {
+					match &= child->parent == parallel.root;
+				}
+				md_temp_end(temp);
+			}
+			test_result(match);
+		}
+	}
+
+	test("Parallel Files")
+	{
+		// every sample a few times over, plus a path that doesn't exist (an empty file with an error)
+		MD_String8List path_list = {0};
+		for (MD_U64 idx = 0; idx < 4 * md_array_count(sample_paths); idx += 1) {
+			md_str8_list_pushf(arena, &path_list, "%S/%s", root, sample_paths[idx % md_array_count(sample_paths)]);
+		}
+		md_str8_list_pushf(arena, &path_list, "%S/missing.mdesk", root);
+		MD_String8Array paths = md_str8_array_from_list(arena, &path_list);
+
+		MD_ParseResult expected = {0};
+		expected.root = md_push_node(arena, MD_NodeKind_List, 0, md_str8_zero(), md_str8_zero(), 0);
+		for (MD_U64 idx = 0; idx < paths.count; idx += 1)
+		{
+			MD_ParseResult parse = md_parse_from_text(arena, paths.v[idx], md_os_data_from_file_path(arena, paths.v[idx]));
+			if ( ! md_os_file_path_exists(paths.v[idx])) {
+				md_msg_list_push(arena, &parse.msgs, parse.root, MD_MsgKind_Error, md_str8f(arena, "Couldn't read file \"%S\".", paths.v[idx]));
+			}
+			md_node_push_child(expected.root, parse.root);
+			md_msg_list_concat_in_place(&expected.msgs, &parse.msgs);
+		}
+		test_result(expected.msgs.count > 0 && md_node_is_nil(expected.root->last->first));
+
+		// the missing path's error is on its file node, the only message of a parse of just that path
+		MD_String8Array missing_path = { &paths.v[paths.count - 1], 1 };
+		MD_ParseResult  missing      = md_parse_files_parallel(arena, missing_path, 4);
+		test_result(missing.msgs.count == 1 && missing.msgs.first->kind == MD_MsgKind_Error && missing.msgs.first->node == missing.root->first &&
+			missing.root->first->kind == MD_NodeKind_File && md_node_is_nil(missing.root->first->first));
+
+		MD_U64 thread_counts[] = { 1, 2, 3, 8, 64 };
+		for (MD_U64 count_idx = 0; count_idx < md_array_count(thread_counts); count_idx += 1)
+		{
+			MD_TempArena   temp     = md_temp_begin(arena);
+			MD_ParseResult parallel = md_parse_files_parallel(temp.arena, paths, thread_counts[count_idx]);
+			test_result(parallel.root->kind == MD_NodeKind_List && parse_results_match(expected, parallel));
+			md_temp_end(temp);
+		}
+		test_result(md_child_count_from_node(md_parse_files_parallel(arena, (MD_String8Array){0}, 4).root) == 0);
+	}
+
+	test("Parse Cache")
+	{
+		// xxHash64's own test vectors
+		test_result(
+			md_hash_u64_from_str8(0, md_str8_lit(""))    == 0xEF46DB3751D8E999ull &&
+			md_hash_u64_from_str8(0, md_str8_lit("a"))   == 0xD24EC4F1A98C6E5Bull &&
+			md_hash_u64_from_str8(0, md_str8_lit("abc")) == 0x44BC2CF5AD770999ull &&
+			md_hash_u64_from_str8(0, md_str8_lit("Nobody inspects the spammish repetition")) == 0xFBCEA83C8A378BF1ull
+		);
+
+		MD_ParseCache cache = { md_str8_lit("parse_cache_test") };
+		cache.max_total_size = 1;
+		md_parse_cache_trim(&cache);
+		cache.max_total_size = 0;
+
+		// a miss parses & stores, a hit loads the same result (under whatever name it's parsed as now)
+		MD_U64 entry_count = 0;
+		MD_U64 entry_total = 0;
+		for (MD_U64 sample_idx = 0; sample_idx < md_array_count(samples); sample_idx += 1)
+		{
+			MD_TempArena   temp     = md_temp_begin(arena);
+			MD_ParseResult expected = md_parse_from_text(temp.arena, md_str8_lit("text"), samples[sample_idx]);
+			MD_String8     entry    = md_str8f(temp.arena, "%S/%016llx.mdpc", cache.dir, md_parse_cache_key(&cache, samples[sample_idx]));
+			MD_B32         existed  = md_os_file_path_exists(entry);
+			MD_ParseResult miss     = md_parse_from_text_cached(temp.arena, &cache, md_str8_lit("text"), samples[sample_idx]);
+			MD_ParseResult hit      = md_parse_from_text_cached(temp.arena, &cache, md_str8_lit("text"), samples[sample_idx]);
+			MD_ParseResult renamed  = md_parse_from_text_cached(temp.arena, &cache, md_str8_lit("renamed"), samples[sample_idx]);
+			MD_B32         match    = parse_results_match(expected, miss) && parse_results_match(expected, hit) && md_os_file_path_exists(entry);
+			match = match && md_str8_match(renamed.root->string, md_str8_lit("renamed"), 0);
+			renamed.root->string = expected.root->string;
+			match = match && parse_results_match(expected, renamed);
+
+			// strings in the text point into the caller's text, not the entry
+			match = match && hit.root->first->string.str >= samples[sample_idx].str && hit.root->first->string.str < samples[sample_idx].str + samples[sample_idx].size;
+			test_result(match);
+
+			if ( ! existed) {
+				entry_count += 1;
+				entry_total += md_os_properties_from_file_path(entry).size;
+			}
+			md_temp_end(temp);
+		}
+
+		// a different version of options, a bad entry & an entry over the size limit all just parse
+		{
+			MD_TempArena   temp     = md_temp_begin(arena);
+			MD_ParseResult expected = md_parse_from_text(temp.arena, md_str8_lit("text"), samples[0]);
+			MD_String8     entry    = md_str8f(temp.arena, "%S/%016llx.mdpc", cache.dir, md_parse_cache_key(&cache, samples[0]));
+
+			MD_ParseCache options = cache;
+			options.options_hash  = 1;
+			MD_B32 match = md_parse_cache_key(&options, samples[0]) != md_parse_cache_key(&cache, samples[0]);
+
+			MD_String8 data = md_os_data_from_file_path(temp.arena, entry);
+			md_os_write_data_to_file_path(entry, md_str8_prefix(data, data.size / 2));
+			match = match && parse_results_match(expected, md_parse_from_text_cached(temp.arena, &cache, md_str8_lit("text"), samples[0]));
+			match = match && md_os_properties_from_file_path(entry).size == data.size;
+
+			// a whole entry with a damaged tree or message is a miss too, & is stored again
+			MD_ParseCacheEntryHeader* entry_header = (MD_ParseCacheEntryHeader*)data.str;
+			MD_U8*                    tree_data    = data.str + md_align_pow2(sizeof(MD_ParseCacheEntryHeader) + entry_header->msgs_size, 8);
+			MD_FlatTreeFileHeader*    tree_header  = (MD_FlatTreeFileHeader*)tree_data;
+			MD_FlatNode*              parents      = (MD_FlatNode*)(tree_data + tree_header->section_offsets[MD_FlatTreeSection_Parents]);
+			MD_FlatNode               saved_parent = parents[tree_header->count - 1];
+			parents[tree_header->count - 1] = (MD_FlatNode)(tree_header->count - 1);
+			md_os_write_data_to_file_path(entry, data);
+			match = match && parse_results_match(expected, md_parse_from_text_cached(temp.arena, &cache, md_str8_lit("text"), samples[0]));
+			parents[tree_header->count - 1] = saved_parent;
+			match = match && md_memory_compare(md_os_data_from_file_path(temp.arena, entry).str, data.str, data.size) == 0;
+
+			MD_String8     broken          = md_str8_lit("@ broken");
+			MD_ParseResult broken_expected = md_parse_from_text(temp.arena, md_str8_lit("text"), broken);
+			MD_String8     broken_entry    = md_str8f(temp.arena, "%S/%016llx.mdpc", cache.dir, md_parse_cache_key(&cache, broken));
+			md_parse_from_text_cached(temp.arena, &cache, md_str8_lit("text"), broken);
+			MD_String8        broken_data = md_os_data_from_file_path(temp.arena, broken_entry);
+			MD_ParseCacheMsg* records     = (MD_ParseCacheMsg*)(broken_data.str + sizeof(MD_ParseCacheEntryHeader));
+			MD_U32            saved_kind  = records[0].node_kind;
+			records[0].node_kind = MD_NodeKind_COUNT;
+			md_os_write_data_to_file_path(broken_entry, broken_data);
+			match = match && broken_expected.msgs.count > 0 && parse_results_match(broken_expected, md_parse_from_text_cached(temp.arena, &cache, md_str8_lit("text"), broken));
+			records[0].node_kind = saved_kind;
+			match = match && md_memory_compare(md_os_data_from_file_path(temp.arena, broken_entry).str, broken_data.str, broken_data.size) == 0;
+			md_os_delete_file_at_path(broken_entry);
+
+			MD_ParseCache small = cache;
+			small.max_entry_size = 64;
+			small.options_hash   = 2;
+			MD_String8 small_entry = md_str8f(temp.arena, "%S/%016llx.mdpc", cache.dir, md_parse_cache_key(&small, samples[0]));
+			match = match && parse_results_match(expected, md_parse_from_text_cached(temp.arena, &small, md_str8_lit("text"), samples[0]));
+			match = match && ! md_os_file_path_exists(small_entry);
+
+			// the limit is checked against the entry's exact size, before the entry is made
+			MD_ParseCache exact = cache;
+			exact.options_hash  = 3;
+			MD_String8 exact_entry = md_str8f(temp.arena, "%S/%016llx.mdpc", cache.dir, md_parse_cache_key(&exact, samples[0]));
+			exact.max_entry_size = data.size - 1;
+			md_parse_from_text_cached(temp.arena, &exact, md_str8_lit("text"), samples[0]);
+			match = match && ! md_os_file_path_exists(exact_entry);
+			exact.max_entry_size = data.size;
+			md_parse_from_text_cached(temp.arena, &exact, md_str8_lit("text"), samples[0]);
+			match = match && md_os_properties_from_file_path(exact_entry).size == data.size;
+			md_os_delete_file_at_path(exact_entry);
+			test_result(match);
+			md_temp_end(temp);
+		}
+
+		// trimming drops the oldest entries that don't fit, then everything when the limit is below any entry
+		cache.max_total_size = entry_total - 1;
+		test_result(md_parse_cache_trim(&cache) == 1);
+		cache.max_total_size = 1;
+		test_result(md_parse_cache_trim(&cache) == entry_count - 1);
+
+		// stores trim on their own every MD_PARSE_CACHE_TRIM_INTERVAL stores
+		{
+			MD_String8 text  = md_str8_lit("trimmed: 1");
+			MD_String8 entry = md_str8f(arena, "%S/%016llx.mdpc", cache.dir, md_parse_cache_key(&cache, text));
+			cache.store_count = 0;
+			md_parse_from_text_cached(arena, &cache, md_str8_lit("text"), text);
+			MD_B32 kept = md_os_file_path_exists(entry);
+			md_os_delete_file_at_path(entry);
+			cache.store_count = MD_PARSE_CACHE_TRIM_INTERVAL - 1;
+			md_parse_from_text_cached(arena, &cache, md_str8_lit("text"), text);
+			test_result(kept && ! md_os_file_path_exists(entry) && cache.store_count == MD_PARSE_CACHE_TRIM_INTERVAL);
+		}
+	}
+
+	test("Selectors")
+	{
+		MD_String8 text = md_str8_lit(
+			"@table people: { @required name: text, age: int, @required @primary id: int }\n"
+			"@table items:  { @required name: text, price: float, 'sale price': float }\n"
+			"@enum  kinds:  { a, b }\n"
+			"@enum(items) slots: { @table inner: { name: text } }\n"
+		);
+		MD_ParseResult parse = md_parse_from_text(arena, md_str8_lit("text"), text);
+		struct { char* source; MD_U64 count; } queries[] = {
+			{ "@table/*[@required]",               3 },
+			{ "/@table/*[@required][!@primary]",   2 },
+			{ "people/*[!@required]",              1 },
+			{ "@table[name=text]",                 2 },
+			{ "*[@enum=items]",                    1 },
+			{ "//*[@primary]",                     1 },
+			{ "//int",                             2 },
+			{ "@table/name/text",                  2 },
+			{ "//@table/name",                     3 },
+			{ "//@table//text",                    3 },
+			{ "items/'sale price'/float",          1 },
+			{ "*[\"sale price\"]",                 1 },
+			{ "//*[name=text]",                    3 },
+			{ "*[!@table]",                        2 },
+			{ "//name[!text]",                     0 },
+		};
+		MD_B32 match = 1;
+		for (MD_U64 idx = 0; idx < md_array_count(queries); idx += 1)
+		{
+			MD_Selector  selector = md_selector_compile(arena, md_str8_cstring(queries[idx].source));
+			MD_NodeArray selected = md_select(arena, &selector, parse.root);
+			match = match && selector.msgs.count == 0 && selected.count == queries[idx].count;
+			match = match && select_matches_reference(arena, &selector, parse.root, selected);
+		}
+		test_result(match);
+
+		// the same as a hand-written loop
+		match = 1;
+		MD_Selector  selector = md_selector_compile(arena, md_str8_lit("@table/*[@required]"));
+		MD_NodeArray selected = md_select(arena, &selector, parse.root);
+		MD_U64       count    = 0;
+		for md_each_child(table, parse.root) {
+			if (! md_node_has_tag(table, md_str8_lit("table"), 0)) continue;
+			for md_each_child(field, table) {
+				if (md_node_has_tag(field, md_str8_lit("required"), 0)) {
+					match = match && count < selected.count && selected.v[count] == field;
+					count += 1;
+				}
+			}
+		}
+		test_result(match && count == selected.count);
+
+		// errors name the offending byte & leave nothing to run
+		struct { char* source; MD_U64 offset; } errors[] = {
+			{ "",          0 },
+			{ "a/",        2 },
+			{ "a//[b]",    3 },
+			{ "a[",        2 },
+			{ "a[@]",      3 },
+			{ "a[b",       3 },
+			{ "a[b=]",     4 },
+			{ "a b",       2 },
+			{ "'a/b",      0 },
+			{ "a[!\"b]",   3 },
+		};
+		match = 1;
+		for (MD_U64 idx = 0; idx < md_array_count(errors); idx += 1)
+		{
+			MD_Selector broken = md_selector_compile(arena, md_str8_cstring(errors[idx].source));
+			match = match && broken.step_count == 0 && broken.msgs.count == 1 && broken.msgs.first->kind == MD_MsgKind_Error;
+			match = match && broken.msgs.first->node->src_offset == errors[idx].offset;
+			match = match && md_select(arena, &broken, parse.root).count == 0;
+		}
+		MD_String8List long_path = {0};
+		for (MD_U64 idx = 0; idx <= MD_SELECTOR_MAX_STEPS; idx += 1) {
+			md_str8_list_push(arena, &long_path, md_str8_lit("a/"));
+		}
+		md_str8_list_push(arena, &long_path, md_str8_lit("a"));
+		match = match && md_selector_compile(arena, md_str8_list_join(arena, &long_path, 0)).step_count == 0;
+		test_result(match);
+
+		// random trees & selectors, serial against a step at a time & over a lazy tree, parallel over several roots against serial
+		char* sources[] = {
+			"*", "a", "//a", "//*", "a/b", "a//b", "//a/b", "//a//b//c", "@x", "//@x/*[@y]", "//*[@x=a]", "//*[!@x]//b",
+			"*[b]", "//*[b=c]", "//a[!b]/*", "a//*//*", "//b[@y=b]//a[!@x]", "/*/*/*", "//*[a][b][!c]",
+		};
+		match = 1;
+		for (MD_U64 iter = 0; iter < 200 && match; iter += 1)
+		{
+			MD_TempArena   temp  = md_temp_begin(arena);
+			MD_String8List parts = {0};
+			random_selector_text(temp.arena, &parts, 0);
+			MD_Node*     roots[4];
+			MD_NodeArray root_array = { roots, md_array_count(roots) };
+			for (MD_U64 root_idx = 0; root_idx < md_array_count(roots); root_idx += 1) {
+				roots[root_idx] = md_parse_from_text(temp.arena, md_str8_lit("text"), md_str8_list_join(temp.arena, &parts, 0)).root;
+			}
+			for (MD_U64 idx = 0; idx < md_array_count(sources) && match; idx += 1)
+			{
+				MD_Selector  random_selector = md_selector_compile(temp.arena, md_str8_cstring(sources[idx]));
+				MD_NodeArray serial          = md_select(temp.arena, &random_selector, roots[0]);
+				match = random_selector.msgs.count == 0 && select_matches_reference(temp.arena, &random_selector, roots[0], serial);
+
+				// a lazy tree's sets are parsed as the walk reaches them
+				MD_Node* lazy_root = md_parse_lazy_from_text(temp.arena, md_str8_lit("text"), md_str8_list_join(temp.arena, &parts, 0)).root;
+				match = match && md_select(temp.arena, &random_selector, lazy_root).count == serial.count;
+
+				MD_NodeArray parallel = md_select_parallel(temp.arena, &random_selector, root_array, 1 + iter % 5);
+				MD_U64       offset   = 0;
+				for (MD_U64 root_idx = 0; root_idx < md_array_count(roots) && match; root_idx += 1) {
+					MD_NodeArray expected = md_select(temp.arena, &random_selector, roots[root_idx]);
+					for (MD_U64 node_idx = 0; node_idx < expected.count && match; node_idx += 1) {
+						match = offset < parallel.count && parallel.v[offset] == expected.v[node_idx];
+						offset += 1;
+					}
+				}
+				match = match && offset == parallel.count;
+			}
+			md_temp_end(temp);
+		}
+		test_result(match);
+	}
+
+	test("Lookup Paths")
+	{
+		MD_String8 text = md_str8_lit(
+			"renderer: { shadows: { cascade_count: 4, resolution: 2048 }, msaa: 8 }\n"
+			"audio: { volume: 1 }\n"
+		);
+		MD_Node*      root  = md_parse_from_text(arena, md_str8_lit("text"), text).root;
+		MD_LookupPath path  = md_lookup_path_compile(arena, md_str8_lit("/renderer/shadows//cascade_count/"), 0);
+		MD_Node*      chain = md_child_from_string(md_child_from_string(md_child_from_string(root, md_str8_lit("renderer"), 0), md_str8_lit("shadows"), 0), md_str8_lit("cascade_count"), 0);
+		test_result(path.count == 3 && md_lookup_path_resolve(&path, root) == chain && ! md_node_is_nil(chain));
+
+		// the memo answers until the generation moves, direct edits aren't seen until it's bumped
+		MD_Node* shadows = chain->parent;
+		chain->string = md_str8_lit("renamed");
+		MD_B32 match = md_lookup_path_resolve(&path, root) == chain;
+		md_tree_generation_bump();
+		match = match && md_node_is_nil(md_lookup_path_resolve(&path, root));
+		chain->string = md_str8_lit("cascade_count");
+		md_tree_generation_bump();
+		match = match && md_lookup_path_resolve(&path, root) == chain;
+		test_result(match);
+
+		// every structural edit is picked up
+		MD_Node* earlier = md_push_node(arena, MD_NodeKind_Main, 0, md_str8_lit("cascade_count"), md_str8_lit("cascade_count"), 0);
+		md_node_insert_child(shadows, md_nil_node(), earlier);
+		match = md_lookup_path_resolve(&path, root) == earlier;
+		md_unhook(earlier);
+		match = match && md_lookup_path_resolve(&path, root) == chain;
+		md_unhook(chain);
+		match = match && md_node_is_nil(md_lookup_path_resolve(&path, root));
+		md_node_push_child(shadows, chain);
+		match = match && md_lookup_path_resolve(&path, root) == chain;
+		MD_U64 generation = md_tree_generation();
+		md_node_push_tag(chain, md_push_node(arena, MD_NodeKind_Tag, 0, md_str8_lit("tag"), md_str8_lit("tag"), 0));
+		match = match && md_tree_generation() != generation;
+		test_result(match);
+
+		// another root, misses & match flags
+		MD_Node*      other     = md_parse_from_text(arena, md_str8_lit("text"), md_str8_lit("renderer: { shadows: { cascade_count: 2 } }")).root;
+		MD_LookupPath missing   = md_lookup_path_compile(arena, md_str8_lit("renderer/lights/count"), 0);
+		MD_LookupPath uppercase = md_lookup_path_compile(arena, md_str8_lit("RENDERER/MSAA"), MD_StringMatchFlag_CaseInsensitive);
+		match = md_lookup_path_resolve(&path, other) == other->first->first->first;
+		match = match && md_lookup_path_resolve(&path, root) == chain;
+		match = match && md_node_is_nil(md_lookup_path_resolve(&missing, root)) && md_node_is_nil(md_lookup_path_resolve(&missing, root));
+		match = match && md_lookup_path_resolve(&uppercase, root) == md_child_from_string(root->first, md_str8_lit("msaa"), 0);
+		match = match && md_lookup_path_resolve(&path, md_nil_node()) == md_nil_node();
+		test_result(match);
+
+		// a tree built where a cleared one was isn't taken for it, parsed or copied
+		{
+			MD_Arena*     reused = md_arena_alloc(.backing = md_varena_allocator(md_varena_alloc(0)));
+			MD_LookupPath ab     = md_lookup_path_compile(arena, md_str8_lit("a/b"), 0);
+			MD_Node*      before = md_parse_from_text(reused, md_str8_lit("text"), md_str8_lit("a: { b: 1 }")).root;
+			match = ! md_node_is_nil(md_lookup_path_resolve(&ab, before));
+			md_arena_clear(reused);
+			MD_Node* after = md_parse_from_text(reused, md_str8_lit("text"), md_str8_lit("x: { y: 2 }")).root;
+			match = match && after == before && md_node_is_nil(md_lookup_path_resolve(&ab, after));
+			md_arena_clear(reused);
+			before = md_treecopy(reused, md_parse_from_text(arena, md_str8_lit("text"), md_str8_lit("a: { b: 1 }")).root);
+			match  = match && ! md_node_is_nil(md_lookup_path_resolve(&ab, before));
+			md_arena_clear(reused);
+			after = md_treecopy(reused, md_parse_from_text(arena, md_str8_lit("text"), md_str8_lit("x: { y: 2 }")).root);
+			match = match && after == before && md_node_is_nil(md_lookup_path_resolve(&ab, after));
+			md_arena_release(reused);
+			test_result(match);
+		}
+	}
+
+	test("Canonical Text")
+	{
+		MD_B32 match = 1;
+		for (MD_U64 idx = 0; idx < md_array_count(samples); idx += 1)
+		{
+			MD_ParseResult parse = md_parse_from_text(arena, md_str8_lit("text"), samples[idx]);
+			if (parse.msgs.count == 0) {
+				match = match && text_round_trips(arena, parse.root, md_text_from_tree(arena, parse.root));
+			}
+		}
+		test_result(match);
+
+		// random text that parses cleanly, tags, sets, separators & every kind of string
+		MD_U64 clean = 0;
+		for (MD_U64 iter = 0; iter < 4000 && match; iter += 1)
+		{
+			MD_TempArena   temp  = md_temp_begin(arena);
+			MD_ParseResult parse = md_parse_from_text(temp.arena, md_str8_lit("text"), random_text(temp.arena, rng_next() % 256));
+			if (parse.msgs.count == 0 && sets_are_closed(parse.root)) {
+				match  = text_round_trips(temp.arena, parse.root, md_text_from_tree(temp.arena, parse.root));
+				clean += 1;
+			}
+			md_temp_end(temp);
+		}
+		test_result(match && clean > 100);
+
+		// labels made by hand are quoted when they can't be bare, a set without delimiters gets braces when it has no label
+		MD_Node* root = md_push_node(arena, MD_NodeKind_File, 0, md_str8_lit("text"), md_str8_lit(""), 0);
+		char* labels[] = { "plain", "foo1", "x2", "two words", "say \"hi\"", "line\nbreak", "12", "-3.5", "+=", "a//b", "x.y", "", "\"\"\"" };
+		for (MD_U64 idx = 0; idx < md_array_count(labels); idx += 1) {
+			md_node_push_child(root, md_push_node(arena, MD_NodeKind_Main, 0, md_str8_cstring(labels[idx]), md_str8_lit(""), 0));
+		}
+		MD_Node* set = md_push_node(arena, MD_NodeKind_Main, 0, md_str8_lit(""), md_str8_lit(""), 0);
+		md_node_push_child(set, md_push_node(arena, MD_NodeKind_Main, 0, md_str8_lit("inner"), md_str8_lit(""), 0));
+		md_node_push_child(root, set);
+		MD_ParseResult parse = md_parse_from_text(arena, md_str8_lit("text"), md_text_from_tree(arena, root));
+		match = parse.msgs.count == 0 && md_child_count_from_node(parse.root) == md_array_count(labels) + 1;
+		for (MD_U64 idx = 0; idx < md_array_count(labels) && match; idx += 1) {
+			match = md_str8_match(md_child_from_index(parse.root, idx)->string, md_str8_cstring(labels[idx]), 0);
+		}
+		MD_Node* parsed_set = md_child_from_index(parse.root, md_array_count(labels));
+		test_result(match && parsed_set->string.size == 0 && md_str8_match(parsed_set->first->string, md_str8_lit("inner"), 0));
+
+		// digits after the first byte don't need quotes
+		test_result((md_child_from_index(parse.root, 1)->flags & MD_NodeFlag_Identifier) && (md_child_from_index(parse.root, 2)->flags & MD_NodeFlag_Identifier));
+
+		// one node, & to a file through blocks smaller than most labels
+		parse = md_parse_from_text(arena, md_str8_lit("text"), samples[0]);
+		MD_Node*   node      = parse.root->first->next;
+		MD_String8 node_text = md_text_from_tree(arena, node);
+		MD_Node*   reparsed  = md_parse_from_text(arena, md_str8_lit("text"), node_text).root;
+		match = trees_match_shape(node, reparsed->first) && md_node_is_nil(reparsed->first->next);
+
+		MD_String8   path = md_str8_lit("canonical_text.mdesk");
+		MD_OS_Handle file = md_os_file_open(MD_OS_AccessFlag_Write, path);
+		{
+			MD_TempArena temp    = md_temp_begin(arena);
+			MD_Emitter   emitter = md_emitter_from_file(temp.arena, file, 7);
+			md_emit_children(&emitter, parse.root);
+			md_emitter_release(&emitter);
+			md_os_file_close(file);
+			match = match && ! emitter.failed && md_str8_match(md_os_data_from_file_path(temp.arena, path), md_text_from_tree(temp.arena, parse.root), 0);
+			match = match && md_tree_write_to_file_path(parse.root, path) && md_str8_match(md_os_data_from_file_path(temp.arena, path), md_text_from_tree(temp.arena, parse.root), 0);
+			md_temp_end(temp);
+		}
+		md_os_delete_file_at_path(path);
+		test_result(match);
+	}
+
+	test("Tree Export")
+	{
+		// every key, tag arguments as children of the tag
+		MD_ParseResult parse = md_parse_from_text(arena, md_str8_lit("text"), md_str8_lit("@t(1) a: b"));
+		MD_String8     json  = md_export_from_tree(arena, parse.root, MD_ExportFormat_JSON);
+		test_result(md_str8_match(json, md_str8_lit(
+			"{\"label\":\"text\",\"kind\":\"File\",\"flags\":0,\"tags\":[],\"children\":["
+				"{\"label\":\"a\",\"kind\":\"Main\",\"flags\":32768,\"tags\":["
+					"{\"label\":\"t\",\"kind\":\"Tag\",\"flags\":32770,\"tags\":[],\"children\":["
+						"{\"label\":\"1\",\"kind\":\"Main\",\"flags\":16384,\"tags\":[],\"children\":[]}]}],\"children\":["
+					"{\"label\":\"b\",\"kind\":\"Main\",\"flags\":32768,\"tags\":[],\"children\":[]}]}]}"), 0));
+
+		// escapes, on both sides of the runs the scan kernels skip in blocks
+		MD_String8 escaped = md_export_from_tree(arena, md_push_node(arena, MD_NodeKind_Main, 0, md_str8_lit("\"q\\\n\x01 and a label long enough to go past a few vector widths\t"), md_str8_lit(""), 0), MD_ExportFormat_JSON);
+		MD_String8 expected = md_str8_lit("{\"label\":\"\\\"q\\\\\\n\\u0001 and a label long enough to go past a few vector widths\\t\"");
+		test_result(md_str8_match(md_str8_prefix(escaped, expected.size), expected, 0));
+
+		// both formats cover every node of the samples, msgpack is well-formed & nothing but the tree
+		MD_B32 match = 1;
+		for (MD_U64 idx = 0; idx < md_array_count(samples); idx += 1)
+		{
+			MD_Node*   root    = md_parse_from_text(arena, md_str8_lit("text"), samples[idx]).root;
+			MD_U64     count   = tree_node_count(root);
+			MD_String8 json    = md_export_from_tree(arena, root, MD_ExportFormat_JSON);
+			MD_String8 msgpack = md_export_from_tree(arena, root, MD_ExportFormat_MsgPack);
+			MD_U64     keys    = 0;
+			for (MD_U64 pos = 0; (pos = md_str8_find_needle(json, pos, md_str8_lit(",\"kind\":\""), 0)) < json.size; pos += 1) {
+				keys += 1;
+			}
+			MD_U8* at   = msgpack.str;
+			MD_U64 maps = 0;
+			match = match && keys == count && msgpack_skip(&at, msgpack.str + msgpack.size, &maps) && at == msgpack.str + msgpack.size && maps == count;
+		}
+		test_result(match);
+
+		// through a sink in blocks smaller than a node, & a tree deeper than any stack
+		MD_Node* root = md_parse_from_text(arena, md_str8_lit("text"), samples[0]).root;
+		for (MD_ExportFormat format = 0; format < MD_ExportFormat_COUNT; format += 1)
+		{
+			MD_String8List blocks  = {0};
+			MD_Emitter     emitter = md_emitter_from_sink(arena, export_sink_append, &blocks, 5);
+			md_export_tree(&emitter, root, format);
+			md_emitter_flush(&emitter);
+			test_result( ! emitter.failed && md_str8_match(md_str8_list_join(arena, &blocks, 0), md_export_from_tree(arena, root, format), 0));
+		}
+		MD_Node* deep = md_push_node(arena, MD_NodeKind_Main, 0, md_str8_lit("deep"), md_str8_lit(""), 0);
+		MD_Node* leaf = deep;
+		for (MD_U64 depth = 0; depth < 100000; depth += 1) {
+			MD_Node* child = md_push_node(arena, MD_NodeKind_Main, 0, md_str8_lit("x"), md_str8_lit(""), 0);
+			md_node_push_child(leaf, child);
+			leaf = child;
+		}
+		MD_String8 deep_json = md_export_from_tree(arena, deep, MD_ExportFormat_JSON);
+		MD_U64     closed    = 0;
+		for (; 2 * closed + 2 <= deep_json.size && md_str8_match(md_str8_substr(deep_json, md_r1u64(deep_json.size - 2 * closed - 2, deep_json.size - 2 * closed)), md_str8_lit("]}"), 0); closed += 1);
+		MD_String8 deep_head = md_str8_lit("{\"label\":\"deep\"");
+		test_result(closed == 100001 && md_str8_match(md_str8_prefix(deep_json, deep_head.size), deep_head, 0));
+	}
+
+	test("Tree Hashes")
+	{
+		// spacing, comments & source offsets aren't part of the hash, labels, flags & structure are
+		MD_Node*      a        = md_parse_from_text(arena, md_str8_lit("text"), md_str8_lit("x: {a: 1, b: 2} @t(1) y")).root;
+		MD_Node*      spaced   = md_parse_from_text(arena, md_str8_lit("text"), md_str8_lit("// comment\nx:   {a:1,b:2}\n\n@t( 1 )\ny")).root;
+		MD_Node*      edited   = md_parse_from_text(arena, md_str8_lit("text"), md_str8_lit("x: {a: 1, b: 3} @t(1) y")).root;
+		MD_TreeHashes a_hashes = md_tree_hashes_from_tree(arena, a);
+		MD_TreeHashes s_hashes = md_tree_hashes_from_tree(arena, spaced);
+		MD_TreeHashes e_hashes = md_tree_hashes_from_tree(arena, edited);
+		test_result(a_hashes.count == tree_node_count(a) && md_tree_match_hashed(&a_hashes, a, &s_hashes, spaced) && ! md_tree_match_hashed(&a_hashes, a, &e_hashes, edited) &&
+			md_tree_match_hashed(&a_hashes, md_child_from_string(a, md_str8_lit("y"), 0), &e_hashes, md_child_from_string(edited, md_str8_lit("y"), 0)));
+
+		// agrees with tree_match on random trees, against themselves reparsed & against other random trees
+		MD_B32 match = 1;
+		for (MD_U64 iter = 0; iter < 2000 && match; iter += 1)
+		{
+			MD_TempArena  temp    = md_temp_begin(arena);
+			MD_String8    text    = random_text(temp.arena, rng_next() % 256);
+			MD_Node*      first   = md_parse_from_text(temp.arena, md_str8_lit("text"), text).root;
+			MD_Node*      again   = md_parse_from_text(temp.arena, md_str8_lit("text"), text).root;
+			MD_Node*      other   = md_parse_from_text(temp.arena, md_str8_lit("text"), random_text(temp.arena, rng_next() % 64)).root;
+			MD_TreeHashes hashes[3] = { md_tree_hashes_from_tree(temp.arena, first), md_tree_hashes_from_tree(temp.arena, again), md_tree_hashes_from_tree(temp.arena, other) };
+			match = hashes[0].count == tree_node_count(first) &&
+				md_tree_match_hashed(&hashes[0], first, &hashes[1], again) &&
+				md_tree_match_hashed(&hashes[0], first, &hashes[2], other) == tree_match(first, other, 0);
+			md_temp_end(temp);
+		}
+		test_result(match);
+
+		// changed, removed & added, only the roots of added & removed subtrees, in document order
+		MD_Node*      before = md_parse_from_text(arena, md_str8_lit("text"), md_str8_lit("config: {width: 640, height: 480, title: \"demo\"}\n@old flags: {vsync}\nkeep: {a b c}")).root;
+		MD_Node*      after  = md_parse_from_text(arena, md_str8_lit("text"), md_str8_lit("config: {width: 800, height: 480, fullscreen: {yes}}\n@new flags: {vsync}\nkeep: {a b c}")).root;
+		MD_TreeHashes before_hashes = md_tree_hashes_from_tree(arena, before);
+		MD_TreeHashes after_hashes  = md_tree_hashes_from_tree(arena, after);
+		MD_TreeDiff   diff          = md_tree_diff(arena, &before_hashes, &after_hashes);
+		test_result(diff.changed.count == 2 && diff.removed.count == 1 && diff.added.count == 1 &&
+			md_str8_match(diff.changed.first->a->string, md_str8_lit("640"), 0) && md_str8_match(diff.changed.first->b->string, md_str8_lit("800"), 0) &&
+			diff.changed.first->a->src_offset == 16 && diff.changed.first->b->src_offset == 16 &&
+			md_str8_match(diff.changed.last->a->string,  md_str8_lit("old"), 0) && md_str8_match(diff.changed.last->b->string,  md_str8_lit("new"), 0) &&
+			md_str8_match(diff.removed.first->a->string, md_str8_lit("title"), 0)      && md_str8_match(diff.removed.first->b->string, md_str8_lit("config"), 0) &&
+			md_str8_match(diff.added.first->a->string,   md_str8_lit("config"), 0)     && md_str8_match(diff.added.first->b->string,   md_str8_lit("fullscreen"), 0));
+
+		// an edit moves the generation & the hashes are taken again
+		MD_U64 hash = md_tree_hash_from_node(&a_hashes, a);
+		md_node_push_child(md_child_from_string(a, md_str8_lit("y"), 0), md_push_node(arena, MD_NodeKind_Main, 0, md_str8_lit("z"), md_str8_lit(""), 0));
+		test_result(md_tree_hash_from_node(&a_hashes, a) != hash && a_hashes.count == tree_node_count(a));
+
+		// so does a tree parsed where a cleared one was
+		{
+			MD_Arena*     reused        = md_arena_alloc(.backing = md_varena_allocator(md_varena_alloc(0)));
+			MD_Node*      cleared       = md_parse_from_text(reused, md_str8_lit("text"), md_str8_lit("a: { b: 1 }")).root;
+			MD_TreeHashes reused_hashes = md_tree_hashes_from_tree(arena, cleared);
+			MD_U64        cleared_hash  = md_tree_hash_from_node(&reused_hashes, cleared);
+			md_arena_clear(reused);
+			MD_Node*      reparsed      = md_parse_from_text(reused, md_str8_lit("text"), md_str8_lit("x: { y: 2 }")).root;
+			MD_TreeHashes fresh_hashes  = md_tree_hashes_from_tree(arena, reparsed);
+			MD_U64        reparsed_hash = md_tree_hash_from_node(&reused_hashes, reparsed);
+			test_result(reparsed == cleared && reparsed_hash != cleared_hash && reparsed_hash == md_tree_hash_from_node(&fresh_hashes, reparsed));
+			md_arena_release(reused);
+		}
+	}
+
+	return 0;
+}
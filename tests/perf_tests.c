@@ -0,0 +1,871 @@
+//$ exe //
+
+// Throughput benchmarks, not run as part of run_tests.sh
+//  ./perf_tests.exe [path to .mdesk file (defaults to docs/metadesk_reference.mdesk)]
+
+#include "metadesk.c"
+
+MD_Arena* arena = 0;
+
+static char* scan_level_names[MD_TextScanLevel_COUNT] = {
+	"scalar",
+	"sse2",
+	"avx2",
+};
+
+//- synthetic inputs, generated deterministically so results are comparable across runs
+
+static MD_String8
+synthetic_text(MD_Arena* arena, MD_U64 target_size)
+{
+	MD_String8List parts = {0};
+	for (MD_U64 idx = 0; parts.total_size < target_size; idx += 1)
+	{
+		md_str8_list_pushf(arena, &parts, "// entry %llu: lorem ipsum dolor sit amet, consectetur adipiscing elit\n", idx);
+		md_str8_list_pushf(arena, &parts, "@table(name, value) entry_%llu: { name: \"string_value_for_entry_%llu\", value: %llu, scale: %llu.25 }\n", idx, idx, idx * 7, idx % 100);
+		md_str8_list_push (arena, &parts, md_str8_lit("/* block comments can run over\n   multiple lines without any tokens inside them */\n"));
+		md_str8_list_pushf(arena, &parts, "text_%llu: \"\"\"multi-line\nstring literal with \"quotes\" inside\"\"\"\n\n", idx);
+	}
+	return md_str8_list_join(arena, &parts, 0);
+}
+
+static MD_String8
+repeated_text(MD_Arena* arena, MD_String8 text, MD_U64 target_size)
+{
+	MD_U64 count  = md_max(1, target_size / md_max(1, text.size));
+	MD_U8* str    = md_push_array__no_zero(arena, MD_U8, text.size * count);
+	for (MD_U64 idx = 0; idx < count; idx += 1) {
+		md_memory_copy(str + idx * text.size, text.str, text.size);
+	}
+	return md_str8(str, text.size * count);
+}
+
+static void
+bench_tokenize(char* name, MD_String8 text)
+{
+	printf("%s (%.1f MB)\n", name, (double)text.size / MD_MB(1));
+	for (MD_TextScanLevel level = MD_TextScanLevel_Scalar; level <= md_text_scan_level_supported(); level += 1)
+	{
+		md_text_scan_set_level(level);
+
+		MD_U64 best_us = MD_MAX_U64;
+		MD_U64 tokens  = 0;
+		for (MD_U64 run = 0; run < 5; run += 1)
+		{
+			MD_TempArena      temp     = md_temp_begin(arena);
+			MD_U64            begin_us = md_os_now_microseconds();
+			MD_TokenizeResult tokenize = md_tokenize_from_text(temp.arena, text);
+			MD_U64            end_us   = md_os_now_microseconds();
+			best_us = md_min(best_us, end_us - begin_us);
+			tokens  = tokenize.tokens.count;
+			md_temp_end(temp);
+		}
+		double mb_per_s = ((double)text.size / MD_MB(1)) / ((double)md_max(best_us, 1) / 1000000.0);
+		printf("  tokenize %-6s %10.1f MB/s  (%llu tokens)\n", scan_level_names[level], mb_per_s, tokens);
+	}
+	md_text_scan_set_level(md_text_scan_level_supported());
+}
+
+static void
+bench_tokenize_parallel(char* name, MD_String8 text)
+{
+	printf("%s (%.1f MB)\n", name, (double)text.size / MD_MB(1));
+	MD_U64 thread_counts[] = { 1, 2, 4, 8, 0 };
+	for (MD_U64 count_idx = 0; count_idx < md_array_count(thread_counts); count_idx += 1)
+	{
+		MD_U64 best_us = MD_MAX_U64;
+		for (MD_U64 run = 0; run < 5; run += 1)
+		{
+			MD_TempArena temp     = md_temp_begin(arena);
+			MD_U64       begin_us = md_os_now_microseconds();
+			md_tokenize_from_text_parallel(temp.arena, text, thread_counts[count_idx]);
+			MD_U64       end_us   = md_os_now_microseconds();
+			best_us = md_min(best_us, end_us - begin_us);
+			md_temp_end(temp);
+		}
+		double mb_per_s = ((double)text.size / MD_MB(1)) / ((double)md_max(best_us, 1) / 1000000.0);
+		printf("  tokenize %2llu threads %10.1f MB/s%s\n", thread_counts[count_idx], mb_per_s, thread_counts[count_idx] == 0 ? "  (all logical processors)" : "");
+	}
+}
+
+static void
+bench_parse(char* name, MD_String8 text)
+{
+	MD_U64 best_us = MD_MAX_U64;
+	MD_U64 nodes   = 0;
+	for (MD_U64 run = 0; run < 5; run += 1)
+	{
+		MD_TempArena   temp     = md_temp_begin(arena);
+		MD_U64         begin_us = md_os_now_microseconds();
+		MD_ParseResult parse    = md_parse_from_text(temp.arena, md_str8_lit(""), text);
+		MD_U64         end_us   = md_os_now_microseconds();
+		best_us = md_min(best_us, end_us - begin_us);
+		nodes   = md_child_count_from_node(parse.root);
+		md_temp_end(temp);
+	}
+	double mb_per_s = ((double)text.size / MD_MB(1)) / ((double)md_max(best_us, 1) / 1000000.0);
+	printf("%s (%.1f MB)\n  parse %10.1f MB/s  (%llu top-level nodes)\n", name, (double)text.size / MD_MB(1), mb_per_s, nodes);
+}
+
+static void
+bench_parse_layouts(char* name, MD_String8 text)
+{
+	md_local_persist char* layout_names[] = { "wide", "compact", "significant", "fused" };
+	printf("%s (%.1f MB)\n", name, (double)text.size / MD_MB(1));
+	for (MD_U64 layout = 0; layout < md_array_count(layout_names); layout += 1)
+	{
+		MD_U64 best_tokenize_us = MD_MAX_U64;
+		MD_U64 best_parse_us    = MD_MAX_U64;
+		MD_U64 token_bytes      = 0;
+		for (MD_U64 run = 0; run < 3; run += 1)
+		{
+			MD_TempArena temp     = md_temp_begin(arena);
+			MD_U64       begin_us = md_os_now_microseconds();
+			MD_U64       mid_us   = begin_us;
+			switch (layout)
+			{
+				case 0: {
+					MD_TokenizeResult tokenize = md_tokenize_from_text(temp.arena, text);
+					mid_us = md_os_now_microseconds();
+					md_parse_from_text_tokens(temp.arena, md_str8_lit(""), text, tokenize.tokens);
+					token_bytes = tokenize.tokens.count * size_of(MD_Token);
+				}
+				break;
+				case 1: {
+					MD_TokenizeCompactResult tokenize = md_tokenize_compact_from_text(temp.arena, text);
+					mid_us = md_os_now_microseconds();
+					md_parse_from_text_compact_tokens(temp.arena, md_str8_lit(""), text, tokenize.tokens);
+					token_bytes = tokenize.tokens.count * (size_of(MD_U32) + (tokenize.tokens.offsets_wide ? 2 * size_of(MD_U64) : 2 * size_of(MD_U32)));
+				}
+				break;
+				case 2: {
+					MD_TokenizeSignificantResult tokenize = md_tokenize_significant_from_text(temp.arena, text, 0);
+					mid_us = md_os_now_microseconds();
+					md_parse_from_text_significant_tokens(temp.arena, md_str8_lit(""), text, tokenize.tokens);
+					token_bytes = tokenize.tokens.count * size_of(MD_SignificantToken);
+				}
+				break;
+				case 3: {
+					// tokenizing happens inside the parse
+					md_parse_from_text_fused(temp.arena, md_str8_lit(""), text);
+					token_bytes = size_of(MD_TokenCursor);
+				}
+				break;
+			}
+			MD_U64 end_us = md_os_now_microseconds();
+			best_tokenize_us = md_min(best_tokenize_us, mid_us - begin_us);
+			best_parse_us    = md_min(best_parse_us,    end_us - mid_us);
+			md_temp_end(temp);
+		}
+		double total_mb_per_s = ((double)text.size / MD_MB(1)) / ((double)md_max(best_tokenize_us + best_parse_us, 1) / 1000000.0);
+		double parse_mb_per_s = ((double)text.size / MD_MB(1)) / ((double)md_max(best_parse_us, 1) / 1000000.0);
+		printf("  %-11s total %8.1f MB/s  parse %8.1f MB/s  tokens %8.1f MB\n", layout_names[layout], total_mb_per_s, parse_mb_per_s, (double)token_bytes / MD_MB(1));
+	}
+}
+
+static void
+bench_child_index(char* name, MD_U64 key_count)
+{
+	MD_TempArena   temp = md_temp_begin(arena);
+	MD_String8List keys = {0};
+	for (MD_U64 idx = 0; idx < key_count; idx += 1) {
+		md_str8_list_pushf(temp.arena, &keys, "k%c%c%c%c: \"value\"\n", (char)('a' + idx / 17576 % 26), (char)('a' + idx / 676 % 26), (char)('a' + idx / 26 % 26), (char)('a' + idx % 26));
+	}
+	MD_Node* root = md_parse_from_text(temp.arena, md_str8_lit(""), md_str8_list_join(temp.arena, &keys, 0)).root;
+	printf("%s (%llu children)\n", name, md_child_count_from_node(root));
+
+	// every key resolved by walking the siblings vs through the index (built by the parser)
+	MD_U64 found[4] = {0};
+	MD_U64 times[5];
+	times[0] = md_os_now_microseconds();
+	for md_each_child(child, root) {
+		found[0] += md_node_from_chain_string(root->first, md_nil_node(), child->string, 0) == child;
+	}
+	times[1] = md_os_now_microseconds();
+	for md_each_child(child, root) {
+		found[1] += md_child_from_string(root, child->string, 0) == child;
+	}
+	times[2] = md_os_now_microseconds();
+	for (MD_U64 idx = 0; idx < key_count; idx += 1) {
+		found[2] += !md_node_is_nil(md_node_from_chain_index(root->first, md_nil_node(), idx));
+	}
+	times[3] = md_os_now_microseconds();
+	for (MD_U64 idx = 0; idx < key_count; idx += 1) {
+		found[3] += !md_node_is_nil(md_child_from_index(root, idx));
+	}
+	times[4] = md_os_now_microseconds();
+
+	// every child's position & the child count asked alongside it, as table tools do
+	MD_U64 position_found[2] = {0};
+	MD_U64 position_times[3];
+	position_times[0] = md_os_now_microseconds();
+	for md_each_child(child, root) {
+		MD_U64 position = 0;
+		for (MD_Node* n = child->prev; !md_node_is_nil(n); n = n->prev) { position += 1; }
+		MD_U64 count = 0;
+		for (MD_Node* n = root->first; !md_node_is_nil(n); n = n->next) { count += 1; }
+		position_found[0] += position < count;
+	}
+	position_times[1] = md_os_now_microseconds();
+	for md_each_child(child, root) {
+		position_found[1] += md_index_from_node(child) < md_child_count_from_node(root);
+	}
+	position_times[2] = md_os_now_microseconds();
+	printf("  by string  walk %9.2f ms  indexed %8.2f ms  (%.0fx)%s\n", (double)(times[1] - times[0]) / 1000.0, (double)(times[2] - times[1]) / 1000.0,
+		(double)(times[1] - times[0]) / (double)md_max(times[2] - times[1], 1), found[0] == key_count && found[1] == key_count ? "" : "  (mismatch)");
+	printf("  by index   walk %9.2f ms  indexed %8.2f ms  (%.0fx)%s\n", (double)(times[3] - times[2]) / 1000.0, (double)(times[4] - times[3]) / 1000.0,
+		(double)(times[3] - times[2]) / (double)md_max(times[4] - times[3], 1), found[2] == key_count && found[3] == key_count ? "" : "  (mismatch)");
+	printf("  positions  walk %9.2f ms  indexed %8.2f ms  (%.0fx)%s\n", (double)(position_times[1] - position_times[0]) / 1000.0, (double)(position_times[2] - position_times[1]) / 1000.0,
+		(double)(position_times[1] - position_times[0]) / (double)md_max(position_times[2] - position_times[1], 1), position_found[0] == key_count && position_found[1] == key_count ? "" : "  (mismatch)");
+	md_temp_end(temp);
+}
+
+static void
+bench_tag_filter(char* name, MD_U64 node_count)
+{
+	// metagen style: a pass over the nodes per generator tag, nodes have a few tags each & most lookups miss
+	MD_TempArena   temp = md_temp_begin(arena);
+	MD_String8List text = {0};
+	for (MD_U64 idx = 0; idx < node_count; idx += 1) {
+		md_str8_list_pushf(temp.arena, &text, "@struct @serialize(%llu) @category_%c type_%c%c%c: { x: f32, y: f32 }\n", idx % 4, (char)('a' + idx % 16), (char)('a' + idx / 676 % 26), (char)('a' + idx / 26 % 26), (char)('a' + idx % 26));
+	}
+	MD_Node*   root          = md_parse_from_text(temp.arena, md_str8_lit(""), md_str8_list_join(temp.arena, &text, 0)).root;
+	MD_String8 generators[16];
+	for (MD_U64 idx = 0; idx < md_array_count(generators); idx += 1) {
+		generators[idx] = idx == 0 ? md_str8_lit("serialize") : md_str8f(temp.arena, "generator_%c", (char)('a' + idx));
+	}
+	printf("%s (%llu nodes, %llu generator tags)\n", name, md_child_count_from_node(root), (MD_U64)md_array_count(generators));
+
+	MD_U64 best_us[2] = { MD_MAX_U64, MD_MAX_U64 };
+	MD_U64 found[2]   = {0};
+	for (MD_U64 run = 0; run < 5; run += 1)
+	{
+		MD_U64 times[3];
+		md_memory_zero(found, sizeof(found));
+		times[0] = md_os_now_microseconds();
+		for (MD_U64 idx = 0; idx < md_array_count(generators); idx += 1) {
+			for md_each_child(node, root) {
+				found[0] += !md_node_is_nil(md_node_from_chain_string(node->first_tag, md_nil_node(), generators[idx], 0));
+			}
+		}
+		times[1] = md_os_now_microseconds();
+		for (MD_U64 idx = 0; idx < md_array_count(generators); idx += 1) {
+			for md_each_child(node, root) {
+				found[1] += md_node_has_tag(node, generators[idx], 0);
+			}
+		}
+		times[2] = md_os_now_microseconds();
+		best_us[0] = md_min(best_us[0], times[1] - times[0]);
+		best_us[1] = md_min(best_us[1], times[2] - times[1]);
+	}
+	printf("  has tag  walk %8.2f ms  filtered %8.2f ms  (%.1fx)%s\n", (double)best_us[0] / 1000.0, (double)best_us[1] / 1000.0,
+		(double)best_us[0] / (double)md_max(best_us[1], 1), found[0] == found[1] && found[0] == node_count ? "" : "  (mismatch)");
+	md_temp_end(temp);
+}
+
+static void
+bench_lazy_parse(char* name, MD_String8 text)
+{
+	printf("%s (%.1f MB)\n", name, (double)text.size / MD_MB(1));
+	for (MD_U64 lazy = 0; lazy <= 1; lazy += 1)
+	{
+		MD_U64 best_us = MD_MAX_U64;
+		MD_U64 touch_us = 0;
+		MD_U64 bytes   = 0;
+		for (MD_U64 run = 0; run < 3; run += 1)
+		{
+			MD_TempArena temp     = md_temp_begin(arena);
+			MD_U64       begin_us = md_os_now_microseconds();
+			MD_Node*     root     = md_nil_node();
+			if (lazy) {
+				root = md_parse_lazy_from_text(temp.arena, md_str8_lit(""), text).root;
+			}
+			else {
+				root = md_parse_from_text(temp.arena, md_str8_lit(""), text).root;
+			}
+			MD_U64 end_us = md_os_now_microseconds();
+
+			// read a few fields out of 64 entries spread over the file
+			MD_U64 top_count = md_child_count_from_node(root);
+			MD_U64 found     = 0;
+			for (MD_U64 entry_idx = 0; entry_idx < 64; entry_idx += 1) {
+				found += md_child_count_from_node(md_child_from_index(root, (entry_idx * 7919) % top_count));
+			}
+			best_us  = md_min(best_us, end_us - begin_us);
+			touch_us = md_os_now_microseconds() - end_us;
+			bytes    = md_arena_pos(temp.arena) - temp.pos;
+			md_temp_end(temp);
+		}
+		double mb_per_s = ((double)text.size / MD_MB(1)) / ((double)md_max(best_us, 1) / 1000000.0);
+		printf("  %-5s parse %8.1f MB/s  memory %8.1f MB  (touch 64 entries %.1f ms)\n", lazy ? "lazy" : "eager", mb_per_s, (double)bytes / MD_MB(1), (double)touch_us / 1000.0);
+	}
+}
+
+static void
+bench_filtered_parse(char* name, MD_String8 text)
+{
+	md_local_persist MD_String8 tags[] = { md_str8_lit_comp("table"), md_str8_lit_comp("missing") };
+	md_local_persist char*      filter_names[] = { "none", "@table", "@missing" };
+	printf("%s (%.1f MB)\n", name, (double)text.size / MD_MB(1));
+	for (MD_U64 filter_idx = 0; filter_idx < md_array_count(filter_names); filter_idx += 1)
+	{
+		MD_ParseFilter filter  = { { tags + (filter_idx > 0 ? filter_idx - 1 : 0), 1 }, 0 };
+		MD_U64         best_us = MD_MAX_U64;
+		MD_U64         bytes   = 0;
+		MD_U64         nodes   = 0;
+		for (MD_U64 run = 0; run < 3; run += 1)
+		{
+			MD_TempArena   temp     = md_temp_begin(arena);
+			MD_U64         begin_us = md_os_now_microseconds();
+			MD_ParseResult parse    = (filter_idx == 0) ? md_parse_from_text(temp.arena, md_str8_lit(""), text) : md_parse_filtered_from_text(temp.arena, md_str8_lit(""), text, filter);
+			MD_U64         end_us   = md_os_now_microseconds();
+			best_us = md_min(best_us, end_us - begin_us);
+			bytes   = md_arena_pos(temp.arena) - temp.pos;
+			nodes   = md_child_count_from_node(parse.root);
+			md_temp_end(temp);
+		}
+		double mb_per_s = ((double)text.size / MD_MB(1)) / ((double)md_max(best_us, 1) / 1000000.0);
+		printf("  filter %-8s parse %8.1f MB/s  memory %8.1f MB  (%llu top-level nodes)\n", filter_names[filter_idx], mb_per_s, (double)bytes / MD_MB(1), nodes);
+	}
+}
+
+static MD_U64
+node_string_size_sum(MD_Node* node)
+{
+	MD_U64 result = node->string.size;
+	for md_each_node(tag,   node->first_tag) { result += node_string_size_sum(tag);   }
+	for md_each_node(child, node->first)     { result += node_string_size_sum(child); }
+	return result;
+}
+
+static void
+bench_flat_tree(char* name, MD_String8 text)
+{
+	printf("%s (%.1f MB)\n", name, (double)text.size / MD_MB(1));
+	MD_TempArena temp  = md_temp_begin(arena);
+	MD_Node*     root  = md_parse_from_text(temp.arena, md_str8_lit(""), text).root;
+	MD_U64       begin_us = md_os_now_microseconds();
+	MD_FlatTree  flat  = md_flat_tree_from_node(temp.arena, root, text);
+	MD_U64       flatten_us = md_os_now_microseconds() - begin_us;
+	MD_U64       flat_node_bytes = size_of(MD_U8) + size_of(MD_NodeFlags) + 9 * size_of(MD_U32);
+	printf("  nodes %llu: MD_Node %8.1f MB  flat %8.1f MB  (flatten %.1f ms)\n", flat.count - 1,
+		(double)((flat.count - 1) * size_of(MD_Node)) / MD_MB(1), (double)(flat.count * flat_node_bytes + flat.extra.size) / MD_MB(1), (double)flatten_us / 1000.0);
+
+	// every node's string, tags included
+	MD_U64 node_best_us = MD_MAX_U64;
+	MD_U64 flat_best_us = MD_MAX_U64;
+	MD_U64 node_sum     = 0;
+	MD_U64 flat_sum     = 0;
+	for (MD_U64 run = 0; run < 5; run += 1)
+	{
+		MD_U64 node_begin_us = md_os_now_microseconds();
+		node_sum = node_string_size_sum(root);
+		MD_U64 flat_begin_us = md_os_now_microseconds();
+		flat_sum = 0;
+		for (MD_FlatNode node = 1; node < flat.count; node += 1) {
+			flat_sum += flat.string_sizes[node];
+		}
+		MD_U64 end_us = md_os_now_microseconds();
+		node_best_us = md_min(node_best_us, flat_begin_us - node_begin_us);
+		flat_best_us = md_min(flat_best_us, end_us - flat_begin_us);
+	}
+	printf("  walk   MD_Node %8.2f ms  flat %8.2f ms%s\n", (double)node_best_us / 1000.0, (double)flat_best_us / 1000.0, node_sum == flat_sum ? "" : "  (mismatch)");
+
+	// child lookups by string along the top-level chain
+	MD_U64     lookup_count = 64;
+	MD_U64     top_count    = md_child_count_from_node(root);
+	MD_String8 keys[64];
+	for (MD_U64 key_idx = 0; key_idx < lookup_count; key_idx += 1) {
+		keys[key_idx] = md_child_from_index(root, (key_idx * 7919) % top_count)->string;
+	}
+	MD_U64 node_begin_us = md_os_now_microseconds();
+	MD_U64 node_found    = 0;
+	for (MD_U64 key_idx = 0; key_idx < lookup_count; key_idx += 1) {
+		node_found += md_child_from_string(root, keys[key_idx], 0)->src_offset;
+	}
+	MD_U64 flat_begin_us = md_os_now_microseconds();
+	MD_U64 flat_found    = 0;
+	for (MD_U64 key_idx = 0; key_idx < lookup_count; key_idx += 1) {
+		flat_found += flat.src_offsets[md_flat_child_from_string(&flat, md_flat_tree_root(&flat), keys[key_idx], 0)];
+	}
+	MD_U64 end_us = md_os_now_microseconds();
+	printf("  lookup MD_Node %8.2f ms  flat %8.2f ms%s\n", (double)(flat_begin_us - node_begin_us) / 1000.0, (double)(end_us - flat_begin_us) / 1000.0, node_found == flat_found ? "" : "  (mismatch)");
+	md_temp_end(temp);
+}
+
+static void
+bench_flat_tree_file(char* name, MD_String8 text)
+{
+	printf("%s (%.1f MB)\n", name, (double)text.size / MD_MB(1));
+	MD_TempArena temp = md_temp_begin(arena);
+	MD_String8   path = md_str8_lit("perf_flat_tree.mdft");
+
+	// what loading saves: parsing the text again
+	MD_U64             parse_begin_us = md_os_now_microseconds();
+	MD_FlatParseResult flat           = md_parse_flat_from_text(temp.arena, md_str8_lit(""), text);
+	MD_U64             parse_us       = md_os_now_microseconds() - parse_begin_us;
+	MD_U64             write_begin_us = md_os_now_microseconds();
+	md_flat_tree_write_to_file_path(&flat.tree, path);
+	MD_U64             write_us       = md_os_now_microseconds() - write_begin_us;
+
+	MD_U64 open_best_us = MD_MAX_U64;
+	MD_U64 walk_best_us = MD_MAX_U64;
+	MD_U64 sum          = 0;
+	for (MD_U64 run = 0; run < 5; run += 1)
+	{
+		MD_U64         open_begin_us = md_os_now_microseconds();
+		MD_FlatTreeMap map           = md_flat_tree_map_open(path);
+		MD_U64         walk_begin_us = md_os_now_microseconds();
+		sum = 0;
+		for (MD_FlatNode node = 1; node < map.tree.count; node += 1) {
+			sum += map.tree.string_sizes[node];
+		}
+		MD_U64         end_us        = md_os_now_microseconds();
+		open_best_us = md_min(open_best_us, walk_begin_us - open_begin_us);
+		walk_best_us = md_min(walk_best_us, end_us - walk_begin_us);
+		md_flat_tree_map_close(&map);
+	}
+	MD_U64 flat_sum = 0;
+	for (MD_FlatNode node = 1; node < flat.tree.count; node += 1) {
+		flat_sum += flat.tree.string_sizes[node];
+	}
+	printf("  parse %8.1f ms  write %8.1f ms  map open %8.3f ms  first walk %8.2f ms%s\n", (double)parse_us / 1000.0, (double)write_us / 1000.0,
+		(double)open_best_us / 1000.0, (double)walk_best_us / 1000.0, sum == flat_sum ? "" : "  (mismatch)");
+	md_os_delete_file_at_path(path);
+	md_temp_end(temp);
+}
+
+static void
+bench_parse_cache(char* name, MD_String8 text)
+{
+	printf("%s (%.1f MB)\n", name, (double)text.size / MD_MB(1));
+	MD_ParseCache cache = { md_str8_lit("perf_parse_cache") };
+	cache.max_total_size = 1;
+	md_parse_cache_trim(&cache);
+	cache.max_total_size = 0;
+
+	MD_U64 hash_begin_us = md_os_now_microseconds();
+	MD_U64 key           = md_parse_cache_key(&cache, text);
+	MD_U64 hash_us       = md_os_now_microseconds() - hash_begin_us;
+
+	// parse, the miss that parses & stores, then the best of a few hits
+	MD_U64 times_us[3] = { MD_MAX_U64, 0, MD_MAX_U64 };
+	for (MD_U64 run = 0; run < 5; run += 1)
+	{
+		MD_TempArena temp     = md_temp_begin(arena);
+		MD_U64       begin_us = md_os_now_microseconds();
+		if (run == 0) {
+			md_parse_from_text(temp.arena, md_str8_lit(""), text);
+			MD_U64 parse_end_us = md_os_now_microseconds();
+			md_parse_from_text_cached(temp.arena, &cache, md_str8_lit(""), text);
+			times_us[0] = parse_end_us - begin_us;
+			times_us[1] = md_os_now_microseconds() - parse_end_us;
+		}
+		else {
+			md_parse_from_text_cached(temp.arena, &cache, md_str8_lit(""), text);
+			times_us[2] = md_min(times_us[2], md_os_now_microseconds() - begin_us);
+		}
+		md_temp_end(temp);
+	}
+	printf("  hash %8.2f ms (key %016llx)  parse %8.1f ms  miss %8.1f ms  hit %8.1f ms\n", (double)hash_us / 1000.0, key,
+		(double)times_us[0] / 1000.0, (double)times_us[1] / 1000.0, (double)times_us[2] / 1000.0);
+	cache.max_total_size = 1;
+	md_parse_cache_trim(&cache);
+}
+
+static void
+bench_atoms(char* name, MD_String8 text)
+{
+	printf("%s (%.1f MB)\n", name, (double)text.size / MD_MB(1));
+	MD_TempArena  temp  = md_temp_begin(arena);
+	MD_AtomTable* atoms = md_atom_table_alloc(temp.arena, 1 << 20);
+
+	MD_U64         parse_begin_us = md_os_now_microseconds();
+	MD_Node*       root           = md_parse_from_text(temp.arena, md_str8_lit(""), text).root;
+	MD_U64         atoms_begin_us = md_os_now_microseconds();
+	md_parse_from_text_atoms(temp.arena, atoms, md_str8_lit(""), text);
+	MD_U64         atoms_end_us   = md_os_now_microseconds();
+	root = md_parse_from_text_atoms(temp.arena, atoms, md_str8_lit(""), text).root;
+	printf("  parse %8.1f ms  with atoms %8.1f ms (%llu atoms)\n", (double)(atoms_begin_us - parse_begin_us) / 1000.0, (double)(atoms_end_us - atoms_begin_us) / 1000.0, atoms->count);
+
+	// a tag & a child of every top-level node, then keys along the top-level chain
+	MD_String8 tag_string   = md_str8_lit("table");
+	MD_String8 child_string = md_str8_lit("value");
+	MD_Atom    tag_atom     = md_atom_lookup(atoms, tag_string);
+	MD_Atom    child_atom   = md_atom_lookup(atoms, child_string);
+	MD_U64     lookup_count = 64;
+	MD_U64     top_count    = md_child_count_from_node(root);
+	MD_String8 keys[64];
+	MD_Atom    key_atoms[64];
+	for (MD_U64 key_idx = 0; key_idx < lookup_count; key_idx += 1) {
+		keys[key_idx]      = md_child_from_index(root, (key_idx * 7919) % top_count)->string;
+		key_atoms[key_idx] = md_atom_lookup(atoms, keys[key_idx]);
+	}
+
+	MD_U64 best_us[4] = { MD_MAX_U64, MD_MAX_U64, MD_MAX_U64, MD_MAX_U64 };
+	MD_U64 found[4]   = {0};
+	for (MD_U64 run = 0; run < 5; run += 1)
+	{
+		MD_U64 times[5];
+		md_memory_zero(found, sizeof(found));
+		times[0] = md_os_now_microseconds();
+		for md_each_child(node, root) {
+			found[0] += md_node_has_tag(node, tag_string, 0) && md_node_has_child(node, child_string, 0);
+		}
+		times[1] = md_os_now_microseconds();
+		for md_each_child(node, root) {
+			found[1] += md_node_has_tag_atom(node, tag_atom) && md_node_has_child_atom(node, child_atom);
+		}
+		times[2] = md_os_now_microseconds();
+		for (MD_U64 key_idx = 0; key_idx < lookup_count; key_idx += 1) {
+			found[2] += md_child_from_string(root, keys[key_idx], 0)->src_offset;
+		}
+		times[3] = md_os_now_microseconds();
+		for (MD_U64 key_idx = 0; key_idx < lookup_count; key_idx += 1) {
+			found[3] += md_child_from_atom(root, key_atoms[key_idx])->src_offset;
+		}
+		times[4] = md_os_now_microseconds();
+		for (MD_U64 idx = 0; idx < 4; idx += 1) {
+			best_us[idx] = md_min(best_us[idx], times[idx + 1] - times[idx]);
+		}
+	}
+	printf("  tag & child   string %8.2f ms  atom %8.2f ms  (%.1fx)%s\n", (double)best_us[0] / 1000.0, (double)best_us[1] / 1000.0,
+		(double)best_us[0] / (double)md_max(best_us[1], 1), found[0] == found[1] ? "" : "  (mismatch)");
+	printf("  chain lookups string %8.2f ms  atom %8.2f ms  (%.1fx)%s\n", (double)best_us[2] / 1000.0, (double)best_us[3] / 1000.0,
+		(double)best_us[2] / (double)md_max(best_us[3], 1), found[2] == found[3] ? "" : "  (mismatch)");
+	md_atom_table_release(atoms);
+	md_temp_end(temp);
+}
+
+static void
+bench_parse_parallel(char* name, MD_String8 text)
+{
+	printf("%s (%.1f MB)\n", name, (double)text.size / MD_MB(1));
+	MD_TempArena      tokens_temp = md_temp_begin(arena);
+	MD_TokenizeResult tokenize    = md_tokenize_from_text(tokens_temp.arena, text);
+	MD_U64            thread_counts[] = { 1, 2, 4, 8, 0 };
+	for (MD_U64 count_idx = 0; count_idx < md_array_count(thread_counts); count_idx += 1)
+	{
+		MD_U64 best_us = MD_MAX_U64;
+		for (MD_U64 run = 0; run < 5; run += 1)
+		{
+			MD_TempArena temp     = md_temp_begin(arena);
+			MD_U64       begin_us = md_os_now_microseconds();
+			md_parse_from_text_tokens_parallel(temp.arena, md_str8_lit(""), text, tokenize.tokens, thread_counts[count_idx]);
+			MD_U64       end_us   = md_os_now_microseconds();
+			best_us = md_min(best_us, end_us - begin_us);
+			md_temp_end(temp);
+		}
+		double mb_per_s = ((double)text.size / MD_MB(1)) / ((double)md_max(best_us, 1) / 1000000.0);
+		printf("  parse %2llu threads %10.1f MB/s%s\n", thread_counts[count_idx], mb_per_s, thread_counts[count_idx] == 0 ? "  (all logical processors)" : "");
+	}
+	md_temp_end(tokens_temp);
+}
+
+static void
+bench_parse_files(char* name, MD_U64 file_count, MD_U64 file_size)
+{
+	MD_TempArena   files_temp = md_temp_begin(arena);
+	MD_String8     dir        = md_str8_lit("perf_files");
+	MD_String8     text       = synthetic_text(files_temp.arena, file_size);
+	MD_String8List path_list  = {0};
+	md_os_make_directory(dir);
+	for (MD_U64 file_idx = 0; file_idx < file_count; file_idx += 1) {
+		MD_String8 path = md_str8_list_pushf(files_temp.arena, &path_list, "%S/file_%llu.mdesk", dir, file_idx)->string;
+		md_os_write_data_to_file_path(path, text);
+	}
+	MD_String8Array paths = md_str8_array_from_list(files_temp.arena, &path_list);
+
+	printf("%s (%llu files, %.1f MB)\n", name, file_count, (double)(text.size * file_count) / MD_MB(1));
+	MD_U64 thread_counts[] = { 1, 2, 4, 8, 0 };
+	for (MD_U64 count_idx = 0; count_idx < md_array_count(thread_counts); count_idx += 1)
+	{
+		MD_U64 best_us = MD_MAX_U64;
+		for (MD_U64 run = 0; run < 5; run += 1)
+		{
+			MD_TempArena temp     = md_temp_begin(arena);
+			MD_U64       begin_us = md_os_now_microseconds();
+			md_parse_files_parallel(temp.arena, paths, thread_counts[count_idx]);
+			MD_U64       end_us   = md_os_now_microseconds();
+			best_us = md_min(best_us, end_us - begin_us);
+			md_temp_end(temp);
+		}
+		double mb_per_s = ((double)(text.size * file_count) / MD_MB(1)) / ((double)md_max(best_us, 1) / 1000000.0);
+		printf("  load & parse %2llu threads %10.1f MB/s%s\n", thread_counts[count_idx], mb_per_s, thread_counts[count_idx] == 0 ? "  (all logical processors)" : "");
+	}
+
+	for (MD_U64 file_idx = 0; file_idx < paths.count; file_idx += 1) {
+		md_os_delete_file_at_path(paths.v[file_idx]);
+	}
+	md_temp_end(files_temp);
+}
+
+static MD_U64
+count_labels_below(MD_Node* node, MD_String8 label)
+{
+	MD_U64 count = 0;
+	for md_each_child(child, node) {
+		count += md_str8_match(child->string, label, 0) + count_labels_below(child, label);
+	}
+	return count;
+}
+
+static void
+bench_select(char* name, MD_String8 text)
+{
+	MD_TempArena temp = md_temp_begin(arena);
+	MD_Node*     root = md_parse_from_text(temp.arena, md_str8_lit(""), text).root;
+	printf("%s (%.1f MB)\n", name, (double)text.size / MD_MB(1));
+
+	char* sources[] = { "@table/value", "//value" };
+	for (MD_U64 source_idx = 0; source_idx < md_array_count(sources); source_idx += 1)
+	{
+		MD_Selector selector = md_selector_compile(temp.arena, md_str8_cstring(sources[source_idx]));
+		MD_U64      best_us[2] = { MD_MAX_U64, MD_MAX_U64 };
+		MD_U64      found[2]   = {0};
+		for (MD_U64 run = 0; run < 5; run += 1)
+		{
+			MD_TempArena run_temp = md_temp_begin(arena);
+			MD_U64       times[3];
+			times[0] = md_os_now_microseconds();
+			found[0] = 0;
+			if (source_idx == 0) {
+				for md_each_child(node, root) {
+					if (md_node_has_tag(node, md_str8_lit("table"), 0)) {
+						for md_each_child(child, node) { found[0] += md_str8_match(child->string, md_str8_lit("value"), 0); }
+					}
+				}
+			}
+			else {
+				found[0] = count_labels_below(root, md_str8_lit("value"));
+			}
+			times[1] = md_os_now_microseconds();
+			found[1] = md_select(run_temp.arena, &selector, root).count;
+			times[2] = md_os_now_microseconds();
+			best_us[0] = md_min(best_us[0], times[1] - times[0]);
+			best_us[1] = md_min(best_us[1], times[2] - times[1]);
+			md_temp_end(run_temp);
+		}
+		printf("  %-14s hand loop %8.2f ms  selector %8.2f ms  (%.2fx)%s\n", sources[source_idx], (double)best_us[0] / 1000.0, (double)best_us[1] / 1000.0,
+			(double)best_us[0] / (double)md_max(best_us[1], 1), found[0] == found[1] ? "" : "  (mismatch)");
+
+		MD_NodeArray roots           = { &root, 1 };
+		MD_U64       thread_counts[] = { 1, 2, 4, 0 };
+		for (MD_U64 count_idx = 0; count_idx < md_array_count(thread_counts); count_idx += 1)
+		{
+			MD_U64 parallel_us = MD_MAX_U64;
+			MD_U64 count       = 0;
+			for (MD_U64 run = 0; run < 5; run += 1)
+			{
+				MD_TempArena run_temp = md_temp_begin(arena);
+				MD_U64       begin_us = md_os_now_microseconds();
+				count = md_select_parallel(run_temp.arena, &selector, roots, thread_counts[count_idx]).count;
+				parallel_us = md_min(parallel_us, md_os_now_microseconds() - begin_us);
+				md_temp_end(run_temp);
+			}
+			printf("  %-14s %2llu threads %8.2f ms%s%s\n", sources[source_idx], thread_counts[count_idx], (double)parallel_us / 1000.0,
+				thread_counts[count_idx] == 0 ? "  (all logical processors)" : "", count == found[0] ? "" : "  (mismatch)");
+		}
+	}
+	md_temp_end(temp);
+}
+
+static void
+bench_lookup_path(char* name, MD_U64 lookup_count)
+{
+	// a config of 48 sections of 48 settings, read by the same deep path over & over
+	MD_TempArena   temp = md_temp_begin(arena);
+	MD_String8List text = {0};
+	for (MD_U64 section = 0; section < 48; section += 1)
+	{
+		md_str8_list_pushf(temp.arena, &text, "s%c%c: {\n", (char)('a' + section / 26), (char)('a' + section % 26));
+		for (MD_U64 setting = 0; setting < 48; setting += 1) {
+			md_str8_list_pushf(temp.arena, &text, "  k%c%c: { value: %llu, default: 0 }\n", (char)('a' + setting / 26), (char)('a' + setting % 26), setting);
+		}
+		md_str8_list_push(temp.arena, &text, md_str8_lit("}\n"));
+	}
+	MD_Node*      root = md_parse_from_text(temp.arena, md_str8_lit(""), md_str8_list_join(temp.arena, &text, 0)).root;
+	MD_LookupPath path = md_lookup_path_compile(temp.arena, md_str8_lit("sbu/kbu/default"), 0);
+	printf("%s (%llu lookups of sbu/kbu/default)\n", name, lookup_count);
+
+	MD_U64 found[3] = {0};
+	MD_U64 times[4];
+	times[0] = md_os_now_microseconds();
+	for (MD_U64 idx = 0; idx < lookup_count; idx += 1) {
+		MD_Node* node = md_child_from_string(root, md_str8_lit("sbu"), 0);
+		node = md_child_from_string(node, md_str8_lit("kbu"), 0);
+		node = md_child_from_string(node, md_str8_lit("default"), 0);
+		found[0] += ! md_node_is_nil(node);
+	}
+	times[1] = md_os_now_microseconds();
+	for (MD_U64 idx = 0; idx < lookup_count; idx += 1) {
+		found[1] += ! md_node_is_nil(md_lookup_path_resolve(&path, root));
+	}
+	times[2] = md_os_now_microseconds();
+	// worst case, an edit between every lookup
+	for (MD_U64 idx = 0; idx < lookup_count; idx += 1) {
+		md_tree_generation_bump();
+		found[2] += ! md_node_is_nil(md_lookup_path_resolve(&path, root));
+	}
+	times[3] = md_os_now_microseconds();
+	printf("  chained lookups %8.2f ms  path %8.2f ms  (%.0fx)  path, edited every lookup %8.2f ms%s\n",
+		(double)(times[1] - times[0]) / 1000.0, (double)(times[2] - times[1]) / 1000.0, (double)(times[1] - times[0]) / (double)md_max(times[2] - times[1], 1),
+		(double)(times[3] - times[2]) / 1000.0, found[0] == lookup_count && found[1] == lookup_count && found[2] == lookup_count ? "" : "  (mismatch)");
+	md_temp_end(temp);
+}
+
+static void
+bench_emit(char* name, MD_String8 text)
+{
+	MD_TempArena temp = md_temp_begin(arena);
+	MD_Node*     root = md_parse_from_text(temp.arena, md_str8_lit(""), text).root;
+	MD_String8   path = md_str8_lit("perf_emit.mdesk");
+	printf("%s (%.1f MB parsed)\n", name, (double)text.size / MD_MB(1));
+
+	MD_U64 best_us[4] = { MD_MAX_U64, MD_MAX_U64, MD_MAX_U64, MD_MAX_U64 };
+	MD_U64 bytes      = 0;
+	MD_U64 debug_size = 0;
+	for (MD_U64 run = 0; run < 3; run += 1)
+	{
+		MD_TempArena run_temp = md_temp_begin(temp.arena);
+		MD_U64       times[5];
+		times[0] = md_os_now_microseconds();
+		MD_String8 out = md_text_from_tree(run_temp.arena, root);
+		times[1] = md_os_now_microseconds();
+		md_tree_write_to_file_path(root, path);
+		times[2] = md_os_now_microseconds();
+		MD_U8* copy = md_push_array__no_zero(run_temp.arena, MD_U8, out.size);
+		times[3] = md_os_now_microseconds();
+		md_memory_copy(copy, out.str, out.size);
+		times[4] = md_os_now_microseconds();
+		MD_String8List debug = md_debug_string_list_from_tree(run_temp.arena, root);
+		MD_U64 debug_us = md_os_now_microseconds() - times[4];
+		best_us[0] = md_min(best_us[0], times[1] - times[0]);
+		best_us[1] = md_min(best_us[1], times[2] - times[1]);
+		best_us[2] = md_min(best_us[2], times[4] - times[3]);
+		best_us[3] = md_min(best_us[3], debug_us);
+		bytes      = out.size;
+		debug_size = debug.total_size;
+		md_temp_end(run_temp);
+	}
+	md_os_delete_file_at_path(path);
+	char* labels[4] = { "emit to memory", "emit to file", "memcpy", "debug string list" };
+	for (MD_U64 idx = 0; idx < md_array_count(labels); idx += 1) {
+		MD_U64 size = idx == 3 ? debug_size : bytes;
+		printf("  %-17s %8.1f MB/s  (%.1f MB)\n", labels[idx], ((double)size / MD_MB(1)) / ((double)md_max(best_us[idx], 1) / 1000000.0), (double)size / MD_MB(1));
+	}
+	md_temp_end(temp);
+}
+
+static MD_B32
+bench_export_sink(void* user_data, MD_String8 block)
+{
+	*(MD_U64*)user_data += block.size;
+	return 1;
+}
+
+static void
+bench_export(char* name, MD_String8 text)
+{
+	MD_TempArena temp = md_temp_begin(arena);
+	MD_Node*     root = md_parse_from_text(temp.arena, md_str8_lit(""), text).root;
+	printf("%s (%.1f MB parsed)\n", name, (double)text.size / MD_MB(1));
+	char* format_names[MD_ExportFormat_COUNT] = { "json", "msgpack" };
+	for (MD_ExportFormat format = 0; format < MD_ExportFormat_COUNT; format += 1)
+	{
+		MD_U64 best_us[2] = { MD_MAX_U64, MD_MAX_U64 };
+		MD_U64 bytes      = 0;
+		MD_U64 sunk       = 0;
+		for (MD_U64 run = 0; run < 3; run += 1)
+		{
+			MD_TempArena run_temp = md_temp_begin(temp.arena);
+			MD_U64       times[3];
+			times[0] = md_os_now_microseconds();
+			MD_String8 out = md_export_from_tree(run_temp.arena, root, format);
+			times[1] = md_os_now_microseconds();
+			// 1 MB blocks handed to a sink that only counts them, what an inline pipeline stage would see
+			MD_Emitter emitter = md_emitter_from_sink(run_temp.arena, bench_export_sink, &sunk, MD_MB(1));
+			md_export_tree(&emitter, root, format);
+			md_emitter_flush(&emitter);
+			times[2] = md_os_now_microseconds();
+			best_us[0] = md_min(best_us[0], times[1] - times[0]);
+			best_us[1] = md_min(best_us[1], times[2] - times[1]);
+			bytes      = out.size;
+			md_temp_end(run_temp);
+		}
+		printf("  %-8s to memory %8.1f MB/s  to sink %8.1f MB/s  (%.1f MB%s)\n", format_names[format],
+			((double)bytes / MD_MB(1)) / ((double)md_max(best_us[0], 1) / 1000000.0),
+			((double)bytes / MD_MB(1)) / ((double)md_max(best_us[1], 1) / 1000000.0),
+			(double)bytes / MD_MB(1), sunk == 3 * bytes ? "" : ", sink mismatch");
+	}
+	md_temp_end(temp);
+}
+
+static void
+bench_tree_hash(char* name, MD_String8 text)
+{
+	// two snapshots of the same config, the second with one value edited near the end
+	MD_TempArena temp   = md_temp_begin(arena);
+	MD_Node*     before = md_parse_from_text(temp.arena, md_str8_lit(""), text).root;
+	MD_Node*     after  = md_parse_from_text(temp.arena, md_str8_lit(""), text).root;
+	MD_Node*     entry  = after->last;
+	for (; md_node_is_nil(entry->first); entry = entry->prev);
+	MD_Node*     edited = entry->first;
+	edited->string = md_str8_lit("edited");
+	md_tree_generation_bump();
+	printf("%s (%.1f MB parsed twice, one label edited)\n", name, (double)text.size / MD_MB(1));
+
+	MD_U64 times[5];
+	times[0] = md_os_now_microseconds();
+	MD_B32 matched = tree_match(before, after, 0);
+	times[1] = md_os_now_microseconds();
+	MD_TreeHashes before_hashes = md_tree_hashes_from_tree(temp.arena, before);
+	MD_TreeHashes after_hashes  = md_tree_hashes_from_tree(temp.arena, after);
+	times[2] = md_os_now_microseconds();
+	MD_B32 hash_matched = md_tree_match_hashed(&before_hashes, before, &after_hashes, after);
+	times[3] = md_os_now_microseconds();
+	MD_TreeDiff diff = md_tree_diff(temp.arena, &before_hashes, &after_hashes);
+	times[4] = md_os_now_microseconds();
+	printf("  tree_match %8.2f ms  hash both %8.2f ms  hashed match %8.3f ms  diff %8.3f ms  (%llu changed%s)\n",
+		(double)(times[1] - times[0]) / 1000.0, (double)(times[2] - times[1]) / 1000.0, (double)(times[3] - times[2]) / 1000.0, (double)(times[4] - times[3]) / 1000.0,
+		diff.changed.count, matched == hash_matched && diff.changed.count == 1 && diff.changed.first->b == edited ? "" : ", mismatch");
+	md_temp_end(temp);
+}
+
+int main(int argc, char** argv)
+{
+	MD_Context ctx = {0};
+	md_init(&ctx);
+	arena = md_arena_alloc(.backing = md_varena_allocator(md_varena_alloc(.reserve_size = MD_GB(8), .commit_size = MD_MB(64))));
+
+	MD_String8 reference_path = md_str8_lit("../docs/metadesk_reference.mdesk");
+	if (argc > 1) {
+		reference_path = md_str8_cstring(argv[1]);
+	}
+	MD_String8 reference = md_os_data_from_file_path(arena, reference_path);
+
+	bench_tokenize("reference",            reference);
+	bench_tokenize("reference x 1000",     repeated_text(arena, reference, reference.size * 1000));
+	MD_String8 synthetic = synthetic_text(arena, MD_MB(256));
+	bench_tokenize("synthetic table data", synthetic);
+	bench_tokenize_parallel("synthetic table data, parallel", synthetic);
+	bench_parse("reference x 1000, parse", repeated_text(arena, reference, reference.size * 1000));
+	bench_parse("synthetic table data, parse", synthetic);
+	bench_parse_layouts("synthetic table data, token layouts", synthetic);
+	bench_flat_tree("synthetic table data, flat tree", md_str8_prefix(synthetic, MD_MB(64)));
+	bench_flat_tree_file("synthetic table data, flat tree file", md_str8_prefix(synthetic, MD_MB(64)));
+	bench_atoms("synthetic table data, atoms", md_str8_prefix(synthetic, MD_MB(64)));
+	bench_child_index("string table, child index", 20000);
+	bench_tag_filter("tagged types, tag filter", 200000);
+	bench_lazy_parse("synthetic table data, lazy parse", md_str8_prefix(synthetic, MD_MB(64)));
+	bench_filtered_parse("synthetic table data, filtered parse", md_str8_prefix(synthetic, MD_MB(64)));
+	bench_parse_parallel("synthetic table data, parallel parse", md_str8_prefix(synthetic, MD_MB(64)));
+	bench_parse_cache("synthetic table data, parse cache", md_str8_prefix(synthetic, MD_MB(64)));
+	bench_parse_files("synthetic table data, parallel files", 2000, MD_KB(32));
+	bench_select("synthetic table data, selectors", md_str8_prefix(synthetic, MD_MB(64)));
+	bench_lookup_path("config, lookup paths", 1000000);
+	bench_emit("synthetic table data, canonical emit", md_str8_prefix(synthetic, MD_MB(64)));
+	bench_export("synthetic table data, json/msgpack export", md_str8_prefix(synthetic, MD_MB(64)));
+	bench_tree_hash("synthetic table data, tree hashes", md_str8_prefix(synthetic, MD_MB(64)));
+	return 0;
+}
@@ -0,0 +1,878 @@
+//$ exe //
+
+#include "metadesk.c"
+
+MD_Arena* arena = 0;
+
+static struct
+{
+	int number_of_tests;
+	int number_passed;
+}
+test_ctx;
+
+static void
+begin_test(char* name)
+{
+	int length = (int)md_cstring_length((MD_U8*)name);
+	int spaces = 25 - length;
+	if (spaces < 0) {
+		spaces = 0;
+	}
+	printf("\"%s\" %.*s [", name, spaces, "------------------------------");
+	test_ctx.number_of_tests = 0;
+	test_ctx.number_passed   = 0;
+}
+
+static void
+test_result(MD_B32 result)
+{
+	test_ctx.number_of_tests += 1;
+	test_ctx.number_passed   += !!result;
+	printf(result ? "." : "X");
+}
+
+static void
+end_test(void)
+{
+	int spaces = 20 - test_ctx.number_of_tests;
+	if (spaces < 0) { spaces = 0; }
+	printf("]%.*s ", spaces, "                                      ");
+	printf("[%i/%i] %i passed, %i tests, ",
+		test_ctx.number_passed, test_ctx.number_of_tests,
+		test_ctx.number_passed, test_ctx.number_of_tests);
+	if (test_ctx.number_of_tests == test_ctx.number_passed) {
+		printf("SUCCESS ( )");
+	}
+	else {
+		printf("FAILED  (X)");
+	}
+	printf("\n");
+}
+
+#define test(name) for(int _i_ = (begin_test(name), 0); !_i_; _i_ += 1, end_test())
+
+//- random text made of fragments that stress every token class & their edge cases
+
+static MD_U32 rng_state = 1;
+
+static MD_U32
+rng_next(void) {
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 17;
+	rng_state ^= rng_state << 5;
+	return rng_state;
+}
+
+static MD_String8
+random_text(MD_Arena* arena, MD_U64 max_size)
+{
+	md_local_persist char* fragments[] = {
+		"//", "/*", "*/", "\"", "'", "`", "\"\"\"", "'''", "```", "\\", "\n", "\r\n", " ", "\t",
+		"abc", "_x", "123", ".5", "-3", "{", "}", "(", ")", "@", "#", ":", ";", ",", "+-*",
+		"\xc3\xa9", "\x80", "x\\\n", "lorem ipsum dolor sit amet consectetur ",
+	};
+	MD_U8* str  = md_push_array(arena, MD_U8, max_size);
+	MD_U64 size = 0;
+	for (;;)
+	{
+		MD_String8 fragment = md_str8_cstring(fragments[rng_next() % md_array_count(fragments)]);
+		if (size + fragment.size > max_size) {
+			break;
+		}
+		md_memory_copy(str + size, fragment.str, fragment.size);
+		size += fragment.size;
+	}
+	return md_str8(str, size);
+}
+
+static MD_B32
+tokenize_results_match(MD_TokenizeResult a, MD_TokenizeResult b)
+{
+	MD_B32 result = a.tokens.count == b.tokens.count && a.msgs.count == b.msgs.count;
+	for (MD_U64 idx = 0; result && idx < a.tokens.count; idx += 1) {
+		result = md_token_match(a.tokens.v[idx], b.tokens.v[idx]);
+	}
+	for (MD_Msg* ma = a.msgs.first, *mb = b.msgs.first; result && ma != 0 && mb != 0; ma = ma->next, mb = mb->next) {
+		result = ma->kind == mb->kind && ma->node->src_offset == mb->node->src_offset && md_str8_match(ma->string, mb->string, 0);
+	}
+	return result;
+}
+
+static MD_B32
+str8_list_has(MD_String8List* list, MD_String8 string)
+{
+	MD_B32 result = 0;
+	for (MD_String8Node* node = list->first; !result && node != 0; node = node->next) {
+		result = md_str8_match(node->string, string, 0);
+	}
+	return result;
+}
+
+//- reference tokenizer: the branch-per-class implementation the table-driven one replaced, kept to diff against
+// (comment ranges end at their terminator, matching the tokenizer since tokens were made to tile the text)
+
+static MD_TokenizeResult
+tokenize_from_text__reference(MD_AllocatorInfo ainfo, MD_String8 text)
+{
+	MD_TempArena scratch = md_scratch_begin(ainfo);
+
+	MD_TokenChunkList tokens = {0};
+	MD_MsgList        msgs = {0};
+
+	MD_U8* byte_first = text.str;
+	MD_U8* byte_opl   = byte_first + text.size; // one-past-last
+	MD_U8* byte       = byte_first;
+
+	//- rjf: scan string & produce tokens
+	for (;byte < byte_opl;)
+	{
+		MD_TokenFlags md_token_flags = 0;
+		MD_U8*        md_token_start = 0;
+		MD_U8*        md_token_opl   = 0;
+
+		#define is_whitespace(byte) (*byte == ' ' || *byte == '\t' || *byte == '\v' || *byte == '\r')
+		
+		//- rjf: whitespace
+		if (md_token_flags == 0 && is_whitespace(byte))
+		{
+			md_token_flags = MD_TokenFlag_Whitespace;
+			md_token_start = byte;
+			md_token_opl   = byte;
+
+			byte += 1;
+			for (;byte <= byte_opl; byte += 1)
+			{
+				md_token_opl += 1;
+				if (byte == byte_opl || !is_whitespace(byte)) {
+					break;
+				}
+			}
+		}
+		#undef is_whitespace
+		
+		//- rjf: newlines
+		if (md_token_flags == 0 && *byte == '\n')
+		{
+			md_token_flags = MD_TokenFlag_Newline;
+			md_token_start = byte;
+			md_token_opl   = byte+1;
+
+			byte += 1;
+		}
+		
+		//- rjf: single-line comments
+		if (md_token_flags == 0 && (byte + 1 < byte_opl && *byte == '/' && byte[1] == '/'))
+		{
+			md_token_flags = MD_TokenFlag_Comment;
+			md_token_start = byte;
+			md_token_opl   = byte+2;
+
+			byte += 2;
+
+			MD_B32 escaped = 0;
+			for (;byte <= byte_opl; byte += 1)
+			{
+				md_token_opl += 1;
+				if (byte == byte_opl) {
+					break;
+				}
+				if (escaped) {
+					escaped = 0;
+				}
+				else
+				{
+					if (*byte == '\n') {
+						break;
+					}
+					else if (*byte == '\\') {
+						escaped = 1;
+					}
+				}
+			}
+			md_token_opl = byte;
+		}
+		
+		//- rjf: multi-line comments
+		if (md_token_flags == 0 && (byte + 1 < byte_opl && *byte == '/' && byte[1] == '*'))
+		{
+			md_token_flags = MD_TokenFlag_Comment;
+			md_token_start = byte;
+			md_token_opl   = byte + 2;
+
+			byte += 2;
+			for (;byte <= byte_opl; byte += 1)
+			{
+				md_token_opl += 1;
+				if (byte == byte_opl) {
+					md_token_flags |= MD_TokenFlag_BrokenComment;
+					md_token_opl    = byte;
+					break;
+				}
+				if (byte + 1 < byte_opl && byte[0] == '*' && byte[1] == '/') {
+					byte         += 2;
+					md_token_opl  = byte;
+					break;
+				}
+			}
+		}
+
+		#define is_identifier(byte) (         \
+			('A' <= *byte && *byte <= 'Z') || \
+			('a' <= *byte && *byte <= 'z') || \
+			*byte == '_'                   || \
+			md_utf8_class(*byte >> 3) >= 2       \
+		)
+		#if 0
+		(
+			!('A' <= *byte && *byte <= 'Z') && 
+			!('a' <= *byte && *byte <= 'z') && 
+			!('0' <= *byte && *byte <= '9') && 
+			*byte != '_' && 
+			md_utf8_class(*byte>>3) < 2
+		)
+		#endif
+		
+		//- rjf: identifiers
+		if (md_token_flags == 0 && is_identifier(byte))
+		{
+			md_token_flags = MD_TokenFlag_Identifier;
+			md_token_start = byte;
+			md_token_opl   = byte;
+
+			byte += 1;
+			for(;byte <= byte_opl; byte += 1)
+			{
+				md_token_opl += 1;
+				// an identifier goes on through digits (matching C's rule), which this once stopped at
+				if (byte == byte_opl || !(is_identifier(byte) || ('0' <= *byte && *byte <= '9'))) {
+					break;
+				}
+			}
+		}
+		#undef is_identifier
+
+		#define is_numeric(byte) (                                                       \
+			('0'  <= *byte && *byte <= '9')                                           || \
+			(*byte == '.' && byte + 1 < byte_opl && '0' <= byte[1] && byte[1] <= '9') || \
+			(*byte == '-' && byte + 1 < byte_opl && '0' <= byte[1] && byte[1] <= '9') || \
+		     *byte == '_'                                                                \
+		)
+		#define is_not_numeric(byte) (         \
+			!('A' <= *byte && *byte <= 'Z') && \
+			!('a' <= *byte && *byte <= 'z') && \
+			!('0' <= *byte && *byte <= '9') && \
+			*byte != '_' && *byte != '.'       \
+		)
+		
+		//- rjf: numerics
+		if (md_token_flags == 0 && is_numeric(byte)) 
+		{
+			md_token_flags = MD_TokenFlag_Numeric;
+			md_token_start = byte;
+			md_token_opl   = byte;
+
+			byte += 1;
+			for (;byte <= byte_opl; byte += 1)
+			{
+				md_token_opl += 1;
+				if (byte == byte_opl || is_not_numeric(byte)) {
+					break;
+				}
+			}
+		}
+		#undef is_numeric
+		#undef is_not_numeric
+
+		#define is_triple_string_literal(byte) (                     \
+			(byte[0] == '"' && byte[1] == '"' && byte[2] == '"' ) || \
+			(byte[0] == '\''&& byte[1] == '\''&& byte[2] == '\'') || \
+			(byte[0] == '`' && byte[1] == '`' && byte[2] == '`' )    \
+		)
+		
+		//- rjf: triplet string literals
+		if (md_token_flags == 0 && byte + 2 < byte_opl && is_triple_string_literal(byte))
+		{
+			MD_U8 literal_style = byte[0];
+			md_token_flags  = MD_TokenFlag_StringLiteral | MD_TokenFlag_StringTriplet;
+			md_token_flags |= (literal_style == '\'') * MD_TokenFlag_StringSingleQuote;
+			md_token_flags |= (literal_style ==  '"') * MD_TokenFlag_StringDoubleQuote;
+			md_token_flags |= (literal_style ==  '`') * MD_TokenFlag_StringTick;
+			md_token_start  = byte;
+			md_token_opl    = byte + 3;
+
+			byte += 3;
+			for (;byte <= byte_opl; byte += 1)
+			{
+				if (byte == byte_opl) {
+					md_token_flags |= MD_TokenFlag_BrokenStringLiteral;
+					md_token_opl    = byte;
+					break;
+				}
+				if (byte + 2 < byte_opl && (byte[0] == literal_style && byte[1] == literal_style && byte[2] == literal_style)) { 
+					byte      += 3;
+					md_token_opl  = byte;
+					break;
+				}
+			}
+		}
+		#undef is_triple_string_literal
+		
+		//- rjf: singlet string literals
+		if (md_token_flags == 0 && (byte[0] == '"' || byte[0] == '\'' || byte[0] == '`'))
+		{
+			MD_U8 literal_style = byte[0];
+			md_token_flags  = MD_TokenFlag_StringLiteral;
+			md_token_flags |= (literal_style == '\'') * MD_TokenFlag_StringSingleQuote;
+			md_token_flags |= (literal_style ==  '"') * MD_TokenFlag_StringDoubleQuote;
+			md_token_flags |= (literal_style ==  '`') * MD_TokenFlag_StringTick;
+			md_token_start  = byte;
+			md_token_opl    = byte + 1;
+
+			byte += 1;
+			MD_B32 escaped = 0;
+			for (;byte <= byte_opl; byte += 1)
+			{
+				if (byte == byte_opl || *byte == '\n') {
+					md_token_opl = byte;
+					md_token_flags |= MD_TokenFlag_BrokenStringLiteral;
+					break;
+				}
+				if (!escaped && byte[0] == '\\') {
+					escaped = 1;
+				}
+				else if (!escaped && byte[0] == literal_style) {
+					md_token_opl = byte+1;
+					byte += 1;
+					break;
+				}
+				else if (escaped) {
+					escaped = 0;
+				}
+			}
+		}
+
+		#define is_non_reserved_symbol(byte) (                                              \
+			*byte == '~' || *byte == '!' || *byte == '$' || *byte == '%' || *byte == '^' || \
+			*byte == '&' || *byte == '*' || *byte == '-' || *byte == '=' || *byte == '+' || \
+			*byte == '<' || *byte == '.' || *byte == '>' || *byte == '/' || *byte == '?' || \
+			*byte == '|'                                                                    \
+		)
+		#if 0
+		(
+			*byte != '~' && *byte != '!' && *byte != '$' && *byte != '%' && *byte != '^' &&
+			*byte != '&' && *byte != '*' && *byte != '-' && *byte != '=' && *byte != '+' &&
+			*byte != '<' && *byte != '.' && *byte != '>' && *byte != '/' && *byte != '?' &&
+			*byte != '|'
+		)
+		#endif
+		
+		//- rjf: non-reserved symbols
+		if (md_token_flags == 0 && is_non_reserved_symbol(byte))
+		{
+			md_token_flags = MD_TokenFlag_Symbol;
+			md_token_start = byte;
+			md_token_opl   = byte;
+
+			byte += 1;
+			for (;byte <= byte_opl; byte += 1)
+			{
+				md_token_opl += 1;
+				if (byte == byte_opl || !is_non_reserved_symbol(byte)) {
+					break;
+				}
+			}
+		}
+		#undef is_non_reserved_symbol
+
+		#define is_reserved_symbol(byte) (  \
+			*byte == '{' || *byte == '}' || \
+			*byte == '(' || *byte == ')' || \
+			*byte == '[' || *byte == ']' || \
+			*byte == '#' ||                 \
+			*byte == ',' ||                 \
+			*byte == '\\'||                 \
+			*byte == ':' || *byte == ';' || \
+			*byte == '@'                    \
+		)
+		
+		//- rjf: reserved symbols
+		if (md_token_flags == 0 && is_reserved_symbol(byte)) {
+			md_token_flags = MD_TokenFlag_Reserved | md_token_reserved_flag(*byte);
+			md_token_start = byte;
+			md_token_opl   = byte+1;
+
+			byte += 1;
+		}
+		#undef is_reserved_symbol
+		
+		//- rjf: bad characters in all other cases
+		if (md_token_flags == 0) {
+			md_token_flags = MD_TokenFlag_BadCharacter;
+			md_token_start = byte;
+			md_token_opl   = byte+1;
+
+			byte += 1;
+		}
+		
+		//- rjf; push token if formed
+		if (md_token_flags != 0 && md_token_start != 0 && md_token_opl > md_token_start) {
+			MD_Token token = {{(MD_U64)(md_token_start - byte_first), (MD_U64)(md_token_opl - byte_first)}, md_token_flags};
+			md_token_chunk_list_push(scratch.arena, &tokens, 4096, token);
+		}
+		
+		//- rjf: push errors on unterminated comments
+		if (md_token_flags & MD_TokenFlag_BrokenComment)
+		{
+			MD_Node*   error        = md_push_node(ainfo, MD_NodeKind_ErrorMarker, 0, md_str8_lit(""), md_str8_lit(""), md_token_start - byte_first);
+			MD_String8 error_string = md_str8_lit("Unterminated comment.");
+			md_msg_list_push(ainfo, &msgs, error, MD_MsgKind_Error, error_string);
+		}
+		
+		//- rjf: push errors on unterminated strings
+		if (md_token_flags & MD_TokenFlag_BrokenStringLiteral) {
+			MD_Node*   error        = md_push_node(ainfo, MD_NodeKind_ErrorMarker, 0, md_str8_lit(""), md_str8_lit(""), md_token_start - byte_first);
+			MD_String8 error_string = md_str8_lit("Unterminated string literal.");
+			md_msg_list_push(ainfo, &msgs, error, MD_MsgKind_Error, error_string);
+		}
+	}
+
+	//- rjf: bake, fill & return
+	MD_TokenizeResult result = {0}; {
+		result.tokens = md_token_array_from_chunk_list(ainfo, &tokens);
+		result.msgs   = msgs;
+	}
+	scratch_end(scratch);
+	return result;
+}
+
+//- streaming tokenizer, fed in random-sized chunks & reassembled to diff against tokenizing the whole text
+
+static MD_TokenizeResult
+tokenize_stream_chunked(MD_Arena* arena, MD_String8 text, MD_U64 max_chunk_size, MD_B32* strings_match, MD_U64* carry_cap)
+{
+	MD_TokenizeStream stream;
+	md_tokenize_stream_init(&stream, md_heap());
+
+	MD_TokenChunkList tokens = {0};
+	MD_MsgList        msgs   = {0};
+	for (MD_U64 offset = 0;;)
+	{
+		MD_U64                  chunk_size = md_min(text.size - offset, 1 + rng_next() % max_chunk_size);
+		MD_String8              chunk      = md_str8_substr(text, md_r1u64(offset, offset + chunk_size));
+		MD_B32                  last       = chunk.size == 0;
+		MD_TokenizeStreamResult pushed     = last ? md_tokenize_stream_finish(arena, &stream) : md_tokenize_stream_push(arena, &stream, chunk);
+		for (MD_U64 idx = 0; idx < pushed.tokens.count; idx += 1)
+		{
+			MD_Token token = pushed.tokens.v[idx];
+			md_token_chunk_list_push(arena, &tokens, 256, token);
+			*strings_match = *strings_match && md_str8_match(md_tokenize_stream_token_string(&pushed, chunk, idx), md_str8_substr(text, token.range), 0);
+		}
+		md_msg_list_concat_in_place(&msgs, &pushed.msgs);
+		offset += chunk.size;
+		if (last) {
+			break;
+		}
+	}
+	*carry_cap = stream.carry_cap;
+	md_tokenize_stream_release(&stream);
+
+	MD_TokenizeResult result = {0}; {
+		result.tokens = md_token_array_from_chunk_list(arena, &tokens);
+		result.msgs   = msgs;
+	}
+	return result;
+}
+
+int main(int argc, char** argv)
+{
+	MD_Context ctx = {0};
+	md_init(&ctx);
+	arena = md_arena_alloc(.backing = md_varena_allocator(md_varena_alloc(0)));
+
+	// Paths are relative to the repo root, which defaults to the parent of build/
+	MD_String8 root = md_str8_lit("..");
+	if (argc > 1) {
+		root = md_str8_cstring(argv[1]);
+	}
+	MD_String8 reference = md_os_data_from_file_path(arena, md_str8f(arena, "%S/docs/metadesk_reference.mdesk", root));
+
+	MD_TextScanLevel supported = md_text_scan_level_supported();
+
+	test("Scan Kernels")
+	{
+		MD_TextScanKernels* scalar = &md_text_scan_kernel_table[MD_TextScanLevel_Scalar];
+		for (MD_TextScanLevel level = MD_TextScanLevel_SSE2; level <= supported; level += 1)
+		{
+			MD_TextScanKernels* kernels = &md_text_scan_kernel_table[level];
+			MD_B32              match   = 1;
+			for (MD_U64 iter = 0; iter < 10000 && match; iter += 1)
+			{
+				MD_TempArena temp  = md_temp_begin(arena);
+				MD_String8   text  = random_text(temp.arena, rng_next() % 256);
+				MD_U8*       first = text.str + (text.size ? rng_next() % text.size : 0);
+				MD_U8*       opl   = text.str + text.size;
+				match = match && kernels->find_any       (first, opl, '"', '\\', '\n') == scalar->find_any       (first, opl, '"', '\\', '\n');
+				match = match && kernels->find_pair      (first, opl, '*', '/')        == scalar->find_pair      (first, opl, '*', '/');
+				match = match && kernels->skip_whitespace(first, opl)                  == scalar->skip_whitespace(first, opl);
+				match = match && kernels->skip_identifier(first, opl)                  == scalar->skip_identifier(first, opl);
+				match = match && kernels->skip_numeric   (first, opl)                  == scalar->skip_numeric   (first, opl);
+				match = match && kernels->find_escape    (first, opl)                  == scalar->find_escape    (first, opl);
+				md_temp_end(temp);
+			}
+			test_result(match);
+		}
+	}
+
+	test("Identifiers")
+	{
+		// identifiers go on through digits but can't start with one, at every scan level
+		MD_String8    text      = md_str8_lit("abc123 x_9y 7abc a1.5 _0");
+		char*         strings[] = { "abc123", "x_9y", "7abc", "a1", ".5", "_0" };
+		MD_TokenFlags flags[]   = { MD_TokenFlag_Identifier, MD_TokenFlag_Identifier, MD_TokenFlag_Numeric, MD_TokenFlag_Identifier, MD_TokenFlag_Numeric, MD_TokenFlag_Identifier };
+		for (MD_TextScanLevel level = MD_TextScanLevel_Scalar; level <= supported; level += 1)
+		{
+			md_text_scan_set_level(level);
+			MD_TokenizeResult tokenize = md_tokenize_from_text(arena, text);
+			MD_U64            count    = 0;
+			MD_B32            match    = 1;
+			for (MD_U64 idx = 0; idx < tokenize.tokens.count && match; idx += 1)
+			{
+				MD_Token token = tokenize.tokens.v[idx];
+				if (token.flags & MD_TokenFlagGroup_Whitespace) continue;
+				match = count < md_array_count(strings) && token.flags == flags[count] && md_str8_match(md_str8_substr(text, token.range), md_str8_cstring(strings[count]), 0);
+				count += 1;
+			}
+			test_result(match && count == md_array_count(strings));
+		}
+		md_text_scan_set_level(supported);
+	}
+
+	test("Token Flag Strings")
+	{
+		// every flag has its own name, a reserved token's names include its symbol's
+		MD_TempArena   temp  = md_temp_begin(arena);
+		MD_String8List names = {0};
+		MD_B32         named = 1;
+		for (MD_TokenFlags flag = 1; flag <= MD_TokenFlag_Backslash; flag <<= 1) {
+			MD_String8List strs = md_string_list_from_token_flags(temp.arena, flag);
+			named = named && strs.node_count == 1 && !str8_list_has(&names, strs.first->string);
+			md_str8_list_push(temp.arena, &names, strs.first->string);
+		}
+		test_result(named);
+
+		char*             strings[] = { "BraceLeft", "BraceRight", "BracketLeft", "BracketRight", "ParenLeft", "ParenRight", "Colon", "Semicolon", "Comma", "At", "Hash", "Backslash" };
+		MD_TokenizeResult tokenize  = md_tokenize_from_text(temp.arena, md_str8_lit("{}[]():;,@#\\"));
+		MD_B32            match     = tokenize.tokens.count == md_array_count(strings);
+		for (MD_U64 idx = 0; idx < tokenize.tokens.count && match; idx += 1) {
+			MD_String8List strs = md_string_list_from_token_flags(temp.arena, tokenize.tokens.v[idx].flags);
+			match = str8_list_has(&strs, md_str8_cstring(strings[idx]));
+		}
+		test_result(match);
+		md_temp_end(temp);
+	}
+
+	test("Tokenizer Levels")
+	{
+		MD_String8 texts[] = {
+			reference,
+			random_text(arena, MD_KB(256)),
+			md_str8_lit("/* unterminated"),
+			md_str8_lit("'''unterminated triplet"),
+			md_str8_lit("\"escaped \\\" quote\" // comment \\\n continued\nnext"),
+		};
+		for (MD_U64 text_idx = 0; text_idx < md_array_count(texts); text_idx += 1)
+		{
+			md_text_scan_set_level(MD_TextScanLevel_Scalar);
+			MD_TokenizeResult expected = md_tokenize_from_text(arena, texts[text_idx]);
+			for (MD_TextScanLevel level = MD_TextScanLevel_SSE2; level <= supported; level += 1)
+			{
+				md_text_scan_set_level(level);
+				MD_TokenizeResult actual = md_tokenize_from_text(arena, texts[text_idx]);
+				test_result(tokenize_results_match(expected, actual));
+			}
+		}
+		md_text_scan_set_level(supported);
+	}
+
+	test("Tokenizer Reference")
+	{
+		md_local_persist char* sample_paths[] = {
+			"docs/metadesk_reference.mdesk",
+			"examples/expr/expr_c_like.mdesk",
+			"examples/expr/expr_intro.mdesk",
+			"examples/intro/hello_world.mdesk",
+			"examples/intro/labels.mdesk",
+			"examples/intro/sets.mdesk",
+			"examples/type_metadata/bad_types.mdesk",
+			"examples/type_metadata/types.mdesk",
+			"examples/user_errors/user_errors.mdesk",
+		};
+		for (MD_U64 path_idx = 0; path_idx < md_array_count(sample_paths); path_idx += 1)
+		{
+			MD_TempArena temp = md_temp_begin(arena);
+			MD_String8   text = md_os_data_from_file_path(temp.arena, md_str8f(temp.arena, "%S/%s", root, sample_paths[path_idx]));
+			test_result(text.size > 0 && tokenize_results_match(tokenize_from_text__reference(md_arena_allocator(temp.arena), text), md_tokenize_from_text(temp.arena, text)));
+			md_temp_end(temp);
+		}
+
+		// every byte value, in random sequences & in fragments that sit on the lookahead boundaries
+		MD_B32 match = 1;
+		for (MD_U64 iter = 0; iter < 20000 && match; iter += 1)
+		{
+			MD_TempArena temp = md_temp_begin(arena);
+			MD_String8   text = random_text(temp.arena, rng_next() % 512);
+			if (iter & 1) {
+				for (MD_U64 idx = 0; idx < text.size; idx += 1) {
+					text.str[idx] = (MD_U8)rng_next();
+				}
+			}
+			match = tokenize_results_match(tokenize_from_text__reference(md_arena_allocator(temp.arena), text), md_tokenize_from_text(temp.arena, text));
+			md_temp_end(temp);
+		}
+		test_result(match);
+	}
+
+	test("Tokenizer Stream")
+	{
+		MD_String8 texts[] = {
+			reference,
+			random_text(arena, MD_KB(64)),
+			md_str8_lit("/* unterminated"),
+			md_str8_lit("'''unterminated triplet ''"),
+			md_str8_lit("\"\" '' ``` ``` \"a\\\"b\" // comment \\\n continued\n/**/ -5 .5 +-5 /"),
+		};
+		MD_U64 chunk_sizes[] = { 1, 2, 3, 7, 64, MD_KB(4) };
+		for (MD_U64 text_idx = 0; text_idx < md_array_count(texts); text_idx += 1)
+		{
+			MD_TokenizeResult expected = md_tokenize_from_text(arena, texts[text_idx]);
+			MD_U64            longest  = 0;
+			for (MD_U64 idx = 0; idx < expected.tokens.count; idx += 1) {
+				longest = md_max(longest, md_dim_1u64(expected.tokens.v[idx].range));
+			}
+
+			// carried bytes never outgrow the longest token that spans a chunk boundary
+			MD_B32 match = 1;
+			for (MD_U64 size_idx = 0; size_idx < md_array_count(chunk_sizes); size_idx += 1)
+			{
+				MD_TempArena      temp          = md_temp_begin(arena);
+				MD_B32            strings_match = 1;
+				MD_U64            carry_cap     = 0;
+				MD_TokenizeResult actual        = tokenize_stream_chunked(temp.arena, texts[text_idx], chunk_sizes[size_idx], &strings_match, &carry_cap);
+				match = match && strings_match && tokenize_results_match(expected, actual) && carry_cap <= md_max(256, 2 * longest);
+				md_temp_end(temp);
+			}
+			test_result(match);
+		}
+
+		MD_B32 match = 1;
+		for (MD_U64 iter = 0; iter < 10000 && match; iter += 1)
+		{
+			MD_TempArena temp          = md_temp_begin(arena);
+			MD_String8   text          = random_text(temp.arena, rng_next() % 512);
+			MD_B32       strings_match = 1;
+			MD_U64       carry_cap     = 0;
+			if (iter & 1) {
+				for (MD_U64 idx = 0; idx < text.size; idx += 1) {
+					text.str[idx] = (MD_U8)rng_next();
+				}
+			}
+			MD_TokenizeResult expected = md_tokenize_from_text(temp.arena, text);
+			MD_TokenizeResult actual   = tokenize_stream_chunked(temp.arena, text, 1 + rng_next() % 16, &strings_match, &carry_cap);
+			match = strings_match && tokenize_results_match(expected, actual);
+			md_temp_end(temp);
+		}
+		test_result(match);
+	}
+
+	test("Tokenizer Parallel")
+	{
+		// splits land inside strings & comments that span many lines, as well as on plain boundaries
+		MD_String8List reference_parts = {0};
+		MD_String8List spanning_parts  = {0};
+		for (MD_U64 idx = 0; reference_parts.total_size < MD_MB(4); idx += 1) {
+			md_str8_list_push(arena, &reference_parts, reference);
+		}
+		for (MD_U64 idx = 0; spanning_parts.total_size < MD_MB(4); idx += 1)
+		{
+			md_str8_list_push(arena, &spanning_parts, md_str8_lit("\"\"\"\n"));
+			for (MD_U64 line = 0; line < 20000; line += 1) {
+				md_str8_list_push(arena, &spanning_parts, md_str8_lit("a /* b // c ' \" d\n"));
+			}
+			md_str8_list_push(arena, &spanning_parts, md_str8_lit("\"\"\" /*\n"));
+			for (MD_U64 line = 0; line < 20000; line += 1) {
+				md_str8_list_push(arena, &spanning_parts, md_str8_lit("x: \"y\" // z\n"));
+			}
+			md_str8_list_push(arena, &spanning_parts, md_str8_lit("*/ 'unterminated\n"));
+		}
+		MD_String8 texts[] = {
+			md_str8_list_join(arena, &reference_parts, 0),
+			md_str8_list_join(arena, &spanning_parts, 0),
+			random_text(arena, MD_MB(4)),
+			md_str8_list_join(arena, &spanning_parts, &(MD_StringJoin){ .post = md_str8_lit("/* unterminated") }),
+		};
+		MD_U64 thread_counts[] = { 2, 3, 7, 16 };
+		for (MD_U64 text_idx = 0; text_idx < md_array_count(texts); text_idx += 1)
+		{
+			MD_TokenizeResult expected = md_tokenize_from_text(arena, texts[text_idx]);
+			MD_B32            match    = 1;
+			for (MD_U64 count_idx = 0; count_idx < md_array_count(thread_counts); count_idx += 1)
+			{
+				MD_TempArena temp = md_temp_begin(arena);
+				match = match && tokenize_results_match(expected, md_tokenize_from_text_parallel(temp.arena, texts[text_idx], thread_counts[count_idx]));
+				md_temp_end(temp);
+			}
+			test_result(match);
+		}
+	}
+
+	test("Compact Tokens")
+	{
+		MD_String8 texts[] = {
+			reference,
+			random_text(arena, MD_KB(256)),
+			md_str8_lit(""),
+			md_str8_lit("/* unterminated"),
+			md_str8_lit("@tag(a, b) label: { child_a; child_b, 'broken\n} \"\"\"triplet\"\"\" 1.5 -2 a.b"),
+		};
+		for (MD_U64 text_idx = 0; text_idx < md_array_count(texts); text_idx += 1)
+		{
+			MD_TempArena             temp     = md_temp_begin(arena);
+			MD_String8               text     = texts[text_idx];
+			MD_TokenizeResult        wide     = md_tokenize_from_text(temp.arena, text);
+			MD_TokenizeCompactResult compact  = md_tokenize_compact_from_text(temp.arena, text);
+			MD_CompactTokenArray     from_wide = md_compact_token_array_from_token_array(temp.arena, wide.tokens);
+
+			MD_B32 match = wide.tokens.count == compact.tokens.count && wide.tokens.count == from_wide.count && wide.msgs.count == compact.msgs.count;
+			for (MD_U64 idx = 0; match && idx < wide.tokens.count; idx += 1) {
+				match = md_token_match(wide.tokens.v[idx], md_compact_token_at(&compact.tokens, idx)) && md_token_match(wide.tokens.v[idx], md_compact_token_at(&from_wide, idx));
+			}
+
+			// same tree & messages from either layout
+			MD_ParseResult wide_parse    = md_parse_from_text_tokens        (temp.arena, md_str8_lit("text"), text, wide.tokens);
+			MD_ParseResult compact_parse = md_parse_from_text_compact_tokens(temp.arena, md_str8_lit("text"), text, compact.tokens);
+			match = match && tree_match(wide_parse.root, compact_parse.root, 0) && wide_parse.msgs.count == compact_parse.msgs.count;
+			test_result(match);
+			md_temp_end(temp);
+		}
+	}
+
+	test("Significant Tokens")
+	{
+		MD_String8 texts[] = {
+			reference,
+			random_text(arena, MD_KB(256)),
+			md_str8_lit(""),
+			md_str8_lit("  // only trivia\n\n"),
+			md_str8_lit("// a\n/* b */ label\n\n\n@tag (x) /* unterminated"),
+		};
+		for (MD_U64 text_idx = 0; text_idx < md_array_count(texts); text_idx += 1)
+		{
+			MD_TempArena                 temp        = md_temp_begin(arena);
+			MD_String8                   text        = texts[text_idx];
+			MD_TokenizeResult            wide        = md_tokenize_from_text(temp.arena, text);
+			MD_TokenizeSignificantResult significant = md_tokenize_significant_from_text(temp.arena, text, 1);
+
+			// fold the wide tokens by hand
+			MD_B32     match    = wide.msgs.count == significant.msgs.count;
+			MD_U64     sig_idx  = 0;
+			MD_U32     newlines = 0;
+			MD_B32     spaced   = 0;
+			MD_Rng1U64 comment  = {0};
+			for (MD_U64 idx = 0; match && idx < wide.tokens.count; idx += 1)
+			{
+				MD_Token token = wide.tokens.v[idx];
+				if (token.flags & (MD_TokenFlag_Whitespace | MD_TokenFlag_Newline | MD_TokenFlag_Comment)) {
+					newlines += !!(token.flags & MD_TokenFlag_Newline);
+					spaced    = 1;
+					if (token.flags & MD_TokenFlag_Comment) {
+						comment = md_r1u64(comment.md_max == 0 ? token.range.md_min : comment.md_min, token.range.md_max);
+					}
+					continue;
+				}
+				if (sig_idx >= significant.tokens.count) {
+					match = 0;
+					break;
+				}
+				MD_SignificantToken sig = significant.tokens.v[sig_idx];
+				match = (
+					sig.range.md_min == token.range.md_min && sig.range.md_max == token.range.md_max && sig.flags == token.flags &&
+					md_significant_token_newline_count(sig) == newlines && md_significant_token_is_adjacent(sig) == !spaced &&
+					significant.tokens.comments[sig_idx].md_min == comment.md_min && significant.tokens.comments[sig_idx].md_max == comment.md_max
+				);
+				sig_idx += 1;
+				newlines = 0;
+				spaced   = 0;
+				comment  = md_r1u64(0, 0);
+			}
+			match = match && sig_idx == significant.tokens.count;
+			test_result(match);
+			md_temp_end(temp);
+		}
+	}
+
+	test("Tokenizer Edits")
+	{
+		// random edits to random text, any fragment may be inserted or cut apart
+		MD_B32 match = 1;
+		for (MD_U64 iter = 0; iter < 4000 && match; iter += 1)
+		{
+			MD_TempArena      temp        = md_temp_begin(arena);
+			MD_String8        old_text    = random_text(temp.arena, rng_next() % MD_KB(2));
+			MD_TokenizeResult old         = md_tokenize_from_text(temp.arena, old_text);
+			MD_U64            edit_min    = rng_next() % (old_text.size + 1);
+			MD_U64            edit_max    = edit_min + rng_next() % (old_text.size - edit_min + 1) % 32;
+			MD_String8        replacement = random_text(temp.arena, rng_next() % 32);
+			MD_String8        new_text    = md_str8f(temp.arena, "%S%S%S", md_str8_prefix(old_text, edit_min), replacement, md_str8_skip(old_text, edit_max));
+
+			MD_TokenizeEditResult edited  = md_tokenize_from_text_edit(temp.arena, old.tokens, old_text, new_text, md_r1u64(edit_min, edit_max));
+			MD_TokenizeResult     as_full = { edited.tokens, edited.msgs };
+			MD_TokenizeResult     full    = md_tokenize_from_text(temp.arena, new_text);
+			match = tokenize_results_match(full, as_full);
+
+			// in place, over the old tokens & messages, fails with nothing changed when they don't fit
+			MD_U64                token_cap = md_max(old.tokens.count, full.tokens.count);
+			MD_TokenizeEditResult in_place  = { { md_push_array(temp.arena, MD_Token, token_cap), old.tokens.count }, old.msgs };
+			md_memory_copy(in_place.tokens.v, old.tokens.v, size_of(MD_Token) * old.tokens.count);
+			if (full.tokens.count > old.tokens.count) {
+				match = match && ! md_tokenize_edit_in_place(temp.arena, &in_place, old.tokens.count, old_text, new_text, md_r1u64(edit_min, edit_max)) && in_place.tokens.count == old.tokens.count;
+			}
+			match = match && md_tokenize_edit_in_place(temp.arena, &in_place, token_cap, old_text, new_text, md_r1u64(edit_min, edit_max));
+			match = match && tokenize_results_match(full, (MD_TokenizeResult){ in_place.tokens, in_place.msgs }) && md_memory_match(&in_place.relexed, &edited.relexed, sizeof(MD_Rng1U64));
+			md_temp_end(temp);
+		}
+		test_result(match);
+
+		// typing into the reference one keystroke at a time, each only re-lexes around itself, in place too
+		MD_TempArena          temp      = md_temp_begin(arena);
+		MD_String8            text      = reference;
+		MD_TokenizeResult     tokenize  = md_tokenize_from_text(temp.arena, text);
+		MD_U64                token_cap = tokenize.tokens.count + 1000;
+		MD_TokenizeEditResult in_place  = { { md_push_array(temp.arena, MD_Token, token_cap), tokenize.tokens.count }, tokenize.msgs };
+		MD_U64                max_lexed = 0;
+		md_memory_copy(in_place.tokens.v, tokenize.tokens.v, size_of(MD_Token) * tokenize.tokens.count);
+		match = 1;
+		for (MD_U64 iter = 0; iter < 500 && match; iter += 1)
+		{
+			MD_U64     at       = rng_next() % (text.size + 1);
+			MD_B32     erase    = (iter & 1) && at < text.size && md_char_is_alpha(text.str[at]);
+			MD_String8 new_text = erase ?
+				md_str8f(temp.arena, "%S%S",  md_str8_prefix(text, at), md_str8_skip(text, at + 1)) :
+				md_str8f(temp.arena, "%Sx%S", md_str8_prefix(text, at), md_str8_skip(text, at));
+
+			MD_TokenizeEditResult edited = md_tokenize_from_text_edit(temp.arena, tokenize.tokens, text, new_text, md_r1u64(at, at + erase));
+			match           = md_tokenize_edit_in_place(temp.arena, &in_place, token_cap, text, new_text, md_r1u64(at, at + erase));
+			tokenize.tokens = edited.tokens;
+			tokenize.msgs   = edited.msgs;
+			text            = new_text;
+			match           = match && tokenize_results_match(md_tokenize_from_text(temp.arena, text), tokenize);
+			match           = match && tokenize_results_match(tokenize, (MD_TokenizeResult){ in_place.tokens, in_place.msgs });
+			max_lexed       = md_max(max_lexed, edited.relexed.md_max - edited.relexed.md_min);
+		}
+		test_result(match);
+		test_result(max_lexed <= 8);
+		md_temp_end(temp);
+	}
+
+	return 0;
+}